@@ -62,6 +62,7 @@
 #message( STATUS "TokenList2DsnLexer.cmake" )    # indicate we are running
 
 set( tokens "" )
+set( keywordMapLines "" )
 set( lineCount 0 )
 set( dsnErrorMsg "TokenList2DsnLexer.cmake failure:" )
 
@@ -212,6 +213,7 @@ foreach( token ${tokens} )
     endif( lineCount EQUAL 1 )
 
     file(APPEND "${outCppFile}" "    TOKDEF( ${token} )" )
+    list( APPEND keywordMapLines "        KW_MAP( ${token} )" )
 
     if( lineCount EQUAL tokensAfter )
         file( APPEND "${outHeaderFile}" "\n" )
@@ -240,6 +242,9 @@ class ${LEXERCLASS} : public DSNLEXER
     static const KEYWORD  keywords[];
     static const unsigned keyword_count;
 
+    /// Keyword hashtable shared by all instances, built on first use.
+    static const KEYWORD_MAP& keywordsHash();
+
 public:
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -248,7 +253,7 @@ public:
      *   If left empty, then _(\"clipboard\") is used.
      */
     ${LEXERCLASS}( const std::string& aSExpression, const wxString& aSource = wxEmptyString ) :
-        DSNLEXER( keywords, keyword_count, aSExpression, aSource )
+        DSNLEXER( keywords, keyword_count, &keywordsHash(), aSExpression, aSource )
     {
     }
 
@@ -262,7 +267,7 @@ public:
      * @param aFilename is the name of the opened file, needed for error reporting.
      */
     ${LEXERCLASS}( FILE* aFile, const wxString& aFilename ) :
-        DSNLEXER( keywords, keyword_count, aFile, aFilename )
+        DSNLEXER( keywords, keyword_count, &keywordsHash(), aFile, aFilename )
     {
     }
 
@@ -278,7 +283,7 @@ public:
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken of aLineReader.
      */
     ${LEXERCLASS}( LINE_READER* aLineReader ) :
-        DSNLEXER( keywords, keyword_count, aLineReader )
+        DSNLEXER( keywords, keyword_count, &keywordsHash(), aLineReader )
     {
     }
 
@@ -373,11 +378,27 @@ class ${PARSERCLASS} : public ${LEXERCLASS}
 "
 )
 
+# The keyword hashtable is emitted along with the table so that every lexer instance shares
+# it rather than rebuilding it at construction.  It is a function-local static so that it is
+# built before any lexer uses it, even from another translation unit's static initializer.
+string( REPLACE ";" ",\n" keywordMapText "${keywordMapLines}" )
+
 file( APPEND "${outCppFile}"
 "};
 
 const unsigned ${LEXERCLASS}::keyword_count = unsigned( sizeof( ${LEXERCLASS}::keywords )/sizeof( ${LEXERCLASS}::keywords[0] ) );
 
+#define KW_MAP(x)    { #x, T_##x }
+
+const KEYWORD_MAP& ${LEXERCLASS}::keywordsHash()
+{
+    static const KEYWORD_MAP hash( {
+${keywordMapText}
+    } );
+
+    return hash;
+}
+
 
 const char* ${LEXERCLASS}::TokenName( T aTok )
 {
@@ -162,6 +162,12 @@ static const wxChar DrawBoundingBoxes[] = wxT( "DrawBoundingBoxes" );
 
 static const wxChar ShowPcbnewExportNetlist[] = wxT( "ShowPcbnewExportNetlist" );
 
+static const wxChar IncrementalDRC[] = wxT( "IncrementalDRC" );
+
+static const wxChar DRCResultCache[] = wxT( "DRCResultCache" );
+
+static const wxChar DRCProfile[] = wxT( "DRCProfile" );
+
 } // namespace KEYS
 
 
@@ -264,6 +270,9 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_HotkeysDumper             = false;
     m_DrawBoundingBoxes         = false;
     m_ShowPcbnewExportNetlist   = false;
+    m_IncrementalDRC            = false;
+    m_DRCResultCache            = false;
+    m_DRCProfile                = false;
 
     loadFromConfigFile();
 }
@@ -364,6 +373,15 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ShowPcbnewExportNetlist,
                                                 &m_ShowPcbnewExportNetlist, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalDRC,
+                                                &m_IncrementalDRC, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DRCResultCache,
+                                                &m_DRCResultCache, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DRCProfile,
+                                                &m_DRCProfile, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
@@ -50,34 +50,37 @@ void DSNLEXER::init()
 
     curOffset = 0;
 
-#if 1
-    if( keywordCount > 11 )
+    if( !keywordsLookup )
     {
-        // resize the hashtable bucket count
-        keyword_hash.reserve( keywordCount );
-    }
+        // No table was generated along with the keywords, so fill our own specialized
+        // "C string" hashtable from keywords[]
+        if( keywordCount > 11 )
+        {
+            // resize the hashtable bucket count
+            ownKeywordsLookup.reserve( keywordCount );
+        }
 
-    // fill the specialized "C string" hashtable from keywords[]
-    const KEYWORD*  it  = keywords;
-    const KEYWORD*  end = it + keywordCount;
+        const KEYWORD*  it  = keywords;
+        const KEYWORD*  end = it + keywordCount;
 
-    for( ; it < end; ++it )
-    {
-        keyword_hash[it->name] = it->token;
+        for( ; it < end; ++it )
+            ownKeywordsLookup[it->name] = it->token;
+
+        keywordsLookup = &ownKeywordsLookup;
     }
-#endif
 }
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    FILE* aFile, const wxString& aFilename ) :
+                    const KEYWORD_MAP* aKeywordMap, FILE* aFile, const wxString& aFilename ) :
     iOwnReaders( true ),
     start( nullptr ),
     next( nullptr ),
     limit( nullptr ),
     reader( nullptr ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordsLookup( aKeywordMap )
 {
     FILE_LINE_READER* fileReader = new FILE_LINE_READER( aFile, aFilename );
     PushReader( fileReader );
@@ -86,14 +89,16 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    const std::string& aClipboardTxt, const wxString& aSource ) :
+                    const KEYWORD_MAP* aKeywordMap, const std::string& aClipboardTxt,
+                    const wxString& aSource ) :
     iOwnReaders( true ),
     start( nullptr ),
     next( nullptr ),
     limit( nullptr ),
     reader( nullptr ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordsLookup( aKeywordMap )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aClipboardTxt, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -103,14 +108,15 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    LINE_READER* aLineReader ) :
+                    const KEYWORD_MAP* aKeywordMap, LINE_READER* aLineReader ) :
     iOwnReaders( false ),
     start( nullptr ),
     next( nullptr ),
     limit( nullptr ),
     reader( nullptr ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordsLookup( aKeywordMap )
 {
     if( aLineReader )
         PushReader( aLineReader );
@@ -127,7 +133,8 @@ DSNLEXER::DSNLEXER( const std::string& aSExpression, const wxString& aSource ) :
     limit( nullptr ),
     reader( nullptr ),
     keywords( empty_keywords ),
-    keywordCount( 0 )
+    keywordCount( 0 ),
+    keywordsLookup( nullptr )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aSExpression, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -226,11 +233,11 @@ LINE_READER* DSNLEXER::PopReader()
 }
 
 
-int DSNLEXER::findToken( const std::string& tok ) const
+int DSNLEXER::findToken( const char* tok ) const
 {
-    KEYWORD_MAP::const_iterator it = keyword_hash.find( tok.c_str() );
+    KEYWORD_MAP::const_iterator it = keywordsLookup->find( tok );
 
-    if( it != keyword_hash.end() )
+    if( it != keywordsLookup->end() )
         return it->second;
 
     return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
@@ -746,14 +753,14 @@ L_read:
         }
     }           // specctraMode
 
-    // non-quoted token, read it into curText.
-    curText.clear();
-
+    // non-quoted token, read it into curText in one go.
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
-    if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
+    if( isNumber( cur, head ) )
     {
         curTok = DSN_NUMBER;
         goto exit;
@@ -765,7 +772,7 @@ L_read:
         goto exit;
     }
 
-    curTok = findToken( curText );
+    curTok = findToken( curText.c_str() );
 
 exit:   // single point of exit, no returns elsewhere please.
 
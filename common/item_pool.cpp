@@ -0,0 +1,146 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <item_pool.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+
+static const size_t GRANULARITY = 16;
+static const size_t MAX_BLOCK_SIZE = 2048;
+static const size_t SIZE_CLASS_COUNT = MAX_BLOCK_SIZE / GRANULARITY;
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+
+struct FREE_BLOCK
+{
+    FREE_BLOCK* next;
+};
+
+
+struct SIZE_CLASS
+{
+    std::mutex  lock;
+    FREE_BLOCK* freeList = nullptr;
+    char*       chunkCursor = nullptr;  ///< next uncarved block of the current chunk
+    char*       chunkEnd = nullptr;
+};
+
+
+struct POOLS
+{
+    SIZE_CLASS          classes[SIZE_CLASS_COUNT];
+    std::atomic<size_t> allocations{ 0 };
+    std::atomic<size_t> frees{ 0 };
+    std::atomic<size_t> bytesInUse{ 0 };
+    std::atomic<size_t> chunkBytes{ 0 };
+};
+
+
+/**
+ * The pools are never destroyed: items owned by static objects may be freed after the end
+ * of main(), and the chunks go back to the system with the process anyway.
+ */
+static POOLS& pools()
+{
+    static POOLS* s_pools = new POOLS;
+    return *s_pools;
+}
+
+
+void* ITEM_POOL::Allocate( size_t aSize )
+{
+    if( aSize == 0 || aSize > MAX_BLOCK_SIZE )
+        return ::operator new( aSize );
+
+    POOLS&      all = pools();
+    size_t      classIdx = ( aSize - 1 ) / GRANULARITY;
+    size_t      blockSize = ( classIdx + 1 ) * GRANULARITY;
+    SIZE_CLASS& sizeClass = all.classes[classIdx];
+    void*       block;
+
+    {
+        std::lock_guard<std::mutex> lock( sizeClass.lock );
+
+        if( sizeClass.freeList )
+        {
+            block = sizeClass.freeList;
+            sizeClass.freeList = sizeClass.freeList->next;
+        }
+        else
+        {
+            if( (size_t) ( sizeClass.chunkEnd - sizeClass.chunkCursor ) < blockSize )
+            {
+                // The tail of the previous chunk, if any, is too short for a block and is lost
+                sizeClass.chunkCursor = static_cast<char*>( ::operator new( CHUNK_SIZE ) );
+                sizeClass.chunkEnd = sizeClass.chunkCursor + CHUNK_SIZE;
+                all.chunkBytes += CHUNK_SIZE;
+            }
+
+            block = sizeClass.chunkCursor;
+            sizeClass.chunkCursor += blockSize;
+        }
+    }
+
+    all.allocations++;
+    all.bytesInUse += blockSize;
+
+    return block;
+}
+
+
+void ITEM_POOL::Free( void* aBlock, size_t aSize )
+{
+    if( !aBlock )
+        return;
+
+    if( aSize == 0 || aSize > MAX_BLOCK_SIZE )
+    {
+        ::operator delete( aBlock );
+        return;
+    }
+
+    POOLS&      all = pools();
+    size_t      classIdx = ( aSize - 1 ) / GRANULARITY;
+    SIZE_CLASS& sizeClass = all.classes[classIdx];
+    FREE_BLOCK* freed = static_cast<FREE_BLOCK*>( aBlock );
+
+    {
+        std::lock_guard<std::mutex> lock( sizeClass.lock );
+
+        freed->next = sizeClass.freeList;
+        sizeClass.freeList = freed;
+    }
+
+    all.frees++;
+    all.bytesInUse -= ( classIdx + 1 ) * GRANULARITY;
+}
+
+
+ITEM_POOL::STATS ITEM_POOL::GetStats()
+{
+    POOLS& all = pools();
+
+    return { all.allocations, all.frees, all.bytesInUse, all.chunkBytes };
+}
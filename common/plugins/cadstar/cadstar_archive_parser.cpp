@@ -2302,12 +2302,15 @@ void CADSTAR_ARCHIVE_PARSER::InsertAttributeAtEnd( XNODE* aNode, wxString aValue
 }
 
 
-XNODE* CADSTAR_ARCHIVE_PARSER::LoadArchiveFile(
-        const wxString& aFileName, const wxString& aFileTypeIdentifier )
+XNODE* CADSTAR_ARCHIVE_PARSER::LoadArchiveFile( const wxString& aFileName,
+                                                const wxString& aFileTypeIdentifier,
+                                                const std::set<wxString>& aStreamedSections,
+                                                const NODE_HANDLER& aHandler )
 {
     KEYWORD   emptyKeywords[1] = {};
     XNODE *   iNode = NULL, *cNode = NULL;
     int       tok;
+    int       depth = 0;        // number of open nodes, the file's root node being the first
     bool      cadstarFileCheckDone = false;
     wxString  str;
     wxCSConv  win1252( wxT( "windows-1252" ) );
@@ -2318,7 +2321,7 @@ XNODE* CADSTAR_ARCHIVE_PARSER::LoadArchiveFile(
     if( !fp )
         THROW_IO_ERROR( wxString::Format( _( "Cannot open file '%s'" ), aFileName ) );
 
-    DSNLEXER lexer( emptyKeywords, 0, fp, aFileName );
+    DSNLEXER lexer( emptyKeywords, 0, nullptr, fp, aFileName );
 
     while( ( tok = lexer.NextTok() ) != DSN_EOF )
     {
@@ -2334,6 +2337,20 @@ XNODE* CADSTAR_ARCHIVE_PARSER::LoadArchiveFile(
                 //too many closing brackets
                 THROW_IO_ERROR( _( "The selected file is not valid or might be corrupt!" ) );
             }
+
+            // Hand over top level sections, and the children of streamed sections, as soon as
+            // they are complete
+            bool isSection = depth == 2;
+            bool isStreamed = depth == 3 && aStreamedSections.count( iNode->GetName() );
+
+            if( aHandler && ( isSection || isStreamed ) && aHandler( cNode ) )
+            {
+                iNode->RemoveChild( cNode );
+                delete cNode;
+                cNode = NULL;
+            }
+
+            --depth;
         }
         else if( tok == DSN_LEFT )
         {
@@ -2343,8 +2360,11 @@ XNODE* CADSTAR_ARCHIVE_PARSER::LoadArchiveFile(
 
             if( iNode )
             {
-                //we will add it as attribute as well as child node
-                InsertAttributeAtEnd( iNode, str );
+                //we will add it as attribute as well as child node, except in streamed
+                //sections where it would only pile up
+                if( depth != 2 || !aStreamedSections.count( iNode->GetName() ) )
+                    InsertAttributeAtEnd( iNode, str );
+
                 iNode->AddChild( cNode );
             }
             else if( !cadstarFileCheckDone )
@@ -2356,6 +2376,7 @@ XNODE* CADSTAR_ARCHIVE_PARSER::LoadArchiveFile(
             }
 
             iNode = cNode;
+            ++depth;
         }
         else if( iNode )
         {
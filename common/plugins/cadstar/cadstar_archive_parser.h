@@ -28,6 +28,7 @@
 
 #include <richio.h>
 #include <wx/gdicmn.h>
+#include <functional>
 #include <map>
 #include <set>
 #include <vector>
@@ -1263,17 +1264,32 @@ public:
 
     static void InsertAttributeAtEnd( XNODE* aNode, wxString aValue );
 
+    /**
+     * Handler for the nodes of an archive file as they are read, see LoadArchiveFile().
+     *
+     * @return true if the node has been dealt with and can be freed.
+     */
+    typedef std::function<bool( XNODE* aNode )> NODE_HANDLER;
+
     /**
      * @brief Reads a CADSTAR Archive file (S-parameter format)
      * @param aFileName
      * @param aFileTypeIdentifier Identifier of the first node in the file to check against.
               E.g. "CADSTARPCB"
+     * @param aStreamedSections Names of top level sections whose children are handed to
+     *        @a aHandler as soon as each is read, rather than being kept in the tree.  These
+     *        sections do not get the names of their children as attributes.
+     * @param aHandler If not null, is called with each top level section once it has been read
+     *        (as well as with the children of streamed sections), and the node is freed if the
+     *        handler returns true.  This keeps only part of a large file in memory at any time.
      * @return XNODE pointing to the top of the tree for further parsing. Each node has the first
      *         element as the node's name and subsequent elements as node attributes ("attr0",
      *         "attr1", "attr2", etc.). Caller is responsible for deleting to avoid memory leaks.
      * @throws IO_ERROR
      */
-    static XNODE* LoadArchiveFile( const wxString& aFileName, const wxString& aFileTypeIdentifier );
+    static XNODE* LoadArchiveFile( const wxString& aFileName, const wxString& aFileTypeIdentifier,
+                                   const std::set<wxString>& aStreamedSections = {},
+                                   const NODE_HANDLER& aHandler = nullptr );
 
     /**
      * @brief
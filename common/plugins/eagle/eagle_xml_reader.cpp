@@ -0,0 +1,625 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <plugins/eagle/eagle_xml_reader.h>
+#include <plugins/eagle/eagle_parser.h>
+
+#include <cstring>
+
+#include <richio.h>
+#include <wx/filefn.h>
+#include <wx/translation.h>
+
+
+static const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+
+static bool isXmlWhitespace( int c )
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+
+EAGLE_XML_READER::EAGLE_XML_READER( const wxString& aFileName ) :
+        m_fp( nullptr ),
+        m_fileName( aFileName ),
+        m_buffer( READ_BUFFER_SIZE ),
+        m_next( nullptr ),
+        m_end( nullptr ),
+        m_line( 1 ),
+        m_streamDepth( 0 )
+{
+    m_fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !m_fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ), aFileName ) );
+}
+
+
+EAGLE_XML_READER::~EAGLE_XML_READER()
+{
+    if( m_fp )
+        fclose( m_fp );
+}
+
+
+bool EAGLE_XML_READER::ReadUntil( const wxString& aStreamedElement )
+{
+    wxASSERT( !m_root );
+
+    wxXmlNode* found = readContent( 0, aStreamedElement );
+
+    if( !found )
+    {
+        readTrailer();
+        return false;
+    }
+
+    // An empty element tag has no children to stream
+    if( !m_open.empty() && m_open.back().node == found )
+        m_streamDepth = m_open.size();
+
+    return true;
+}
+
+
+std::unique_ptr<wxXmlNode> EAGLE_XML_READER::ReadChild()
+{
+    while( m_streamDepth )
+    {
+        wxXmlNode* node = nullptr;
+        bool       isEmpty = false;
+
+        switch( readToken( node, isEmpty ) )
+        {
+        case TOKEN::ELEMENT_START:
+        {
+            std::unique_ptr<wxXmlNode> child( node );
+
+            if( !isEmpty )
+            {
+                m_open.push_back( { node, nullptr } );
+                readContent( m_streamDepth, wxEmptyString );
+            }
+
+            return child;
+        }
+
+        case TOKEN::ELEMENT_END:
+            closeElement();
+            m_streamDepth = 0;
+            break;
+
+        case TOKEN::CONTENT:
+            append( node );
+            break;
+
+        case TOKEN::END_OF_FILE:
+            error( _( "unexpected end of file" ) );
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void EAGLE_XML_READER::ReadToEnd()
+{
+    // Skip whatever is left of the streamed element
+    while( ReadChild() )
+        ;
+
+    if( !m_root || !m_open.empty() )
+    {
+        readContent( 0, wxEmptyString );
+        readTrailer();
+    }
+}
+
+
+wxXmlNode* EAGLE_XML_READER::readContent( size_t aDepth, const wxString& aStopAt )
+{
+    for( ;; )
+    {
+        wxXmlNode* node = nullptr;
+        bool       isEmpty = false;
+
+        switch( readToken( node, isEmpty ) )
+        {
+        case TOKEN::ELEMENT_START:
+            append( node );
+
+            if( !isEmpty )
+                m_open.push_back( { node, nullptr } );
+
+            if( !aStopAt.IsEmpty() && node->GetName() == aStopAt )
+                return node;
+
+            if( m_open.size() == aDepth )
+                return nullptr;
+
+            break;
+
+        case TOKEN::ELEMENT_END:
+            closeElement();
+
+            if( m_open.size() == aDepth )
+                return nullptr;
+
+            break;
+
+        case TOKEN::CONTENT:
+            if( m_open.empty() )
+            {
+                bool isComment = node->GetType() == wxXML_COMMENT_NODE;
+
+                delete node;
+
+                // Comments may come before the root element, but nothing else
+                if( isComment )
+                    break;
+
+                error( _( "content outside of the root element" ) );
+            }
+
+            append( node );
+            break;
+
+        case TOKEN::END_OF_FILE:
+            error( _( "unexpected end of file" ) );
+            return nullptr;
+        }
+    }
+}
+
+
+void EAGLE_XML_READER::readTrailer()
+{
+    for( ;; )
+    {
+        wxXmlNode* node = nullptr;
+        bool       isEmpty = false;
+        TOKEN      token = readToken( node, isEmpty );
+
+        if( token == TOKEN::END_OF_FILE )
+            return;
+
+        bool isComment = node && node->GetType() == wxXML_COMMENT_NODE;
+
+        delete node;
+
+        if( !isComment )
+            error( _( "content after the root element" ) );
+    }
+}
+
+
+void EAGLE_XML_READER::append( wxXmlNode* aNode )
+{
+    if( m_open.empty() )
+    {
+        if( m_root )
+        {
+            delete aNode;
+            error( _( "more than one root element" ) );
+        }
+
+        m_root.reset( aNode );
+        return;
+    }
+
+    OPEN_ELEMENT& parent = m_open.back();
+
+    if( parent.lastChild )
+    {
+        parent.lastChild->SetNext( aNode );
+        aNode->SetParent( parent.node );
+    }
+    else
+    {
+        parent.node->AddChild( aNode );
+    }
+
+    parent.lastChild = aNode;
+}
+
+
+void EAGLE_XML_READER::closeElement()
+{
+    if( m_open.empty() )
+        error( _( "unexpected end tag" ) );
+
+    wxString name = wxString::FromUTF8( m_name.c_str() );
+
+    if( name != m_open.back().node->GetName() )
+    {
+        error( wxString::Format( _( "end tag '%s' does not match start tag '%s'" ),
+                                 name, m_open.back().node->GetName() ) );
+    }
+
+    m_open.pop_back();
+}
+
+
+EAGLE_XML_READER::TOKEN EAGLE_XML_READER::readToken( wxXmlNode*& aNode, bool& aIsEmpty )
+{
+    for( ;; )
+    {
+        int c = peek();
+
+        if( c == EOF )
+            return TOKEN::END_OF_FILE;
+
+        if( c != '<' )
+        {
+            int line = m_line;
+
+            m_text.clear();
+            readText( '<', false, m_text );
+
+            // Like wxXmlDocument, drop text made of whitespace only
+            bool whitespaceOnly = true;
+
+            for( char ch : m_text )
+            {
+                if( !isXmlWhitespace( ch ) )
+                {
+                    whitespaceOnly = false;
+                    break;
+                }
+            }
+
+            if( whitespaceOnly )
+                continue;
+
+            aNode = new wxXmlNode( wxXML_TEXT_NODE, wxT( "text" ),
+                                   wxString::FromUTF8( m_text.c_str() ), line );
+            return TOKEN::CONTENT;
+        }
+
+        get();      // '<'
+        c = peek();
+
+        if( c == '?' )
+        {
+            // Processing instruction, including the XML declaration
+            readUntil( "?>", nullptr );
+            continue;
+        }
+
+        if( c == '!' )
+        {
+            get();
+
+            if( peek() == '-' )
+            {
+                expect( '-' );
+                expect( '-' );
+
+                int line = m_line;
+
+                m_text.clear();
+                readUntil( "-->", &m_text );
+
+                aNode = new wxXmlNode( wxXML_COMMENT_NODE, wxT( "comment" ),
+                                       wxString::FromUTF8( m_text.c_str() ), line );
+                return TOKEN::CONTENT;
+            }
+
+            if( peek() == '[' )
+            {
+                for( const char* p = "[CDATA["; *p; ++p )
+                    expect( *p );
+
+                int line = m_line;
+
+                m_text.clear();
+                readUntil( "]]>", &m_text );
+
+                aNode = new wxXmlNode( wxXML_CDATA_SECTION_NODE, wxT( "cdata" ),
+                                       wxString::FromUTF8( m_text.c_str() ), line );
+                return TOKEN::CONTENT;
+            }
+
+            // The DOCTYPE, including any internal subset
+            int depth = 0;
+            int quote = 0;
+
+            while( ( c = get() ) != EOF )
+            {
+                if( quote )
+                {
+                    if( c == quote )
+                        quote = 0;
+                }
+                else if( c == '"' || c == '\'' )
+                {
+                    quote = c;
+                }
+                else if( c == '[' )
+                {
+                    depth++;
+                }
+                else if( c == ']' )
+                {
+                    depth--;
+                }
+                else if( c == '>' && depth <= 0 )
+                {
+                    break;
+                }
+            }
+
+            if( c == EOF )
+                error( _( "unexpected end of file" ) );
+
+            continue;
+        }
+
+        if( c == '/' )
+        {
+            get();
+            readName( m_name );
+            skipWhitespace();
+            expect( '>' );
+            return TOKEN::ELEMENT_END;
+        }
+
+        int line = m_line;
+
+        readName( m_name );
+
+        std::unique_ptr<wxXmlNode> node( new wxXmlNode( wxXML_ELEMENT_NODE,
+                                                        wxString::FromUTF8( m_name.c_str() ),
+                                                        wxEmptyString, line ) );
+
+        for( ;; )
+        {
+            skipWhitespace();
+            c = peek();
+
+            if( c == '/' )
+            {
+                get();
+                expect( '>' );
+                aIsEmpty = true;
+                break;
+            }
+            else if( c == '>' )
+            {
+                get();
+                aIsEmpty = false;
+                break;
+            }
+
+            readName( m_name );
+            skipWhitespace();
+            expect( '=' );
+            skipWhitespace();
+
+            int quote = get();
+
+            if( quote != '"' && quote != '\'' )
+                error( _( "attribute value is not quoted" ) );
+
+            m_text.clear();
+            readText( quote, true, m_text );
+            get();
+
+            node->AddAttribute( wxString::FromUTF8( m_name.c_str() ),
+                                wxString::FromUTF8( m_text.c_str() ) );
+        }
+
+        aNode = node.release();
+        return TOKEN::ELEMENT_START;
+    }
+}
+
+
+bool EAGLE_XML_READER::fill()
+{
+    size_t count = fread( m_buffer.data(), 1, m_buffer.size(), m_fp );
+
+    m_next = m_buffer.data();
+    m_end = m_next + count;
+
+    return count > 0;
+}
+
+
+void EAGLE_XML_READER::readUntil( const char* aTerminator, std::string* aResult )
+{
+    size_t      length = strlen( aTerminator );
+    std::string tail;       // the last characters read, to match against aTerminator
+    int         c;
+
+    while( ( c = get() ) != EOF )
+    {
+        tail.push_back( (char) c );
+
+        if( tail.size() > length )
+        {
+            if( aResult )
+                aResult->push_back( tail.front() );
+
+            tail.erase( 0, 1 );
+        }
+
+        if( tail == aTerminator )
+            return;
+    }
+
+    error( _( "unexpected end of file" ) );
+}
+
+
+void EAGLE_XML_READER::skipWhitespace()
+{
+    while( isXmlWhitespace( peek() ) )
+        get();
+}
+
+
+void EAGLE_XML_READER::expect( char aChar )
+{
+    int c = get();
+
+    if( c != (unsigned char) aChar )
+    {
+        if( c == EOF )
+            error( _( "unexpected end of file" ) );
+        else
+            error( wxString::Format( _( "expected '%c'" ), aChar ) );
+    }
+}
+
+
+void EAGLE_XML_READER::readName( std::string& aName )
+{
+    aName.clear();
+
+    for( int c = peek(); c != EOF; c = peek() )
+    {
+        if( isXmlWhitespace( c ) || c == '/' || c == '>' || c == '=' || c == '<' )
+            break;
+
+        aName.push_back( (char) get() );
+    }
+
+    if( aName.empty() )
+        error( _( "expected a name" ) );
+}
+
+
+void EAGLE_XML_READER::readText( int aTerminator, bool aIsAttribute, std::string& aText )
+{
+    for( int c = peek(); c != aTerminator; c = peek() )
+    {
+        if( c == EOF )
+        {
+            if( aIsAttribute )
+                error( _( "unexpected end of file" ) );
+
+            return;
+        }
+
+        get();
+
+        if( c == '&' )
+        {
+            appendReference( aText );
+        }
+        else if( c == '\r' )
+        {
+            // Line ends are normalised to '\n', and to a space in attribute values
+            if( peek() == '\n' )
+                get();
+
+            aText.push_back( aIsAttribute ? ' ' : '\n' );
+        }
+        else if( aIsAttribute && ( c == '\n' || c == '\t' ) )
+        {
+            aText.push_back( ' ' );
+        }
+        else if( aIsAttribute && c == '<' )
+        {
+            error( _( "'<' in attribute value" ) );
+        }
+        else
+        {
+            aText.push_back( (char) c );
+        }
+    }
+}
+
+
+void EAGLE_XML_READER::appendReference( std::string& aText )
+{
+    std::string ref;
+    int         c;
+
+    while( ( c = get() ) != ';' )
+    {
+        if( c == EOF || ref.size() > 8 )
+            error( _( "bad character reference" ) );
+
+        ref.push_back( (char) c );
+    }
+
+    if( ref == "lt" )
+        aText.push_back( '<' );
+    else if( ref == "gt" )
+        aText.push_back( '>' );
+    else if( ref == "amp" )
+        aText.push_back( '&' );
+    else if( ref == "quot" )
+        aText.push_back( '"' );
+    else if( ref == "apos" )
+        aText.push_back( '\'' );
+    else if( ref.size() > 1 && ref[0] == '#' )
+    {
+        bool          hex = ref[1] == 'x';
+        const char*   digits = ref.c_str() + ( hex ? 2 : 1 );
+        char*         end = nullptr;
+        unsigned long cp = strtoul( digits, &end, hex ? 16 : 10 );
+
+        if( *digits == 0 || *end != 0 || cp == 0 || cp > 0x10FFFF )
+            error( _( "bad character reference" ) );
+
+        // Encode the code point as UTF-8
+        if( cp < 0x80 )
+        {
+            aText.push_back( (char) cp );
+        }
+        else if( cp < 0x800 )
+        {
+            aText.push_back( (char) ( 0xC0 | ( cp >> 6 ) ) );
+            aText.push_back( (char) ( 0x80 | ( cp & 0x3F ) ) );
+        }
+        else if( cp < 0x10000 )
+        {
+            aText.push_back( (char) ( 0xE0 | ( cp >> 12 ) ) );
+            aText.push_back( (char) ( 0x80 | ( ( cp >> 6 ) & 0x3F ) ) );
+            aText.push_back( (char) ( 0x80 | ( cp & 0x3F ) ) );
+        }
+        else
+        {
+            aText.push_back( (char) ( 0xF0 | ( cp >> 18 ) ) );
+            aText.push_back( (char) ( 0x80 | ( ( cp >> 12 ) & 0x3F ) ) );
+            aText.push_back( (char) ( 0x80 | ( ( cp >> 6 ) & 0x3F ) ) );
+            aText.push_back( (char) ( 0x80 | ( cp & 0x3F ) ) );
+        }
+    }
+    else
+    {
+        error( wxString::Format( _( "unknown entity '&%s;'" ), ref ) );
+    }
+}
+
+
+void EAGLE_XML_READER::error( const wxString& aMessage ) const
+{
+    throw XML_PARSER_ERROR( wxString::Format( _( "%s in '%s' at line %d" ), aMessage, m_fileName,
+                                              m_line ) );
+}
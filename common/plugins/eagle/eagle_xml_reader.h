@@ -0,0 +1,189 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef EAGLE_XML_READER_H_
+#define EAGLE_XML_READER_H_
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/xml/xml.h>
+#include <wx/string.h>
+
+
+/**
+ * A pull reader for Eagle XML files.
+ *
+ * wxXmlDocument has to hold the whole document in memory before any of it can be used, which
+ * for a big board is several times the size of the file.  This reader builds the same
+ * wxXmlNode trees as wxXmlDocument, but can stop at a given element and hand out its children
+ * one at a time, so that the bulk of a board (its signals) never needs to be in memory at once.
+ *
+ * Only what Eagle writes is supported: UTF-8 content, the predefined and numeric character
+ * references, CDATA sections and comments.  Processing instructions, the DOCTYPE and comments
+ * outside of the root element are skipped.
+ */
+class EAGLE_XML_READER
+{
+public:
+    /**
+     * @param aFileName is the file to read.
+     * @throw IO_ERROR if the file cannot be opened.
+     */
+    EAGLE_XML_READER( const wxString& aFileName );
+
+    ~EAGLE_XML_READER();
+
+    /**
+     * Read the document into a tree up to and including the start tag of the first element
+     * named @a aStreamedElement, or up to the end of the document if there is no such element.
+     *
+     * @return true if the element was found.  Its children must then be read with ReadChild().
+     * @throw XML_PARSER_ERROR if the document is malformed.
+     */
+    bool ReadUntil( const wxString& aStreamedElement );
+
+    /**
+     * Read the next child element of the element found by ReadUntil().
+     *
+     * Text found between the children is kept in the tree.
+     *
+     * @return the child and all of its content, detached from the tree, or nullptr once the end
+     *         tag of the streamed element has been read.
+     * @throw XML_PARSER_ERROR if the document is malformed.
+     */
+    std::unique_ptr<wxXmlNode> ReadChild();
+
+    /**
+     * Read the rest of the document into the tree, skipping any children of the streamed
+     * element that were not read.
+     *
+     * @throw XML_PARSER_ERROR if the document is malformed.
+     */
+    void ReadToEnd();
+
+    /**
+     * @return the root of the tree read so far, owned by the reader.
+     */
+    wxXmlNode* GetRoot() const { return m_root.get(); }
+
+private:
+    enum class TOKEN
+    {
+        ELEMENT_START,      ///< a start tag, or an empty element tag
+        ELEMENT_END,        ///< an end tag
+        CONTENT,            ///< text, a CDATA section or a comment
+        END_OF_FILE
+    };
+
+    /// An element that has been started and not yet ended.
+    struct OPEN_ELEMENT
+    {
+        wxXmlNode* node;
+        wxXmlNode* lastChild;       ///< to append children without walking the sibling list
+    };
+
+    /**
+     * Read the next start tag, end tag or content.
+     *
+     * @param aNode receives a new node for a start tag or content.  For an end tag it receives
+     *              nothing and the tag name is left in m_name.
+     * @param aIsEmpty is set when a start tag is also its own end tag.
+     */
+    TOKEN readToken( wxXmlNode*& aNode, bool& aIsEmpty );
+
+    /**
+     * Read content into the open elements until only @a aDepth of them are left open.
+     *
+     * @param aStopAt if not empty, stop as well after the start tag of an element of this name.
+     * @return the element named @a aStopAt if stopped there, else nullptr.
+     */
+    wxXmlNode* readContent( size_t aDepth, const wxString& aStopAt );
+
+    /// Read what follows the root element, which may only be comments and the like.
+    void readTrailer();
+
+    /// Append @a aNode to the innermost open element, or make it the root.
+    void append( wxXmlNode* aNode );
+
+    void closeElement();
+
+    int peek()
+    {
+        if( m_next == m_end && !fill() )
+            return EOF;
+
+        return (unsigned char) *m_next;
+    }
+
+    int get()
+    {
+        int c = peek();
+
+        if( c != EOF )
+        {
+            ++m_next;
+
+            if( c == '\n' )
+                ++m_line;
+        }
+
+        return c;
+    }
+
+    bool fill();
+
+    /// Read up to and including @a aTerminator, appending what was read (less the
+    /// terminator) to @a aResult if not null.
+    void readUntil( const char* aTerminator, std::string* aResult );
+
+    void skipWhitespace();
+
+    void expect( char aChar );
+
+    void readName( std::string& aName );
+
+    /// Read text up to @a aTerminator (not consumed), resolving character references.
+    void readText( int aTerminator, bool aIsAttribute, std::string& aText );
+
+    void appendReference( std::string& aText );
+
+    void error( const wxString& aMessage ) const;
+
+    FILE*                      m_fp;
+    wxString                   m_fileName;
+    std::vector<char>          m_buffer;
+    const char*                m_next;
+    const char*                m_end;
+    int                        m_line;
+
+    std::unique_ptr<wxXmlNode> m_root;
+    std::vector<OPEN_ELEMENT>  m_open;
+    size_t                     m_streamDepth;  ///< open depth of the streamed element, or 0
+    std::string                m_name;         ///< scratch for names
+    std::string                m_text;         ///< scratch for text and attribute values
+};
+
+#endif // EAGLE_XML_READER_H_
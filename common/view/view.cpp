@@ -448,6 +448,29 @@ int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) con
 }
 
 
+void VIEW::QueryAllLayers( const BOX2I& aRect, std::unordered_set<VIEW_ITEM*>& aResult ) const
+{
+    auto visitor =
+            [&]( VIEW_ITEM* aItem ) -> bool
+            {
+                aResult.insert( aItem );
+                return true;
+            };
+
+    for( const VIEW_LAYER& layer : m_layers )
+        layer.items->Query( aRect, visitor );
+}
+
+
+bool VIEW::IsBBoxCurrent( const VIEW_ITEM* aItem ) const
+{
+    const VIEW_ITEM_DATA* viewData = aItem->viewPrivData();
+
+    return viewData && viewData->m_view == this
+            && !( viewData->m_requiredUpdate & ( GEOMETRY | LAYERS ) );
+}
+
+
 VECTOR2D VIEW::ToWorld( const VECTOR2D& aCoord, bool aAbsolute ) const
 {
     const MATRIX3x3D& matrix = m_gal->GetScreenWorldMatrix();
@@ -1100,7 +1123,8 @@ void VIEW::Clear()
 
     m_nextDrawPriority = 0;
 
-    m_gal->ClearCache();
+    if( m_gal )
+        m_gal->ClearCache();
 }
 
 
@@ -32,9 +32,12 @@
 
 #include <wx/regex.h>
 #include <algorithm>
-#include <vector>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include <hash_eda.h>
 #include <refdes_utils.h>
 #include <erc_settings.h>
 #include <sch_symbol.h>
@@ -261,54 +264,193 @@ std::vector<SYMBOL_INSTANCE_REFERENCE> SCH_REFERENCE_LIST::GetSymbolInstances()
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+// A helper function to build a full reference string of a SCH_REFERENCE item
+wxString buildFullReference( const SCH_REFERENCE& aItem, int aUnitNumber = -1 )
+{
+    wxString fullref;
+    fullref = aItem.GetRef() + aItem.GetRefNumber();
+
+    if( aUnitNumber < 0 )
+        fullref << ".." << aItem.GetUnit();
+    else
+        fullref << ".." << aUnitNumber;
+
+    return fullref;
+}
+
+
+static size_t hashPath( const KIID_PATH& aPath )
 {
-    int expectedId = aFirstValue;
+    size_t hash = hash_val( aPath.size() );
+
+    for( const KIID& id : aPath )
+        hash_combine( hash, id.Hash() );
+
+    return hash;
+}
 
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
 
-    for( ; ii < aIdList.size(); ii++ )
+/**
+ * A symbol instance, i.e. what SCH_REFERENCE::IsSameInstance() compares.
+ */
+struct INSTANCE_KEY
+{
+    const SCH_SYMBOL* m_Symbol;
+    KIID_PATH         m_SheetPath;
+
+    bool operator==( const INSTANCE_KEY& aOther ) const
     {
-        if( expectedId <= aIdList[ii] )
-            break;
+        return m_Symbol == aOther.m_Symbol && m_SheetPath == aOther.m_SheetPath;
     }
+};
 
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
+
+struct INSTANCE_KEY_HASH
+{
+    size_t operator()( const INSTANCE_KEY& aKey ) const
     {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
+        size_t hash = hashPath( aKey.m_SheetPath );
+        hash_combine( hash, aKey.m_Symbol );
+        return hash;
+    }
+};
 
-        expectedId++;
+
+/**
+ * An annotated unit: reference prefix, reference number and unit number.
+ */
+struct UNIT_KEY
+{
+    std::string m_Ref;
+    int         m_NumRef;
+    int         m_Unit;
+
+    bool operator==( const UNIT_KEY& aOther ) const
+    {
+        return m_NumRef == aOther.m_NumRef && m_Unit == aOther.m_Unit && m_Ref == aOther.m_Ref;
     }
+};
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
-    return expectedId;
-}
 
+struct UNIT_KEY_HASH
+{
+    size_t operator()( const UNIT_KEY& aKey ) const
+    {
+        return hash_val( aKey.m_Ref, aKey.m_NumRef, aKey.m_Unit );
+    }
+};
 
-// A helper function to build a full reference string of a SCH_REFERENCE item
-wxString buildFullReference( const SCH_REFERENCE& aItem, int aUnitNumber = -1 )
+
+/**
+ * What a reference not yet annotated must share with a multi-unit symbol to be annotated as
+ * one of its other units.  The sheet path is only set when annotating by sheet.
+ */
+struct UNIT_CANDIDATE_KEY
 {
-    wxString fullref;
-    fullref = aItem.GetRef() + aItem.GetRefNumber();
+    std::string m_Ref;
+    wxString    m_Value;
+    std::string m_LibName;
+    KIID_PATH   m_SheetPath;
+    int         m_Unit;
 
-    if( aUnitNumber < 0 )
-        fullref << ".." << aItem.GetUnit();
-    else
-        fullref << ".." << aUnitNumber;
+    bool operator==( const UNIT_CANDIDATE_KEY& aOther ) const
+    {
+        return m_Unit == aOther.m_Unit && m_Ref == aOther.m_Ref && m_Value == aOther.m_Value
+                && m_LibName == aOther.m_LibName && m_SheetPath == aOther.m_SheetPath;
+    }
+};
+
+
+struct UNIT_CANDIDATE_KEY_HASH
+{
+    size_t operator()( const UNIT_CANDIDATE_KEY& aKey ) const
+    {
+        size_t hash = hashPath( aKey.m_SheetPath );
+        hash_combine( hash, aKey.m_Ref, aKey.m_Value, aKey.m_LibName, aKey.m_Unit );
+        return hash;
+    }
+};
+
+
+/**
+ * The indices in the reference list of the candidates for one UNIT_CANDIDATE_KEY, in increasing
+ * order.  As references are only ever annotated, the candidates before m_Next are known to be
+ * already used.
+ */
+struct UNIT_CANDIDATES
+{
+    std::vector<unsigned> m_Refs;
+    size_t                m_Next = 0;
+};
+
+
+/**
+ * The reference numbers in use for one reference prefix, to allocate the free ones.
+ *
+ * Like the list GetRefsInUse() fills, the numbers in use are a snapshot taken when the allocation
+ * restarts: the numbers given to, or taken from, references in the meantime are pending until
+ * the next restart.  Only the numbers allocated since the restart are taken into account.
+ */
+class REF_ID_ALLOCATOR
+{
+public:
+    REF_ID_ALLOCATOR() :
+            m_next( 0 )
+    {
+        m_cursor = m_inUse.end();
+    }
+
+    /**
+     * Record that \a aCount more references (or less, if negative) use \a aNumRef.
+     */
+    void Change( int aNumRef, int aCount )
+    {
+        m_pending.emplace_back( aNumRef, aCount );
+    }
+
+    /**
+     * Apply the pending changes and restart allocating from \a aFirstValue.
+     */
+    void Restart( int aFirstValue )
+    {
+        for( const std::pair<int, int>& change : m_pending )
+        {
+            std::map<int, int>::iterator it = m_inUse.emplace( change.first, 0 ).first;
+
+            it->second += change.second;
+
+            if( it->second == 0 )
+                m_inUse.erase( it );
+        }
+
+        m_pending.clear();
+
+        m_cursor = m_inUse.lower_bound( aFirstValue );
+        m_next = aFirstValue;
+    }
+
+    /**
+     * @return the first number from the restart value not in use nor already allocated.
+     */
+    int CreateFirstFreeRefId()
+    {
+        // The numbers below m_next are all either in use or allocated
+        for( ; m_cursor != m_inUse.end() && m_cursor->first <= m_next; ++m_cursor )
+        {
+            if( m_cursor->first == m_next )
+                m_next++;
+        }
+
+        return m_next++;
+    }
+
+private:
+    std::map<int, int>               m_inUse;     ///< Reference count by reference number
+    std::vector<std::pair<int, int>> m_pending;
+    std::map<int, int>::iterator     m_cursor;    ///< First number in use not below m_next
+    int                              m_next;      ///< Next candidate free number
+};
 
-    return fullref;
-}
 
 void SCH_REFERENCE_LIST::ReannotateDuplicates( const SCH_REFERENCE_LIST& aAdditionalReferences )
 {
@@ -370,6 +512,76 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         AddItem( additionalRef ); //add to this container
     }
 
+    // Rescanning the list for each symbol is quadratic, and annotating large hierarchies
+    // would be slow: index the list once, and keep the indices up to date instead.
+
+    // The annotated units, to find the units already annotated of a multi-unit symbol.
+    std::unordered_map<UNIT_KEY, int, UNIT_KEY_HASH> annotatedUnits;
+
+    // The reference numbers in use, by reference prefix.
+    std::unordered_map<std::string, REF_ID_ALLOCATOR> refIdAllocators;
+
+    // The references not yet annotated, to annotate them as the other units of a symbol.
+    std::unordered_map<UNIT_CANDIDATE_KEY, UNIT_CANDIDATES, UNIT_CANDIDATE_KEY_HASH> unitCandidates;
+
+    // The references of each symbol instance, in the list order.
+    std::unordered_map<INSTANCE_KEY, std::vector<unsigned>, INSTANCE_KEY_HASH> instanceRefs;
+
+    // The first list of aLockedUnitMap holding each symbol instance.
+    std::unordered_map<INSTANCE_KEY, SCH_REFERENCE_LIST*, INSTANCE_KEY_HASH> lockedLists;
+
+    auto instanceKey =
+            []( const SCH_REFERENCE& aRef ) -> INSTANCE_KEY
+            {
+                return { aRef.GetSymbol(), aRef.GetSheetPath().Path() };
+            };
+
+    auto unitCandidateKey =
+            [&]( const SCH_REFERENCE& aRef, int aUnit ) -> UNIT_CANDIDATE_KEY
+            {
+                const std::string& ref = aRef.m_ref;
+                const std::string& libName = aRef.m_rootSymbol->GetLibId().GetLibItemName();
+
+                return { ref, aRef.m_value, libName,
+                         aUseSheetNum ? aRef.GetSheetPath().Path() : KIID_PATH(), aUnit };
+            };
+
+    // Take into account that aCount more references (or less, if negative) are annotated as
+    // aRef currently is
+    auto addAnnotated =
+            [&]( const SCH_REFERENCE& aRef, int aCount )
+            {
+                const std::string& ref = aRef.m_ref;
+                UNIT_KEY           unitKey = { ref, aRef.m_numRef, aRef.m_unit };
+                int&               count = annotatedUnits[unitKey];
+
+                count += aCount;
+
+                if( count == 0 )
+                    annotatedUnits.erase( unitKey );
+
+                refIdAllocators[ref].Change( aRef.m_numRef, aCount );
+            };
+
+    for( unsigned ii = 0; ii < flatList.size(); ii++ )
+    {
+        const SCH_REFERENCE& ref = flatList[ii];
+
+        if( !ref.m_isNew )
+            addAnnotated( ref, 1 );
+        else
+            unitCandidates[ unitCandidateKey( ref, ref.m_unit ) ].m_Refs.push_back( ii );
+
+        if( !aLockedUnitMap.empty() )
+            instanceRefs[ instanceKey( ref ) ].push_back( ii );
+    }
+
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+            lockedLists.emplace( instanceKey( pair.second[thisRefI] ), &pair.second );
+    }
+
     int LastReferenceNumber = 0;
     int NumberOfUnits, Unit;
 
@@ -389,10 +601,12 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     else
         minRefId = aStartNumber + 1;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    // This is the allocator of the Ids for the current reference prefix.
+    // Will be restarted for each new reference prefix.
+    const std::string& firstRef = flatList[first].m_ref;
+    REF_ID_ALLOCATOR*  idAllocator = &refIdAllocators[firstRef];
+
+    idAllocator->Restart( minRefId );
 
     for( unsigned ii = 0; ii < flatList.size(); ii++ )
     {
@@ -403,21 +617,13 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this symbol is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
 
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
-            {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
+        if( !lockedLists.empty() )
+        {
+            auto locked = lockedLists.find( instanceKey( ref_unit ) );
 
-                if( thisRef.IsSameInstance( ref_unit ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
-            }
-            if( lockedList != NULL ) break;
+            if( locked != lockedLists.end() )
+                lockedList = locked->second;
         }
 
         if(  ( flatList[first].CompareRef( ref_unit ) != 0 )
@@ -432,14 +638,17 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             else
                 minRefId = aStartNumber + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            const std::string& ref = ref_unit.m_ref;
+
+            idAllocator = &refIdAllocators[ref];
+            idAllocator->Restart( minRefId );
         }
 
         // Find references greater than current reference (unless not annotated)
         if( aStartAtCurrent && ref_unit.m_numRef > 0 )
         {
             minRefId = ref_unit.m_numRef;
-            GetRefsInUse( first, idList, minRefId );
+            idAllocator->Restart( minRefId );
         }
 
         // Annotation of one part per package symbols (trivial case).
@@ -447,8 +656,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         {
             if( ref_unit.m_isNew )
             {
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = idAllocator->CreateFirstFreeRefId();
                 ref_unit.m_numRef = LastReferenceNumber;
+                addAnnotated( ref_unit, 1 );
             }
 
             ref_unit.m_flag  = 1;
@@ -461,7 +671,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         if( ref_unit.m_isNew )
         {
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = idAllocator->CreateFirstFreeRefId();
             ref_unit.m_numRef = LastReferenceNumber;
 
             ref_unit.m_flag = 1;
@@ -479,8 +689,15 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
                 if( thisRef.IsSameInstance( ref_unit ) )
                 {
+                    if( !ref_unit.m_isNew )
+                        addAnnotated( ref_unit, -1 );
+
                     // This is the symbol we're currently annotating. Hold the unit!
                     ref_unit.m_unit = thisRef.m_unit;
+
+                    if( !ref_unit.m_isNew )
+                        addAnnotated( ref_unit, 1 );
+
                     // lock this new full reference
                     inUseRefs.insert( buildFullReference( ref_unit ) );
                 }
@@ -492,25 +709,35 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     continue;
 
                 // Find the matching symbol
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                auto instance = instanceRefs.find( instanceKey( thisRef ) );
+
+                if( instance == instanceRefs.end() )
+                    continue;
+
+                auto jj = std::upper_bound( instance->second.begin(), instance->second.end(), ii );
+
+                if( jj == instance->second.end() )
+                    continue;
+
+                wxString ref_candidate = buildFullReference( ref_unit, thisRef.m_unit );
+
+                // propagate the new reference and unit selection to the "old" symbol,
+                // if this new full reference is not already used (can happens when initial
+                // multiunits symbols have duplicate references)
+                if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
                 {
-                    if( ! thisRef.IsSameInstance( flatList[jj] ) )
-                        continue;
+                    SCH_REFERENCE& matching = flatList[*jj];
+
+                    if( !matching.m_isNew )
+                        addAnnotated( matching, -1 );
 
-                    wxString ref_candidate = buildFullReference( ref_unit, thisRef.m_unit );
-
-                    // propagate the new reference and unit selection to the "old" symbol,
-                    // if this new full reference is not already used (can happens when initial
-                    // multiunits symbols have duplicate references)
-                    if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
-                    {
-                        flatList[jj].m_numRef = ref_unit.m_numRef;
-                        flatList[jj].m_isNew = false;
-                        flatList[jj].m_flag = 1;
-                        // lock this new full reference
-                        inUseRefs.insert( ref_candidate );
-                        break;
-                    }
+                    matching.m_numRef = ref_unit.m_numRef;
+                    matching.m_isNew = false;
+                    matching.m_flag = 1;
+                    addAnnotated( matching, 1 );
+
+                    // lock this new full reference
+                    inUseRefs.insert( ref_candidate );
                 }
             }
         }
@@ -520,48 +747,41 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             * we search for others parts that have the same value and the same
             * reference prefix (ref without ref number)
             */
+            const std::string& ref = ref_unit.m_ref;
+            UNIT_CANDIDATE_KEY candidateKey = unitCandidateKey( ref_unit, 0 );
+
             for( Unit = 1; Unit <= NumberOfUnits; Unit++ )
             {
                 if( ref_unit.m_unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
-
-                if( found >= 0 )
+                if( annotatedUnits.count( { ref, ref_unit.m_numRef, Unit } ) )
                     continue; // this unit exists for this reference (unit already annotated)
 
                 // Search a symbol to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
-                {
-                    auto& cmp_unit = flatList[jj];
+                candidateKey.m_Unit = Unit;
 
-                    if( cmp_unit.m_flag )    // already tested
-                        continue;
+                auto candidates = unitCandidates.find( candidateKey );
 
-                    if( cmp_unit.CompareRef( ref_unit ) != 0 )
-                        continue;
+                if( candidates == unitCandidates.end() )
+                    continue;
 
-                    if( cmp_unit.CompareValue( ref_unit ) != 0 )
-                        continue;
+                UNIT_CANDIDATES& unitRefs = candidates->second;
 
-                    if( cmp_unit.CompareLibName( ref_unit ) != 0 )
-                        continue;
-
-                    if( aUseSheetNum &&
-                            cmp_unit.GetSheetPath().Cmp( ref_unit.GetSheetPath() ) != 0 )
-                        continue;
+                for( ; unitRefs.m_Next < unitRefs.m_Refs.size(); unitRefs.m_Next++ )
+                {
+                    unsigned jj = unitRefs.m_Refs[unitRefs.m_Next];
+                    auto&    cmp_unit = flatList[jj];
 
-                    if( !cmp_unit.m_isNew )
+                    if( jj <= ii || cmp_unit.m_flag || !cmp_unit.m_isNew )
                         continue;
 
-                    // Symbol without reference number found, annotate it if possible.
-                    if( cmp_unit.m_unit == Unit )
-                    {
-                        cmp_unit.m_numRef = ref_unit.m_numRef;
-                        cmp_unit.m_flag   = 1;
-                        cmp_unit.m_isNew  = false;
-                        break;
-                    }
+                    // Symbol without reference number found, annotate it.
+                    cmp_unit.m_numRef = ref_unit.m_numRef;
+                    cmp_unit.m_flag   = 1;
+                    cmp_unit.m_isNew  = false;
+                    addAnnotated( cmp_unit, 1 );
+                    break;
                 }
             }
         }
@@ -735,7 +955,7 @@ int SCH_REFERENCE_LIST::CheckAnnotation( ANNOTATION_ERROR_HANDLER aHandler )
 }
 
 
-SCH_REFERENCE::SCH_REFERENCE( SCH_SYMBOL* aSymbol, LIB_SYMBOL* aLibSymbol,
+SCH_REFERENCE::SCH_REFERENCE( SCH_SYMBOL* aSymbol, const LIB_SYMBOL* aLibSymbol,
                               const SCH_SHEET_PATH& aSheetPath )
 {
     wxASSERT( aSymbol != NULL );
@@ -281,20 +281,7 @@ void DIALOG_ERC::OnRunERCClick( wxCommandEvent& event )
 
     sch->GetSheets().AnnotatePowerSymbols();
 
-    int itemsNotAnnotated = m_parent->CheckAnnotate(
-            []( ERCE_T aType, const wxString& aMsg, SCH_REFERENCE* aItemA, SCH_REFERENCE* aItemB )
-            {
-                std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( aType );
-                ercItem->SetErrorMessage( aMsg );
-
-                if( aItemB )
-                    ercItem->SetItems( aItemA->GetSymbol(), aItemB->GetSymbol() );
-                else
-                    ercItem->SetItems( aItemA->GetSymbol() );
-
-                SCH_MARKER* marker = new SCH_MARKER( ercItem, aItemA->GetSymbol()->GetPosition() );
-                aItemA->GetSheetPath().LastScreen()->Append( marker );
-            } );
+    int itemsNotAnnotated = ERC_TESTER( sch ).TestAnnotation();
 
     testErc();
 
@@ -345,70 +332,12 @@ void DIALOG_ERC::testErc()
     // Build the whole sheet list in hierarchy (sheet, not screen)
     sch->GetSheets().AnnotatePowerSymbols();
 
-    SCH_SCREENS screens( sch->Root() );
-    ERC_SETTINGS& settings = sch->ErcSettings();
-    ERC_TESTER tester( sch );
-
-    // Test duplicate sheet names inside a given sheet.  While one can have multiple references
-    // to the same file, each must have a unique name.
-    if( settings.IsTestEnabled( ERCE_DUPLICATE_SHEET_NAME ) )
-    {
-        AdvancePhase( _( "Checking sheet names..." ) );
-        tester.TestDuplicateSheetNames( true );
-    }
-
-    if( settings.IsTestEnabled( ERCE_BUS_ALIAS_CONFLICT ) )
-    {
-        AdvancePhase( _( "Checking bus conflicts..." ) );
-        tester.TestConflictingBusAliases();
-    }
-
     // The connection graph has a whole set of ERC checks it can run
-    AdvancePhase( _( "Checking conflicts..." ) );
     m_parent->RecalculateConnections( NO_CLEANUP );
-    sch->ConnectionGraph()->RunERC();
-
-    // Test is all units of each multiunit symbol have the same footprint assigned.
-    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_FP ) )
-    {
-        AdvancePhase( _( "Checking footprints..." ) );
-        tester.TestMultiunitFootprints();
-    }
 
-    AdvancePhase( _( "Checking pins..." ) );
-
-    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_NET ) )
-        tester.TestMultUnitPinConflicts();
-
-    // Test pins on each net against the pin connection table
-    if( settings.IsTestEnabled( ERCE_PIN_TO_PIN_ERROR ) )
-        tester.TestPinToPin();
-
-    // Test similar labels (i;e. labels which are identical when
-    // using case insensitive comparisons)
-    if( settings.IsTestEnabled( ERCE_SIMILAR_LABELS ) )
-    {
-        AdvancePhase( _( "Checking labels..." ) );
-        tester.TestSimilarLabels();
-    }
-
-    if( settings.IsTestEnabled( ERCE_UNRESOLVED_VARIABLE ) )
-    {
-        AdvancePhase( _( "Checking for unresolved variables..." ) );
-        tester.TestTextVars( m_parent->GetCanvas()->GetView()->GetDrawingSheet() );
-    }
-
-    if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED ) )
-    {
-        AdvancePhase( _( "Checking no connect pins for connections..." ) );
-        tester.TestNoConnectPins();
-    }
+    ERC_TESTER tester( sch );
 
-    if( settings.IsTestEnabled( ERCE_LIB_SYMBOL_ISSUES ) )
-    {
-        AdvancePhase( _( "Checking for library symbol issues..." ) );
-        tester.TestLibSymbolIssues();
-    }
+    tester.RunTests( m_parent->GetCanvas()->GetView()->GetDrawingSheet(), this );
 
     m_parent->ResolveERCExclusions();
 
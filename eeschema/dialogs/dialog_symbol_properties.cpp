@@ -645,10 +645,15 @@ bool DIALOG_SYMBOL_PROPERTIES::TransferDataFromWindow()
     case 2: m_symbol->SetOrientation( SYM_MIRROR_Y ); break;
     }
 
-    if( m_part )
+    if( m_part && ( m_part->ShowPinNames() != m_ShowPinNameButt->GetValue()
+                    || m_part->ShowPinNumbers() != m_ShowPinNumButt->GetValue() ) )
     {
-        m_part->SetShowPinNames( m_ShowPinNameButt->GetValue() );
-        m_part->SetShowPinNumbers( m_ShowPinNumButt->GetValue() );
+        // The library symbol may be shared with other symbols, which must not change
+        LIB_SYMBOL* libSymbol = m_symbol->GetUniqueLibSymbol();
+
+        libSymbol->SetShowPinNames( m_ShowPinNameButt->GetValue() );
+        libSymbol->SetShowPinNumbers( m_ShowPinNumButt->GetValue() );
+        m_part = libSymbol;
     }
 
     // Restore m_Flag modified by SetUnit() and other change settings
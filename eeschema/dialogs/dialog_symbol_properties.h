@@ -90,7 +90,7 @@ private:
 
 private:
     SCH_SYMBOL*    m_symbol;
-    LIB_SYMBOL*    m_part;
+    const LIB_SYMBOL* m_part;
 
     int            m_width;
     int            m_delayedFocusRow;
@@ -36,6 +36,7 @@
 #include <schematic.h>
 #include <drawing_sheet/ds_draw_item.h>
 #include <drawing_sheet/ds_proxy_view_item.h>
+#include <widgets/progress_reporter.h>
 #include <wx/ffile.h>
 
 
@@ -161,6 +162,107 @@ int ERC_TESTER::TestDuplicateSheetNames( bool aCreateMarker )
 }
 
 
+void ERC_TESTER::RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet,
+                           PROGRESS_REPORTER* aProgressReporter )
+{
+    ERC_SETTINGS& settings = m_schematic->ErcSettings();
+
+    auto advancePhase =
+            [&]( const wxString& aMessage )
+            {
+                if( aProgressReporter )
+                    aProgressReporter->AdvancePhase( aMessage );
+            };
+
+    // Test duplicate sheet names inside a given sheet.  While one can have multiple references
+    // to the same file, each must have a unique name.
+    if( settings.IsTestEnabled( ERCE_DUPLICATE_SHEET_NAME ) )
+    {
+        advancePhase( _( "Checking sheet names..." ) );
+        TestDuplicateSheetNames( true );
+    }
+
+    if( settings.IsTestEnabled( ERCE_BUS_ALIAS_CONFLICT ) )
+    {
+        advancePhase( _( "Checking bus conflicts..." ) );
+        TestConflictingBusAliases();
+    }
+
+    // The connection graph has a whole set of ERC checks it can run
+    advancePhase( _( "Checking conflicts..." ) );
+    m_schematic->ConnectionGraph()->RunERC();
+
+    // Test is all units of each multiunit symbol have the same footprint assigned.
+    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_FP ) )
+    {
+        advancePhase( _( "Checking footprints..." ) );
+        TestMultiunitFootprints();
+    }
+
+    advancePhase( _( "Checking pins..." ) );
+
+    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_NET ) )
+        TestMultUnitPinConflicts();
+
+    // Test pins on each net against the pin connection table
+    if( settings.IsTestEnabled( ERCE_PIN_TO_PIN_ERROR ) )
+        TestPinToPin();
+
+    // Test similar labels (i;e. labels which are identical when
+    // using case insensitive comparisons)
+    if( settings.IsTestEnabled( ERCE_SIMILAR_LABELS ) )
+    {
+        advancePhase( _( "Checking labels..." ) );
+        TestSimilarLabels();
+    }
+
+    if( settings.IsTestEnabled( ERCE_UNRESOLVED_VARIABLE ) )
+    {
+        advancePhase( _( "Checking for unresolved variables..." ) );
+        TestTextVars( aDrawingSheet );
+    }
+
+    if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED ) )
+    {
+        advancePhase( _( "Checking no connect pins for connections..." ) );
+        TestNoConnectPins();
+    }
+
+    if( settings.IsTestEnabled( ERCE_LIB_SYMBOL_ISSUES ) )
+    {
+        advancePhase( _( "Checking for library symbol issues..." ) );
+        TestLibSymbolIssues();
+    }
+}
+
+
+int ERC_TESTER::TestAnnotation()
+{
+    SCH_REFERENCE_LIST referenceList;
+
+    m_schematic->GetSheets().GetSymbols( referenceList );
+
+    // Empty schematic does not need annotation
+    if( referenceList.GetCount() == 0 )
+        return 0;
+
+    return referenceList.CheckAnnotation(
+            []( ERCE_T aType, const wxString& aMsg, SCH_REFERENCE* aItemA, SCH_REFERENCE* aItemB )
+            {
+                std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( aType );
+                ercItem->SetErrorMessage( aMsg );
+
+                if( aItemB )
+                    ercItem->SetItems( aItemA->GetSymbol(), aItemB->GetSymbol() );
+                else
+                    ercItem->SetItems( aItemA->GetSymbol() );
+
+                SCH_MARKER* marker = new SCH_MARKER( ercItem, aItemA->GetSymbol()->GetPosition() );
+                aItemA->GetSheetPath().LastScreen()->Append( marker );
+            } );
+}
+
+
 void ERC_TESTER::TestTextVars( DS_PROXY_VIEW_ITEM* aDrawingSheet )
 {
     DS_DRAW_ITEM_LIST wsItems;
@@ -692,7 +794,7 @@ int ERC_TESTER::TestLibSymbolIssues()
 
             wxCHECK2( symbol, continue );
 
-            LIB_SYMBOL* libSymbolInSchematic = symbol->GetLibSymbolRef().get();
+            const LIB_SYMBOL* libSymbolInSchematic = symbol->GetLibSymbolRef().get();
 
             wxCHECK2( libSymbolInSchematic, continue );
 
@@ -38,6 +38,7 @@ class NETLIST_OBJECT_LIST;
 class SCH_SHEET_LIST;
 class SCHEMATIC;
 class DS_PROXY_VIEW_ITEM;
+class PROGRESS_REPORTER;
 
 
 extern const wxString CommentERC_H[];
@@ -53,6 +54,23 @@ public:
     {
     }
 
+    /**
+     * Run all the enabled tests, adding a marker to the schematic for each error found.
+     *
+     * The connections of the schematic must be up to date.
+     *
+     * @param aDrawingSheet is the drawing sheet whose text variables are checked, if any.
+     * @param aProgressReporter is advanced to a new phase for each group of tests, if given.
+     */
+    void RunTests( DS_PROXY_VIEW_ITEM* aDrawingSheet, PROGRESS_REPORTER* aProgressReporter );
+
+    /**
+     * Check that the symbols are fully annotated, and that no two have the same reference.
+     *
+     * @return the error count
+     */
+    int TestAnnotation();
+
     /**
      * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
      * (mainly pin) on the same net.
@@ -47,7 +47,7 @@ enum
 
 template <class T>
 FIELDS_GRID_TABLE<T>::FIELDS_GRID_TABLE( DIALOG_SHIM* aDialog, SCH_BASE_FRAME* aFrame,
-                                         WX_GRID* aGrid, LIB_SYMBOL* aSymbol ) :
+                                         WX_GRID* aGrid, const LIB_SYMBOL* aSymbol ) :
         m_frame( aFrame ),
         m_userUnits( aDialog->GetUserUnits() ),
         m_grid( aGrid ),
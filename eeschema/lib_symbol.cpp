@@ -35,6 +35,8 @@
 #include <lib_arc.h>
 #include <settings/color_settings.h>
 
+#include <atomic>
+
 
 // the separator char between the subpart id and the reference
 // 0 (no separator) or '.' or some other character
@@ -83,7 +85,9 @@ LIB_SYMBOL::LIB_SYMBOL( const wxString& aName, LIB_SYMBOL* aParent, SYMBOL_LIB*
     EDA_ITEM( LIB_SYMBOL_T ),
     m_me( this, null_deleter() ),
     m_includeInBom( true ),
-    m_includeOnBoard( true )
+    m_includeOnBoard( true ),
+    m_flattenedStamp( 0 ),
+    m_flattenedParentStamp( 0 )
 {
     m_lastModDate    = 0;
     m_unitCount      = 1;
@@ -93,6 +97,8 @@ LIB_SYMBOL::LIB_SYMBOL( const wxString& aName, LIB_SYMBOL* aParent, SYMBOL_LIB*
     m_showPinNumbers = true;
     m_showPinNames   = true;
 
+    updateModificationStamp();
+
     // Add the MANDATORY_FIELDS in RAM only.  These are assumed to be present
     // when the field editors are invoked.
     m_drawings[LIB_FIELD_T].reserve( 4 );
@@ -112,7 +118,9 @@ LIB_SYMBOL::LIB_SYMBOL( const wxString& aName, LIB_SYMBOL* aParent, SYMBOL_LIB*
 
 LIB_SYMBOL::LIB_SYMBOL( const LIB_SYMBOL& aSymbol, SYMBOL_LIB* aLibrary ) :
     EDA_ITEM( aSymbol ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_flattenedStamp( 0 ),
+    m_flattenedParentStamp( 0 )
 {
     LIB_ITEM* newItem;
 
@@ -132,6 +140,7 @@ LIB_SYMBOL::LIB_SYMBOL( const LIB_SYMBOL& aSymbol, SYMBOL_LIB* aLibrary ) :
     m_description    = aSymbol.m_description;
     m_keyWords       = aSymbol.m_keyWords;
 
+    updateModificationStamp();
     ClearSelected();
 
     for( const LIB_ITEM& oldItem : aSymbol.m_drawings )
@@ -187,6 +196,9 @@ const LIB_SYMBOL& LIB_SYMBOL::operator=( const LIB_SYMBOL& aSymbol )
     m_description    = aSymbol.m_description;
     m_keyWords       = aSymbol.m_keyWords;
 
+    updateModificationStamp();
+    m_flattened.reset();
+
     m_drawings.clear();
 
     for( const LIB_ITEM& oldItem : aSymbol.m_drawings )
@@ -319,6 +331,7 @@ void LIB_SYMBOL::SetName( const wxString& aName )
     m_libId.SetLibItemName( validatedName, false );
 
     GetValueField().SetText( validatedName );
+    updateModificationStamp();
 }
 
 
@@ -328,6 +341,8 @@ void LIB_SYMBOL::SetParent( LIB_SYMBOL* aParent )
         m_parent = aParent->SharedPtr();
     else
         m_parent.reset();
+
+    updateModificationStamp();
 }
 
 
@@ -399,6 +414,37 @@ std::unique_ptr< LIB_SYMBOL > LIB_SYMBOL::Flatten() const
 }
 
 
+const LIB_SYMBOL* LIB_SYMBOL::GetFlattened() const
+{
+    if( !IsAlias() )
+        return this;
+
+    LIB_SYMBOL_SPTR parent = m_parent.lock();
+
+    wxCHECK_MSG( parent, this,
+                 wxString::Format( "Parent of derived symbol '%s' undefined", m_name ) );
+
+    if( !m_flattened || m_flattenedStamp != m_modificationStamp
+            || m_flattenedParentStamp != parent->GetModificationStamp() )
+    {
+        m_flattened = Flatten();
+        m_flattenedStamp = m_modificationStamp;
+        m_flattenedParentStamp = parent->GetModificationStamp();
+    }
+
+    return m_flattened.get();
+}
+
+
+void LIB_SYMBOL::updateModificationStamp()
+{
+    // Shared by all the symbols, so that a flattened copy is never reused with another parent
+    static std::atomic<unsigned> nextStamp( 1 );
+
+    m_modificationStamp = nextStamp++;
+}
+
+
 const wxString LIB_SYMBOL::GetLibraryName() const
 {
     if( m_library )
@@ -646,6 +692,7 @@ void LIB_SYMBOL::RemoveDrawItem( LIB_ITEM* aItem )
         {
             items.erase( i );
             SetModified();
+            updateModificationStamp();
             break;
         }
     }
@@ -660,6 +707,8 @@ void LIB_SYMBOL::AddDrawItem( LIB_ITEM* aItem, bool aSort )
 
     if( aSort )
         m_drawings.sort();
+
+    updateModificationStamp();
 }
 
 
@@ -692,7 +741,19 @@ LIB_ITEM* LIB_SYMBOL::GetNextDrawItem( const LIB_ITEM* aItem, KICAD_T aType )
 }
 
 
-void LIB_SYMBOL::GetPins( LIB_PINS& aList, int aUnit, int aConvert ) const
+void LIB_SYMBOL::GetPins( LIB_PINS& aList, int aUnit, int aConvert )
+{
+    std::vector<const LIB_PIN*> pins;
+
+    static_cast<const LIB_SYMBOL*>( this )->GetPins( pins, aUnit, aConvert );
+
+    // The pins of a symbol which isn't const can be modified
+    for( const LIB_PIN* pin : pins )
+        aList.push_back( const_cast<LIB_PIN*>( pin ) );
+}
+
+
+void LIB_SYMBOL::GetPins( std::vector<const LIB_PIN*>& aList, int aUnit, int aConvert ) const
 {
     /* Notes:
      * when aUnit == 0: no unit filtering
@@ -714,14 +775,22 @@ void LIB_SYMBOL::GetPins( LIB_PINS& aList, int aUnit, int aConvert ) const
         if( aConvert && item.m_convert && ( item.m_convert != aConvert ) )
             continue;
 
-        aList.push_back( (LIB_PIN*) &item );
+        aList.push_back( static_cast<const LIB_PIN*>( &item ) );
     }
 }
 
 
-LIB_PIN* LIB_SYMBOL::GetPin( const wxString& aNumber, int aUnit, int aConvert ) const
+LIB_PIN* LIB_SYMBOL::GetPin( const wxString& aNumber, int aUnit, int aConvert )
 {
-    LIB_PINS pinList;
+    const LIB_SYMBOL* symbol = this;
+
+    return const_cast<LIB_PIN*>( symbol->GetPin( aNumber, aUnit, aConvert ) );
+}
+
+
+const LIB_PIN* LIB_SYMBOL::GetPin( const wxString& aNumber, int aUnit, int aConvert ) const
+{
+    std::vector<const LIB_PIN*> pinList;
 
     GetPins( pinList, aUnit, aConvert );
 
@@ -740,13 +809,13 @@ LIB_PIN* LIB_SYMBOL::GetPin( const wxString& aNumber, int aUnit, int aConvert )
 bool LIB_SYMBOL::PinsConflictWith( const LIB_SYMBOL& aOtherPart, bool aTestNums, bool aTestNames,
                                    bool aTestType, bool aTestOrientation, bool aTestLength ) const
 {
-    LIB_PINS thisPinList;
+    std::vector<const LIB_PIN*> thisPinList;
     GetPins( thisPinList, /* aUnit */ 0, /* aConvert */ 0 );
 
     for( const LIB_PIN* eachThisPin : thisPinList )
     {
         wxASSERT( eachThisPin );
-        LIB_PINS otherPinList;
+        std::vector<const LIB_PIN*> otherPinList;
         aOtherPart.GetPins( otherPinList, /* aUnit */ 0, /* aConvert */ 0 );
         bool foundMatch = false;
 
@@ -901,6 +970,7 @@ void LIB_SYMBOL::SetFields( const std::vector <LIB_FIELD>& aFields )
     }
 
     m_drawings.sort();
+    updateModificationStamp();
 }
 
 
@@ -921,16 +991,16 @@ void LIB_SYMBOL::GetFields( std::vector<LIB_FIELD*>& aList )
 }
 
 
-void LIB_SYMBOL::GetFields( std::vector<LIB_FIELD>& aList )
+void LIB_SYMBOL::GetFields( std::vector<LIB_FIELD>& aList ) const
 {
     // Grab the MANDATORY_FIELDS first, in expected order given by enum MANDATORY_FIELD_T
     for( int id = 0; id < MANDATORY_FIELDS; ++id )
         aList.push_back( *GetFieldById( id ) );
 
     // Now grab all the rest of fields.
-    for( LIB_ITEM& item : m_drawings[ LIB_FIELD_T ] )
+    for( const LIB_ITEM& item : m_drawings[ LIB_FIELD_T ] )
     {
-        LIB_FIELD* field = static_cast<LIB_FIELD*>( &item );
+        const LIB_FIELD* field = static_cast<const LIB_FIELD*>( &item );
 
         if( !field->IsMandatory() )
             aList.push_back( *field );
@@ -1012,12 +1082,15 @@ void LIB_SYMBOL::SetOffset( const wxPoint& aOffset )
 {
     for( LIB_ITEM& item : m_drawings )
         item.Offset( aOffset );
+
+    updateModificationStamp();
 }
 
 
 void LIB_SYMBOL::RemoveDuplicateDrawItems()
 {
     m_drawings.unique();
+    updateModificationStamp();
 }
 
 
@@ -1159,6 +1232,7 @@ void LIB_SYMBOL::SetUnitCount( int aCount, bool aDuplicateDrawItems )
 
     m_drawings.sort();
     m_unitCount = aCount;
+    updateModificationStamp();
 }
 
 
@@ -1218,6 +1292,7 @@ void LIB_SYMBOL::SetConversion( bool aSetConvert, bool aDuplicatePins )
     }
 
     m_drawings.sort();
+    updateModificationStamp();
 }
 
 
@@ -30,6 +30,7 @@
 #include <lib_tree_item.h>
 #include <lib_item.h>
 #include <lib_field.h>
+#include <memory>
 #include <vector>
 #include <multivector.h>
 
@@ -137,9 +138,18 @@ public:
 
     wxString GetLibNickname() const override { return GetLibraryName(); }
 
-    void SetDescription( const wxString& aDescription ) { m_description = aDescription; }
+    void SetDescription( const wxString& aDescription )
+    {
+        m_description = aDescription;
+        updateModificationStamp();
+    }
 
     wxString GetDescription() override
+    {
+        return static_cast<const LIB_SYMBOL*>( this )->GetDescription();
+    }
+
+    wxString GetDescription() const
     {
         if( m_description.IsEmpty() && IsAlias() )
         {
@@ -150,7 +160,11 @@ public:
         return m_description;
     }
 
-    void SetKeyWords( const wxString& aKeyWords ) { m_keyWords = aKeyWords; }
+    void SetKeyWords( const wxString& aKeyWords )
+    {
+        m_keyWords = aKeyWords;
+        updateModificationStamp();
+    }
 
     wxString GetKeyWords() const
     {
@@ -178,7 +192,11 @@ public:
 
     timestamp_t GetLastModDate() const { return m_lastModDate; }
 
-    void SetFPFilters( const wxArrayString& aFilters ) { m_fpFilters = aFilters; }
+    void SetFPFilters( const wxArrayString& aFilters )
+    {
+        m_fpFilters = aFilters;
+        updateModificationStamp();
+    }
 
     wxArrayString GetFPFilters() const
     {
@@ -257,7 +275,7 @@ public:
      * @param aList - List to add fields to
      */
     void GetFields( std::vector<LIB_FIELD*>& aList );
-    void GetFields( std::vector<LIB_FIELD>& aList );
+    void GetFields( std::vector<LIB_FIELD>& aList ) const;
 
     /**
      * Add a field.  Takes ownership of the pointer.
@@ -387,7 +405,8 @@ public:
      * @param aConvert - Convert number of pin to add to list.  Set to 0 to
      *                   get pins from any convert of symbol.
      */
-    void GetPins( LIB_PINS& aList, int aUnit = 0, int aConvert = 0 ) const;
+    void GetPins( LIB_PINS& aList, int aUnit = 0, int aConvert = 0 );
+    void GetPins( std::vector<const LIB_PIN*>& aList, int aUnit = 0, int aConvert = 0 ) const;
 
     /**
      * Return pin object with the requested pin \a aNumber.
@@ -399,7 +418,8 @@ public:
      *                   no alternate body style is required.
      * @return The pin object if found.  Otherwise NULL.
      */
-    LIB_PIN* GetPin( const wxString& aNumber, int aUnit = 0, int aConvert = 0 ) const;
+    LIB_PIN* GetPin( const wxString& aNumber, int aUnit = 0, int aConvert = 0 );
+    const LIB_PIN* GetPin( const wxString& aNumber, int aUnit = 0, int aConvert = 0 ) const;
 
     /**
      * Return true if this symbol's pins do not match another symbol's pins. This
@@ -618,6 +638,32 @@ public:
      */
     std::unique_ptr< LIB_SYMBOL > Flatten() const;
 
+    /**
+     * Return the flattened symbol inheritance, as Flatten() does, without flattening the symbol
+     * again until it or its parent is modified.
+     *
+     * This is meant for drawing derived symbols, which would otherwise be flattened on each
+     * repaint.  It isn't thread safe.
+     *
+     * @return this symbol if it does not inherit from another symbol, or a flattened copy which
+     *         is valid until the next call, or until ClearFlattened() is called.
+     */
+    const LIB_SYMBOL* GetFlattened() const;
+
+    /**
+     * Free the flattened copy kept by GetFlattened(), once the symbol isn't drawn anymore.
+     */
+    void ClearFlattened() { m_flattened.reset(); }
+
+    /**
+     * Return a number which changes when the items, fields or properties of this symbol are
+     * added, removed or replaced, and which is never the same for two different symbols.
+     *
+     * @note Items modified in place, as the symbol editor does with its own copy of the
+     *       symbol, don't change it.  Such a copy must be assigned back to the symbol.
+     */
+    unsigned GetModificationStamp() const { return m_modificationStamp; }
+
     /**
      * Return a list of LIB_ITEM objects separated by unit and convert number.
      *
@@ -658,6 +704,8 @@ private:
 
     void deleteAllFields();
 
+    void updateModificationStamp();
+
 private:
     LIB_SYMBOL_SPTR     m_me;
     LIB_SYMBOL_REF      m_parent;           ///< Use for inherited symbols.
@@ -686,6 +734,13 @@ private:
     wxArrayString       m_fpFilters;        ///< List of suitable footprint names for the
                                             ///<  symbol (wild card names accepted).
 
+    unsigned            m_modificationStamp;
+
+    ///< The cache of GetFlattened(), and the stamps of this symbol and its parent it was made of
+    mutable std::unique_ptr< LIB_SYMBOL > m_flattened;
+    mutable unsigned                      m_flattenedStamp;
+    mutable unsigned                      m_flattenedParentStamp;
+
     static int  m_subpartIdSeparator;       ///< the separator char between
                                             ///< the subpart id and the reference like U1A
                                             ///< ( m_subpartIdSeparator = 0 ) or U1.A or U1-A
@@ -217,7 +217,8 @@ void NETLIST_EXPORTER_BASE::eraseDuplicatePins()
 }
 
 
-void NETLIST_EXPORTER_BASE::findAllUnitsOfSymbol( SCH_SYMBOL* aSchSymbol, LIB_SYMBOL* aLibSymbol,
+void NETLIST_EXPORTER_BASE::findAllUnitsOfSymbol( SCH_SYMBOL* aSchSymbol,
+                                                  const LIB_SYMBOL* aLibSymbol,
                                                   SCH_SHEET_PATH* aSheetPath,
                                                   bool aKeepUnconnectedPins )
 {
@@ -240,12 +240,12 @@ wxString NETLIST_EXPORTER_PSPICE::GetSpiceFieldDefVal( SPICE_FIELD aField, SCH_S
     case SF_NODE_SEQUENCE:
     {
         wxString nodeSeq;
-        std::vector<LIB_PIN*> pins;
+        std::vector<const LIB_PIN*> pins;
 
         wxCHECK( aSymbol->GetLibSymbolRef(), wxString() );
         aSymbol->GetLibSymbolRef()->GetPins( pins );
 
-        for( LIB_PIN* pin : pins )
+        for( const LIB_PIN* pin : pins )
             nodeSeq += pin->GetNumber() + " ";
 
         nodeSeq.Trim();
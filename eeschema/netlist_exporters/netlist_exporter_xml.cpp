@@ -32,57 +32,95 @@
 #include <kicad_string.h>
 #include <connection_graph.h>
 #include <refdes_utils.h>
-#include <wx/wfstream.h>
+#include <richio.h>
 #include <xnode.h>      // also nests: <wx/xml/xml.h>
 
 #include <symbol_lib_table.h>
 
+#include <exception>
 #include <set>
 
-static bool sortPinsByNumber( LIB_PIN* aPin1, LIB_PIN* aPin2 );
+#include <wx/mstream.h>
+
+static bool sortPinsByNumber( const LIB_PIN* aPin1, const LIB_PIN* aPin2 );
 
 bool NETLIST_EXPORTER_XML::WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions )
 {
-    // output the XML format netlist.
-
-    // declare the stream ourselves to use the buffered FILE api
-    // instead of letting wx use the syscall variant
-    wxFFileOutputStream stream( aOutFileName );
+    // output the XML format netlist, as the schematic is walked.
+    try
+    {
+        FILE_OUTPUTFORMATTER formatter( aOutFileName, wxT( "wb" ) );
 
-    if( !stream.IsOk() )
+        FormatXML( &formatter, GNL_ALL | aNetlistOptions );
+    }
+    catch( const IO_ERROR& )
+    {
         return false;
+    }
+
+    return true;
+}
+
 
-    wxXmlDocument       xdoc;
-    xdoc.SetRoot( makeRoot( GNL_ALL | aNetlistOptions ) );
+void NETLIST_EXPORTER_XML::FormatXML( OUTPUTFORMATTER* aOut, unsigned aCtl )
+{
+#if wxCHECK_VERSION( 3, 1, 0 )
+    XML_STREAM_WRITER writer( aOut );
+
+    writeRoot( writer, aCtl );
+#else
+    // XML_STREAM_WRITER escapes text as wxXmlDocument::Save() does from wxWidgets 3.1 on, so
+    // the tree is saved by wx itself with older versions, to write the same netlist they did
+    wxXmlDocument        xdoc;
+    wxMemoryOutputStream stream;
+
+    xdoc.SetRoot( makeRoot( aCtl ) );
+
+    if( !xdoc.Save( stream, 2 ) )
+        THROW_IO_ERROR( _( "Cannot write the XML netlist" ) );
+
+    const wxStreamBuffer* buffer = stream.GetOutputStreamBuffer();
+    std::string           xml( static_cast<const char*>( buffer->GetBufferStart() ),
+                               buffer->GetIntPosition() );
 
-    return xdoc.Save( stream, 2 /* indent bug, today was ignored by wxXml lib */ );
+    aOut->Print( 0, "%s", xml.c_str() );
+#endif
 }
 
 
 XNODE* NETLIST_EXPORTER_XML::makeRoot( unsigned aCtl )
 {
-    XNODE*      xroot = node( "export" );
+    XNODE_TREE_BUILDER builder;
+
+    writeRoot( builder, aCtl );
+
+    return builder.ReleaseRoot();
+}
+
 
-    xroot->AddAttribute( "version", "E" );
+void NETLIST_EXPORTER_XML::writeRoot( XML_ELEMENT_SINK& aSink, unsigned aCtl )
+{
+    aSink.StartElement( "export" );
+    aSink.AddAttribute( "version", "E" );
 
     if( aCtl & GNL_HEADER )
         // add the "design" header
-        xroot->AddChild( makeDesignHeader() );
+        writeDesignHeader( aSink );
 
     if( aCtl & GNL_SYMBOLS )
-        xroot->AddChild( makeSymbols( aCtl ) );
+        writeSymbols( aSink, aCtl );
 
     if( aCtl & GNL_PARTS )
-        xroot->AddChild( makeLibParts() );
+        writeLibParts( aSink );
 
     if( aCtl & GNL_LIBRARIES )
-        // must follow makeGenericLibParts()
-        xroot->AddChild( makeLibraries() );
+        // must follow writeLibParts()
+        writeLibraries( aSink );
 
     if( aCtl & GNL_NETS )
-        xroot->AddChild( makeListOfNets( aCtl ) );
+        writeListOfNets( aSink, aCtl );
 
-    return xroot;
+    aSink.EndElement();
 }
 
 
@@ -97,7 +135,7 @@ struct COMP_FIELDS
 };
 
 
-void NETLIST_EXPORTER_XML::addSymbolFields( XNODE* aNode, SCH_SYMBOL* aSymbol,
+void NETLIST_EXPORTER_XML::addSymbolFields( XML_ELEMENT_SINK& aSink, SCH_SYMBOL* aSymbol,
                                             SCH_SHEET_PATH* aSheet )
 {
     COMP_FIELDS fields;
@@ -197,36 +235,38 @@ void NETLIST_EXPORTER_XML::addSymbolFields( XNODE* aNode, SCH_SYMBOL* aSymbol,
 
     // Do not output field values blank in netlist:
     if( fields.value.size() )
-        aNode->AddChild( node( "value", fields.value ) );
+        aSink.AddElement( "value", fields.value );
     else    // value field always written in netlist
-        aNode->AddChild( node( "value", "~" ) );
+        aSink.AddElement( "value", "~" );
 
     if( fields.footprint.size() )
-        aNode->AddChild( node( "footprint", fields.footprint ) );
+        aSink.AddElement( "footprint", fields.footprint );
 
     if( fields.datasheet.size() )
-        aNode->AddChild( node( "datasheet", fields.datasheet ) );
+        aSink.AddElement( "datasheet", fields.datasheet );
 
     if( fields.f.size() )
     {
-        XNODE* xfields;
-        aNode->AddChild( xfields = node( "fields" ) );
+        aSink.StartElement( "fields" );
 
         // non MANDATORY fields are output alphabetically
         for( std::map< wxString, wxString >::const_iterator it = fields.f.begin();
              it != fields.f.end();  ++it )
         {
-            XNODE*  xfield;
-            xfields->AddChild( xfield = node( "field", it->second ) );
-            xfield->AddAttribute( "name", it->first );
+            aSink.StartElement( "field" );
+            aSink.AddAttribute( "name", it->first );
+            aSink.AddText( it->second );
+            aSink.EndElement();
         }
+
+        aSink.EndElement();
     }
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::makeSymbols( unsigned aCtl )
+void NETLIST_EXPORTER_XML::writeSymbols( XML_ELEMENT_SINK& aSink, unsigned aCtl )
 {
-    XNODE* xcomps = node( "components" );
+    aSink.StartElement( "components" );
 
     m_referencesAlreadyFound.Clear();
     m_libParts.clear();
@@ -285,116 +325,115 @@ XNODE* NETLIST_EXPORTER_XML::makeSymbols( unsigned aCtl )
             // not always look best, but it will allow faster execution under XSL processing
             // systems which do sequential searching within an element.
 
-            XNODE* xcomp;  // current symbol being constructed
-            xcomps->AddChild( xcomp = node( "comp" ) );
-
-            xcomp->AddAttribute( "ref", symbol->GetRef( &sheet ) );
-            addSymbolFields( xcomp, symbol, &sheetList[ ii ] );
+            aSink.StartElement( "comp" );   // current symbol being written
+            aSink.AddAttribute( "ref", symbol->GetRef( &sheet ) );
+            addSymbolFields( aSink, symbol, &sheetList[ ii ] );
 
-            XNODE*  xlibsource;
-            xcomp->AddChild( xlibsource = node( "libsource" ) );
+            aSink.StartElement( "libsource" );
 
             // "logical" library name, which is in anticipation of a better search algorithm
             // for parts based on "logical_lib.part" and where logical_lib is merely the library
             // name minus path and extension.
             if( symbol->GetLibSymbolRef() )
-                xlibsource->AddAttribute( "lib",
-                                          symbol->GetLibSymbolRef()->GetLibId().GetLibNickname() );
+                aSink.AddAttribute( "lib",
+                                    symbol->GetLibSymbolRef()->GetLibId().GetLibNickname() );
 
             // We only want the symbol name, not the full LIB_ID.
-            xlibsource->AddAttribute( "part", symbol->GetLibId().GetLibItemName() );
+            aSink.AddAttribute( "part", symbol->GetLibId().GetLibItemName() );
 
-            xlibsource->AddAttribute( "description", symbol->GetDescription() );
-
-            XNODE* xproperty;
+            aSink.AddAttribute( "description", symbol->GetDescription() );
+            aSink.EndElement();
 
             std::vector<SCH_FIELD>& fields = symbol->GetFields();
 
             for( size_t jj = MANDATORY_FIELDS; jj < fields.size(); ++jj )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", fields[jj].GetCanonicalName() );
-                xproperty->AddAttribute( "value", fields[jj].GetText() );
+                aSink.StartElement( "property" );
+                aSink.AddAttribute( "name", fields[jj].GetCanonicalName() );
+                aSink.AddAttribute( "value", fields[jj].GetText() );
+                aSink.EndElement();
             }
 
             for( const SCH_FIELD& sheetField : sheet.Last()->GetFields() )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", sheetField.GetCanonicalName() );
-                xproperty->AddAttribute( "value", sheetField.GetText() );
+                aSink.StartElement( "property" );
+                aSink.AddAttribute( "name", sheetField.GetCanonicalName() );
+                aSink.AddAttribute( "value", sheetField.GetText() );
+                aSink.EndElement();
             }
 
             if( !symbol->GetIncludeInBom() )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", "exclude_from_bom" );
+                aSink.StartElement( "property" );
+                aSink.AddAttribute( "name", "exclude_from_bom" );
+                aSink.EndElement();
             }
 
             if( !symbol->GetIncludeOnBoard() )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", "exclude_from_board" );
+                aSink.StartElement( "property" );
+                aSink.AddAttribute( "name", "exclude_from_board" );
+                aSink.EndElement();
             }
 
-            XNODE* xsheetpath;
-            xcomp->AddChild( xsheetpath = node( "sheetpath" ) );
-
-            xsheetpath->AddAttribute( "names", sheet.PathHumanReadable() );
-            xsheetpath->AddAttribute( "tstamps", sheet.PathAsString() );
+            aSink.StartElement( "sheetpath" );
+            aSink.AddAttribute( "names", sheet.PathHumanReadable() );
+            aSink.AddAttribute( "tstamps", sheet.PathAsString() );
+            aSink.EndElement();
 
-            XNODE* xunits; // Node for extra units
-            xcomp->AddChild( xunits = node( "tstamps" ) );
+            aSink.StartElement( "tstamps" );   // Element for extra units
 
             auto range = extra_units.equal_range( symbol );
 
-            // Output a series of children with all UUIDs associated with the REFDES
+            // Output a series of texts with all UUIDs associated with the REFDES
             for( auto it = range.first; it != range.second; ++it )
             {
                 wxString uuid = ( *it )->m_Uuid.AsString();
 
-                // Add a space between UUIDs, if not in KICAD mode (i.e.
-                // using wxXmlDocument::Save()).  KICAD MODE has its own XNODE::Format function.
+                // Add a space between UUIDs, if not in KICAD mode (i.e. in XML).  KICAD MODE
+                // has its own XNODE::Format function.
                 if( !( aCtl & GNL_OPT_KICAD ) )     // i.e. for .xml format
                     uuid += ' ';
 
-                xunits->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, uuid ) );
+                aSink.AddText( uuid );
             }
 
             // Output the primary UUID
-            xunits->AddChild(
-                    new XNODE( wxXML_TEXT_NODE, wxEmptyString, symbol->m_Uuid.AsString() ) );
+            aSink.AddText( symbol->m_Uuid.AsString() );
+            aSink.EndElement();
+
+            aSink.EndElement();
         }
     }
 
-    return xcomps;
+    aSink.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::makeDesignHeader()
+void NETLIST_EXPORTER_XML::writeDesignHeader( XML_ELEMENT_SINK& aSink )
 {
     SCH_SCREEN* screen;
-    XNODE*      xdesign = node( "design" );
-    XNODE*      xtitleBlock;
-    XNODE*      xsheet;
-    XNODE*      xcomment;
-    XNODE*      xtextvar;
     wxString    sheetTxt;
     wxFileName  sourceFileName;
 
+    aSink.StartElement( "design" );
+
     // the root sheet is a special sheet, call it source
-    xdesign->AddChild( node( "source", m_schematic->GetFileName() ) );
+    aSink.AddElement( "source", m_schematic->GetFileName() );
 
-    xdesign->AddChild( node( "date", DateAndTime() ) );
+    aSink.AddElement( "date", DateAndTime() );
 
     // which Eeschema tool
-    xdesign->AddChild( node( "tool", wxString( "Eeschema " ) + GetBuildVersion() ) );
+    aSink.AddElement( "tool", wxString( "Eeschema " ) + GetBuildVersion() );
 
     const std::map<wxString, wxString>& properties = m_schematic->Prj().GetTextVars();
 
     for( const std::pair<const wxString, wxString>& prop : properties )
     {
-        xdesign->AddChild( xtextvar = node( "textvar", prop.second ) );
-        xtextvar->AddAttribute( "name", prop.first );
+        aSink.StartElement( "textvar" );
+        aSink.AddAttribute( "name", prop.first );
+        aSink.AddText( prop.second );
+        aSink.EndElement();
     }
 
     /*
@@ -406,105 +445,81 @@ XNODE* NETLIST_EXPORTER_XML::makeDesignHeader()
     {
         screen = sheetList[i].LastScreen();
 
-        xdesign->AddChild( xsheet = node( "sheet" ) );
+        aSink.StartElement( "sheet" );
 
         // get the string representation of the sheet index number.
         // Note that sheet->GetIndex() is zero index base and we need to increment the
         // number by one to make it human readable
         sheetTxt.Printf( "%u", i + 1 );
-        xsheet->AddAttribute( "number", sheetTxt );
-        xsheet->AddAttribute( "name", sheetList[i].PathHumanReadable() );
-        xsheet->AddAttribute( "tstamps", sheetList[i].PathAsString() );
+        aSink.AddAttribute( "number", sheetTxt );
+        aSink.AddAttribute( "name", sheetList[i].PathHumanReadable() );
+        aSink.AddAttribute( "tstamps", sheetList[i].PathAsString() );
 
         TITLE_BLOCK tb = screen->GetTitleBlock();
         PROJECT*    prj = &m_schematic->Prj();
 
-        xsheet->AddChild( xtitleBlock = node( "title_block" ) );
+        aSink.StartElement( "title_block" );
 
-        xtitleBlock->AddChild( node( "title", ExpandTextVars( tb.GetTitle(), prj ) ) );
-        xtitleBlock->AddChild( node( "company", ExpandTextVars( tb.GetCompany(), prj ) ) );
-        xtitleBlock->AddChild( node( "rev", ExpandTextVars( tb.GetRevision(), prj ) ) );
-        xtitleBlock->AddChild( node( "date", ExpandTextVars( tb.GetDate(), prj ) ) );
+        aSink.AddElement( "title", ExpandTextVars( tb.GetTitle(), prj ) );
+        aSink.AddElement( "company", ExpandTextVars( tb.GetCompany(), prj ) );
+        aSink.AddElement( "rev", ExpandTextVars( tb.GetRevision(), prj ) );
+        aSink.AddElement( "date", ExpandTextVars( tb.GetDate(), prj ) );
 
         // We are going to remove the fileName directories.
         sourceFileName = wxFileName( screen->GetFileName() );
-        xtitleBlock->AddChild( node( "source", sourceFileName.GetFullName() ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "1" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 0 ), prj ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "2" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 1 ), prj ) );
+        aSink.AddElement( "source", sourceFileName.GetFullName() );
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "3" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 2 ), prj ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "4" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 3 ), prj ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "5" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 4 ), prj ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "6" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 5 ), prj ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "7" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 6 ), prj ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "8" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 7 ), prj ) );
+        for( int ii = 0; ii < 9; ++ii )
+        {
+            aSink.StartElement( "comment" );
+            aSink.AddAttribute( "number", wxString::Format( "%d", ii + 1 ) );
+            aSink.AddAttribute( "value", ExpandTextVars( tb.GetComment( ii ), prj ) );
+            aSink.EndElement();
+        }
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "9" );
-        xcomment->AddAttribute( "value", ExpandTextVars( tb.GetComment( 8 ), prj ) );
+        aSink.EndElement();
+        aSink.EndElement();
     }
 
-    return xdesign;
+    aSink.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::makeLibraries()
+void NETLIST_EXPORTER_XML::writeLibraries( XML_ELEMENT_SINK& aSink )
 {
-    XNODE*            xlibs = node( "libraries" );     // auto_ptr
     SYMBOL_LIB_TABLE* symbolLibTable = m_schematic->Prj().SchSymbolLibTable();
 
+    aSink.StartElement( "libraries" );
+
     for( std::set<wxString>::iterator it = m_libraries.begin(); it!=m_libraries.end();  ++it )
     {
         wxString    libNickname = *it;
-        XNODE*      xlibrary;
 
         if( symbolLibTable->HasLibrary( libNickname ) )
         {
-            xlibs->AddChild( xlibrary = node( "library" ) );
-            xlibrary->AddAttribute( "logical", libNickname );
-            xlibrary->AddChild( node( "uri", symbolLibTable->GetFullURI( libNickname ) ) );
+            aSink.StartElement( "library" );
+            aSink.AddAttribute( "logical", libNickname );
+            aSink.AddElement( "uri", symbolLibTable->GetFullURI( libNickname ) );
+            aSink.EndElement();
         }
 
         // @todo: add more fun stuff here
     }
 
-    return xlibs;
+    aSink.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::makeLibParts()
+void NETLIST_EXPORTER_XML::writeLibParts( XML_ELEMENT_SINK& aSink )
 {
-    XNODE*                  xlibparts = node( "libparts" );   // auto_ptr
+    std::vector<const LIB_PIN*> pinList;
+    std::vector<LIB_FIELD>      fieldList;
 
-    LIB_PINS                pinList;
-    std::vector<LIB_FIELD*> fieldList;
+    aSink.StartElement( "libparts" );
 
     m_libraries.clear();
 
-    for( auto lcomp : m_libParts )
+    for( const LIB_SYMBOL* lcomp : m_libParts )
     {
         wxString libNickname = lcomp->GetLibId().GetLibNickname();;
 
@@ -512,45 +527,49 @@ XNODE* NETLIST_EXPORTER_XML::makeLibParts()
         if( !libNickname.IsEmpty() )
             m_libraries.insert( libNickname );  // inserts symbol's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( "libpart" ) );
-        xlibpart->AddAttribute( "lib", libNickname );
-        xlibpart->AddAttribute( "part", lcomp->GetName()  );
+        aSink.StartElement( "libpart" );
+        aSink.AddAttribute( "lib", libNickname );
+        aSink.AddAttribute( "part", lcomp->GetName()  );
 
         //----- show the important properties -------------------------
         if( !lcomp->GetDescription().IsEmpty() )
-            xlibpart->AddChild( node( "description", lcomp->GetDescription() ) );
+            aSink.AddElement( "description", lcomp->GetDescription() );
+
+        const LIB_FIELD* datasheet = lcomp->GetFieldById( DATASHEET_FIELD );
 
-        if( !lcomp->GetDatasheetField().GetText().IsEmpty() )
-            xlibpart->AddChild( node( "docs",  lcomp->GetDatasheetField().GetText() ) );
+        if( !datasheet->GetText().IsEmpty() )
+            aSink.AddElement( "docs",  datasheet->GetText() );
 
         // Write the footprint list
         if( lcomp->GetFPFilters().GetCount() )
         {
-            XNODE*  xfootprints;
-            xlibpart->AddChild( xfootprints = node( "footprints" ) );
+            aSink.StartElement( "footprints" );
 
             for( unsigned i = 0; i < lcomp->GetFPFilters().GetCount(); ++i )
-                xfootprints->AddChild( node( "fp", lcomp->GetFPFilters()[i] ) );
+                aSink.AddElement( "fp", lcomp->GetFPFilters()[i] );
+
+            aSink.EndElement();
         }
 
         //----- show the fields here ----------------------------------
         fieldList.clear();
         lcomp->GetFields( fieldList );
 
-        XNODE*     xfields;
-        xlibpart->AddChild( xfields = node( "fields" ) );
+        aSink.StartElement( "fields" );
 
-        for( const LIB_FIELD* field : fieldList )
+        for( const LIB_FIELD& field : fieldList )
         {
-            if( !field->GetText().IsEmpty() )
+            if( !field.GetText().IsEmpty() )
             {
-                XNODE*     xfield;
-                xfields->AddChild( xfield = node( "field", field->GetText() ) );
-                xfield->AddAttribute( "name", field->GetCanonicalName() );
+                aSink.StartElement( "field" );
+                aSink.AddAttribute( "name", field.GetCanonicalName() );
+                aSink.AddText( field.GetText() );
+                aSink.EndElement();
             }
         }
 
+        aSink.EndElement();
+
         //----- show the pins here ------------------------------------
         pinList.clear();
         lcomp->GetPins( pinList, 0, 0 );
@@ -575,36 +594,35 @@ XNODE* NETLIST_EXPORTER_XML::makeLibParts()
 
         if( pinList.size() )
         {
-            XNODE*     pins;
+            aSink.StartElement( "pins" );
 
-            xlibpart->AddChild( pins = node( "pins" ) );
             for( unsigned i=0; i<pinList.size();  ++i )
             {
-                XNODE*     pin;
-
-                pins->AddChild( pin = node( "pin" ) );
-                pin->AddAttribute( "num", pinList[i]->GetShownNumber() );
-                pin->AddAttribute( "name", pinList[i]->GetShownName() );
-                pin->AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
+                aSink.StartElement( "pin" );
+                aSink.AddAttribute( "num", pinList[i]->GetShownNumber() );
+                aSink.AddAttribute( "name", pinList[i]->GetShownName() );
+                aSink.AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
 
                 // caution: construction work site here, drive slowly
+                aSink.EndElement();
             }
+
+            aSink.EndElement();
         }
+
+        aSink.EndElement();
     }
 
-    return xlibparts;
+    aSink.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::makeListOfNets( unsigned aCtl )
+void NETLIST_EXPORTER_XML::writeListOfNets( XML_ELEMENT_SINK& aSink, unsigned aCtl )
 {
-    XNODE*      xnets = node( "nets" );      // auto_ptr if exceptions ever get used.
     wxString    netCodeTxt;
     wxString    netName;
     wxString    ref;
 
-    XNODE*      xnet = nullptr;
-
     /*  output:
         <net code="123" name="/cfcard.sch/WAIT#">
             <node ref="R23" pin="1"/>
@@ -685,7 +703,6 @@ XNODE* NETLIST_EXPORTER_XML::makeListOfNets( unsigned aCtl )
     {
         NET_RECORD* net_record = nets[i];
         bool        added = false;
-        XNODE*      xnode;
 
         // Netlist ordering: Net name, then ref des, then pin name
         std::sort( net_record->m_Nodes.begin(), net_record->m_Nodes.end(),
@@ -728,50 +745,247 @@ XNODE* NETLIST_EXPORTER_XML::makeListOfNets( unsigned aCtl )
             {
                 netCodeTxt.Printf( "%d", i + 1 );
 
-                xnets->AddChild( xnet = node( "net" ) );
-                xnet->AddAttribute( "code", netCodeTxt );
-                xnet->AddAttribute( "name", net_record->m_Name );
+                aSink.StartElement( "net" );
+                aSink.AddAttribute( "code", netCodeTxt );
+                aSink.AddAttribute( "name", net_record->m_Name );
 
                 added = true;
             }
 
-            xnet->AddChild( xnode = node( "node" ) );
-            xnode->AddAttribute( "ref", refText );
-            xnode->AddAttribute( "pin", pinText );
+            aSink.StartElement( "node" );
+            aSink.AddAttribute( "ref", refText );
+            aSink.AddAttribute( "pin", pinText );
 
             wxString pinName = netNode.m_Pin->GetShownName();
             wxString pinType = netNode.m_Pin->GetCanonicalElectricalTypeName();
 
             if( !pinName.IsEmpty() )
-                xnode->AddAttribute( "pinfunction", pinName );
+                aSink.AddAttribute( "pinfunction", pinName );
 
             if( netNode.m_NoConnect )
                 pinType += "+no_connect";
 
-            xnode->AddAttribute( "pintype", pinType );
+            aSink.AddAttribute( "pintype", pinType );
+            aSink.EndElement();
         }
+
+        if( added )
+            aSink.EndElement();
     }
 
+    aSink.EndElement();
+
     for( NET_RECORD* record : nets )
         delete record;
+}
+
+
+XNODE_TREE_BUILDER::~XNODE_TREE_BUILDER()
+{
+    delete m_root;
+}
+
+
+void XNODE_TREE_BUILDER::StartElement( const wxString& aName )
+{
+    XNODE* element = new XNODE( wxXML_ELEMENT_NODE, aName );
+
+    if( m_stack.empty() )
+    {
+        wxASSERT( !m_root );
+        m_root = element;
+    }
+    else
+    {
+        addChild( element );
+    }
+
+    m_stack.emplace_back( element, nullptr );
+}
+
+
+void XNODE_TREE_BUILDER::AddAttribute( const wxString& aName, const wxString& aValue )
+{
+    m_stack.back().first->AddAttribute( aName, aValue );
+}
+
+
+void XNODE_TREE_BUILDER::AddText( const wxString& aText )
+{
+    if( !aText.IsEmpty() )
+        addChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aText ) );
+}
+
+
+void XNODE_TREE_BUILDER::EndElement()
+{
+    m_stack.pop_back();
+}
 
-    return xnets;
+
+XNODE* XNODE_TREE_BUILDER::ReleaseRoot()
+{
+    wxASSERT( m_stack.empty() );
+
+    XNODE* root = m_root;
+    m_root = nullptr;
+    return root;
+}
+
+
+void XNODE_TREE_BUILDER::addChild( XNODE* aNode )
+{
+    std::pair<XNODE*, XNODE*>& parent = m_stack.back();
+
+    // wxXmlNode::AddChild() walks all the children to append one; keep the last one instead
+    if( parent.second )
+        parent.first->InsertChildAfter( aNode, parent.second );
+    else
+        parent.first->AddChild( aNode );
+
+    parent.second = aNode;
+}
+
+
+XML_STREAM_WRITER::XML_STREAM_WRITER( OUTPUTFORMATTER* aOut ) :
+        m_out( aOut ),
+        m_startTagOpen( false )
+{
+    m_buffer = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+}
+
+
+XML_STREAM_WRITER::~XML_STREAM_WRITER()
+{
+    // An exception thrown by the output formatter leaves the elements open
+    wxASSERT( std::uncaught_exception() || m_stack.empty() );
+}
+
+
+void XML_STREAM_WRITER::StartElement( const wxString& aName )
+{
+    if( !m_stack.empty() )
+    {
+        startChild( false );
+        indent( m_stack.size() );
+    }
+
+    m_buffer += '<';
+    m_buffer += aName.utf8_str();
+
+    m_stack.push_back( { aName, false, false } );
+    m_startTagOpen = true;
+}
+
+
+void XML_STREAM_WRITER::AddAttribute( const wxString& aName, const wxString& aValue )
+{
+    wxASSERT( m_startTagOpen );
+
+    m_buffer += ' ';
+    m_buffer += aName.utf8_str();
+    m_buffer += "=\"";
+    escape( aValue, true );
+    m_buffer += '"';
+}
+
+
+void XML_STREAM_WRITER::AddText( const wxString& aText )
+{
+    if( aText.IsEmpty() )
+        return;
+
+    startChild( true );
+    escape( aText, false );
 }
 
 
-XNODE* NETLIST_EXPORTER_XML::node( const wxString& aName,
-                                   const wxString& aTextualContent /* = wxEmptyString*/ )
+void XML_STREAM_WRITER::EndElement()
 {
-    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
+    const ELEMENT& element = m_stack.back();
 
-    if( aTextualContent.Len() > 0 )     // excludes wxEmptyString, the parameter's default value
-        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aTextualContent ) );
+    if( !element.m_HasChildren )
+    {
+        m_buffer += "/>";
+    }
+    else
+    {
+        if( !element.m_LastChildIsText )
+            indent( m_stack.size() - 1 );
+
+        m_buffer += "</";
+        m_buffer += element.m_Name.utf8_str();
+        m_buffer += '>';
+    }
+
+    m_startTagOpen = false;
+    m_stack.pop_back();
+
+    if( m_stack.empty() )
+    {
+        m_buffer += '\n';
+        flush();
+    }
+    else if( m_buffer.size() > 65536 )
+    {
+        flush();
+    }
+}
+
+
+void XML_STREAM_WRITER::startChild( bool aIsText )
+{
+    ELEMENT& parent = m_stack.back();
+
+    if( m_startTagOpen )
+    {
+        m_buffer += '>';
+        m_startTagOpen = false;
+    }
+
+    parent.m_HasChildren = true;
+    parent.m_LastChildIsText = aIsText;
+}
+
+
+void XML_STREAM_WRITER::indent( size_t aDepth )
+{
+    m_buffer += '\n';
+    m_buffer.append( 2 * aDepth, ' ' );
+}
+
+
+void XML_STREAM_WRITER::escape( const wxString& aText, bool aAttribute )
+{
+    // The same escaping as wxXmlDocument::Save() of wxWidgets 3.1 and later.  All the escaped
+    // characters are ASCII, so this can work on the UTF-8 bytes.
+    const wxScopedCharBuffer utf8 = aText.utf8_str();
 
-    return n;
+    for( const char* c = utf8.data(); *c; ++c )
+    {
+        switch( *c )
+        {
+        case '<':  m_buffer += "&lt;";   break;
+        case '>':  m_buffer += "&gt;";   break;
+        case '&':  m_buffer += "&amp;";  break;
+        case '\r': m_buffer += "&#xD;";  break;
+        case '"':  m_buffer += aAttribute ? "&quot;" : "\"";  break;
+        case '\t': m_buffer += aAttribute ? "&#x9;" : "\t";   break;
+        case '\n': m_buffer += aAttribute ? "&#xA;" : "\n";   break;
+        default:   m_buffer += *c;       break;
+        }
+    }
+}
+
+
+void XML_STREAM_WRITER::flush()
+{
+    m_out->Print( 0, "%s", m_buffer.c_str() );
+    m_buffer.clear();
 }
 
 
-static bool sortPinsByNumber( LIB_PIN* aPin1, LIB_PIN* aPin2 )
+static bool sortPinsByNumber( const LIB_PIN* aPin1, const LIB_PIN* aPin2 )
 {
     // return "lhs < rhs"
     return UTIL::RefDesStringCompare( aPin1->GetShownNumber(), aPin2->GetShownNumber() ) < 0;
@@ -33,13 +33,14 @@
 #include <sch_edit_frame.h>
 
 class CONNECTION_GRAPH;
+class OUTPUTFORMATTER;
 class SYMBOL_LIB_TABLE;
 class XNODE;
 
 #define GENERIC_INTERMEDIATE_NETLIST_EXT wxT( "xml" )
 
 /**
- * A set of bits which control the totality of the tree built by makeRoot()
+ * A set of bits which control the totality of the tree built by writeRoot()
  */
 enum GNL_T
 {
@@ -53,6 +54,121 @@ enum GNL_T
 };
 
 
+/**
+ * Receive the elements of a netlist, in document order, as the exporter walks the schematic.
+ *
+ * The attributes of an element must be added before its children.
+ */
+class XML_ELEMENT_SINK
+{
+public:
+    virtual ~XML_ELEMENT_SINK() {}
+
+    virtual void StartElement( const wxString& aName ) = 0;
+
+    virtual void AddAttribute( const wxString& aName, const wxString& aValue ) = 0;
+
+    /**
+     * Add \a aText to the content of the current element, unless empty.
+     */
+    virtual void AddText( const wxString& aText ) = 0;
+
+    virtual void EndElement() = 0;
+
+    /**
+     * Add an element without attributes, with \a aText as content unless empty.
+     */
+    void AddElement( const wxString& aName, const wxString& aText = wxEmptyString )
+    {
+        StartElement( aName );
+        AddText( aText );
+        EndElement();
+    }
+};
+
+
+/**
+ * Build the elements of a netlist into a tree of XNODEs, for the formats derived from it.
+ */
+class XNODE_TREE_BUILDER : public XML_ELEMENT_SINK
+{
+public:
+    XNODE_TREE_BUILDER() :
+            m_root( nullptr )
+    {}
+
+    ~XNODE_TREE_BUILDER();
+
+    void StartElement( const wxString& aName ) override;
+
+    void AddAttribute( const wxString& aName, const wxString& aValue ) override;
+
+    void AddText( const wxString& aText ) override;
+
+    void EndElement() override;
+
+    /**
+     * @return the root element, now owned by the caller.
+     */
+    XNODE* ReleaseRoot();
+
+private:
+    void addChild( XNODE* aNode );
+
+    XNODE*                                 m_root;
+    std::vector<std::pair<XNODE*, XNODE*>> m_stack;   ///< Open elements, and their last child
+};
+
+
+/**
+ * Write the elements of a netlist as an XML document, as they come.
+ *
+ * The output is the same as the one of wxXmlDocument::Save() with an indentation of 2, without
+ * building the document first.  It matches the escaping of wxWidgets 3.1 and later only, so
+ * FormatXML() doesn't use it with older versions.
+ */
+class XML_STREAM_WRITER : public XML_ELEMENT_SINK
+{
+public:
+    /**
+     * Write the XML declaration to \a aOut, which receives the document.
+     */
+    XML_STREAM_WRITER( OUTPUTFORMATTER* aOut );
+
+    ~XML_STREAM_WRITER();
+
+    void StartElement( const wxString& aName ) override;
+
+    void AddAttribute( const wxString& aName, const wxString& aValue ) override;
+
+    void AddText( const wxString& aText ) override;
+
+    void EndElement() override;
+
+private:
+    struct ELEMENT
+    {
+        wxString m_Name;
+        bool     m_HasChildren;
+        bool     m_LastChildIsText;
+    };
+
+    /// Close the start tag of the current element, which gets a child
+    void startChild( bool aIsText );
+
+    void indent( size_t aDepth );
+
+    void escape( const wxString& aText, bool aAttribute );
+
+    void flush();
+
+    OUTPUTFORMATTER*     m_out;
+    std::string          m_buffer;
+    std::vector<ELEMENT> m_stack;
+    bool                 m_startTagOpen;
+};
+
+
 /**
  * Generate a generic XML based netlist file.
  *
@@ -77,59 +193,60 @@ public:
      */
     bool WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions ) override;
 
-#define GNL_ALL     ( GNL_LIBRARIES | GNL_SYMBOLS | GNL_PARTS | GNL_HEADER | GNL_NETS )
-
-protected:
-   /**
-     * A convenience function that creates a new XNODE with an optional textual child.
-     * It also provides some insulation from a possible change in XML library.
+    /**
+     * Write the XML netlist to \a aOut as the schematic is walked, without building its tree
+     * with wxWidgets 3.1 and later.
      *
-     * @param aName is the name to associate with a new node of type wxXML_ELEMENT_NODE.
-     * @param aTextualContent is optional, and if given is the text to include in a child
-     *   of the returned node, and has type wxXML_TEXT_NODE.
+     * @param aOut is the formatter to write to.
+     * @param aCtl a bitset or-ed together from GNL_ENUM values.
+     * @throw IO_ERROR if a system error writing the output, such as a full disk.
      */
-    XNODE* node( const wxString& aName, const wxString& aTextualContent = wxEmptyString );
+    void FormatXML( OUTPUTFORMATTER* aOut, unsigned aCtl );
+
+#define GNL_ALL     ( GNL_LIBRARIES | GNL_SYMBOLS | GNL_PARTS | GNL_HEADER | GNL_NETS )
 
+protected:
     /**
      * Build the entire document tree for the generic export.  This is factored
-     * out here so we can write the tree in either S-expression file format
-     * or in XML if we put the tree built here into a wxXmlDocument.
+     * out here so we can write the tree in S-expression file format.
      * @param aCtl a bitset or-ed together from GNL_ENUM values
      * @return the root nodes
      */
     XNODE* makeRoot( unsigned aCtl = GNL_ALL );
 
     /**
-     * @return a sub-tree holding all the schematic symbols.
+     * Walk the schematic to give the entire document to \a aSink.
+     * @param aCtl a bitset or-ed together from GNL_ENUM values
+     */
+    void writeRoot( XML_ELEMENT_SINK& aSink, unsigned aCtl );
+
+    /**
+     * Write the element holding all the schematic symbols.
      */
-    XNODE* makeSymbols( unsigned aCtl );
+    void writeSymbols( XML_ELEMENT_SINK& aSink, unsigned aCtl );
 
     /**
-     * Fill out a project "design" header into an XML node.
-     * @return the design header
+     * Write a project "design" header element.
      */
-    XNODE* makeDesignHeader();
+    void writeDesignHeader( XML_ELEMENT_SINK& aSink );
 
     /**
-     * Fill out an XML node with the unique library parts and returns it.
-     * @return the library parts nodes
+     * Write the element holding the unique library parts.
      */
-    XNODE* makeLibParts();
+    void writeLibParts( XML_ELEMENT_SINK& aSink );
 
     /**
-     * Fill out an XML node with a list of nets and returns it.
-     * @return the list of nets nodes
+     * Write the element holding the list of nets.
      */
-    XNODE* makeListOfNets( unsigned aCtl );
+    void writeListOfNets( XML_ELEMENT_SINK& aSink, unsigned aCtl );
 
     /**
-     * Fill out an XML node with a list of used libraries and returns it.
-     * Must have called makeGenericLibParts() before this function.
-     * @return the library nodes
+     * Write the element holding the list of used libraries.
+     * Must have called writeLibParts() before this function.
      */
-    XNODE* makeLibraries();
+    void writeLibraries( XML_ELEMENT_SINK& aSink );
 
-    void addSymbolFields( XNODE* aNode, SCH_SYMBOL* aSymbol, SCH_SHEET_PATH* aSheet );
+    void addSymbolFields( XML_ELEMENT_SINK& aSink, SCH_SYMBOL* aSymbol, SCH_SHEET_PATH* aSheet );
 
     bool                m_resolveTextVars;   // Export textVar references resolved
 
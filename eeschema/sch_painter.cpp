@@ -421,14 +421,8 @@ void SCH_PAINTER::draw( const LIB_SYMBOL *aSymbol, int aLayer, bool aDrawFields,
     if( !aConvert )
         aConvert = m_schSettings.m_ShowConvert;
 
-    std::unique_ptr< LIB_SYMBOL > tmpSymbol;
-    const LIB_SYMBOL* drawnSymbol = aSymbol;
-
-    if( aSymbol->IsAlias() )
-    {
-        tmpSymbol = aSymbol->Flatten();
-        drawnSymbol = tmpSymbol.get();
-    }
+    // Derived symbols are flattened once, and again only when they or their parent change
+    const LIB_SYMBOL* drawnSymbol = aSymbol->GetFlattened();
 
     for( const LIB_ITEM& item : drawnSymbol->GetDrawItems() )
     {
@@ -1445,9 +1439,9 @@ void SCH_PAINTER::draw( SCH_SYMBOL* aSymbol, int aLayer )
     int convert = aSymbol->GetConvert();
 
     // Use dummy symbol if the actual couldn't be found (or couldn't be locked).
-    LIB_SYMBOL* originalSymbol = aSymbol->GetLibSymbolRef() ?
-                                 aSymbol->GetLibSymbolRef().get() : dummy();
-    LIB_PINS  originalPins;
+    const LIB_SYMBOL* originalSymbol = aSymbol->GetLibSymbolRef() ?
+                                       aSymbol->GetLibSymbolRef().get() : dummy();
+    std::vector<const LIB_PIN*> originalPins;
     originalSymbol->GetPins( originalPins, unit, convert );
 
     // Copy the source so we can re-orient and translate it.
@@ -1652,11 +1652,13 @@ SCH_SYMBOL* CADSTAR_SCH_ARCHIVE_LOADER::loadSchematicSymbol( const SYMBOL& aCads
 
         std::map<wxString, LIB_PIN*> pinNumToLibPinMap;
 
+        // The pin numbers are only swapped for this symbol, not in a shared library symbol
+        LIB_SYMBOL* libSymbol = symbol->GetUniqueLibSymbol();
+
         for( auto& term : termNumMap )
         {
             wxString pinNum = term.second;
-            pinNumToLibPinMap.insert( { pinNum,
-                    symbol->GetLibSymbolRef()->GetPin( term.second ) } );
+            pinNumToLibPinMap.insert( { pinNum, libSymbol->GetPin( term.second ) } );
         }
 
         auto replacePinNumber = [&]( wxString aOldPinNum, wxString aNewPinNum )
@@ -1359,7 +1359,7 @@ void SCH_EAGLE_PLUGIN::loadInstance( wxXmlNode* aInstanceNode )
 
     symbol->SetLibSymbol( new LIB_SYMBOL( *libSymbol ) );
 
-    std::vector<LIB_PIN*> pins;
+    std::vector<const LIB_PIN*> pins;
     symbol->GetLibPins( pins );
 
     for( const auto& pin : pins )
@@ -2831,9 +2831,9 @@ void SCH_EAGLE_PLUGIN::addImplicitConnections( SCH_SYMBOL* aSymbol, SCH_SCREEN*
     if( aSymbol->GetLibSymbolRef()->IsPower() )
         return;
 
-    int                   unit      = aSymbol->GetUnit();
-    const wxString        reference = aSymbol->GetField( REFERENCE_FIELD )->GetText();
-    std::vector<LIB_PIN*> pins;
+    int                         unit      = aSymbol->GetUnit();
+    const wxString              reference = aSymbol->GetField( REFERENCE_FIELD )->GetText();
+    std::vector<const LIB_PIN*> pins;
     aSymbol->GetLibSymbolRef()->GetPins( pins );
     std::set<int> missingUnits;
 
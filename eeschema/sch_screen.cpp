@@ -154,7 +154,10 @@ void SCH_SCREEN::Append( SCH_ITEM* aItem )
 
             if( symbol->GetLibSymbolRef() )
             {
-                symbol->GetLibSymbolRef()->GetDrawItems().sort();
+                // A shared library symbol was sorted when it was linked and must not be copied
+                // here, so only a library symbol this symbol owns alone is sorted.
+                if( symbol->GetLibSymbolRef().use_count() == 1 )
+                    symbol->GetUniqueLibSymbol()->GetDrawItems().sort();
 
                 auto it = m_libSymbols.find( symbol->GetSchSymbolLibraryName() );
 
@@ -540,10 +543,13 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
     wxCHECK_RET( Schematic(), "Cannot call SCH_SCREEN::UpdateSymbolLinks with no SCHEMATIC" );
 
     wxString msg;
-    std::unique_ptr< LIB_SYMBOL > libSymbol;
+    std::shared_ptr< LIB_SYMBOL > libSymbol;
     std::vector<SCH_SYMBOL*> symbols;
     SYMBOL_LIB_TABLE* libs = Schematic()->Prj().SchSymbolLibTable();
 
+    // The flattened library symbols, each shared by all the symbols linked to it
+    std::map<wxString, std::shared_ptr< LIB_SYMBOL >> linkedSymbols;
+
     // This will be a nullptr if an s-expression schematic is loaded.
     SYMBOL_LIBS* legacyLibs = Schematic()->Prj().SchLibs();
 
@@ -577,8 +583,17 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
                 aReporter->ReportTail( msg, RPT_SEVERITY_INFO );
             }
 
-            // Internal library symbols are already flattened so just make a copy.
-            symbol->SetLibSymbol( new LIB_SYMBOL( *it->second ) );
+            // Internal library symbols are already flattened so just make a copy, once for
+            // all the symbols using them.
+            std::shared_ptr< LIB_SYMBOL >& linkedSymbol = linkedSymbols[it->first];
+
+            if( !linkedSymbol )
+            {
+                linkedSymbol = std::make_shared<LIB_SYMBOL>( *it->second );
+                linkedSymbol->GetDrawItems().sort();
+            }
+
+            symbol->SetLibSymbol( linkedSymbol );
             continue;
         }
 
@@ -656,10 +671,14 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
             // We want a full symbol not just the top level child symbol.
             libSymbol = tmp->Flatten();
             libSymbol->SetParent();
+            libSymbol->GetDrawItems().sort();
 
             m_libSymbols.insert( { symbol->GetSchSymbolLibraryName(),
                                    new LIB_SYMBOL( *libSymbol.get() ) } );
 
+            // The next symbols of this name share it
+            linkedSymbols[symbol->GetSchSymbolLibraryName()] = libSymbol;
+
             if( aReporter )
             {
                 msg.Printf( _( "Setting schematic symbol '%s %s' library identifier to '%s'." ),
@@ -680,7 +699,7 @@ void SCH_SCREEN::UpdateSymbolLinks( REPORTER* aReporter )
             }
         }
 
-        symbol->SetLibSymbol( libSymbol.release() );
+        symbol->SetLibSymbol( libSymbol );
     }
 
     // Changing the symbol may adjust the bbox of the symbol.  This re-inserts the
@@ -694,6 +713,9 @@ void SCH_SCREEN::UpdateLocalLibSymbolLinks()
 {
     std::vector<SCH_SYMBOL*> symbols;
 
+    // The flattened library symbols, each shared by all the symbols linked to it
+    std::map<wxString, std::shared_ptr< LIB_SYMBOL >> linkedSymbols;
+
     for( SCH_ITEM* item : Items().OfType( SCH_SYMBOL_T ) )
         symbols.push_back( static_cast<SCH_SYMBOL*>( item ) );
 
@@ -704,10 +726,19 @@ void SCH_SCREEN::UpdateLocalLibSymbolLinks()
 
         auto it = m_libSymbols.find( symbol->GetSchSymbolLibraryName() );
 
-        LIB_SYMBOL* libSymbol = nullptr;
+        std::shared_ptr< LIB_SYMBOL > libSymbol;
 
         if( it != m_libSymbols.end() )
-            libSymbol = new LIB_SYMBOL( *it->second );
+        {
+            libSymbol = linkedSymbols[it->first];
+
+            if( !libSymbol )
+            {
+                libSymbol = std::make_shared<LIB_SYMBOL>( *it->second );
+                libSymbol->GetDrawItems().sort();
+                linkedSymbols[it->first] = libSymbol;
+            }
+        }
 
         symbol->SetLibSymbol( libSymbol );
 
@@ -829,11 +860,11 @@ void SCH_SCREEN::ClearDrawingState()
 }
 
 
-LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_SYMBOL** aSymbol,
-                             bool aEndPointOnly ) const
+const LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_SYMBOL** aSymbol,
+                                   bool aEndPointOnly ) const
 {
-    SCH_SYMBOL*  candidate = NULL;
-    LIB_PIN*     pin = NULL;
+    SCH_SYMBOL*     candidate = NULL;
+    const LIB_PIN*  pin = NULL;
 
     for( SCH_ITEM* item : Items().Overlapping( SCH_SYMBOL_T, aPosition ) )
     {
@@ -846,20 +877,18 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_SYMBOL** aSymbol,
             if( !candidate->GetLibSymbolRef() )
                 continue;
 
-            for( pin = candidate->GetLibSymbolRef()->GetNextPin(); pin;
-                 pin = candidate->GetLibSymbolRef()->GetNextPin( pin ) )
-            {
-                // Skip items not used for this part.
-                if( candidate->GetUnit() && pin->GetUnit() &&
-                    ( pin->GetUnit() != candidate->GetUnit() ) )
-                    continue;
+            // Only the pins used by this part
+            std::vector<const LIB_PIN*> pins;
+            candidate->GetLibSymbolRef()->GetPins( pins, candidate->GetUnit(),
+                                                   candidate->GetConvert() );
 
-                if( candidate->GetConvert() && pin->GetConvert() &&
-                    ( pin->GetConvert() != candidate->GetConvert() ) )
-                    continue;
-
-                if( candidate->GetPinPhysicalPosition( pin ) == aPosition )
+            for( const LIB_PIN* candidatePin : pins )
+            {
+                if( candidate->GetPinPhysicalPosition( candidatePin ) == aPosition )
+                {
+                    pin = candidatePin;
                     break;
+                }
             }
 
             if( pin )
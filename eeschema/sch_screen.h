@@ -331,8 +331,8 @@ public:
      *                      point of the pin.
      * @return The pin item if found, otherwise NULL.
      */
-    LIB_PIN* GetPin( const wxPoint& aPosition, SCH_SYMBOL** aSymbol = nullptr,
-                     bool aEndPointOnly = false ) const;
+    const LIB_PIN* GetPin( const wxPoint& aPosition, SCH_SYMBOL** aSymbol = nullptr,
+                           bool aEndPointOnly = false ) const;
 
     /**
      * Test the screen if \a aPosition is a sheet label object.
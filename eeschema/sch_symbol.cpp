@@ -124,7 +124,7 @@ SCH_SYMBOL::SCH_SYMBOL( const LIB_SYMBOL& aSymbol, const LIB_ID& aLibId,
                   true,   /* reset ref */
                   true    /* reset other fields */ );
 
-    m_prefix = UTIL::GetRefDesPrefix( m_part->GetReferenceField().GetText() );
+    m_prefix = UTIL::GetRefDesPrefix( m_part->GetFieldById( REFERENCE_FIELD )->GetText() );
 
     if( aSheet )
         SetRef( aSheet, UTIL::GetRefDesUnannotated( m_prefix ) );
@@ -162,8 +162,9 @@ SCH_SYMBOL::SCH_SYMBOL( const SCH_SYMBOL& aSymbol ) :
     m_inBom       = aSymbol.m_inBom;
     m_onBoard     = aSymbol.m_onBoard;
 
-    if( aSymbol.m_part )
-        SetLibSymbol( new LIB_SYMBOL( *aSymbol.m_part.get() ) );
+    // The library symbol is never modified in place, so the copy can share it
+    m_part = aSymbol.m_part;
+    UpdatePins();
 
     const_cast<KIID&>( m_Uuid ) = aSymbol.m_Uuid;
 
@@ -253,6 +254,34 @@ void SCH_SYMBOL::SetLibSymbol( LIB_SYMBOL* aLibSymbol )
 }
 
 
+void SCH_SYMBOL::SetLibSymbol( const std::shared_ptr< LIB_SYMBOL >& aLibSymbol )
+{
+    m_part = aLibSymbol;
+
+    wxCHECK2( ( m_part == nullptr ) || ( m_part->IsRoot() ), m_part.reset() );
+
+    UpdatePins();
+}
+
+
+LIB_SYMBOL* SCH_SYMBOL::GetUniqueLibSymbol()
+{
+    if( m_part && m_part.use_count() > 1 )
+    {
+        std::shared_ptr< LIB_SYMBOL > copy = std::make_shared<LIB_SYMBOL>( *m_part );
+        m_part = copy;
+
+        // The pins must point to the pins of the copy
+        UpdatePins();
+
+        return copy.get();
+    }
+
+    // Not shared with any other schematic symbol, so this one is free to modify it
+    return libSymbol();
+}
+
+
 wxString SCH_SYMBOL::GetDescription() const
 {
     if( m_part )
@@ -265,7 +294,7 @@ wxString SCH_SYMBOL::GetDescription() const
 wxString SCH_SYMBOL::GetDatasheet() const
 {
     if( m_part )
-        return m_part->GetDatasheetField().GetText();
+        return m_part->GetFieldById( DATASHEET_FIELD )->GetText();
 
     return wxEmptyString;
 }
@@ -292,7 +321,9 @@ void SCH_SYMBOL::UpdatePins()
 
     unsigned i = 0;
 
-    for( LIB_PIN* libPin = m_part->GetNextPin(); libPin; libPin = m_part->GetNextPin( libPin ) )
+    LIB_SYMBOL* part = libSymbol();
+
+    for( LIB_PIN* libPin = part->GetNextPin(); libPin; libPin = part->GetNextPin( libPin ) )
     {
         wxASSERT( libPin->Type() == LIB_PIN_T );
 
@@ -375,7 +406,7 @@ void SCH_SYMBOL::Print( const RENDER_SETTINGS* aSettings, const wxPoint& aOffset
 
     if( m_part )
     {
-        m_part->Print( aSettings, m_pos + aOffset, m_unit, m_convert, opts );
+        libSymbol()->Print( aSettings, m_pos + aOffset, m_unit, m_convert, opts );
     }
     else    // Use dummy() part if the actual cannot be found.
     {
@@ -752,7 +783,7 @@ void SCH_SYMBOL::UpdateFields( const SCH_SHEET_PATH* aPath, bool aUpdateStyle, b
         wxString                symbolName;
         std::vector<LIB_FIELD*> fields;
 
-        m_part->GetFields( fields );
+        libSymbol()->GetFields( fields );
 
         for( const LIB_FIELD* libField : fields )
         {
@@ -784,7 +815,7 @@ void SCH_SYMBOL::UpdateFields( const SCH_SHEET_PATH* aPath, bool aUpdateStyle, b
             if( id == REFERENCE_FIELD && aPath )
             {
                 if( aResetOtherFields )
-                    SetRef( aPath, m_part->GetReferenceField().GetText() );
+                    SetRef( aPath, m_part->GetFieldById( REFERENCE_FIELD )->GetText() );
                 else if( aUpdateRef )
                     SetRef( aPath, libField->GetText() );
             }
@@ -839,14 +870,14 @@ SCH_PIN* SCH_SYMBOL::GetPin( const wxString& aNumber ) const
 }
 
 
-void SCH_SYMBOL::GetLibPins( std::vector<LIB_PIN*>& aPinsList ) const
+void SCH_SYMBOL::GetLibPins( std::vector<const LIB_PIN*>& aPinsList ) const
 {
     if( m_part )
         m_part->GetPins( aPinsList, m_unit, m_convert );
 }
 
 
-SCH_PIN* SCH_SYMBOL::GetPin( LIB_PIN* aLibPin )
+SCH_PIN* SCH_SYMBOL::GetPin( const LIB_PIN* aLibPin )
 {
     wxASSERT( m_pinMap.count( aLibPin ) );
     return m_pins[ m_pinMap.at( aLibPin ) ].get();
@@ -887,10 +918,8 @@ void SCH_SYMBOL::SwapData( SCH_ITEM* aItem )
 
     std::swap( m_lib_id, symbol->m_lib_id );
 
-    LIB_SYMBOL* libSymbol = symbol->m_part.release();
-    symbol->m_part.reset( m_part.release() );
+    std::swap( m_part, symbol->m_part );
     symbol->UpdatePins();
-    m_part.reset( libSymbol );
     UpdatePins();
 
     std::swap( m_pos, symbol->m_pos );
@@ -1599,7 +1628,7 @@ LIB_ITEM* SCH_SYMBOL::GetDrawItem( const wxPoint& aPosition, KICAD_T aType )
         // Calculate the position relative to the symbol.
         wxPoint libPosition = aPosition - m_pos;
 
-        return m_part->LocateDrawItem( m_unit, m_convert, aType, libPosition, m_transform );
+        return libSymbol()->LocateDrawItem( m_unit, m_convert, aType, libPosition, m_transform );
     }
 
     return NULL;
@@ -1745,9 +1774,7 @@ SCH_SYMBOL& SCH_SYMBOL::operator=( const SCH_ITEM& aItem )
 
         m_lib_id    = c->m_lib_id;
 
-        LIB_SYMBOL* libSymbol = c->m_part ? new LIB_SYMBOL( *c->m_part.get() ) : nullptr;
-
-        m_part.reset( libSymbol );
+        m_part      = c->m_part;
         m_pos       = c->m_pos;
         m_unit      = c->m_unit;
         m_convert   = c->m_convert;
@@ -1837,7 +1864,7 @@ void SCH_SYMBOL::Plot( PLOTTER* aPlotter ) const
         TRANSFORM temp = GetTransform();
         aPlotter->StartBlock( nullptr );
 
-        m_part->Plot( aPlotter, GetUnit(), GetConvert(), m_pos, temp );
+        libSymbol()->Plot( aPlotter, GetUnit(), GetConvert(), m_pos, temp );
 
         for( SCH_FIELD field : m_fields )
             field.Plot( aPlotter );
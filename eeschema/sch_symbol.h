@@ -161,8 +161,18 @@ public:
     wxString GetSchSymbolLibraryName() const;
     bool UseLibIdLookup() const { return m_schLibSymbolName.IsEmpty(); }
 
-    std::unique_ptr< LIB_SYMBOL >& GetLibSymbolRef() { return m_part; }
-    const std::unique_ptr< LIB_SYMBOL >& GetLibSymbolRef() const { return m_part; }
+    /**
+     * The library symbol may be shared with other schematic symbols of the same library symbol,
+     * so it is read only.  Use GetUniqueLibSymbol() to change the library symbol of this
+     * schematic symbol only.
+     */
+    const std::shared_ptr< const LIB_SYMBOL >& GetLibSymbolRef() const { return m_part; }
+
+    /**
+     * Return the library symbol of this schematic symbol, first making a copy of it if it is
+     * shared with other schematic symbols, so that it can be modified.
+     */
+    LIB_SYMBOL* GetUniqueLibSymbol();
 
     /**
      * Set this schematic symbol library symbol reference to \a aLibSymbol
@@ -182,6 +192,12 @@ public:
      */
     void SetLibSymbol( LIB_SYMBOL* aLibSymbol );
 
+    /**
+     * Set this schematic symbol library symbol reference to \a aLibSymbol, which may be shared
+     * with other schematic symbols.  It must not be modified afterwards.
+     */
+    void SetLibSymbol( const std::shared_ptr< LIB_SYMBOL >& aLibSymbol );
+
     /**
      * Return information about the aliased parts
      */
@@ -450,9 +466,9 @@ public:
      *
      * @param aPinsList is the list to populate with all of the pins.
      */
-    void GetLibPins( std::vector<LIB_PIN*>& aPinsList ) const;
+    void GetLibPins( std::vector<const LIB_PIN*>& aPinsList ) const;
 
-    SCH_PIN* GetPin( LIB_PIN* aLibPin );
+    SCH_PIN* GetPin( const LIB_PIN* aLibPin );
 
     /**
      * Retrieve a list of the SCH_PINs for the given sheet path.
@@ -667,6 +683,12 @@ public:
 private:
     bool doIsConnected( const wxPoint& aPosition ) const override;
 
+    /**
+     * The library symbol for the read only uses of the #LIB_SYMBOL methods which are not const.
+     * It must not be modified as it may be shared with other schematic symbols.
+     */
+    LIB_SYMBOL* libSymbol() const { return const_cast<LIB_SYMBOL*>( m_part.get() ); }
+
     void Init( const wxPoint& pos = wxPoint( 0, 0 ) );
 
     wxPoint     m_pos;
@@ -692,10 +714,11 @@ private:
     TRANSFORM   m_transform;    ///< The rotation/mirror transformation matrix.
     SCH_FIELDS  m_fields;       ///< Variable length list of fields.
 
-    std::unique_ptr< LIB_SYMBOL >          m_part;    // a flattened copy of the LIB_SYMBOL from
-                                                      // the PROJECT's libraries.
-    std::vector<std::unique_ptr<SCH_PIN>>  m_pins;    // a SCH_PIN for every LIB_PIN (all units)
-    std::unordered_map<LIB_PIN*, unsigned> m_pinMap;  // library pin pointer to SCH_PIN's index
+    std::shared_ptr< const LIB_SYMBOL >          m_part;   // a flattened copy of the LIB_SYMBOL
+                                                           // from the PROJECT's libraries, shared
+                                                           // by the symbols linked to the same one.
+    std::vector<std::unique_ptr<SCH_PIN>>        m_pins;   // a SCH_PIN for every LIB_PIN
+    std::unordered_map<const LIB_PIN*, unsigned> m_pinMap; // library pin pointer to SCH_PIN's index
 
     bool        m_isInNetlist;  ///< True if the symbol should appear in the netlist
     bool        m_inBom;        ///< True to include in bill of materials export.
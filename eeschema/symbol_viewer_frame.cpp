@@ -221,7 +221,12 @@ SYMBOL_VIEWER_FRAME::~SYMBOL_VIEWER_FRAME()
         m_toolManager->ShutdownAllTools();
 
     if( m_previewItem )
+    {
         GetCanvas()->GetView()->Remove( m_previewItem );
+
+        // The library symbol outlives the viewer
+        m_previewItem->ClearFlattened();
+    }
 }
 
 
@@ -342,6 +347,11 @@ void SYMBOL_VIEWER_FRAME::updatePreviewSymbol()
     if( m_previewItem )
     {
         view->Remove( m_previewItem );
+
+        // Only the shown symbol keeps the flattened copy it is drawn from
+        if( m_previewItem != symbol )
+            m_previewItem->ClearFlattened();
+
         m_previewItem = nullptr;
     }
 
@@ -170,6 +170,24 @@ public:
      */
     bool m_ShowPcbnewExportNetlist;
 
+    /**
+     * Check the copper clearances, track widths and via diameters of the items touched by each
+     * board edit as soon as it is committed, updating the DRC markers.
+     */
+    bool m_IncrementalDRC;
+
+    /**
+     * Keep the results of the copper clearance checks in the project between DRC runs, and
+     * only check again the pairs of items of which something changed.
+     */
+    bool m_DRCResultCache;
+
+    /**
+     * Measure where the time of each DRC run goes, and write it to drc-profile.json in the
+     * project directory.
+     */
+    bool m_DRCProfile;
+
 private:
     ADVANCED_CFG();
 
@@ -33,6 +33,10 @@
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/geometry_utils.h>
 
+#ifdef KICAD_ITEM_POOL
+#include <item_pool.h>
+#endif
+
 class BOARD;
 class BOARD_ITEM_CONTAINER;
 class SHAPE_POLY_SET;
@@ -87,6 +91,17 @@ public:
     {
     }
 
+#ifdef KICAD_ITEM_POOL
+    /*
+     * Board items are created and destroyed by the hundred thousand when loading boards and
+     * footprint libraries, so they come from the item pools.  The destructor is virtual, so
+     * delete passes the size of the most derived class, which is the size that was allocated.
+     */
+    static void* operator new( size_t aSize ) { return ITEM_POOL::Allocate( aSize ); }
+
+    static void operator delete( void* aBlock, size_t aSize ) { ITEM_POOL::Free( aBlock, aSize ); }
+#endif
+
     void SetParentGroup( PCB_GROUP* aGroup ) { m_group = aGroup; }
     PCB_GROUP* GetParentGroup() const { return m_group; }
 
@@ -86,10 +86,12 @@ public:
      * @param aKeywordTable is an array of KEYWORDS holding \a aKeywordCount.  This
      *  token table need not contain the lexer separators such as '(' ')', etc.
      * @param aKeywordCount is the count of tokens in aKeywordTable.
+     * @param aKeywordMap is a hashtable of the keywords in aKeywordTable, or nullptr to have
+     *  one built for this lexer.
      * @param aFile is an open file, which will be closed when this is destructed.
      * @param aFileName is the name of the file
      */
-    DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
+    DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount, const KEYWORD_MAP* aKeywordMap,
               FILE* aFile, const wxString& aFileName );
 
     /**
@@ -98,10 +100,12 @@ public:
      * @param aKeywordTable is an array of KEYWORDS holding \a aKeywordCount.  This
      *  token table need not contain the lexer separators such as '(' ')', etc.
      * @param aKeywordCount is the count of tokens in aKeywordTable.
+     * @param aKeywordMap is a hashtable of the keywords in aKeywordTable, or nullptr to have
+     *  one built for this lexer.
      * @param aSExpression is text to feed through a STRING_LINE_READER
      * @param aSource is a description of aSExpression, used for error reporting.
      */
-    DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
+    DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount, const KEYWORD_MAP* aKeywordMap,
               const std::string& aSExpression, const wxString& aSource = wxEmptyString );
 
     /**
@@ -123,10 +127,12 @@ public:
      * @param aKeywordTable is an array of #KEYWORDS holding \a aKeywordCount.  This
      *  token table need not contain the lexer separators such as '(' ')', etc.
      * @param aKeywordCount is the count of tokens in aKeywordTable.
+     * @param aKeywordMap is a hashtable of the keywords in aKeywordTable, or nullptr to have
+     *  one built for this lexer.
      * @param aLineReader is any subclassed instance of LINE_READER, such as
      *  #STRING_LINE_READER or #FILE_LINE_READER.  No ownership is taken.
      */
-    DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
+    DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount, const KEYWORD_MAP* aKeywordMap,
               LINE_READER* aLineReader = NULL );
 
     virtual ~DSNLEXER();
@@ -245,7 +251,7 @@ public:
      */
     int GetCurStrAsToken() const
     {
-        return findToken( curText );
+        return findToken( curText.c_str() );
     }
 
     /**
@@ -478,7 +484,7 @@ protected:
      * @return with a value from the enum #DSN_T matching the keyword text,
      *         or #DSN_SYMBOL if @a aToken is not in the keywords table.
      */
-    int findToken( const std::string& aToken ) const;
+    int findToken( const char* aToken ) const;
 
     bool isStringTerminator( char cc ) const
     {
@@ -523,7 +529,8 @@ protected:
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
-    KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
+    const KEYWORD_MAP*  keywordsLookup;         ///< fast, specialized "C string" hashtable
+    KEYWORD_MAP         ownKeywordsLookup;      ///< built by init() when none is supplied
 #endif // SWIG
 };
 
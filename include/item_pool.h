@@ -0,0 +1,70 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef ITEM_POOL_H
+#define ITEM_POOL_H
+
+#include <cstddef>
+
+
+/**
+ * Fixed size block pools for small, numerous objects such as board items.
+ *
+ * Loading a board or a footprint library creates hundreds of thousands of items of a handful
+ * of sizes, and closing it frees them all again.  Blocks are carved out of large chunks, one
+ * free list per 16 byte size class, so that allocating and freeing are a few pointer moves and
+ * the items of a board end up next to each other in memory.  Freed blocks are reused by later
+ * allocations of the same size class; chunks are kept for the life of the process.
+ *
+ * Requests larger than the biggest size class go straight to the global operator new.
+ *
+ * All the functions are thread safe.
+ */
+class ITEM_POOL
+{
+public:
+    struct STATS
+    {
+        size_t allocations;     ///< blocks handed out since startup
+        size_t frees;           ///< blocks given back since startup
+        size_t bytesInUse;      ///< size of the blocks currently handed out
+        size_t chunkBytes;      ///< memory reserved from the system for the pools
+    };
+
+    /**
+     * @return a block of at least \a aSize bytes, suitably aligned for any type.
+     * @throw std::bad_alloc if the memory is exhausted.
+     */
+    static void* Allocate( size_t aSize );
+
+    /**
+     * Give back a block obtained from Allocate().
+     *
+     * @param aSize must be the size which was passed to Allocate().
+     */
+    static void Free( void* aBlock, size_t aSize );
+
+    static STATS GetStats();
+};
+
+
+#endif // ITEM_POOL_H
@@ -30,6 +30,7 @@
 #include <vector>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 
 #include <math/box2.h>
@@ -116,6 +117,21 @@ public:
      */
     virtual int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
 
+    /**
+     * Find all items that touch or are within the rectangle \a aRect on any layer, whether
+     * the layers and items are visible or not.
+     *
+     * @param aRect area to search for items
+     * @param aResult the items found, each reported once regardless of its layer count.
+     */
+    void QueryAllLayers( const BOX2I& aRect, std::unordered_set<VIEW_ITEM*>& aResult ) const;
+
+    /**
+     * Return true if \a aItem belongs to this view and the bounding box stored for it in the
+     * spatial index is up to date (i.e. it has no pending geometry or layer update).
+     */
+    bool IsBBoxCurrent( const VIEW_ITEM* aItem ) const;
+
     /**
      * Set the item visibility.
      *
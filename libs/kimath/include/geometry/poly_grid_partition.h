@@ -27,6 +27,7 @@
 
 
 #include <algorithm>
+#include <climits>
 #include <functional>
 #include <set>
 #include <unordered_map>
@@ -63,7 +64,7 @@ class POLY_GRID_PARTITION
 public:
     POLY_GRID_PARTITION( const SHAPE_LINE_CHAIN& aPolyOutline, int gridSize );
 
-    int ContainsPoint( const VECTOR2I& aP, int aClearance = 0 );
+    int ContainsPoint( const VECTOR2I& aP, int aClearance = 0 ) const;
 
     const BOX2I& BBox() const
     {
@@ -104,7 +105,7 @@ private:
 
     int containsPoint( const VECTOR2I& aP, bool debug = false ) const;
 
-    bool checkClearance( const VECTOR2I& aP, int aClearance );
+    bool checkClearance( const VECTOR2I& aP, int aClearance ) const;
 
     int rescale_trunc( int aNumerator, int aValue, int aDenominator ) const;
 
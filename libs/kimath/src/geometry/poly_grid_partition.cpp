@@ -31,7 +31,7 @@ POLY_GRID_PARTITION::POLY_GRID_PARTITION( const SHAPE_LINE_CHAIN& aPolyOutline,
 }
 
 
-int POLY_GRID_PARTITION::ContainsPoint( const VECTOR2I& aP, int aClearance ) // const
+int POLY_GRID_PARTITION::ContainsPoint( const VECTOR2I& aP, int aClearance ) const
 {
     if( containsPoint( aP ) )
         return 1;
@@ -119,7 +119,7 @@ int POLY_GRID_PARTITION::containsPoint( const VECTOR2I& aP, bool debug ) const
 }
 
 
-bool POLY_GRID_PARTITION::checkClearance( const VECTOR2I& aP, int aClearance )
+bool POLY_GRID_PARTITION::checkClearance( const VECTOR2I& aP, int aClearance ) const
 {
     int gx0 = poly2gridX( aP.x - aClearance - 1 );
     int gx1 = poly2gridX( aP.x + aClearance + 1 );
@@ -137,7 +137,7 @@ bool POLY_GRID_PARTITION::checkClearance( const VECTOR2I& aP, int aClearance )
             const auto& cell = m_grid[m_gridSize * gy + gx];
             for( auto index : cell )
             {
-                const auto& seg = m_outline.Segment( index );
+                const SEG seg = m_outline.CSegment( index );
 
                 if( seg.SquaredDistance( aP ) <= dist )
                     return true;
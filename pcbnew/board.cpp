@@ -33,6 +33,8 @@
 #include <reporter.h>
 #include <board_commit.h>
 #include <board.h>
+#include <board_outline.h>
+#include <track_columns.h>
 #include <footprint.h>
 #include <pcb_track.h>
 #include <zone.h>
@@ -52,6 +54,7 @@
 #include <ratsnest/ratsnest_data.h>
 #include <tool/selection_conditions.h>
 #include <convert_drawsegment_list_to_polygon.h>
+#include <hash_eda.h>
 #include <wx/log.h>
 
 // This is an odd place for this, but CvPcb won't link if it's in board_item.cpp like I first
@@ -69,7 +72,8 @@ BOARD::BOARD() :
         m_paper( PAGE_INFO::A4 ),
         m_project( nullptr ),
         m_designSettings( new BOARD_DESIGN_SETTINGS( nullptr, "board.design_settings" ) ),
-        m_NetInfo( this )
+        m_NetInfo( this ),
+        m_boardOutlineHash( 0 )
 {
     // we have not loaded a board yet, assume latest until then.
     m_fileFormatVersionAtLoad = LEGACY_BOARD_FILE_VERSION;
@@ -198,6 +202,7 @@ void BOARD::IncrementTimeStamp()
         m_InsideCourtyardCache.clear();
         m_InsideFCourtyardCache.clear();
         m_InsideBCourtyardCache.clear();
+        m_TrackColumns.reset();
     }
 
     m_CopperZoneRTrees.clear();
@@ -648,6 +653,7 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
         else
             m_tracks.push_front( static_cast<PCB_TRACK*>( aBoardItem ) );
 
+        invalidateTrackColumns();
         break;
 
     case PCB_FOOTPRINT_T:
@@ -782,6 +788,7 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem, REMOVE_MODE aRemoveMode )
                                         {
                                             return aItem == aBoardItem;
                                         } ) );
+        invalidateTrackColumns();
         break;
 
     case PCB_DIM_ALIGNED_T:
@@ -1974,9 +1981,75 @@ bool BOARD::NormalizeAreaPolygon( PICKED_ITEMS_LIST * aNewZonesList, ZONE* aCurr
 }
 
 
+size_t BOARD::hashBoardOutlineItems() const
+{
+    size_t hash = hash_val( GetDesignSettings().m_MaxError );
+
+    auto hashShape =
+            [&]( const PCB_SHAPE* aShape )
+            {
+                hash_combine( hash, aShape, static_cast<int>( aShape->GetShape() ),
+                              aShape->GetStart(), aShape->GetEnd(), aShape->GetWidth() );
+
+                switch( aShape->GetShape() )
+                {
+                case PCB_SHAPE_TYPE::ARC:
+                    hash_combine( hash, aShape->GetAngle() );
+                    break;
+
+                case PCB_SHAPE_TYPE::CURVE:
+                    hash_combine( hash, aShape->GetBezControl1(), aShape->GetBezControl2() );
+                    break;
+
+                case PCB_SHAPE_TYPE::POLYGON:
+                    if( FOOTPRINT* parentFP = aShape->GetParentFootprint() )
+                        hash_combine( hash, parentFP->GetPosition(), parentFP->GetOrientation() );
+
+                    for( auto it = aShape->GetPolyShape().CIterate(); it; it++ )
+                        hash_combine( hash, it->x, it->y );
+
+                    break;
+
+                default:
+                    break;
+                }
+            };
+
+    for( BOARD_ITEM* item : m_drawings )
+    {
+        if( item->Type() == PCB_SHAPE_T && item->GetLayer() == Edge_Cuts )
+            hashShape( static_cast<PCB_SHAPE*>( item ) );
+    }
+
+    for( FOOTPRINT* footprint : m_footprints )
+    {
+        for( BOARD_ITEM* item : footprint->GraphicalItems() )
+        {
+            if( item->Type() == PCB_FP_SHAPE_T && item->GetLayer() == Edge_Cuts )
+                hashShape( static_cast<PCB_SHAPE*>( item ) );
+        }
+    }
+
+    return hash;
+}
+
+
 bool BOARD::GetBoardPolygonOutlines( SHAPE_POLY_SET& aOutlines,
                                      OUTLINE_ERROR_HANDLER* aErrorHandler )
 {
+    size_t hash = hashBoardOutlineItems();
+
+    if( !aErrorHandler )
+    {
+        std::unique_lock<std::mutex> cacheLock( m_boardOutlineMutex );
+
+        if( m_boardOutline && m_boardOutlineHash == hash )
+        {
+            aOutlines = m_boardOutline->Polygons();
+            return true;
+        }
+    }
+
     int chainingEpsilon = Millimeter2iu( 0.02 );  // max dist from one endPt to next startPt
 
     bool success = BuildBoardPolygonOutlines( this, aOutlines, GetDesignSettings().m_MaxError,
@@ -1985,10 +2058,64 @@ bool BOARD::GetBoardPolygonOutlines( SHAPE_POLY_SET& aOutlines,
     // Make polygon strictly simple to avoid issues (especially in 3D viewer)
     aOutlines.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
+    // A failed build falls back to bounding boxes which can depend on more than Edge.Cuts, so
+    // only successful builds are cached.
+    std::shared_ptr<const BOARD_OUTLINE> outline;
+
+    if( success )
+        outline = std::make_shared<const BOARD_OUTLINE>( aOutlines );
+
+    std::unique_lock<std::mutex> cacheLock( m_boardOutlineMutex );
+
+    m_boardOutline = outline;
+    m_boardOutlineHash = hash;
+
     return success;
 }
 
 
+std::shared_ptr<const BOARD_OUTLINE> BOARD::GetBoardOutline()
+{
+    size_t hash = hashBoardOutlineItems();
+
+    {
+        std::unique_lock<std::mutex> cacheLock( m_boardOutlineMutex );
+
+        if( m_boardOutline && m_boardOutlineHash == hash )
+            return m_boardOutline;
+    }
+
+    SHAPE_POLY_SET dummy;
+
+    if( !GetBoardPolygonOutlines( dummy ) )
+        return nullptr;
+
+    std::unique_lock<std::mutex> cacheLock( m_boardOutlineMutex );
+
+    return m_boardOutline;
+}
+
+
+std::shared_ptr<const TRACK_COLUMNS> BOARD::GetTrackColumns()
+{
+    std::unique_lock<std::mutex> cacheLock( m_CachesMutex );
+
+    // The size check catches the track list being cleared behind our back
+    if( !m_TrackColumns || m_TrackColumns->Size() != m_tracks.size() )
+        m_TrackColumns = std::make_shared<const TRACK_COLUMNS>( m_tracks );
+
+    return m_TrackColumns;
+}
+
+
+void BOARD::invalidateTrackColumns()
+{
+    std::unique_lock<std::mutex> cacheLock( m_CachesMutex );
+
+    m_TrackColumns.reset();
+}
+
+
 const std::vector<PAD*> BOARD::GetPads() const
 {
     std::vector<PAD*> allPads;
@@ -55,6 +55,8 @@ class MSG_PANEL_ITEM;
 class NETLIST;
 class REPORTER;
 class SHAPE_POLY_SET;
+class BOARD_OUTLINE;
+class TRACK_COLUMNS;
 class CONNECTIVITY_DATA;
 class COMPONENT;
 class PROJECT;
@@ -551,6 +553,9 @@ public:
      * Any closed outline inside the main outline is a hole.  All contours should be closed,
      * i.e. have valid vertices to build a closed polygon.
      *
+     * The result is cached until the Edge.Cuts graphics change.  Callers supplying an error
+     * handler always get a fresh build so that every error is reported.
+     *
      * @param aOutlines is the #SHAPE_POLY_SET to fill in with outlines/holes.
      * @param aErrorHandler is an optional DRC_ITEM error handler.
      * @return true if success, false if a contour is not valid
@@ -558,6 +563,25 @@ public:
     bool GetBoardPolygonOutlines( SHAPE_POLY_SET& aOutlines,
                                   OUTLINE_ERROR_HANDLER* aErrorHandler = nullptr );
 
+    /**
+     * Get the cached board outline, with its triangulation and a point containment index.
+     *
+     * The outline is shared rather than copied, so callers which only read it should prefer
+     * this to GetBoardPolygonOutlines().  It stays valid after the Edge.Cuts graphics change,
+     * but is then out of date.
+     *
+     * @return the outline, or nullptr if the Edge.Cuts graphics don't make a valid outline.
+     */
+    std::shared_ptr<const BOARD_OUTLINE> GetBoardOutline();
+
+    /**
+     * Get the tracks stored column by column, for loops reading many tracks.
+     *
+     * This is a run-time cache like the others on the board: it is rebuilt after tracks are
+     * added or removed and after IncrementTimeStamp(), but doesn't see edits made in between.
+     */
+    std::shared_ptr<const TRACK_COLUMNS> GetTrackColumns();
+
     /**
      * Build a set of polygons which are the outlines of copper items (pads, tracks, vias, texts,
      * zones).
@@ -1094,6 +1118,7 @@ public:
     std::map< std::pair<BOARD_ITEM*, BOARD_ITEM*>, bool > m_InsideAreaCache;
 
     std::map< ZONE*, std::unique_ptr<DRC_RTREE> >         m_CopperZoneRTrees;
+    std::shared_ptr<const TRACK_COLUMNS>                  m_TrackColumns;
 
 private:
     // The default copy constructor & operator= are inadequate,
@@ -1109,6 +1134,13 @@ private:
             ( l->*aFunc )( std::forward<Args>( args )... );
     }
 
+    /**
+     * @return a hash of everything on Edge.Cuts which GetBoardPolygonOutlines() depends on.
+     */
+    size_t hashBoardOutlineItems() const;
+
+    void invalidateTrackColumns();
+
     friend class PCB_EDIT_FRAME;
 
     /// What is this board being used for
@@ -1154,6 +1186,10 @@ private:
     NETINFO_LIST                 m_NetInfo;         // net info list (name, design constraints...
 
     std::vector<BOARD_LISTENER*> m_listeners;
+
+    std::mutex                           m_boardOutlineMutex;
+    std::shared_ptr<const BOARD_OUTLINE> m_boardOutline;    // last successful outline build
+    size_t                               m_boardOutlineHash; // hashBoardOutlineItems() of cache
 };
 
 #endif      // CLASS_BOARD_H_
@@ -363,6 +363,8 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
         if( m_changes.size() > num_changes )
         {
+            std::vector<BOARD_ITEM*> connectivityChanged;
+
             for( size_t i = num_changes; i < m_changes.size(); ++i )
             {
                 COMMIT_LINE& ent = m_changes[i];
@@ -385,7 +387,11 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
                 }
 
                 view->Update( boardItem );
+                connectivityChanged.push_back( boardItem );
             }
+
+            // Listeners care about the nets the connectivity algo assigned too
+            board->OnItemsChanged( connectivityChanged );
         }
     }
 
@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <board_outline.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+/**
+ * POLY_GRID_PARTITION expects its outline in one winding direction, whereas the holes of a
+ * SHAPE_POLY_SET run the other way.
+ */
+static POLY_GRID_PARTITION makePartition( const SHAPE_LINE_CHAIN& aChain, int aGridSize )
+{
+    if( aChain.Area() < 0 )
+        return POLY_GRID_PARTITION( aChain.Reverse(), aGridSize );
+
+    return POLY_GRID_PARTITION( aChain, aGridSize );
+}
+
+
+BOARD_OUTLINE::BOARD_OUTLINE( const SHAPE_POLY_SET& aPolygons ) :
+        m_polygons( aPolygons )
+{
+    m_polygons.CacheTriangulation();
+
+    for( int ii = 0; ii < m_polygons.OutlineCount(); ++ii )
+    {
+        const SHAPE_LINE_CHAIN& outline = m_polygons.COutline( ii );
+
+        m_index.push_back( { makePartition( outline, gridSize( outline ) ), {} } );
+
+        for( int jj = 0; jj < m_polygons.HoleCount( ii ); ++jj )
+        {
+            const SHAPE_LINE_CHAIN& hole = m_polygons.CHole( ii, jj );
+
+            m_index.back().holes.push_back( makePartition( hole, gridSize( hole ) ) );
+        }
+    }
+}
+
+
+int BOARD_OUTLINE::gridSize( const SHAPE_LINE_CHAIN& aChain )
+{
+    int size = (int) std::sqrt( (double) aChain.SegmentCount() );
+
+    return std::min( std::max( size, 16 ), 256 );
+}
+
+
+bool BOARD_OUTLINE::Contains( const VECTOR2I& aPoint ) const
+{
+    for( const INDEXED_POLYGON& polygon : m_index )
+    {
+        if( !polygon.outline.ContainsPoint( aPoint ) )
+            continue;
+
+        bool inHole = false;
+
+        for( const POLY_GRID_PARTITION& hole : polygon.holes )
+        {
+            if( hole.ContainsPoint( aPoint ) )
+            {
+                inHole = true;
+                break;
+            }
+        }
+
+        if( !inHole )
+            return true;
+    }
+
+    return false;
+}
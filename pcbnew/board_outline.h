@@ -0,0 +1,74 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef BOARD_OUTLINE_H
+#define BOARD_OUTLINE_H
+
+#include <vector>
+
+#include <geometry/poly_grid_partition.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * A board outline built from the Edge.Cuts graphics, prepared for repeated use.
+ *
+ * The polygons are triangulated up front, and each outline and hole gets a grid index so that
+ * point containment tests don't have to walk every edge of an outline made of thousands of
+ * arc segments.  A BOARD_OUTLINE is never modified once built, so it can be shared between
+ * threads.
+ */
+class BOARD_OUTLINE
+{
+public:
+    /**
+     * @param aPolygons is a strictly simple outline, as built by GetBoardPolygonOutlines().
+     */
+    BOARD_OUTLINE( const SHAPE_POLY_SET& aPolygons );
+
+    /**
+     * @return the outline polygons, with their triangulation cached.
+     */
+    const SHAPE_POLY_SET& Polygons() const { return m_polygons; }
+
+    /**
+     * Test if a point is on the board.
+     *
+     * Points on the outline itself are on the board; points on the edge of a hole are not.
+     */
+    bool Contains( const VECTOR2I& aPoint ) const;
+
+private:
+    struct INDEXED_POLYGON
+    {
+        POLY_GRID_PARTITION              outline;
+        std::vector<POLY_GRID_PARTITION> holes;
+    };
+
+    /// @return a grid size giving a few edges per cell for @a aChain.
+    static int gridSize( const SHAPE_LINE_CHAIN& aChain );
+
+    SHAPE_POLY_SET               m_polygons;
+    std::vector<INDEXED_POLYGON> m_index;
+};
+
+#endif // BOARD_OUTLINE_H
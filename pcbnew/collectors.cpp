@@ -167,6 +167,11 @@ SEARCH_RESULT GENERAL_COLLECTOR::Inspect( EDA_ITEM* testItem, void* testData )
     PCB_SHAPE*          shape       = nullptr;
     PCB_DIMENSION_BASE* dimension   = nullptr;
 
+    // Items which the view's spatial index puts nowhere near the reference point can't be
+    // hit, so don't bother with the (sometimes expensive) tests below.
+    if( m_view && m_view->IsBBoxCurrent( item ) && !m_viewCandidates.count( item ) )
+        return SEARCH_RESULT::CONTINUE;
+
 #if 0   // debugging
     static int  breakhere = 0;
 
@@ -565,7 +570,8 @@ exit:
 
 
 void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
-                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide )
+                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide,
+                                 const KIGFX::VIEW* aView )
 {
     Empty();        // empty the collection, primary criteria list
     Empty2nd();     // empty the collection, secondary criteria list
@@ -579,8 +585,25 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
+    m_view = aView;
+    m_viewCandidates.clear();
+
+    if( m_view )
+    {
+        // Inspect() hit-tests with up to twice the accuracy (for zone corners)
+        int      margin = 2 * KiROUND( 5 * aGuide.OnePixelInIU() ) + 1;
+        VECTOR2I refPos( aRefPos );
+
+        m_view->QueryAllLayers( BOX2I( refPos - VECTOR2I( margin, margin ),
+                                       VECTOR2I( 2 * margin, 2 * margin ) ),
+                                m_viewCandidates );
+    }
+
     aItem->Visit( m_inspector, NULL, m_scanTypes );
 
+    m_view = nullptr;
+    m_viewCandidates.clear();
+
     // record the length of the primary list before concatenating on to it.
     m_PrimaryLength = m_list.size();
 
@@ -35,6 +35,7 @@
 #include <collector.h>
 #include <layers_id_colors_and_visibility.h>              // LAYER_COUNT, layer defs
 #include <view/view.h>
+#include <unordered_set>
 #include <board_item.h>
 
 
@@ -259,6 +260,17 @@ protected:
      */
     int                         m_PrimaryLength;
 
+    /**
+     * An optional view whose spatial index is used to skip hit testing items which are
+     * nowhere near the reference point.
+     */
+    const KIGFX::VIEW*          m_view;
+
+    /**
+     * The items found in #m_view's spatial index near the reference point.
+     */
+    std::unordered_set<KIGFX::VIEW_ITEM*> m_viewCandidates;
+
 public:
 
     /**
@@ -316,6 +328,7 @@ public:
     {
         m_Guide = nullptr;
         m_PrimaryLength = 0;
+        m_view = nullptr;
         SetScanTypes( AllBoardItems );
     }
 
@@ -364,9 +377,13 @@ public:
      *  collection in "m_list".
      * @param aRefPos A wxPoint to use in hit-testing.
      * @param aGuide The COLLECTORS_GUIDE to use in collecting items.
+     * @param aView An optional view displaying \a aItem.  When given, only items whose
+     *              bounding boxes in the view's spatial index are near \a aRefPos (and items
+     *              the view doesn't index) are hit-tested.  The results are identical.
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
-                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide,
+                  const KIGFX::VIEW* aView = nullptr );
 };
 
 
@@ -423,7 +440,7 @@ public:
         m_ignoreTracks              = false;
         m_ignoreZoneFills           = true;
 
-        m_onePixelInIU              = abs( aView->ToWorld( one, false ).x );
+        m_onePixelInIU              = aView ? abs( aView->ToWorld( one, false ).x ) : 1.0;
     }
 
     /**
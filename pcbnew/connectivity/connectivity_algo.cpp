@@ -580,8 +580,12 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( ZONE* aZone, PCB_LAYER_ID
 
 void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones )
 {
+    // Zones whose fill didn't change keep their items, and the partitions of their outlines
     for( auto& z : aZones )
     {
+        if( !z.m_dirty )
+            continue;
+
         Remove( z.m_zone );
         Add( z.m_zone );
     }
@@ -225,7 +225,8 @@ public:
      * Find the copper islands that are not connected to a net.
      *
      * These are added to the m_islands vector.
-     * N.B. This must be called after aZones has been refreshed.
+     * N.B. This must be called after aZones has been refreshed.  The items of the zones which
+     * are not marked dirty are reused, so their fills must be the ones the items were built from.
      *
      * @param: aZones is the set of zones to search for islands.
      */
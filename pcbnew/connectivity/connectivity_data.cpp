@@ -33,6 +33,7 @@
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
+#include <connectivity/diff_pair_coupling_cache.h>
 #include <connectivity/from_to_cache.h>
 
 #include <ratsnest/ratsnest_data.h>
@@ -42,6 +43,7 @@ CONNECTIVITY_DATA::CONNECTIVITY_DATA()
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_progressReporter = nullptr;
     m_fromToCache.reset( new FROM_TO_CACHE );
+    m_diffPairCouplingCache.reset( new DIFF_PAIR_COUPLING_CACHE );
 }
 
 
@@ -51,6 +53,7 @@ CONNECTIVITY_DATA::CONNECTIVITY_DATA( const std::vector<BOARD_ITEM*>& aItems, bo
     Build( aItems );
     m_progressReporter = nullptr;
     m_fromToCache.reset( new FROM_TO_CACHE );
+    m_diffPairCouplingCache.reset( new DIFF_PAIR_COUPLING_CACHE );
 }
 
 
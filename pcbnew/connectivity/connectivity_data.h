@@ -40,6 +40,7 @@
 #include <zone.h>
 
 class FROM_TO_CACHE;
+class DIFF_PAIR_COUPLING_CACHE;
 class CN_CLUSTER;
 class CN_CONNECTIVITY_ALGO;
 class CN_EDGE;
@@ -68,11 +69,15 @@ struct CN_DISJOINT_NET_ENTRY
 struct CN_ZONE_ISOLATED_ISLAND_LIST
 {
     CN_ZONE_ISOLATED_ISLAND_LIST( ZONE* aZone ) :
-            m_zone( aZone )
+            m_zone( aZone ),
+            m_dirty( true )
     {}
 
     ZONE* m_zone;
 
+    /// False when the fill of the zone is the one its connectivity items were built from
+    bool  m_dirty;
+
     std::map<PCB_LAYER_ID, std::vector<int>> m_islands;
 };
 
@@ -303,6 +308,11 @@ public:
         return m_fromToCache;
     }
 
+    std::shared_ptr<DIFF_PAIR_COUPLING_CACHE> GetDiffPairCouplingCache()
+    {
+        return m_diffPairCouplingCache;
+    }
+
 private:
 
     void    updateRatsnest();
@@ -317,6 +327,7 @@ private:
 
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
     std::shared_ptr<FROM_TO_CACHE> m_fromToCache;
+    std::shared_ptr<DIFF_PAIR_COUPLING_CACHE> m_diffPairCouplingCache;
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
     std::vector<RN_NET*> m_nets;
 
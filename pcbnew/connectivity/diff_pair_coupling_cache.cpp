@@ -0,0 +1,239 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <connectivity/diff_pair_coupling_cache.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <core/optional.h>
+#include <hash_eda.h>
+#include <math/util.h>
+#include <pcb_track.h>
+
+
+static bool commonParallelProjection( SEG p, SEG n, SEG &pClip, SEG& nClip )
+{
+    SEG n_proj_p( p.LineProject( n.A ), p.LineProject( n.B ) );
+
+    int64_t t_a = 0;
+    int64_t t_b = p.TCoef( p.B );
+
+    int64_t tproj_a = p.TCoef( n_proj_p.A );
+    int64_t tproj_b = p.TCoef( n_proj_p.B );
+
+    if( t_b < t_a )
+        std::swap( t_b, t_a );
+
+    if( tproj_b < tproj_a )
+        std::swap( tproj_b, tproj_a );
+
+    if( t_b <= tproj_a )
+        return false;
+
+    if( t_a >= tproj_b )
+        return false;
+
+    int64_t t[4] = { 0, p.TCoef( p.B ), p.TCoef( n_proj_p.A ), p.TCoef( n_proj_p.B ) };
+    std::vector<int64_t> tv( t, t + 4 );
+    std::sort( tv.begin(), tv.end() ); // fixme: awful and disgusting way of finding 2 midpoints
+
+    int64_t pLenSq = p.SquaredLength();
+
+    VECTOR2I dp = p.B - p.A;
+    pClip.A.x = p.A.x + rescale( (int64_t)dp.x, tv[1], pLenSq );
+    pClip.A.y = p.A.y + rescale( (int64_t)dp.y, tv[1], pLenSq );
+
+    pClip.B.x = p.A.x + rescale( (int64_t)dp.x, tv[2], pLenSq );
+    pClip.B.y = p.A.y + rescale( (int64_t)dp.y, tv[2], pLenSq );
+
+    nClip.A = n.LineProject( pClip.A );
+    nClip.B = n.LineProject( pClip.B );
+
+    return true;
+}
+
+
+/**
+ * @return a hash of which tracks \a aItems contains.
+ */
+static size_t hashTrackSet( const std::set<BOARD_CONNECTED_ITEM*>& aItems )
+{
+    size_t hash = hash_val( aItems.size() );
+
+    for( BOARD_CONNECTED_ITEM* item : aItems )
+    {
+        if( PCB_TRACK* track = dyn_cast<PCB_TRACK*>( item ) )
+            hash_combine( hash, static_cast<const void*>( track ) );
+    }
+
+    return hash;
+}
+
+
+/**
+ * @return a hash of the geometry of the tracks of \a aItems which the coupled segments depend on.
+ */
+static size_t hashTracks( const std::set<BOARD_CONNECTED_ITEM*>& aItems )
+{
+    size_t hash = hash_val( aItems.size() );
+
+    for( BOARD_CONNECTED_ITEM* item : aItems )
+    {
+        if( PCB_TRACK* track = dyn_cast<PCB_TRACK*>( item ) )
+        {
+            hash_combine( hash, track->GetStart().x, track->GetStart().y, track->GetEnd().x,
+                          track->GetEnd().y, static_cast<int>( track->GetLayer() ) );
+        }
+    }
+
+    return hash;
+}
+
+
+std::vector<DIFF_PAIR_COUPLING_CACHE::COUPLED_SEGMENTS>
+DIFF_PAIR_COUPLING_CACHE::FindCoupledSegments( const std::set<BOARD_CONNECTED_ITEM*>& aItemsP,
+                                               const std::set<BOARD_CONNECTED_ITEM*>& aItemsN )
+{
+    std::vector<COUPLED_SEGMENTS> result;
+
+    for( BOARD_CONNECTED_ITEM* itemP : aItemsP )
+    {
+        PCB_TRACK* sp = dyn_cast<PCB_TRACK*>( itemP );
+        OPT<COUPLED_SEGMENTS> bestCoupled;
+        int bestGap = std::numeric_limits<int>::max();
+
+        if( !sp )
+            continue;
+
+        for ( BOARD_CONNECTED_ITEM* itemN : aItemsN )
+        {
+            PCB_TRACK* sn = dyn_cast<PCB_TRACK*> ( itemN );
+
+            if( !sn )
+                continue;
+
+            if( ( sn->GetLayerSet() & sp->GetLayerSet() ).none() )
+                continue;
+
+            SEG ssp ( sp->GetStart(), sp->GetEnd() );
+            SEG ssn ( sn->GetStart(), sn->GetEnd() );
+
+            // Segments that are == 1 IU in length are approximately parallel with everything
+            // and their parallel projection is < 1 IU, leading to bad distance calculations
+            if( ssp.SquaredLength() > 1 && ssn.SquaredLength() > 1 && ssp.ApproxParallel(ssn) )
+            {
+                COUPLED_SEGMENTS cpair;
+                bool coupled = commonParallelProjection( ssp, ssn, cpair.coupledP, cpair.coupledN );
+
+                if( coupled )
+                {
+                    cpair.parentP = sp;
+                    cpair.parentN = sn;
+                    cpair.layer = sp->GetLayer();
+
+                    int gap = (cpair.coupledP.A - cpair.coupledN.A).EuclideanNorm();
+                    if( gap < bestGap )
+                    {
+                        bestGap = gap;
+                        bestCoupled = cpair;
+                    }
+                }
+
+            }
+        }
+
+        if( bestCoupled )
+            result.push_back( *bestCoupled );
+    }
+
+    return result;
+}
+
+
+std::vector<DIFF_PAIR_COUPLING_CACHE::COUPLED_SEGMENTS>
+DIFF_PAIR_COUPLING_CACHE::GetCoupledSegments( int aNetP, int aNetN,
+                                              const std::set<BOARD_CONNECTED_ITEM*>& aItemsP,
+                                              const std::set<BOARD_CONNECTED_ITEM*>& aItemsN )
+{
+    // Rules can select different items of the same pair of nets, so each set of tracks is
+    // kept apart, and checked for moved tracks
+    size_t trackSet = hashTrackSet( aItemsP );
+    hash_combine( trackSet, hashTrackSet( aItemsN ) );
+
+    size_t hash = hashTracks( aItemsP );
+    hash_combine( hash, hashTracks( aItemsN ) );
+
+    KEY key( aNetP, aNetN, trackSet );
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        auto                        it = m_pairs.find( key );
+
+        if( it != m_pairs.end() && it->second.hash == hash )
+        {
+            it->second.used = true;
+            m_reused++;
+            return it->second.segments;
+        }
+    }
+
+    // Computed outside of the lock, as other pairs can be computed at the same time
+    std::vector<COUPLED_SEGMENTS> segments = FindCoupledSegments( aItemsP, aItemsN );
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_pairs[key] = { hash, segments, true };
+    m_computed++;
+
+    return segments;
+}
+
+
+void DIFF_PAIR_COUPLING_CACHE::DropUnused()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( auto it = m_pairs.begin(); it != m_pairs.end(); )
+    {
+        if( it->second.used )
+        {
+            it->second.used = false;
+            ++it;
+        }
+        else
+        {
+            it = m_pairs.erase( it );
+        }
+    }
+}
+
+
+void DIFF_PAIR_COUPLING_CACHE::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_pairs.clear();
+    m_reused = 0;
+    m_computed = 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef DIFF_PAIR_COUPLING_CACHE_H
+#define DIFF_PAIR_COUPLING_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <geometry/seg.h>
+#include <layers_id_colors_and_visibility.h>
+
+class BOARD_CONNECTED_ITEM;
+class PCB_TRACK;
+
+
+/**
+ * Keeps the parallel segments of the two nets of each differential pair, which are found by
+ * comparing every track of one net with every track of the other.
+ *
+ * They are kept until the tracks of either net change, so that the DRC runs after the first one,
+ * and other tools measuring the coupling of a pair, don't compare them again.  Pairs can be
+ * looked up from several threads.  The pairs which are no longer looked up, as their tracks
+ * were deleted or re-routed, are dropped by DropUnused().
+ */
+class DIFF_PAIR_COUPLING_CACHE
+{
+public:
+    /// The parallel parts of a track of each net
+    struct COUPLED_SEGMENTS
+    {
+        SEG          coupledN;
+        SEG          coupledP;
+        PCB_TRACK*   parentN = nullptr;
+        PCB_TRACK*   parentP = nullptr;
+        PCB_LAYER_ID layer = UNDEFINED_LAYER;
+
+        bool operator==( const COUPLED_SEGMENTS& aOther ) const
+        {
+            return coupledN == aOther.coupledN && coupledP == aOther.coupledP
+                   && parentN == aOther.parentN && parentP == aOther.parentP
+                   && layer == aOther.layer;
+        }
+    };
+
+    DIFF_PAIR_COUPLING_CACHE() :
+            m_reused( 0 ),
+            m_computed( 0 )
+    {
+    }
+
+    /**
+     * @return the coupled segments of the pair of nets \a aNetP and \a aNetN, made of the items
+     *         \a aItemsP and \a aItemsN, from the cache if the same tracks were looked up
+     *         before and didn't move since.
+     */
+    std::vector<COUPLED_SEGMENTS> GetCoupledSegments(
+            int aNetP, int aNetN, const std::set<BOARD_CONNECTED_ITEM*>& aItemsP,
+            const std::set<BOARD_CONNECTED_ITEM*>& aItemsN );
+
+    /**
+     * Pair each track of \a aItemsP with the closest track of \a aItemsN parallel to it on the
+     * same layer, keeping the parts of both which face each other.
+     */
+    static std::vector<COUPLED_SEGMENTS> FindCoupledSegments(
+            const std::set<BOARD_CONNECTED_ITEM*>& aItemsP,
+            const std::set<BOARD_CONNECTED_ITEM*>& aItemsN );
+
+    /**
+     * Remove the pairs which weren't looked up since the previous call.  This is called after
+     * each DRC run, so that the pairs of tracks which don't exist anymore don't pile up.
+     */
+    void DropUnused();
+
+    void Clear();
+
+    int GetReusedCount() const { return m_reused; }
+    int GetComputedCount() const { return m_computed; }
+
+private:
+    /// The two nets, and which of their tracks were paired
+    typedef std::tuple<int, int, size_t> KEY;
+
+    struct ENTRY
+    {
+        size_t                        hash;     ///< of the geometry of the paired tracks
+        std::vector<COUPLED_SEGMENTS> segments;
+        bool                          used;     ///< looked up since the last DropUnused()
+    };
+
+    std::mutex           m_lock;
+    std::map<KEY, ENTRY> m_pairs;
+
+    int                  m_reused;
+    int                  m_computed;
+};
+
+#endif // DIFF_PAIR_COUPLING_CACHE_H
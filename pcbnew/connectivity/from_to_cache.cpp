@@ -17,8 +17,13 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <deque>
+#include <future>
 #include <memory>
+#include <thread>
 #include <reporter.h>
 #include <board.h>
 #include <kicad_string.h>
@@ -33,6 +38,7 @@
 void FROM_TO_CACHE::buildEndpointList( )
 {
     m_ftEndpoints.clear();
+    m_padEndpoints.clear();
 
     for( FOOTPRINT* footprint : m_board->Footprints() )
     {
@@ -41,9 +47,11 @@ void FROM_TO_CACHE::buildEndpointList( )
             FT_ENDPOINT ent;
             ent.name = footprint->GetReference() + "-" + pad->GetName();
             ent.parent = pad;
+            m_padEndpoints[pad].push_back( m_ftEndpoints.size() );
             m_ftEndpoints.push_back( ent );
             ent.name = footprint->GetReference();
             ent.parent = pad;
+            m_padEndpoints[pad].push_back( m_ftEndpoints.size() );
             m_ftEndpoints.push_back( ent );
         }
     }
@@ -57,75 +65,82 @@ enum PATH_STATUS {
 };
 
 
-static bool isVertexVisited( CN_ITEM* v, const std::vector<CN_ITEM*>& path )
+/**
+ * Find a shortest path from \a u to \a v with a breadth-first search keeping the parent of each
+ * visited item.  The path is said to be unique when no other path of the same length exists.
+ */
+static PATH_STATUS uniquePathBetweenNodes( CN_ITEM* u, CN_ITEM* v, std::vector<CN_ITEM*>& outPath )
 {
-    for( auto u : path )
+    struct VISIT
     {
-        if ( u == v )
-            return true;
-    }
+        CN_ITEM* parent;
+        int      depth;
+        int      pathCount;     ///< the number of shortest paths from u, up to 2
+    };
 
-    return false;
-}
+    std::unordered_map<CN_ITEM*, VISIT> visited;
+    std::deque<CN_ITEM*>                Q;
 
-
-static PATH_STATUS uniquePathBetweenNodes( CN_ITEM* u, CN_ITEM* v, std::vector<CN_ITEM*>& outPath )
-{
-    using Path = std::vector<CN_ITEM*>;
-    std::deque<Path> Q;
-
-    Path pInit;
-    bool pathFound = false;
-    pInit.push_back( u );
-    Q.push_back( pInit );
+    visited[u] = { nullptr, 0, 1 };
+    Q.push_back( u );
 
     while( Q.size() )
     {
-        Path path = Q.front();
+        CN_ITEM* last = Q.front();
         Q.pop_front();
-        CN_ITEM* last = path.back();
 
+        // All the items one step closer to u have been expanded, so the count is final
         if( last == v )
-        {
-            outPath = path;
-            if( pathFound )
-                return PS_MULTIPLE_PATHS;
-            pathFound = true;
-        }
+            break;
 
-        for( auto ci : last->ConnectedItems() )
-        {
-            bool vertexVisited = isVertexVisited( ci, path );
+        VISIT lastVisit = visited[last];
 
-            for( auto& p : Q )
-                if( isVertexVisited( ci, p ) )
-                {
-                    vertexVisited = true;
-                    break;
-                }
+        for( CN_ITEM* ci : last->ConnectedItems() )
+        {
+            auto it = visited.find( ci );
 
-            if( !vertexVisited )
+            if( it == visited.end() )
+            {
+                visited[ci] = { last, lastVisit.depth + 1, lastVisit.pathCount };
+                Q.push_back( ci );
+            }
+            else if( it->second.depth == lastVisit.depth + 1 )
             {
-                Path newpath( path );
-                newpath.push_back( ci );
-                Q.push_back( newpath );
+                it->second.pathCount = std::min( 2, it->second.pathCount + lastVisit.pathCount );
             }
         }
     }
 
-    return pathFound ? PS_OK : PS_NO_PATH;
+    auto target = visited.find( v );
+
+    if( target == visited.end() )
+        return PS_NO_PATH;
+
+    outPath.clear();
+
+    for( CN_ITEM* item = v; item; item = visited[item].parent )
+        outPath.push_back( item );
+
+    std::reverse( outPath.begin(), outPath.end() );
+
+    return target->second.pathCount > 1 ? PS_MULTIPLE_PATHS : PS_OK;
 };
 
 
 int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo )
 {
     std::vector<FT_PATH> paths;
+    std::set<PAD*>       fromPads;
     auto connectivity = m_board->GetConnectivity();
     auto cnAlgo = connectivity->GetConnectivityAlgo();
 
+    FT_RULE_PATHS& rulePaths = m_rulePaths[ std::make_pair( aFrom, aTo ) ];
+
     for( auto& endpoint : m_ftEndpoints )
     {
-        if( WildCompareString( aFrom, endpoint.name, false ) )
+        // A pad matches through its own name and the reference of its footprint
+        if( WildCompareString( aFrom, endpoint.name, false )
+                && fromPads.insert( endpoint.parent ).second )
         {
             FT_PATH p;
             p.net = endpoint.parent->GetNetCode();
@@ -138,7 +153,6 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
     for( auto &path : paths )
     {
         int count = 0;
-        auto netName = path.from->GetNetname();
 
         wxString fromName = path.from->GetParent()->GetReference() + "-" + path.from->GetName();
 
@@ -156,109 +170,134 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
                 continue;
 
             const PAD *pad = static_cast<const PAD*>( pitem );
+            auto       padEndpoints = m_padEndpoints.find( pad );
 
-            wxString toName = pad->GetParent()->GetReference() + "-" + pad->GetName();
+            if( padEndpoints == m_padEndpoints.end() )
+                continue;
 
+            wxString toName = pad->GetParent()->GetReference() + "-" + pad->GetName();
 
-            for ( const auto& endpoint : m_ftEndpoints )
+            for( size_t idx : padEndpoints->second )
             {
-                if( pad == endpoint.parent )
+                const FT_ENDPOINT& endpoint = m_ftEndpoints[idx];
+
+                if( WildCompareString( aTo, endpoint.name, false ) )
                 {
-                        if( WildCompareString( aTo, endpoint.name, false ) )
-                        {
-                            count++;
-                            toPad = endpoint.parent;
-
-                            path.to = toPad;
-                            path.fromName = fromName;
-                            path.toName = toName;
-                            path.fromWildcard = aFrom;
-                            path.toWildcard = aTo;
-
-                            if( count >= 2 )
-                            {
-                                // fixme: report this somewhere?
-                                //printf("Multiple targets found, aborting...\n");
-                                path.to = nullptr;
-                            }
-                        }
+                    count++;
+                    toPad = endpoint.parent;
+
+                    path.to = toPad;
+                    path.fromName = fromName;
+                    path.toName = toName;
+                    path.fromWildcard = aFrom;
+                    path.toWildcard = aTo;
+
+                    if( count >= 2 )
+                    {
+                        // fixme: report this somewhere?
+                        //printf("Multiple targets found, aborting...\n");
+                        path.to = nullptr;
                     }
                 }
+            }
         }
     }
 
-    int newPaths = 0;
+    std::vector<FT_PATH*>  toTrace;
+    std::vector<CN_ITEM*>  cnFrom;
+    std::vector<CN_ITEM*>  cnTo;
 
     for( auto &path : paths )
     {
         if( !path.from || !path.to )
             continue;
 
+        toTrace.push_back( &path );
+        cnFrom.push_back( cnAlgo->ItemEntry( path.from ).GetItems().front() );
+        cnTo.push_back( cnAlgo->ItemEntry( path.to ).GetItems().front() );
+    }
 
-        CN_ITEM *cnFrom = cnAlgo->ItemEntry( path.from ).GetItems().front();
-        CN_ITEM *cnTo = cnAlgo->ItemEntry( path.to ).GetItems().front();
-        CN_ITEM::CONNECTED_ITEMS upath;
+    std::vector<CN_ITEM::CONNECTED_ITEMS> upaths( toTrace.size() );
+    std::vector<PATH_STATUS>              results( toTrace.size() );
+    std::atomic<size_t>                   nextPath( 0 );
 
-        auto result = uniquePathBetweenNodes( cnFrom, cnTo, upath );
+    // The searches only read the connectivity, so they can run side by side
+    auto search_lambda =
+            [&]() -> size_t
+            {
+                for( size_t i = nextPath++; i < toTrace.size(); i = nextPath++ )
+                    results[i] = uniquePathBetweenNodes( cnFrom[i], cnTo[i], upaths[i] );
 
-        if( result == PS_OK )
-            path.isUnique = true;
-        else
-            path.isUnique = false;
+                return 1;
+            };
 
+    // We don't want to spin up a new thread for fewer than 4 paths (overhead costs)
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   ( toTrace.size() + 3 ) / 4 );
 
-        //printf( "%s\n", (const char *) wxString::Format( _("Check path: %s -> %s (net %s)"), path.fromName, path.toName, cnFrom->Parent()->GetNetname() ) );
+    if( parallelThreadCount <= 1 )
+    {
+        search_lambda();
+    }
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, search_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    int newPaths = 0;
 
-        if( result == PS_NO_PATH )
+    for( size_t i = 0; i < toTrace.size(); ++i )
+    {
+        FT_PATH& path = *toTrace[i];
+
+        path.isUnique = ( results[i] == PS_OK );
+
+        if( results[i] == PS_NO_PATH )
             continue;
 
-        for( const auto item : upath )
-        {
+        for( const auto item : upaths[i] )
             path.pathItems.insert( item->Parent() );
+
+        size_t pathIdx = m_ftPaths.size();
+
+        for( BOARD_CONNECTED_ITEM* item : path.pathItems )
+        {
+            rulePaths.items.insert( item );
+            m_itemPaths[item].push_back( pathIdx );
         }
 
-        m_ftPaths.push_back(path);
+        rulePaths.paths.push_back( pathIdx );
+        m_ftPaths.push_back( path );
         newPaths++;
     }
 
-    // reportAux( _("Cached %d paths\n"), newPaths );
-
     return newPaths;
 }
 
-bool  FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom, const wxString& aTo )
-{
-    int nFromTosFound = 0;
 
+bool FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom,
+                                    const wxString& aTo )
+{
     if( !m_board )
         return false;
 
-    //printf("Check %d cached paths [%p]\n", m_ftPaths.size(), aItem );
-    for( int attempt = 0; attempt < 2; attempt++ )
-    {
-        // item already belongs to path
-        for( auto& ftPath : m_ftPaths )
-        {
-            if( aFrom == ftPath.fromWildcard &&
-                    aTo == ftPath.toWildcard )
-                {
-                    nFromTosFound++;
-
-                    if( ftPath.pathItems.count( aItem ) )
-                    {
-            //            printf("Found cached path for %p [%s->%s]\n", aItem, (const char *)ftPath.fromName, (const char *) ftPath.toName );
-                        return true;
-                    }
-                }
-        }
+    std::pair<wxString, wxString> key( aFrom, aTo );
+    auto                          rulePaths = m_rulePaths.find( key );
 
-        if( !nFromTosFound )
-            cacheFromToPaths( aFrom, aTo );
-        else
-            return false;
+    // Pairs without any path are cached too, so they are only searched once
+    if( rulePaths == m_rulePaths.end() )
+    {
+        cacheFromToPaths( aFrom, aTo );
+        rulePaths = m_rulePaths.find( key );
     }
 
-    return false;
+    return rulePaths->second.items.count( aItem ) > 0;
 }
 
 
@@ -267,16 +306,29 @@ void FROM_TO_CACHE::Rebuild( BOARD* aBoard )
     m_board = aBoard;
     buildEndpointList();
     m_ftPaths.clear();
+    m_rulePaths.clear();
+    m_itemPaths.clear();
 }
 
 
-FROM_TO_CACHE::FT_PATH* FROM_TO_CACHE::QueryFromToPath( const std::set<BOARD_CONNECTED_ITEM*>& aItems )
+FROM_TO_CACHE::FT_PATH* FROM_TO_CACHE::QueryFromToPath(
+        const std::set<BOARD_CONNECTED_ITEM*>& aItems )
 {
-    for( auto& ftPath : m_ftPaths )
+    if( aItems.empty() )
+        return nullptr;
+
+    auto candidates = m_itemPaths.find( *aItems.begin() );
+
+    if( candidates == m_itemPaths.end() )
+        return nullptr;
+
+    for( size_t pathIdx : candidates->second )
     {
+        FT_PATH& ftPath = m_ftPaths[pathIdx];
+
         if ( ftPath.pathItems == aItems )
             return &ftPath;
     }
 
     return nullptr;
-}
\ No newline at end of file
+}
@@ -20,7 +20,11 @@
 #ifndef __FROM_TO_CACHE_H
 #define __FROM_TO_CACHE_H
 
+#include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class PAD;
 class BOARD_CONNECTED_ITEM;
@@ -56,18 +60,38 @@ public:
     }
 
     void Rebuild( BOARD* aBoard );
+
+    /**
+     * @return true if \a aItem is on a path between pads matching the \a aFrom and \a aTo
+     *         wildcards.  The paths of a from/to pair are computed the first time it is asked for.
+     */
     bool IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom, const wxString& aTo );
 
     FT_PATH* QueryFromToPath( const std::set<BOARD_CONNECTED_ITEM*>& aItems );
 
 private:
 
+    /// The paths found for a from/to pair of wildcards
+    struct FT_RULE_PATHS
+    {
+        std::vector<size_t>                       paths;    ///< indices in m_ftPaths
+        std::unordered_set<BOARD_CONNECTED_ITEM*> items;    ///< the items of all the paths
+    };
+
     int cacheFromToPaths( const wxString& aFrom, const wxString& aTo );
     void buildEndpointList();
 
     std::vector<FT_ENDPOINT> m_ftEndpoints;
     std::vector<FT_PATH> m_ftPaths;
 
+    /// The indices in m_ftEndpoints of the names of each pad
+    std::unordered_map<const PAD*, std::vector<size_t>> m_padEndpoints;
+
+    std::map<std::pair<wxString, wxString>, FT_RULE_PATHS> m_rulePaths;
+
+    /// The indices in m_ftPaths of the paths going through each item
+    std::unordered_map<BOARD_CONNECTED_ITEM*, std::vector<size_t>> m_itemPaths;
+
     BOARD* m_board;
 };
 
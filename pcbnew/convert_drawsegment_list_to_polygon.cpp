@@ -35,9 +35,14 @@
 #include <geometry/shape_poly_set.h>
 #include <geometry/geometry_utils.h>
 #include <convert_drawsegment_list_to_polygon.h>
+#include <core/wx_stl_compat.h>
 
 #include <wx/log.h>
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
 
 /**
  * Flag to enable debug tracing for the board outline creation
@@ -78,90 +83,138 @@ bool closer_to_first( VECTOR2I aRef, VECTOR2I aFirst, VECTOR2I aSecond )
 
 
 /**
- * Searches for a PCB_SHAPE matching a given end point or start point in a list.
- * @param aShape The starting shape.
- * @param aPoint The starting or ending point to search for.
- * @param aList The list to remove from.
- * @param aLimit is the distance from \a aPoint that still constitutes a valid find.
- * @return PCB_SHAPE* - The first PCB_SHAPE that has a start or end point matching
- *   aPoint, otherwise NULL if none.
+ * A spatial hash of the end points of the shapes being chained into an outline.
+ *
+ * Chaining used to search the whole shape list for every link, which is quadratic for imported
+ * outlines made of many tiny segments.  The index answers the same queries by only visiting the
+ * end points in the neighbourhood of the requested point.  Candidates are resolved in shape list
+ * order so the results are identical to those of a linear search.
  */
-static PCB_SHAPE* findNext( PCB_SHAPE* aShape, const wxPoint& aPoint,
-                            const std::vector<PCB_SHAPE*>& aList, unsigned aLimit )
+class OUTLINE_ENDPOINT_INDEX
 {
-    // Look for an unused, exact hit
-    for( PCB_SHAPE* graphic : aList )
+public:
+    OUTLINE_ENDPOINT_INDEX( const std::vector<PCB_SHAPE*>& aList, unsigned aLimit ) :
+            m_list( aList ),
+            m_limit( aLimit ),
+            m_cellSize( std::max<int>( aLimit, 1 ) )
     {
-        if( graphic == aShape || ( graphic->GetFlags() & SKIP_STRUCT ) != 0 )
-            continue;
+        m_endpoints.reserve( aList.size() * 2 );
 
-        switch( graphic->GetShape() )
+        for( size_t ii = 0; ii < aList.size(); ++ii )
         {
-        case PCB_SHAPE_TYPE::ARC:
-            if( aPoint == graphic->GetArcStart() || aPoint == graphic->GetArcEnd() )
-                return graphic;
+            PCB_SHAPE* graphic = aList[ii];
 
-            break;
-
-        default:
-            if( aPoint == graphic->GetStart() || aPoint == graphic->GetEnd() )
-                return graphic;
+            if( graphic->GetShape() == PCB_SHAPE_TYPE::ARC )
+            {
+                addEndpoint( graphic->GetArcStart(), ii );
+                addEndpoint( graphic->GetArcEnd(), ii );
+            }
+            else
+            {
+                addEndpoint( graphic->GetStart(), ii );
+                addEndpoint( graphic->GetEnd(), ii );
+            }
         }
     }
 
-    // Search again for anything that's close, even something already used.  (The latter is
-    // important for error reporting.)
-    VECTOR2I    pt( aPoint );
-    SEG::ecoord closest_dist_sq = SEG::Square( aLimit );
-    PCB_SHAPE*  closest_graphic = nullptr;
-    SEG::ecoord d_sq;
-
-    for( PCB_SHAPE* graphic : aList )
+    /**
+     * Search for a PCB_SHAPE matching a given end point or start point.
+     *
+     * An unused (i.e. not flagged SKIP_STRUCT) exact hit is preferred.  Failing that, the
+     * closest shape within the chaining limit is returned, even if already used.  (The latter
+     * is important for error reporting.)
+     *
+     * @param aShape The starting shape.
+     * @param aPoint The starting or ending point to search for.
+     * @return PCB_SHAPE* - The matching PCB_SHAPE, or nullptr if none.
+     */
+    PCB_SHAPE* FindNext( PCB_SHAPE* aShape, const wxPoint& aPoint ) const
     {
-        if( graphic == aShape )
-            continue;
+        auto exact = m_exactHits.find( aPoint );
 
-        switch( graphic->GetShape() )
+        if( exact != m_exactHits.end() )
         {
-        case PCB_SHAPE_TYPE::ARC:
-            d_sq = ( pt - graphic->GetArcStart() ).SquaredEuclideanNorm();
-
-            if( d_sq < closest_dist_sq )
+            // Indices were added in list order
+            for( size_t ii : exact->second )
             {
-                closest_dist_sq = d_sq;
-                closest_graphic = graphic;
+                PCB_SHAPE* graphic = m_list[ii];
+
+                if( graphic != aShape && ( graphic->GetFlags() & SKIP_STRUCT ) == 0 )
+                    return graphic;
             }
+        }
 
-            d_sq = ( pt - graphic->GetArcEnd() ).SquaredEuclideanNorm();
+        // Nothing can be strictly closer than a zero limit
+        if( m_limit == 0 )
+            return nullptr;
 
-            if( d_sq < closest_dist_sq )
+        VECTOR2I    pt( aPoint );
+        SEG::ecoord closest_dist_sq = SEG::Square( m_limit );
+        size_t      closest = m_endpoints.size();
+        wxPoint     cell = cellOf( aPoint );
+
+        for( int dx = -1; dx <= 1; ++dx )
+        {
+            for( int dy = -1; dy <= 1; ++dy )
             {
-                closest_dist_sq = d_sq;
-                closest_graphic = graphic;
-            }
-            break;
+                auto bucket = m_cells.find( wxPoint( cell.x + dx, cell.y + dy ) );
 
-        default:
-            d_sq = ( pt - graphic->GetStart() ).SquaredEuclideanNorm();
+                if( bucket == m_cells.end() )
+                    continue;
 
-            if( d_sq < closest_dist_sq )
-            {
-                closest_dist_sq = d_sq;
-                closest_graphic = graphic;
-            }
+                for( size_t ii : bucket->second )
+                {
+                    const ENDPOINT& candidate = m_endpoints[ii];
 
-            d_sq = ( pt - graphic->GetEnd() ).SquaredEuclideanNorm();
+                    if( m_list[candidate.m_ShapeIndex] == aShape )
+                        continue;
 
-            if( d_sq < closest_dist_sq )
-            {
-                closest_dist_sq = d_sq;
-                closest_graphic = graphic;
+                    SEG::ecoord d_sq = ( pt - candidate.m_Pt ).SquaredEuclideanNorm();
+
+                    // A linear search keeps the first of several equidistant end points
+                    if( d_sq < closest_dist_sq || ( d_sq == closest_dist_sq && ii < closest ) )
+                    {
+                        closest_dist_sq = d_sq;
+                        closest = ii;
+                    }
+                }
             }
         }
+
+        if( closest == m_endpoints.size() )
+            return nullptr;     // nothing within the limit
+
+        return m_list[m_endpoints[closest].m_ShapeIndex];
     }
 
-    return closest_graphic;     // Note: will be nullptr if nothing within aLimit
-}
+private:
+    struct ENDPOINT
+    {
+        VECTOR2I m_Pt;
+        size_t   m_ShapeIndex;
+    };
+
+    wxPoint cellOf( const wxPoint& aPoint ) const
+    {
+        return wxPoint( (int) std::floor( (double) aPoint.x / m_cellSize ),
+                        (int) std::floor( (double) aPoint.y / m_cellSize ) );
+    }
+
+    void addEndpoint( const wxPoint& aPoint, size_t aShapeIndex )
+    {
+        m_exactHits[aPoint].push_back( aShapeIndex );
+        m_cells[cellOf( aPoint )].push_back( m_endpoints.size() );
+        m_endpoints.push_back( { aPoint, aShapeIndex } );
+    }
+
+    const std::vector<PCB_SHAPE*>&                  m_list;
+    unsigned                                        m_limit;
+    int                                             m_cellSize;
+
+    std::vector<ENDPOINT>                           m_endpoints;  // in list order
+    std::unordered_map<wxPoint, std::vector<size_t>> m_exactHits; // shape indices
+    std::unordered_map<wxPoint, std::vector<size_t>> m_cells;     // endpoint indices
+};
 
 
 /**
@@ -309,6 +362,8 @@ bool ConvertOutlineToPolygon( std::vector<PCB_SHAPE*>& aSegList, SHAPE_POLY_SET&
         }
     }
 
+    OUTLINE_ENDPOINT_INDEX endpointIndex( aSegList, aChainingEpsilon );
+
     // Keep a list of where the various segments came from so after doing our combined-polygon
     // tests we can still report errors against the individual graphic items.
     std::map<std::pair<VECTOR2I, VECTOR2I>, PCB_SHAPE*> segOwners;
@@ -542,7 +597,7 @@ bool ConvertOutlineToPolygon( std::vector<PCB_SHAPE*>& aSegList, SHAPE_POLY_SET&
 
             // Get next closest segment.
 
-            PCB_SHAPE* nextGraphic = findNext( graphic, prevPt, aSegList, aChainingEpsilon );
+            PCB_SHAPE* nextGraphic = endpointIndex.FindNext( graphic, prevPt );
 
             if( nextGraphic && !( nextGraphic->GetFlags() & SKIP_STRUCT ) )
             {
@@ -789,7 +844,7 @@ bool ConvertOutlineToPolygon( std::vector<PCB_SHAPE*>& aSegList, SHAPE_POLY_SET&
 
                 // Get next closest segment.
 
-                PCB_SHAPE* nextGraphic = findNext( graphic, prevPt, aSegList, aChainingEpsilon );
+                PCB_SHAPE* nextGraphic = endpointIndex.FindNext( graphic, prevPt );
 
                 if( nextGraphic && !( nextGraphic->GetFlags() & SKIP_STRUCT ) )
                 {
@@ -828,44 +883,86 @@ bool ConvertOutlineToPolygon( std::vector<PCB_SHAPE*>& aSegList, SHAPE_POLY_SET&
     if( !polygonComplete )
         return false;
 
-    // All of the silliness that follows is to work around the segment iterator while checking
-    // for collisions.
-    // TODO: Implement proper segment and point iterators that follow std
+    // Only segments whose bounding boxes touch can overlap or intersect.  Sweep over the
+    // segments sorted by their left edge to find those pairs rather than testing every segment
+    // against every other one, then visit the pairs in the original iteration order so errors
+    // are reported exactly as a full pairwise test would report them.
+
+    std::vector<SEG> segs;
+
+    for( auto seg = aPolygons.IterateSegmentsWithHoles(); seg; seg++ )
+        segs.push_back( *seg );
+
+    std::vector<size_t> byLeft( segs.size() );
 
-    for( auto seg1 = aPolygons.IterateSegmentsWithHoles(); seg1; seg1++ )
+    for( size_t ii = 0; ii < segs.size(); ++ii )
+        byLeft[ii] = ii;
+
+    std::sort( byLeft.begin(), byLeft.end(),
+               [&]( size_t a, size_t b )
+               {
+                   return std::min( segs[a].A.x, segs[a].B.x )
+                                < std::min( segs[b].A.x, segs[b].B.x );
+               } );
+
+    std::vector<std::pair<size_t, size_t>> candidates;
+
+    for( size_t ii = 0; ii < byLeft.size(); ++ii )
     {
-        auto seg2 = seg1;
+        const SEG& seg1 = segs[byLeft[ii]];
+        int        right1 = std::max( seg1.A.x, seg1.B.x );
+        int        top1 = std::min( seg1.A.y, seg1.B.y );
+        int        bottom1 = std::max( seg1.A.y, seg1.B.y );
 
-        for( ++seg2; seg2; seg2++ )
+        for( size_t jj = ii + 1; jj < byLeft.size(); ++jj )
         {
-            // Check for exact overlapping segments.
-            if( *seg1 == *seg2 || ( ( *seg1 ).A == ( *seg2 ).B && ( *seg1 ).B == ( *seg2 ).A ) )
-            {
-                if( aErrorHandler )
-                {
-                    BOARD_ITEM* a = fetchOwner( *seg1 );
-                    BOARD_ITEM* b = fetchOwner( *seg2 );
+            const SEG& seg2 = segs[byLeft[jj]];
 
-                    if( a && b )
-                        (*aErrorHandler)( _( "(self-intersecting)" ), a, b, (wxPoint) ( *seg1 ).A );
-                }
+            if( std::min( seg2.A.x, seg2.B.x ) > right1 )
+                break;
 
-                selfIntersecting = true;
-            }
+            if( std::min( seg2.A.y, seg2.B.y ) > bottom1 || std::max( seg2.A.y, seg2.B.y ) < top1 )
+                continue;
+
+            candidates.emplace_back( std::min( byLeft[ii], byLeft[jj] ),
+                                     std::max( byLeft[ii], byLeft[jj] ) );
+        }
+    }
+
+    std::sort( candidates.begin(), candidates.end() );
 
-            if( boost::optional<VECTOR2I> pt = seg1.Get().Intersect( seg2.Get(), true ) )
+    for( const std::pair<size_t, size_t>& candidate : candidates )
+    {
+        const SEG& seg1 = segs[candidate.first];
+        const SEG& seg2 = segs[candidate.second];
+
+        // Check for exact overlapping segments.
+        if( seg1 == seg2 || ( seg1.A == seg2.B && seg1.B == seg2.A ) )
+        {
+            if( aErrorHandler )
             {
-                if( aErrorHandler )
-                {
-                    BOARD_ITEM* a = fetchOwner( *seg1 );
-                    BOARD_ITEM* b = fetchOwner( *seg2 );
+                BOARD_ITEM* a = fetchOwner( seg1 );
+                BOARD_ITEM* b = fetchOwner( seg2 );
 
-                    if( a && b )
-                        (*aErrorHandler)( _( "(self-intersecting)" ), a, b, (wxPoint) pt.get() );
-                }
+                if( a && b )
+                    (*aErrorHandler)( _( "(self-intersecting)" ), a, b, (wxPoint) seg1.A );
+            }
 
-                selfIntersecting = true;
+            selfIntersecting = true;
+        }
+
+        if( boost::optional<VECTOR2I> pt = seg1.Intersect( seg2, true ) )
+        {
+            if( aErrorHandler )
+            {
+                BOARD_ITEM* a = fetchOwner( seg1 );
+                BOARD_ITEM* b = fetchOwner( seg2 );
+
+                if( a && b )
+                    (*aErrorHandler)( _( "(self-intersecting)" ), a, b, (wxPoint) pt.get() );
             }
+
+            selfIntersecting = true;
         }
     }
 
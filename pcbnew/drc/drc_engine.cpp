@@ -23,11 +23,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <thread>
+
 #include <reporter.h>
 #include <widgets/progress_reporter.h>
 #include <kicad_string.h>
+#include <macros.h>
 #include <board_design_settings.h>
 #include <drc/drc_engine.h>
+#include <drc/drc_profile.h>
+#include <drc/drc_result_cache.h>
 #include <drc/drc_rtree.h>
 #include <drc/drc_rule_parser.h>
 #include <drc/drc_rule.h>
@@ -37,6 +42,7 @@
 #include <pad.h>
 #include <pcb_track.h>
 #include <zone.h>
+#include <plugins/kicad/kicad_plugin.h>
 #include <geometry/shape.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_null.h>
@@ -57,6 +63,55 @@ void drcPrintDebugMessage( int level, const wxString& msg, const char *function,
 }
 
 
+/**
+ * @return the (lower case) names of the functions called by the rule condition \a aExpression.
+ */
+static std::set<wxString> conditionFunctions( const wxString& aExpression )
+{
+    std::set<wxString> functions;
+    wxString           token;
+    wxUniChar          quote = 0;
+    bool               gap = false;
+
+    for( wxUniChar c : aExpression )
+    {
+        if( quote != 0 )
+        {
+            if( c == quote )
+                quote = 0;
+        }
+        else if( c == '\'' || c == '"' )
+        {
+            quote = c;
+            token.clear();
+        }
+        else if( wxIsalnum( c ) || c == '_' || c == '.' )
+        {
+            if( gap )
+                token.clear();
+
+            token += c;
+            gap = false;
+        }
+        else if( c == ' ' )
+        {
+            // Spaces may separate a function name from its arguments
+            gap = true;
+        }
+        else
+        {
+            if( c == '(' && !token.IsEmpty() )
+                functions.insert( token.AfterLast( '.' ).Lower() );
+
+            token.clear();
+            gap = false;
+        }
+    }
+
+    return functions;
+}
+
+
 DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_designSettings ( aSettings ),
     m_board( aBoard ),
@@ -67,7 +122,10 @@ DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_reportAllTrackErrors( false ),
     m_testFootprints( false ),
     m_reporter( nullptr ),
-    m_progressReporter( nullptr )
+    m_progressReporter( nullptr ),
+    m_resultCache( nullptr ),
+    m_profile( nullptr ),
+    m_threadCount( 0 )
 {
     m_errorLimits.resize( DRCE_LAST + 1 );
 
@@ -686,18 +744,21 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
     m_reportAllTrackErrors = aReportAllTrackErrors;
     m_testFootprints = aTestFootprints;
 
-    for( int ii = DRCE_FIRST; ii < DRCE_LAST; ++ii )
-    {
-        if( m_designSettings->Ignore( ii ) )
-            m_errorLimits[ ii ] = 0;
-        else
-            m_errorLimits[ ii ] = INT_MAX;
-    }
+    initErrorLimits();
 
     m_board->IncrementTimeStamp();      // Invalidate all caches
 
+    if( m_profile )
+    {
+        m_profile->BeginRun( m_board->GetFileName(), m_rules );
+        m_profile->BeginProvider( wxT( "setup" ) );
+    }
+
     if( !ReportPhase( _( "Tessellating copper zones..." ) ) )
+    {
+        endProfile();
         return;
+    }
 
     // Number of zones between progress bar updates
     int                delta = 5;
@@ -708,6 +769,9 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
         zone->CacheBoundingBox();
         zone->CacheTriangulation();
 
+        if( m_profile )
+            m_profile->CountPolygonOp();
+
         if( !zone->GetIsRuleArea() )
             copperZones.push_back( zone );
     }
@@ -719,6 +783,9 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
             zone->CacheBoundingBox();
             zone->CacheTriangulation();
 
+            if( m_profile )
+                m_profile->CountPolygonOp();
+
             if( !zone->GetIsRuleArea() )
                 copperZones.push_back( zone );
         }
@@ -735,10 +802,14 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
         if( ( ii % delta ) == 0 || ii == zoneCount -  1 )
         {
             if( !ReportProgress( (double) ii / (double) zoneCount ) )
+            {
+                endProfile();
                 return;
+            }
         }
 
         m_board->m_CopperZoneRTrees[ zone ] = std::make_unique<DRC_RTREE>();
+        m_board->m_CopperZoneRTrees[ zone ]->SetProfile( m_profile );
 
         for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
         {
@@ -747,6 +818,9 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
         }
     }
 
+    if( m_resultCache )
+        m_resultCache->BeginRun( hashRules() );
+
     for( DRC_TEST_PROVIDER* provider : m_testProviders )
     {
         if( !provider->IsEnabled() )
@@ -756,15 +830,247 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
 
         ReportAux( wxString::Format( "Run DRC provider: '%s'", provider->GetName() ) );
 
+        if( m_profile )
+            m_profile->BeginProvider( provider->GetName() );
+
         if( !provider->Run() )
             break;
     }
+
+    if( m_profile )
+    {
+        endProfile();
+
+        ReportAux( wxString::Format( "DRC took %.1f ms, %lld rule evaluations, %lld R-tree queries",
+                                     m_profile->GetTime(),
+                                     (long long) m_profile->GetCounts().m_EvalRules,
+                                     (long long) m_profile->GetCounts().m_RTreeQueries ) );
+    }
+
+    if( m_resultCache )
+    {
+        m_resultCache->EndRun();
+
+        ReportAux( wxString::Format( "Reused %d cached checks, recomputed %d",
+                                     m_resultCache->GetReusedCount(),
+                                     m_resultCache->GetRecomputedCount() ) );
+    }
+}
+
+
+void DRC_ENGINE::endProfile()
+{
+    if( !m_profile )
+        return;
+
+    // The board keeps its zone trees after the run, but not the profile
+    for( std::pair<ZONE* const, std::unique_ptr<DRC_RTREE>>& zoneTree :
+            m_board->m_CopperZoneRTrees )
+    {
+        if( zoneTree.second )
+            zoneTree.second->SetProfile( nullptr );
+    }
+
+    m_profile->EndRun();
+}
+
+
+DRC_RESULT_CACHE* DRC_ENGINE::GetResultCache() const
+{
+    if( m_resultCache && m_resultCache->IsRunning() )
+        return m_resultCache;
+
+    return nullptr;
+}
+
+
+DRC_PROFILE* DRC_ENGINE::GetProfile() const
+{
+    if( m_profile && m_profile->IsRunning() )
+        return m_profile;
+
+    return nullptr;
+}
+
+
+int DRC_ENGINE::GetThreadCount() const
+{
+    if( m_threadCount > 0 )
+        return m_threadCount;
+
+    return std::max<int>( 1, std::thread::hardware_concurrency() );
+}
+
+
+std::string DRC_ENGINE::hashRules() const
+{
+    // The functions which only look at the items a condition is tested against
+    static const std::set<wxString> itemFunctions = { wxT( "existsonlayer" ),
+                                                      wxT( "isplated" ),
+                                                      wxT( "ismicrovia" ),
+                                                      wxT( "isblindburiedvia" ),
+                                                      wxT( "memberof" ),
+                                                      wxT( "iscoupleddiffpair" ),
+                                                      wxT( "indiffpair" ) };
+
+    // The functions which look at the areas and courtyards of the board, hashed below
+    static const std::set<wxString> geometryFunctions = { wxT( "insidecourtyard" ),
+                                                          wxT( "insidefrontcourtyard" ),
+                                                          wxT( "insidebackcourtyard" ),
+                                                          wxT( "insidearea" ) };
+
+    std::string data;
+    bool        testsGeometry = false;
+
+    data += std::to_string( (int) m_reportAllTrackErrors ) + ' ';
+    data += std::to_string( m_designSettings->GetDRCEpsilon() ) + '\n';
+
+    for( const DRC_RULE* rule : m_rules )
+    {
+        data += TO_UTF8( rule->m_Name );
+        data += ' ' + std::to_string( (int) rule->m_Implicit );
+        data += ' ' + std::to_string( (int) rule->m_Unary ) + ' ';
+        data += TO_UTF8( rule->m_LayerSource );
+        data += ' ' + rule->m_LayerCondition.FmtHex() + '\n';
+
+        if( rule->m_Condition )
+        {
+            wxString expression = rule->m_Condition->GetExpression();
+
+            for( const wxString& function : conditionFunctions( expression ) )
+            {
+                if( geometryFunctions.count( function ) )
+                {
+                    testsGeometry = true;
+                }
+                else if( !itemFunctions.count( function ) )
+                {
+                    // fromTo() and the like depend on the connectivity of the whole board,
+                    // which isn't hashed: don't reuse any result.
+                    return std::string();
+                }
+            }
+
+            data += TO_UTF8( expression );
+            data += '\n';
+        }
+
+        for( const DRC_CONSTRAINT& constraint : rule->m_Constraints )
+        {
+            const MINOPTMAX<int>& value = constraint.GetValue();
+
+            data += std::to_string( (int) constraint.m_Type ) + ' ';
+            data += TO_UTF8( constraint.GetName() );
+            data += ' ' + std::to_string( constraint.m_DisallowFlags );
+            data += ' ' + std::to_string( value.HasMin() ? value.Min() : -1 );
+            data += ' ' + std::to_string( value.HasOpt() ? value.Opt() : -1 );
+            data += ' ' + std::to_string( value.HasMax() ? value.Max() : -1 ) + '\n';
+        }
+    }
+
+    if( testsGeometry )
+    {
+        PCB_IO formatter;
+
+        for( const ZONE* zone : m_board->Zones() )
+        {
+            if( zone->GetIsRuleArea() )
+                formatter.Format( zone );
+        }
+
+        data += formatter.GetStringOutput( true );
+
+        for( const FOOTPRINT* footprint : m_board->Footprints() )
+        {
+            data += TO_UTF8( footprint->GetReference() );
+            data += footprint->GetPolyCourtyardFront().Format();
+            data += footprint->GetPolyCourtyardBack().Format();
+
+            for( const ZONE* zone : footprint->Zones() )
+            {
+                if( zone->GetIsRuleArea() )
+                    formatter.Format( zone );
+            }
+
+            data += formatter.GetStringOutput( true );
+        }
+    }
+
+    return DRC_RESULT_CACHE::Hash( data );
+}
+
+
+void DRC_ENGINE::RunIncrementalTests( EDA_UNITS aUnits, const std::vector<BOARD_ITEM*>& aItems,
+                                      const DRC_RTREE& aCopperTree )
+{
+    m_userUnits = aUnits;
+
+    initErrorLimits();
+
+    for( DRC_TEST_PROVIDER* provider : m_testProviders )
+    {
+        if( !provider->IsEnabled() || provider->GetIncrementalErrorCodes().empty() )
+            continue;
+
+        // The providers are shared, and other engines may have been initialised since
+        provider->SetDRCEngine( this );
+
+        if( !provider->RunIncremental( aItems, aCopperTree ) )
+            break;
+    }
+}
+
+
+std::set<int> DRC_ENGINE::GetIncrementalErrorCodes() const
+{
+    std::set<int> codes;
+
+    for( DRC_TEST_PROVIDER* provider : m_testProviders )
+    {
+        if( provider->IsEnabled() )
+        {
+            std::set<int> providerCodes = provider->GetIncrementalErrorCodes();
+            codes.insert( providerCodes.begin(), providerCodes.end() );
+        }
+    }
+
+    return codes;
+}
+
+
+void DRC_ENGINE::initErrorLimits()
+{
+    for( int ii = DRCE_FIRST; ii < DRCE_LAST; ++ii )
+    {
+        if( m_designSettings->Ignore( ii ) )
+            m_errorLimits[ ii ] = 0;
+        else
+            m_errorLimits[ ii ] = INT_MAX;
+    }
 }
 
 
 DRC_CONSTRAINT DRC_ENGINE::EvalRules( DRC_CONSTRAINT_T aConstraintId, const BOARD_ITEM* a,
                                       const BOARD_ITEM* b, PCB_LAYER_ID aLayer,
                                       REPORTER* aReporter )
+{
+    DRC_PROFILE* profile = GetProfile();
+
+    if( !profile )
+        return evalRules( aConstraintId, a, b, aLayer, aReporter );
+
+    PROF_COUNTER   timer;
+    DRC_CONSTRAINT constraint = evalRules( aConstraintId, a, b, aLayer, aReporter );
+
+    profile->AddEvaluation( constraint.GetParentRule(), timer.msecs() );
+
+    return constraint;
+}
+
+
+DRC_CONSTRAINT DRC_ENGINE::evalRules( DRC_CONSTRAINT_T aConstraintId, const BOARD_ITEM* a,
+                                      const BOARD_ITEM* b, PCB_LAYER_ID aLayer,
+                                      REPORTER* aReporter )
 {
 #define REPORT( s ) { if( aReporter ) { aReporter->Report( s ); } }
 #define UNITS aReporter ? aReporter->GetUnits() : EDA_UNITS::MILLIMETRES
@@ -1108,6 +1414,9 @@ void DRC_ENGINE::ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoin
 {
     m_errorLimits[ aItem->GetErrorCode() ] -= 1;
 
+    if( DRC_PROFILE* profile = GetProfile() )
+        profile->AddViolation( aItem->GetViolatingRule() );
+
     if( m_violationHandler )
         m_violationHandler( aItem, aPos );
 
@@ -1154,6 +1463,9 @@ bool DRC_ENGINE::ReportProgress( double aProgress )
 
 bool DRC_ENGINE::ReportPhase( const wxString& aMessage )
 {
+    if( DRC_PROFILE* profile = GetProfile() )
+        profile->BeginPhase( aMessage );
+
     if( !m_progressReporter )
         return true;
 
@@ -25,6 +25,7 @@
 #define DRC_ENGINE_H
 
 #include <memory>
+#include <set>
 #include <vector>
 #include <unordered_map>
 
@@ -35,6 +36,9 @@
 
 class BOARD_DESIGN_SETTINGS;
 class DRC_TEST_PROVIDER;
+class DRC_PROFILE;
+class DRC_RESULT_CACHE;
+class DRC_RTREE;
 class PCB_EDIT_FRAME;
 class DS_PROXY_VIEW_ITEM;
 class BOARD_ITEM;
@@ -112,6 +116,37 @@ public:
         m_violationHandler = DRC_VIOLATION_HANDLER();
     }
 
+    /**
+     * Set an optional cache for the results of the checks of RunTests(), so that those of
+     * which nothing changed since the previous run are not run again.
+     */
+    void SetResultCache( DRC_RESULT_CACHE* aCache ) { m_resultCache = aCache; }
+
+    /**
+     * @return the result cache, if any, while RunTests() runs.
+     */
+    DRC_RESULT_CACHE* GetResultCache() const;
+
+    /**
+     * Set an optional profile to measure the next runs of RunTests() in.
+     */
+    void SetProfile( DRC_PROFILE* aProfile ) { m_profile = aProfile; }
+
+    /**
+     * @return the profile, if any, while RunTests() runs.
+     */
+    DRC_PROFILE* GetProfile() const;
+
+    /**
+     * Set the number of threads the tests may run on, or 0 for one per core.
+     */
+    void SetThreadCount( int aThreadCount ) { m_threadCount = aThreadCount; }
+
+    /**
+     * @return the number of threads the tests may run on.
+     */
+    int GetThreadCount() const;
+
     /**
      * Set an optional reporter for user-level progress info.
      */
@@ -139,6 +174,24 @@ public:
      */
     void RunTests( EDA_UNITS aUnits,  bool aReportAllTrackErrors, bool aTestFootprints );
 
+    /**
+     * Runs again, for the given items only, the tests of the providers which can do so.
+     *
+     * Violations between two items which are not in \a aItems are not looked for.  Nor are
+     * the board caches invalidated: the caller must make sure they are current, and that
+     * \a aCopperTree follows the board.
+     *
+     * @param aItems are the items to check.
+     * @param aCopperTree indexes all the copper items of the board.
+     */
+    void RunIncrementalTests( EDA_UNITS aUnits, const std::vector<BOARD_ITEM*>& aItems,
+                              const DRC_RTREE& aCopperTree );
+
+    /**
+     * @return the error codes RunIncrementalTests() can find.
+     */
+    std::set<int> GetIncrementalErrorCodes() const;
+
 
     bool IsErrorLimitExceeded( int error_code );
 
@@ -207,6 +260,24 @@ private:
     void loadImplicitRules();
     DRC_RULE* createImplicitRule( const wxString& name );
 
+    void initErrorLimits();
+
+    /**
+     * End the profile of the run, if any, and detach it from the R-trees outliving the run.
+     */
+    void endProfile();
+
+    /**
+     * @return a hash of the compiled rules and of the other settings of the run, to tell
+     *         whether the results of a previous run still hold, or an empty string when the
+     *         rule conditions depend on more of the board than the hash covers (fromTo() for
+     *         instance), and no result may be reused.
+     */
+    std::string hashRules() const;
+
+    DRC_CONSTRAINT evalRules( DRC_CONSTRAINT_T aConstraintId, const BOARD_ITEM* a,
+                              const BOARD_ITEM* b, PCB_LAYER_ID aLayer, REPORTER* aReporter );
+
 protected:
     BOARD_DESIGN_SETTINGS*           m_designSettings;
     BOARD*                           m_board;
@@ -228,6 +299,9 @@ protected:
     DRC_VIOLATION_HANDLER            m_violationHandler;
     REPORTER*                        m_reporter;
     PROGRESS_REPORTER*               m_progressReporter;
+    DRC_RESULT_CACHE*                m_resultCache;
+    DRC_PROFILE*                     m_profile;
+    int                              m_threadCount;
 
     wxString m_msg;  // Allocating strings gets expensive enough to want to avoid it
     std::shared_ptr<KIGFX::VIEW_OVERLAY> m_debugOverlay;
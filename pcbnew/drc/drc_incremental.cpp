@@ -0,0 +1,287 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_incremental.h>
+
+#include <algorithm>
+
+#include <footprint.h>
+#include <pad.h>
+#include <pcb_marker.h>
+#include <pcb_track.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <drc/drc_test_provider.h>
+
+
+/**
+ * @return true for the types of items the copper clearance test indexes.
+ */
+static bool isIndexedType( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+    case PCB_PAD_T:
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+    case PCB_TEXT_T:
+    case PCB_FP_TEXT_T:
+        return true;
+
+    default:
+        return BaseType( aItem->Type() ) == PCB_DIMENSION_T;
+    }
+}
+
+
+/**
+ * @return the copper layers the copper clearance test indexes an item on.
+ */
+static LSET copperLayers( const BOARD_ITEM* aItem )
+{
+    LSET layers = aItem->GetLayerSet();
+
+    // Pad holes pierce all the copper layers
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        const PAD* pad = static_cast<const PAD*>( aItem );
+
+        if( pad->GetDrillSizeX() > 0 && pad->GetDrillSizeY() > 0 )
+            layers |= LSET::AllCuMask();
+    }
+
+    return layers & LSET::AllCuMask();
+}
+
+
+DRC_INCREMENTAL::DRC_INCREMENTAL( BOARD* aBoard, std::shared_ptr<DRC_ENGINE> aEngine ) :
+        m_board( aBoard ),
+        m_engine( std::move( aEngine ) ),
+        m_copperTree( true )
+{
+    Reset();
+}
+
+
+void DRC_INCREMENTAL::Reset()
+{
+    m_copperTree.clear();
+    m_children.clear();
+    m_dirty.clear();
+    m_dirtySet.clear();
+    m_removed.clear();
+    m_violations.clear();
+
+    for( PCB_TRACK* track : m_board->Tracks() )
+        index( track );
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+        index( footprint );
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+        index( item );
+
+    for( PCB_MARKER* marker : m_board->Markers() )
+    {
+        std::shared_ptr<DRC_ITEM> item = std::dynamic_pointer_cast<DRC_ITEM>( marker->GetRCItem() );
+        DRC_TEST_PROVIDER*        provider = item ? item->GetViolatingTest() : nullptr;
+
+        if( provider && provider->GetIncrementalErrorCodes().count( item->GetErrorCode() ) )
+        {
+            m_violations[provider].insert( { { item->GetMainItemID(), item->GetAuxItemID() },
+                                             { item, marker->GetPosition() } } );
+        }
+    }
+}
+
+
+void DRC_INCREMENTAL::index( BOARD_ITEM* aItem )
+{
+    if( aItem->Type() == PCB_FOOTPRINT_T )
+    {
+        std::vector<std::pair<BOARD_ITEM*, KIID>>& children = m_children[aItem];
+
+        static_cast<FOOTPRINT*>( aItem )->RunOnChildren(
+                [&]( BOARD_ITEM* aChild )
+                {
+                    if( isIndexedType( aChild ) )
+                    {
+                        children.emplace_back( aChild, aChild->m_Uuid );
+                        index( aChild );
+                    }
+                } );
+
+        return;
+    }
+
+    if( !isIndexedType( aItem ) )
+        return;
+
+    for( PCB_LAYER_ID layer : copperLayers( aItem ).Seq() )
+        m_copperTree.Insert( aItem, layer );
+}
+
+
+void DRC_INCREMENTAL::addItem( BOARD_ITEM* aItem )
+{
+    index( aItem );
+
+    auto markDirty =
+            [&]( BOARD_ITEM* aDirtyItem )
+            {
+                if( m_dirtySet.insert( aDirtyItem ).second )
+                    m_dirty.push_back( aDirtyItem );
+            };
+
+    if( aItem->Type() == PCB_FOOTPRINT_T )
+    {
+        for( const std::pair<BOARD_ITEM*, KIID>& child : m_children[aItem] )
+            markDirty( child.first );
+    }
+    else if( m_copperTree.Contains( aItem ) )
+    {
+        markDirty( aItem );
+    }
+}
+
+
+void DRC_INCREMENTAL::removeItem( BOARD_ITEM* aItem )
+{
+    // Only the pointers are used here; the items may have been swapped out already.
+    auto forget =
+            [&]( BOARD_ITEM* aRemovedItem, const KIID& aId )
+            {
+                m_copperTree.Remove( aRemovedItem );
+                m_removed.insert( aId );
+
+                if( m_dirtySet.erase( aRemovedItem ) )
+                    m_dirty.erase( std::find( m_dirty.begin(), m_dirty.end(), aRemovedItem ) );
+            };
+
+    auto it = m_children.find( aItem );
+
+    if( it != m_children.end() )
+    {
+        for( const std::pair<BOARD_ITEM*, KIID>& child : it->second )
+            forget( child.first, child.second );
+
+        m_children.erase( it );
+    }
+    else if( m_copperTree.Contains( aItem ) )
+    {
+        forget( aItem, aItem->m_Uuid );
+    }
+}
+
+
+void DRC_INCREMENTAL::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    addItem( aBoardItem );
+}
+
+
+void DRC_INCREMENTAL::OnBoardItemsAdded( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems )
+{
+    for( BOARD_ITEM* item : aBoardItems )
+        addItem( item );
+}
+
+
+void DRC_INCREMENTAL::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    removeItem( aBoardItem );
+}
+
+
+void DRC_INCREMENTAL::OnBoardItemsRemoved( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems )
+{
+    for( BOARD_ITEM* item : aBoardItems )
+        removeItem( item );
+}
+
+
+void DRC_INCREMENTAL::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    removeItem( aBoardItem );
+    addItem( aBoardItem );
+}
+
+
+void DRC_INCREMENTAL::OnBoardItemsChanged( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems )
+{
+    for( BOARD_ITEM* item : aBoardItems )
+    {
+        removeItem( item );
+        addItem( item );
+    }
+}
+
+
+void DRC_INCREMENTAL::Update( EDA_UNITS aUnits, std::vector<VIOLATION>& aFound,
+                              std::vector<std::shared_ptr<DRC_ITEM>>& aWithdrawn )
+{
+    std::set<KIID> changed;
+
+    std::swap( changed, m_removed );
+
+    for( BOARD_ITEM* item : m_dirty )
+        changed.insert( item->m_Uuid );
+
+    for( std::pair<DRC_TEST_PROVIDER* const, VIOLATIONS>& providerViolations : m_violations )
+    {
+        VIOLATIONS& violations = providerViolations.second;
+
+        for( auto it = violations.begin(); it != violations.end(); )
+        {
+            if( changed.count( it->first.first ) || changed.count( it->first.second ) )
+            {
+                aWithdrawn.push_back( it->second.item );
+                it = violations.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    if( !m_dirty.empty() )
+    {
+        m_engine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+                {
+                    ITEM_PAIR items( aItem->GetMainItemID(), aItem->GetAuxItemID() );
+
+                    m_violations[aItem->GetViolatingTest()].insert( { items, { aItem, aPos } } );
+                    aFound.push_back( { aItem, aPos } );
+                } );
+
+        m_engine->RunIncrementalTests( aUnits, m_dirty, m_copperTree );
+        m_engine->ClearViolationHandler();
+    }
+
+    m_dirty.clear();
+    m_dirtySet.clear();
+}
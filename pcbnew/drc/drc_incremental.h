@@ -0,0 +1,128 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_INCREMENTAL_H
+#define DRC_INCREMENTAL_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <board.h>
+#include <eda_units.h>
+#include <kiid.h>
+#include <drc/drc_rtree.h>
+
+class DRC_ENGINE;
+class DRC_ITEM;
+class DRC_TEST_PROVIDER;
+
+
+/**
+ * Keeps the DRC results of a board current while it is edited, by only checking again what
+ * each change touches.
+ *
+ * As a listener of the board it keeps an index of the copper items up to date, and remembers
+ * which items were added, changed or removed.  Update() then runs the incremental tests of the
+ * DRC engine over the changed items, which finds their neighbours within the worst clearance
+ * through the index.  The violations are kept per test provider and pair of items, so that
+ * those of the changed items can be withdrawn before they are looked for again.
+ *
+ * The owner registers it as a listener of the board, and must unregister it if the board
+ * outlives it.
+ *
+ * Zones are not followed: they only change for good when refilled, after which a full DRC
+ * run is in order anyway.
+ */
+class DRC_INCREMENTAL : public BOARD_LISTENER
+{
+public:
+    struct VIOLATION
+    {
+        std::shared_ptr<DRC_ITEM> item;
+        wxPoint                   position;
+    };
+
+    /// The main and auxiliary item of a violation (niluuid if there is only one item)
+    using ITEM_PAIR = std::pair<KIID, KIID>;
+    using VIOLATIONS = std::multimap<ITEM_PAIR, VIOLATION>;
+
+    DRC_INCREMENTAL( BOARD* aBoard, std::shared_ptr<DRC_ENGINE> aEngine );
+
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemsAdded( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemsRemoved( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemsChanged( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems ) override;
+
+    /**
+     * Index the board again and take over the violations of its markers which the
+     * incremental tests look for.  Needed after a full DRC run or a change of rules.
+     */
+    void Reset();
+
+    /**
+     * @return true if items were added, changed or removed since the last update.
+     */
+    bool IsDirty() const { return !m_dirty.empty() || !m_removed.empty(); }
+
+    /**
+     * Check the items changed since the last update again.
+     *
+     * @param aFound receives the violations found.
+     * @param aWithdrawn receives the violations of the changed items which were known before.
+     *                   Those which still hold are found again.
+     */
+    void Update( EDA_UNITS aUnits, std::vector<VIOLATION>& aFound,
+                 std::vector<std::shared_ptr<DRC_ITEM>>& aWithdrawn );
+
+    const std::map<DRC_TEST_PROVIDER*, VIOLATIONS>& GetViolations() const
+    {
+        return m_violations;
+    }
+
+private:
+    void addItem( BOARD_ITEM* aItem );
+    void removeItem( BOARD_ITEM* aItem );
+
+    /// Index a copper item, or the copper items of a footprint
+    void index( BOARD_ITEM* aItem );
+
+    BOARD*                      m_board;
+    std::shared_ptr<DRC_ENGINE> m_engine;
+
+    DRC_RTREE                   m_copperTree;
+
+    /// The children of each footprint as they were indexed, as they may be swapped out by undo
+    std::unordered_map<BOARD_ITEM*, std::vector<std::pair<BOARD_ITEM*, KIID>>> m_children;
+
+    std::vector<BOARD_ITEM*>    m_dirty;        ///< in the order they changed
+    std::set<BOARD_ITEM*>       m_dirtySet;
+    std::set<KIID>              m_removed;
+
+    std::map<DRC_TEST_PROVIDER*, VIOLATIONS> m_violations;
+};
+
+#endif // DRC_INCREMENTAL_H
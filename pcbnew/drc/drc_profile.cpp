@@ -0,0 +1,251 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_profile.h>
+
+#include <nlohmann/json.hpp>
+#include <wx/wfstream.h>
+
+#include <build_version.h>
+#include <macros.h>
+#include <drc/drc_rule.h>
+
+
+/// Bumped whenever the meaning of a field of the report changes
+static const int PROFILE_FORMAT_VERSION = 1;
+
+
+DRC_PROFILE::DRC_PROFILE() :
+        m_running( false ),
+        m_time( 0.0 ),
+        m_inProvider( false ),
+        m_inPhase( false ),
+        m_rtreeQueries( 0 ),
+        m_polygonOps( 0 )
+{
+}
+
+
+void DRC_PROFILE::BeginRun( const wxString& aBoardName, const std::vector<DRC_RULE*>& aRules )
+{
+    m_boardName = aBoardName;
+    m_time = 0.0;
+    m_counts = COUNTS();
+    m_providers.clear();
+    m_rules.clear();
+    m_ruleIndices.clear();
+
+    for( const DRC_RULE* rule : aRules )
+    {
+        m_ruleIndices[rule] = (int) m_rules.size();
+        m_rules.emplace_back();
+        m_rules.back().m_Name = rule->m_Name;
+    }
+
+    m_rtreeQueries = 0;
+    m_polygonOps = 0;
+
+    m_inProvider = false;
+    m_inPhase = false;
+    m_running = true;
+    m_runTimer.Start();
+}
+
+
+void DRC_PROFILE::EndRun()
+{
+    EndProvider();
+
+    m_runTimer.Stop();
+    m_time = m_runTimer.msecs();
+    m_counts = currentCounts();
+
+    m_running = false;
+}
+
+
+void DRC_PROFILE::BeginProvider( const wxString& aName )
+{
+    EndProvider();
+
+    m_providers.emplace_back();
+    m_providers.back().m_Name = aName;
+
+    m_providerStart = currentCounts();
+    m_providerTimer.Start();
+    m_inProvider = true;
+}
+
+
+void DRC_PROFILE::EndProvider()
+{
+    if( !m_inProvider )
+        return;
+
+    endPhase();
+
+    PROVIDER& provider = m_providers.back();
+    COUNTS    counts = currentCounts();
+
+    m_providerTimer.Stop();
+    provider.m_Time = m_providerTimer.msecs();
+    provider.m_Counts.m_EvalRules = counts.m_EvalRules - m_providerStart.m_EvalRules;
+    provider.m_Counts.m_RTreeQueries = counts.m_RTreeQueries - m_providerStart.m_RTreeQueries;
+    provider.m_Counts.m_PolygonOps = counts.m_PolygonOps - m_providerStart.m_PolygonOps;
+    provider.m_Counts.m_Violations = counts.m_Violations - m_providerStart.m_Violations;
+
+    m_inProvider = false;
+}
+
+
+void DRC_PROFILE::BeginPhase( const wxString& aName )
+{
+    if( !m_inProvider )
+        return;
+
+    endPhase();
+
+    m_providers.back().m_Phases.emplace_back();
+    m_providers.back().m_Phases.back().m_Name = aName;
+
+    m_phaseStart = currentCounts();
+    m_phaseTimer.Start();
+    m_inPhase = true;
+}
+
+
+void DRC_PROFILE::endPhase()
+{
+    if( !m_inPhase )
+        return;
+
+    PHASE& phase = m_providers.back().m_Phases.back();
+    COUNTS counts = currentCounts();
+
+    m_phaseTimer.Stop();
+    phase.m_Time = m_phaseTimer.msecs();
+    phase.m_Counts.m_EvalRules = counts.m_EvalRules - m_phaseStart.m_EvalRules;
+    phase.m_Counts.m_RTreeQueries = counts.m_RTreeQueries - m_phaseStart.m_RTreeQueries;
+    phase.m_Counts.m_PolygonOps = counts.m_PolygonOps - m_phaseStart.m_PolygonOps;
+    phase.m_Counts.m_Violations = counts.m_Violations - m_phaseStart.m_Violations;
+
+    m_inPhase = false;
+}
+
+
+void DRC_PROFILE::AddEvaluation( const DRC_RULE* aRule, double aMsecs )
+{
+    m_counts.m_EvalRules++;
+
+    auto it = m_ruleIndices.find( aRule );
+
+    if( it != m_ruleIndices.end() )
+    {
+        m_rules[it->second].m_Evaluations++;
+        m_rules[it->second].m_EvalTime += aMsecs;
+    }
+}
+
+
+void DRC_PROFILE::AddViolation( const DRC_RULE* aRule )
+{
+    m_counts.m_Violations++;
+
+    auto it = m_ruleIndices.find( aRule );
+
+    if( it != m_ruleIndices.end() )
+        m_rules[it->second].m_Violations++;
+}
+
+
+DRC_PROFILE::COUNTS DRC_PROFILE::currentCounts() const
+{
+    COUNTS counts = m_counts;
+
+    if( m_running )
+    {
+        counts.m_RTreeQueries = m_rtreeQueries;
+        counts.m_PolygonOps = m_polygonOps;
+    }
+
+    return counts;
+}
+
+
+static nlohmann::json formatCounts( const DRC_PROFILE::COUNTS& aCounts )
+{
+    return { { "evalRules",    aCounts.m_EvalRules },
+             { "rtreeQueries", aCounts.m_RTreeQueries },
+             { "polygonOps",   aCounts.m_PolygonOps },
+             { "violations",   aCounts.m_Violations } };
+}
+
+
+std::string DRC_PROFILE::Format() const
+{
+    nlohmann::json providers = nlohmann::json::array();
+    nlohmann::json rules = nlohmann::json::array();
+
+    for( const PROVIDER& provider : m_providers )
+    {
+        nlohmann::json phases = nlohmann::json::array();
+
+        for( const PHASE& phase : provider.m_Phases )
+        {
+            phases.push_back( { { "name",   TO_UTF8( phase.m_Name ) },
+                                { "time",   phase.m_Time },
+                                { "counts", formatCounts( phase.m_Counts ) } } );
+        }
+
+        providers.push_back( { { "name",   TO_UTF8( provider.m_Name ) },
+                               { "time",   provider.m_Time },
+                               { "counts", formatCounts( provider.m_Counts ) },
+                               { "phases", phases } } );
+    }
+
+    for( const RULE& rule : m_rules )
+    {
+        rules.push_back( { { "name",        TO_UTF8( rule.m_Name ) },
+                           { "evaluations", rule.m_Evaluations },
+                           { "evalTime",    rule.m_EvalTime },
+                           { "violations",  rule.m_Violations } } );
+    }
+
+    nlohmann::json js = { { "version",   PROFILE_FORMAT_VERSION },
+                          { "kicad",     TO_UTF8( GetBuildVersion() ) },
+                          { "board",     TO_UTF8( m_boardName ) },
+                          { "time",      m_time },
+                          { "counts",    formatCounts( m_counts ) },
+                          { "providers", providers },
+                          { "rules",     rules } };
+
+    return js.dump( 2 ) + "\n";
+}
+
+
+bool DRC_PROFILE::Save( const wxString& aFilePath ) const
+{
+    std::string        buffer = Format();
+    wxFFileOutputStream fileStream( aFilePath, "wb" );
+
+    return fileStream.IsOk() && fileStream.WriteAll( buffer.c_str(), buffer.size() );
+}
@@ -0,0 +1,169 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_PROFILE_H
+#define DRC_PROFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <profile.h>
+#include <wx/string.h>
+
+class DRC_RULE;
+
+
+/**
+ * Measures where the time of a DRC run goes: the wall time of each test provider and of each
+ * of its phases, and what they did meanwhile.  The rules are profiled as well.
+ *
+ * The counts of a run depend only on the board and its rules, not on the machine or on the
+ * number of threads, so that the profiles of a reference board can be compared from one
+ * version to the next.  Items are listed in the order of the run, and rules in the order of
+ * the engine.
+ *
+ * Only the R-tree queries and polygon operations may be counted from worker threads.  The
+ * R-trees of the run count theirs in the profile given to DRC_RTREE::SetProfile().
+ */
+class DRC_PROFILE
+{
+public:
+    /// What the DRC did during a provider, a phase, or the whole run
+    struct COUNTS
+    {
+        int64_t m_EvalRules = 0;
+        int64_t m_RTreeQueries = 0;
+        int64_t m_PolygonOps = 0;
+        int64_t m_Violations = 0;
+    };
+
+    struct PHASE
+    {
+        wxString m_Name;
+        double   m_Time = 0.0;      ///< milliseconds
+        COUNTS   m_Counts;
+    };
+
+    struct PROVIDER
+    {
+        wxString           m_Name;
+        double             m_Time = 0.0;
+        COUNTS             m_Counts;
+        std::vector<PHASE> m_Phases;
+    };
+
+    struct RULE
+    {
+        wxString m_Name;
+        int64_t  m_Evaluations = 0;     ///< times the rule was the one resolved for two items
+        double   m_EvalTime = 0.0;      ///< milliseconds spent resolving it
+        int64_t  m_Violations = 0;
+    };
+
+    DRC_PROFILE();
+
+    /**
+     * Start profiling a run of the DRC of \a aBoardName with the rules \a aRules.
+     */
+    void BeginRun( const wxString& aBoardName, const std::vector<DRC_RULE*>& aRules );
+
+    void EndRun();
+
+    bool IsRunning() const { return m_running; }
+
+    /**
+     * Start profiling a test provider, or the preparation of the run.
+     */
+    void BeginProvider( const wxString& aName );
+
+    void EndProvider();
+
+    /**
+     * Start profiling a phase of the current provider, ending the previous one.
+     */
+    void BeginPhase( const wxString& aName );
+
+    /**
+     * Account for an evaluation of the rules which resolved to \a aRule, if any.
+     */
+    void AddEvaluation( const DRC_RULE* aRule, double aMsecs );
+
+    void AddViolation( const DRC_RULE* aRule );
+
+    /**
+     * Account for a query of a DRC_RTREE, from any thread.
+     */
+    void CountRTreeQuery()
+    {
+        m_rtreeQueries.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    /**
+     * Account for a polygon triangulation or boolean operation, from any thread.
+     */
+    void CountPolygonOp()
+    {
+        m_polygonOps.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    double GetTime() const { return m_time; }
+    const COUNTS& GetCounts() const { return m_counts; }
+    const std::vector<PROVIDER>& GetProviders() const { return m_providers; }
+    const std::vector<RULE>& GetRules() const { return m_rules; }
+
+    /**
+     * @return the profile of the last run, as JSON text.
+     */
+    std::string Format() const;
+
+    bool Save( const wxString& aFilePath ) const;
+
+private:
+    /// @return the counts since the start of the run
+    COUNTS currentCounts() const;
+
+    void endPhase();
+
+    bool                                     m_running;
+    wxString                                 m_boardName;
+    double                                   m_time;
+    COUNTS                                   m_counts;
+    std::vector<PROVIDER>                    m_providers;
+    std::vector<RULE>                        m_rules;
+    std::unordered_map<const DRC_RULE*, int> m_ruleIndices;
+
+    PROF_COUNTER                             m_runTimer;
+    PROF_COUNTER                             m_providerTimer;
+    PROF_COUNTER                             m_phaseTimer;
+    COUNTS                                   m_providerStart;
+    COUNTS                                   m_phaseStart;
+    bool                                     m_inProvider;
+    bool                                     m_inPhase;
+
+    std::atomic<int64_t>                     m_rtreeQueries;
+    std::atomic<int64_t>                     m_polygonOps;
+};
+
+#endif // DRC_PROFILE_H
@@ -0,0 +1,279 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_result_cache.h>
+
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+#include <wx/wfstream.h>
+
+#include <macros.h>
+#include <md5_hash.h>
+#include <board_connected_item.h>
+#include <footprint.h>
+#include <pad.h>
+#include <pcb_group.h>
+#include <pcb_track.h>
+#include <plugins/kicad/kicad_plugin.h>
+
+
+/// Results of files written by another version of the cache are not reused
+static const int CACHE_FILE_VERSION = 2;
+
+
+DRC_RESULT_CACHE::DRC_RESULT_CACHE() :
+        m_formatter( new PCB_IO() ),
+        m_running( false ),
+        m_reused( 0 ),
+        m_recomputed( 0 )
+{
+}
+
+
+DRC_RESULT_CACHE::~DRC_RESULT_CACHE()
+{
+}
+
+
+std::string DRC_RESULT_CACHE::Hash( const std::string& aData )
+{
+    MD5_HASH hash;
+
+    hash.Init();
+    hash.Hash( (uint8_t*) aData.data(), (uint32_t) aData.size() );
+    hash.Finalize();
+
+    return hash.Format( true );
+}
+
+
+bool DRC_RESULT_CACHE::Load( const wxString& aFilePath )
+{
+    m_rulesHash.clear();
+    m_previous.clear();
+
+    FILE* fp = wxFopen( aFilePath, wxT( "rt" ) );
+
+    if( !fp )
+        return false;
+
+    nlohmann::json js = nlohmann::json::parse( fp, nullptr, /* allow_exceptions = */ false );
+
+    fclose( fp );
+
+    if( js.is_discarded() )
+        return false;
+
+    try
+    {
+        if( js.at( "version" ).get<int>() != CACHE_FILE_VERSION )
+            return false;
+
+        for( const auto& check : js.at( "checks" ).items() )
+        {
+            RESULT& result = m_previous[check.key()];
+
+            result.m_Continue = !check.value().value( "stop", false );
+
+            if( !check.value().contains( "violations" ) )
+                continue;
+
+            for( const nlohmann::json& violation : check.value().at( "violations" ) )
+            {
+                VIOLATION v;
+
+                v.m_ErrorCode = violation.at( "code" ).get<int>();
+                v.m_Position.x = violation.at( "x" ).get<int>();
+                v.m_Position.y = violation.at( "y" ).get<int>();
+                v.m_Constraint = violation.at( "constraint" ).get<int>();
+                v.m_Swapped = violation.at( "swapped" ).get<bool>();
+                v.m_Layer = (PCB_LAYER_ID) violation.at( "layer" ).get<int>();
+                v.m_Clearance = violation.at( "clearance" ).get<int>();
+                v.m_Actual = violation.at( "actual" ).get<int>();
+
+                result.m_Violations.push_back( v );
+            }
+        }
+
+        m_rulesHash = js.at( "rules" ).get<std::string>();
+    }
+    catch( ... )
+    {
+        // A damaged cache is no worse than none at all
+        m_previous.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool DRC_RESULT_CACHE::Save( const wxString& aFilePath ) const
+{
+    nlohmann::json checks = nlohmann::json::object();
+
+    for( const std::pair<const std::string, RESULT>& check : m_previous )
+    {
+        nlohmann::json js = nlohmann::json::object();
+
+        if( !check.second.m_Continue )
+            js["stop"] = true;
+
+        for( const VIOLATION& v : check.second.m_Violations )
+        {
+            js["violations"].push_back( { { "code",       v.m_ErrorCode },
+                                          { "x",          v.m_Position.x },
+                                          { "y",          v.m_Position.y },
+                                          { "constraint", v.m_Constraint },
+                                          { "swapped",    v.m_Swapped },
+                                          { "layer",      (int) v.m_Layer },
+                                          { "clearance",  v.m_Clearance },
+                                          { "actual",     v.m_Actual } } );
+        }
+
+        checks[check.first] = js;
+    }
+
+    nlohmann::json js = { { "version", CACHE_FILE_VERSION },
+                          { "rules",   m_rulesHash },
+                          { "checks",  checks } };
+
+    std::stringstream buffer;
+    buffer << js << std::endl;
+
+    wxFFileOutputStream fileStream( aFilePath, "wb" );
+
+    return fileStream.IsOk() && fileStream.WriteAll( buffer.str().c_str(), buffer.str().size() );
+}
+
+
+void DRC_RESULT_CACHE::BeginRun( const std::string& aRulesHash )
+{
+    if( aRulesHash.empty() || aRulesHash != m_rulesHash )
+        m_previous.clear();
+
+    m_rulesHash = aRulesHash;
+    m_current.clear();
+    m_itemHashes.clear();
+    m_reused = 0;
+    m_recomputed = 0;
+    m_running = true;
+}
+
+
+void DRC_RESULT_CACHE::EndRun()
+{
+    m_previous = std::move( m_current );
+    m_current.clear();
+    m_itemHashes.clear();
+    m_running = false;
+}
+
+
+std::string DRC_RESULT_CACHE::MakeKey( const char* aCheck, const BOARD_ITEM* aItemA,
+                                       const BOARD_ITEM* aItemB, PCB_LAYER_ID aLayer, int aFlags )
+{
+    std::string key( aCheck );
+
+    key += ' ' + std::to_string( (int) aLayer ) + ' ' + std::to_string( aFlags ) + ' ';
+    key += itemHash( aItemA );
+    key += itemHash( aItemB );
+
+    return Hash( key );
+}
+
+
+const DRC_RESULT_CACHE::RESULT* DRC_RESULT_CACHE::Find( const std::string& aKey )
+{
+    auto it = m_previous.find( aKey );
+
+    if( it == m_previous.end() )
+        return nullptr;
+
+    m_reused++;
+
+    return &( m_current[aKey] = it->second );
+}
+
+
+void DRC_RESULT_CACHE::Store( const std::string& aKey, RESULT aResult )
+{
+    m_recomputed++;
+    m_current[aKey] = std::move( aResult );
+}
+
+
+std::string DRC_RESULT_CACHE::hashItem( const BOARD_ITEM* aItem )
+{
+    // The file format covers the geometry, layers, net and local overrides of an item
+    m_formatter->Format( aItem );
+
+    std::string data = m_formatter->GetStringOutput( true );
+
+    // Rules may also test properties which are not saved with the item
+    if( const BOARD_CONNECTED_ITEM* cItem = dynamic_cast<const BOARD_CONNECTED_ITEM*>( aItem ) )
+    {
+        data += TO_UTF8( cItem->GetNetname() );
+        data += '\n';
+        data += TO_UTF8( cItem->GetNetClassName() );
+        data += '\n';
+    }
+
+    if( PCB_GROUP* group = aItem->GetParentGroup() )
+    {
+        data += TO_UTF8( group->GetName() );
+        data += '\n';
+    }
+
+    // Unconnected layers of pads and vias may be removed, depending on the connectivity
+    if( aItem->Type() == PCB_PAD_T || aItem->Type() == PCB_VIA_T )
+    {
+        for( PCB_LAYER_ID layer : ( aItem->GetLayerSet() & LSET::AllCuMask() ).Seq() )
+        {
+            bool flashed = aItem->Type() == PCB_PAD_T
+                                   ? static_cast<const PAD*>( aItem )->FlashLayer( layer )
+                                   : static_cast<const PCB_VIA*>( aItem )->FlashLayer( layer );
+
+            data += flashed ? '1' : '0';
+        }
+    }
+
+    return Hash( data );
+}
+
+
+const std::string& DRC_RESULT_CACHE::itemHash( const BOARD_ITEM* aItem )
+{
+    auto it = m_itemHashes.find( aItem );
+
+    if( it != m_itemHashes.end() )
+        return it->second;
+
+    std::string hash = hashItem( aItem );
+
+    // The items of a footprint are saved relative to it, and are tested against its properties
+    if( aItem->GetParent() && aItem->GetParent()->Type() == PCB_FOOTPRINT_T )
+        hash = Hash( hash + itemHash( static_cast<BOARD_ITEM*>( aItem->GetParent() ) ) );
+
+    return m_itemHashes[aItem] = hash;
+}
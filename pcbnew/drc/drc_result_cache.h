@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RESULT_CACHE_H
+#define DRC_RESULT_CACHE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <layers_id_colors_and_visibility.h>
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+class BOARD_ITEM;
+class PCB_IO;
+
+
+/**
+ * Keeps the results of DRC checks between two items from one DRC run to the next, and across
+ * sessions in a file of the project.
+ *
+ * A check is known by a key hashed from the name of the check, the layer, and the state of
+ * both items which the DRC depends on: their geometry, layers, nets and net classes, and for
+ * the items of a footprint the whole footprint.  The rule set of the run, which the engine
+ * hashes, must match the one of the previous run for any result to be reused.
+ *
+ * The results of a run replace those of the previous one, so that checks which no longer
+ * exist are forgotten.  Not thread safe: checks are looked up and stored on one thread.
+ */
+class DRC_RESULT_CACHE
+{
+public:
+    /**
+     * A violation found by a check, reported again against the items of the check.
+     *
+     * The message and the violated rule are not kept: they are rebuilt from this data when
+     * the violation is reported, so that they follow the language of the session.
+     */
+    struct VIOLATION
+    {
+        int          m_ErrorCode;
+        wxPoint      m_Position;
+        int          m_Constraint;  ///< DRC_CONSTRAINT_T of the violated constraint
+        bool         m_Swapped;     ///< the constraint is evaluated for the items swapped
+        PCB_LAYER_ID m_Layer;       ///< the layer the constraint is evaluated on
+        int          m_Clearance;
+        int          m_Actual;
+    };
+
+    struct RESULT
+    {
+        bool                   m_Continue = true;  ///< what the check returned
+        std::vector<VIOLATION> m_Violations;
+    };
+
+    DRC_RESULT_CACHE();
+    ~DRC_RESULT_CACHE();
+
+    /**
+     * Read the results of a previous run.
+     *
+     * @return false if the file is missing or cannot be read, in which case there are none.
+     */
+    bool Load( const wxString& aFilePath );
+
+    /**
+     * Write the results of the last run.
+     */
+    bool Save( const wxString& aFilePath ) const;
+
+    /**
+     * Start a run.  The results of the previous run are only reused if \a aRulesHash matches
+     * its own.
+     *
+     * @param aRulesHash is empty when the results depend on more than the items checked, in
+     *                   which case none are reused.
+     */
+    void BeginRun( const std::string& aRulesHash );
+
+    /**
+     * Finish a run: its results become the previous ones.
+     */
+    void EndRun();
+
+    bool IsRunning() const { return m_running; }
+
+    /**
+     * @return the key of the check \a aCheck between \a aItemA and \a aItemB on \a aLayer.
+     *
+     * @param aFlags distinguishes between the variants of a check, such as the tests which
+     *               are still enabled by the error limits.
+     */
+    std::string MakeKey( const char* aCheck, const BOARD_ITEM* aItemA, const BOARD_ITEM* aItemB,
+                         PCB_LAYER_ID aLayer, int aFlags );
+
+    /**
+     * @return the result of the check \a aKey in the previous run, or nullptr if it has to be
+     *         run again.  A result found is kept for the next run.
+     */
+    const RESULT* Find( const std::string& aKey );
+
+    /**
+     * Keep the result of the check \a aKey, which had to be run again.
+     */
+    void Store( const std::string& aKey, RESULT aResult );
+
+    int GetReusedCount() const { return m_reused; }
+    int GetRecomputedCount() const { return m_recomputed; }
+
+    /**
+     * @return the hash the cache uses for \a aData, as text.
+     */
+    static std::string Hash( const std::string& aData );
+
+private:
+    /**
+     * @return a hash of the state of \a aItem itself which the DRC depends on.
+     */
+    std::string hashItem( const BOARD_ITEM* aItem );
+
+    /// @return the hash of \a aItem and of its footprint, computed once per run
+    const std::string& itemHash( const BOARD_ITEM* aItem );
+
+    std::unique_ptr<PCB_IO>                       m_formatter;
+
+    bool                                          m_running;
+    std::string                                   m_rulesHash;
+
+    std::unordered_map<std::string, RESULT>       m_previous;
+    std::unordered_map<std::string, RESULT>       m_current;
+    std::unordered_map<const BOARD_ITEM*, std::string> m_itemHashes;
+
+    int                                           m_reused;
+    int                                           m_recomputed;
+};
+
+#endif // DRC_RESULT_CACHE_H
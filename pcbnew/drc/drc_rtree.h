@@ -29,10 +29,12 @@
 #include <board_item.h>
 #include <fp_text.h>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <set>
 #include <vector>
 
+#include <drc/drc_profile.h>
 #include <geometry/rtree.h>
 #include <geometry/shape.h>
 #include <math/vector2d.h>
@@ -67,7 +69,13 @@ private:
 
 public:
 
-    DRC_RTREE()
+    /**
+     * @param aRemovable set to allow items to be removed again, at the cost of remembering
+     *                   where each of them was inserted.
+     */
+    DRC_RTREE( bool aRemovable = false ) :
+            m_removable( aRemovable ),
+            m_profile( nullptr )
     {
         for( int layer : LSET::AllLayersMask().Seq() )
             m_tree[layer] = new drc_rtree();
@@ -77,10 +85,17 @@ public:
 
     ~DRC_RTREE()
     {
+        deleteEntries();
+
         for( auto tree : m_tree )
             delete tree;
     }
 
+    /**
+     * Count the queries of the tree in \a aProfile, or stop counting them if it is null.
+     */
+    void SetProfile( DRC_PROFILE* aProfile ) { m_profile = aProfile; }
+
     /**
      * Function Insert()
      * Inserts an item into the tree on a particular layer with an optional worst clearance.
@@ -92,9 +107,20 @@ public:
         if( aItem->Type() == PCB_FP_TEXT_T && !static_cast<FP_TEXT*>( aItem )->IsVisible() )
             return;
 
-        std::vector<SHAPE*> subshapes;
-        std::shared_ptr<SHAPE> shape = aItem->GetEffectiveShape( ToLAYER_ID( aLayer ) );
-        subshapes.clear();
+        Insert( aItem, aLayer, aItem->GetEffectiveShape( ToLAYER_ID( aLayer ) ), aWorstClearance );
+    }
+
+    /**
+     * Inserts a shape on behalf of an item, for items whose shape on a layer isn't their
+     * effective shape (such as the courtyards of a footprint).
+     */
+    void Insert( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, std::shared_ptr<SHAPE> aShape,
+                 int aWorstClearance = 0 )
+    {
+        wxASSERT( aLayer != UNDEFINED_LAYER );
+
+        std::vector<SHAPE*>    subshapes;
+        std::shared_ptr<SHAPE> shape = std::move( aShape );
 
         if( shape->HasIndexableSubshapes() )
             shape->GetIndexableSubshapes( subshapes );
@@ -113,7 +139,46 @@ public:
 
             m_tree[aLayer]->Insert( mmin, mmax, itemShape );
             m_count++;
+
+            if( m_removable )
+                m_entries[aItem].push_back( { aLayer, bbox, itemShape } );
+        }
+    }
+
+    /**
+     * Removes an item from all the layers it was inserted on.  The item itself isn't looked
+     * at, so it may already have been changed or deleted.
+     *
+     * Only available for trees created as removable.
+     */
+    void Remove( BOARD_ITEM* aItem )
+    {
+        wxASSERT( m_removable );
+
+        auto it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        for( const ENTRY& entry : it->second )
+        {
+            const int mmin[2] = { entry.bbox.GetX(), entry.bbox.GetY() };
+            const int mmax[2] = { entry.bbox.GetRight(), entry.bbox.GetBottom() };
+
+            m_tree[entry.layer]->Remove( mmin, mmax, entry.itemShape );
+            delete entry.itemShape;
+            m_count--;
         }
+
+        m_entries.erase( it );
+    }
+
+    /**
+     * @return true if \a aItem was inserted into a removable tree.
+     */
+    bool Contains( BOARD_ITEM* aItem ) const
+    {
+        return m_entries.count( aItem ) > 0;
     }
 
     /**
@@ -125,6 +190,7 @@ public:
         for( auto tree : m_tree )
             tree->RemoveAll();
 
+        deleteEntries();
         m_count = 0;
     }
 
@@ -156,6 +222,7 @@ public:
                     return true;
                 };
 
+        countQuery();
         this->m_tree[aTargetLayer]->Search( min, max, visit );
         return count > 0;
     }
@@ -228,6 +295,7 @@ public:
                     return true;
                 };
 
+        countQuery();
         this->m_tree[aTargetLayer]->Search( min, max, visit );
         return count;
     }
@@ -274,6 +342,7 @@ public:
                     return true;
                 };
 
+        countQuery();
         this->m_tree[aLayer]->Search( min, max, visit );
 
         if( collision )
@@ -311,6 +380,7 @@ public:
                     return true;
                 };
 
+        countQuery();
         this->m_tree[aLayer]->Search( min, max, visit );
 
         return collision;
@@ -365,6 +435,7 @@ public:
                             return true;
                         };
 
+                countQuery();
                 this->m_tree[targetLayer]->Search( min, max, visit );
             };
         }
@@ -475,8 +546,37 @@ public:
 
 
 private:
+    /// Where an item of a removable tree went, so that it can be taken out again.
+    struct ENTRY
+    {
+        PCB_LAYER_ID     layer;
+        BOX2I            bbox;
+        ITEM_WITH_SHAPE* itemShape;
+    };
+
+    void countQuery() const
+    {
+        if( m_profile )
+            m_profile->CountRTreeQuery();
+    }
+
+    void deleteEntries()
+    {
+        for( const std::pair<BOARD_ITEM* const, std::vector<ENTRY>>& item : m_entries )
+        {
+            for( const ENTRY& entry : item.second )
+                delete entry.itemShape;
+        }
+
+        m_entries.clear();
+    }
+
     drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
     size_t      m_count;
+
+    bool                                                  m_removable;
+    std::unordered_map<BOARD_ITEM*, std::vector<ENTRY>>   m_entries;
+    DRC_PROFILE*                                          m_profile;
 };
 
 
@@ -21,10 +21,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 #include <drc/drc_engine.h>
 #include <drc/drc_item.h>
 #include <drc/drc_test_provider.h>
 #include <pcb_track.h>
+#include <track_columns.h>
 #include <footprint.h>
 #include <pad.h>
 #include <zone.h>
@@ -167,25 +172,15 @@ int DRC_TEST_PROVIDER::forEachGeometryItem( const std::vector<KICAD_T>& aTypes,
             typeMask[ aType ] = true;
     }
 
-    for( PCB_TRACK* item : brd->Tracks() )
+    // Filter the tracks on their columns, so that only those we want are touched
+    std::shared_ptr<const TRACK_COLUMNS> tracks = brd->GetTrackColumns();
+
+    for( size_t row = 0; row < tracks->Size(); ++row )
     {
-        if( (item->GetLayerSet() & aLayers).any() )
+        if( typeMask[ tracks->Type( row ) ] && ( tracks->Layers( row ) & aLayers ).any() )
         {
-            if( typeMask[ PCB_TRACE_T ] && item->Type() == PCB_TRACE_T )
-            {
-                aFunc( item );
-                n++;
-            }
-            else if( typeMask[ PCB_VIA_T ] && item->Type() == PCB_VIA_T )
-            {
-                aFunc( item );
-                n++;
-            }
-            else if( typeMask[ PCB_ARC_T ] && item->Type() == PCB_ARC_T )
-            {
-                aFunc( item );
-                n++;
-            }
+            aFunc( tracks->Item( row ) );
+            n++;
         }
     }
 
@@ -323,6 +318,56 @@ int DRC_TEST_PROVIDER::forEachGeometryItem( const std::vector<KICAD_T>& aTypes,
 }
 
 
+bool DRC_TEST_PROVIDER::forEachInParallel( size_t aCount,
+                                           const std::function<void( size_t )>& aFunc )
+{
+    std::atomic<size_t> next( 0 );
+    std::atomic<size_t> done( 0 );
+    std::atomic<bool>   cancelled( false );
+
+    auto worker =
+            [&]() -> size_t
+            {
+                size_t num = 0;
+
+                for( size_t i = next++; i < aCount && !cancelled; i = next++ )
+                {
+                    aFunc( i );
+                    done++;
+                    num++;
+                }
+
+                return num;
+            };
+
+    size_t parallelThreadCount = std::min<size_t>( m_drcEngine->GetThreadCount(), aCount );
+
+    if( parallelThreadCount <= 1 )
+    {
+        worker();
+        return true;
+    }
+
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, worker );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        // Keep the UI alive while the workers are busy
+        while( returns[ii].wait_for( std::chrono::milliseconds( 100 ) )
+                    != std::future_status::ready )
+        {
+            if( !cancelled && !reportProgress( (int) done, (int) aCount, 1 ) )
+                cancelled = true;
+        }
+    }
+
+    return !cancelled;
+}
+
+
 bool DRC_TEST_PROVIDER::isInvisibleText( const BOARD_ITEM* aItem ) const
 {
 
@@ -32,6 +32,7 @@
 #include <set>
 
 class DRC_ENGINE;
+class DRC_RTREE;
 class DRC_TEST_PROVIDER;
 
 class DRC_TEST_PROVIDER_REGISTRY
@@ -86,6 +87,24 @@ public:
      */
     virtual bool Run() = 0;
 
+    /**
+     * @return the error codes of the tests RunIncremental() repeats, or an empty set if this
+     *         provider can only check a whole board.
+     */
+    virtual std::set<int> GetIncrementalErrorCodes() const { return {}; }
+
+    /**
+     * Repeats the tests of this provider which involve one of the given items, and only those.
+     *
+     * @param aItems are the items to check again.
+     * @param aCopperTree indexes all the copper items of the board.
+     */
+    virtual bool RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                 const DRC_RTREE& aCopperTree )
+    {
+        return true;
+    }
+
     virtual const wxString GetName() const;
     virtual const wxString GetDescription() const;
 
@@ -112,6 +131,14 @@ protected:
     int forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
                              const std::function<bool(BOARD_ITEM*)>& aFunc );
 
+    /**
+     * Call \a aFunc for every index below \a aCount from worker threads, while the calling
+     * thread reports the progress.  \a aFunc must not report anything itself.
+     *
+     * @return false if the DRC was cancelled.
+     */
+    bool forEachInParallel( size_t aCount, const std::function<void( size_t )>& aFunc );
+
     virtual void reportAux( wxString fmt, ... );
     virtual void reportViolation( std::shared_ptr<DRC_ITEM>& item, wxPoint aMarkerPos );
     virtual bool reportProgress( int aCount, int aSize, int aDelta );
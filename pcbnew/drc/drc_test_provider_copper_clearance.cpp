@@ -24,6 +24,7 @@
 #include <common.h>
 #include <board.h>
 #include <board_design_settings.h>
+#include <board_outline.h>
 #include <footprint.h>
 #include <pcb_shape.h>
 #include <pad.h>
@@ -36,6 +37,7 @@
 #include <geometry/shape_segment.h>
 
 #include <drc/drc_engine.h>
+#include <drc/drc_result_cache.h>
 #include <drc/drc_rtree.h>
 #include <drc/drc_item.h>
 #include <drc/drc_rule.h>
@@ -56,7 +58,8 @@ class DRC_TEST_PROVIDER_COPPER_CLEARANCE : public DRC_TEST_PROVIDER_CLEARANCE_BA
 public:
     DRC_TEST_PROVIDER_COPPER_CLEARANCE () :
             DRC_TEST_PROVIDER_CLEARANCE_BASE(),
-            m_drcEpsilon( 0 )
+            m_drcEpsilon( 0 ),
+            m_cacheResult( nullptr )
     {
     }
 
@@ -66,6 +69,14 @@ public:
 
     virtual bool Run() override;
 
+    virtual std::set<int> GetIncrementalErrorCodes() const override
+    {
+        return { DRCE_CLEARANCE, DRCE_TRACKS_CROSSING, DRCE_SHORTING_ITEMS, DRCE_HOLE_CLEARANCE };
+    }
+
+    virtual bool RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                 const DRC_RTREE& aCopperTree ) override;
+
     virtual const wxString GetName() const override
     {
         return "clearance";
@@ -81,28 +92,82 @@ public:
     int GetNumPhases() const override;
 
 private:
+    /// Pairs of items already tested against each other, in canonical order
+    using CHECKED_PAIRS = std::map< std::pair<BOARD_ITEM*, BOARD_ITEM*>, int>;
+
+    /**
+     * Find the largest clearance to look for and the copper zones.
+     *
+     * @return false if there are no clearance constraints at all.
+     */
+    bool prepare();
+
+    /**
+     * Run \a aTest, the check \a aCheck of \a aItem against \a aOther on \a aLayer, unless
+     * the result cache of the engine knows its result from the previous run.
+     *
+     * @return the result of \a aTest.
+     */
+    bool cachedCheck( const char* aCheck, BOARD_ITEM* aItem, BOARD_ITEM* aOther,
+                      PCB_LAYER_ID aLayer, const std::function<bool()>& aTest );
+
+    /**
+     * @return the DRC item of \a aViolation of the constraint \a aConstraint between \a aItem
+     *         and \a aOther, with its message.
+     */
+    std::shared_ptr<DRC_ITEM> makeViolation( const DRC_RESULT_CACHE::VIOLATION& aViolation,
+                                             const DRC_CONSTRAINT& aConstraint,
+                                             BOARD_ITEM* aItem, BOARD_ITEM* aOther );
+
+    /**
+     * Report \a aViolation of \a aConstraint found by the check of \a aItem against \a aOther,
+     * and keep it for the result cache when the check is cached.
+     */
+    void reportCheckViolation( const DRC_RESULT_CACHE::VIOLATION& aViolation,
+                               const DRC_CONSTRAINT& aConstraint, BOARD_ITEM* aItem,
+                               BOARD_ITEM* aOther );
+
     bool testTrackAgainstItem( PCB_TRACK* track, SHAPE* trackShape, PCB_LAYER_ID layer,
                                BOARD_ITEM* other );
 
     void testTrackClearances();
 
+    void testTrackClearance( PCB_TRACK* aTrack, const DRC_RTREE& aTree,
+                             CHECKED_PAIRS& aCheckedPairs );
+
     bool testPadAgainstItem( PAD* pad, SHAPE* padShape, PCB_LAYER_ID layer, BOARD_ITEM* other );
 
     void testPadClearances();
 
+    void testPadClearance( PAD* aPad, const DRC_RTREE& aTree, CHECKED_PAIRS& aCheckedPairs );
+
+    /**
+     * Test the tracks, and unless \a aItem is a pad itself the pads, around an item against it.
+     *
+     * A full run gets these from the tracks and pads; an incremental run may only have the
+     * item.
+     */
+    void testNeighboursAgainstItem( BOARD_ITEM* aItem, const DRC_RTREE& aTree,
+                                    CHECKED_PAIRS& aCheckedPairs );
+
     void testZones();
 
     void testItemAgainstZones( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer );
 
+    DRC_RTREE* getZoneTree( ZONE* aZone );
+
 private:
     DRC_RTREE          m_copperTree;
     int                m_drcEpsilon;
 
     std::vector<ZONE*> m_zones;
+
+    /// The result of the check cachedCheck() runs, which records the violations reported
+    DRC_RESULT_CACHE::RESULT* m_cacheResult;
 };
 
 
-bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
+bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::prepare()
 {
     m_board = m_drcEngine->GetBoard();
     DRC_CONSTRAINT worstConstraint;
@@ -114,10 +179,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
         m_largestClearance = std::max( m_largestClearance, worstConstraint.GetValue().Min() );
 
     if( m_largestClearance <= 0 )
-    {
-        reportAux( "No Clearance constraints found. Tests not run." );
-        return true;   // continue with other tests
-    }
+        return false;
 
     m_drcEpsilon = m_board->GetDesignSettings().GetDRCEpsilon();
 
@@ -149,12 +211,25 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
 
     reportAux( "Worst clearance : %d nm", m_largestClearance );
 
+    return true;
+}
+
+
+bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
+{
+    if( !prepare() )
+    {
+        reportAux( "No Clearance constraints found. Tests not run." );
+        return true;   // continue with other tests
+    }
+
     // This is the number of tests between 2 calls to the progress bar
     size_t delta = 50;
     size_t count = 0;
     size_t ii = 0;
 
     m_copperTree.clear();
+    m_copperTree.SetProfile( m_drcEngine->GetProfile() );
 
     auto countItems =
             [&]( BOARD_ITEM* item ) -> bool
@@ -290,11 +365,9 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
 
             if( OPT_VECTOR2I intersection = trackSeg.Intersect( otherSeg ) )
             {
-                std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_TRACKS_CROSSING );
-                drcItem->SetItems( track, other );
-                drcItem->SetViolatingRule( constraint.GetParentRule() );
-
-                reportViolation( drcItem, (wxPoint) intersection.get() );
+                reportCheckViolation( { DRCE_TRACKS_CROSSING, (wxPoint) intersection.get(),
+                                        CLEARANCE_CONSTRAINT, false, layer, 0, 0 },
+                                      constraint, track, other );
 
                 return m_drcEngine->GetReportAllTrackErrors();
             }
@@ -304,18 +377,9 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
 
         if( trackShape->Collide( otherShape.get(), clearance - m_drcEpsilon, &actual, &pos ) )
         {
-            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_CLEARANCE );
-
-            m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                          constraint.GetName(),
-                          MessageTextFromValue( userUnits(), clearance ),
-                          MessageTextFromValue( userUnits(), actual ) );
-
-            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-            drce->SetItems( track, other );
-            drce->SetViolatingRule( constraint.GetParentRule() );
-
-            reportViolation( drce, (wxPoint) pos );
+            reportCheckViolation( { DRCE_CLEARANCE, (wxPoint) pos, CLEARANCE_CONSTRAINT, false,
+                                    layer, clearance, actual },
+                                  constraint, track, other );
 
             if( !m_drcEngine->GetReportAllTrackErrors() )
                 return false;
@@ -352,18 +416,10 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
                                                        std::max( 0, clearance - m_drcEpsilon ),
                                                        &actual, &pos ) )
             {
-                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_HOLE_CLEARANCE );
-
-                m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                              constraint.GetName(),
-                              MessageTextFromValue( userUnits(), clearance ),
-                              MessageTextFromValue( userUnits(), actual ) );
-
-                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                drce->SetItems( track, other );
-                drce->SetViolatingRule( constraint.GetParentRule() );
-
-                reportViolation( drce, (wxPoint) pos );
+                reportCheckViolation( { DRCE_HOLE_CLEARANCE, (wxPoint) pos,
+                                        HOLE_CLEARANCE_CONSTRAINT, true, track->GetLayer(),
+                                        clearance, actual },
+                                      constraint, track, other );
 
                 if( !m_drcEngine->GetReportAllTrackErrors() )
                     return false;
@@ -402,7 +458,7 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZones( BOARD_ITEM* aItem
 
             int                    actual;
             VECTOR2I               pos;
-            DRC_RTREE*             zoneTree = m_board->m_CopperZoneRTrees[ zone ].get();
+            DRC_RTREE*             zoneTree = getZoneTree( zone );
             EDA_RECT               itemBBox = aItem->GetBoundingBox();
             std::shared_ptr<SHAPE> itemShape = aItem->GetEffectiveShape( aLayer );
 
@@ -448,6 +504,111 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZones( BOARD_ITEM* aItem
 }
 
 
+bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::cachedCheck( const char* aCheck, BOARD_ITEM* aItem,
+                                                      BOARD_ITEM* aOther, PCB_LAYER_ID aLayer,
+                                                      const std::function<bool()>& aTest )
+{
+    DRC_RESULT_CACHE* cache = m_drcEngine->GetResultCache();
+
+    if( !cache )
+        return aTest();
+
+    // The checks leave out the tests whose error limit has been reached
+    int flags = 0;
+
+    for( int errorCode : { DRCE_CLEARANCE, DRCE_HOLE_CLEARANCE, DRCE_SHORTING_ITEMS } )
+        flags = ( flags << 1 ) | (int) m_drcEngine->IsErrorLimitExceeded( errorCode );
+
+    std::string key = cache->MakeKey( aCheck, aItem, aOther, aLayer, flags );
+
+    if( const DRC_RESULT_CACHE::RESULT* cached = cache->Find( key ) )
+    {
+        for( const DRC_RESULT_CACHE::VIOLATION& violation : cached->m_Violations )
+        {
+            // Neither the items nor the rules changed, so this is the constraint violated
+            DRC_CONSTRAINT constraint;
+
+            if( violation.m_Constraint != NULL_CONSTRAINT )
+            {
+                constraint = m_drcEngine->EvalRules( (DRC_CONSTRAINT_T) violation.m_Constraint,
+                                                     violation.m_Swapped ? aOther : aItem,
+                                                     violation.m_Swapped ? aItem : aOther,
+                                                     violation.m_Layer );
+            }
+
+            std::shared_ptr<DRC_ITEM> drce = makeViolation( violation, constraint, aItem,
+                                                            aOther );
+
+            reportViolation( drce, violation.m_Position );
+        }
+
+        return cached->m_Continue;
+    }
+
+    DRC_RESULT_CACHE::RESULT result;
+
+    m_cacheResult = &result;
+    result.m_Continue = aTest();
+    m_cacheResult = nullptr;
+
+    bool continueQuery = result.m_Continue;
+
+    cache->Store( key, std::move( result ) );
+
+    return continueQuery;
+}
+
+
+std::shared_ptr<DRC_ITEM> DRC_TEST_PROVIDER_COPPER_CLEARANCE::makeViolation(
+        const DRC_RESULT_CACHE::VIOLATION& aViolation, const DRC_CONSTRAINT& aConstraint,
+        BOARD_ITEM* aItem, BOARD_ITEM* aOther )
+{
+    std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( aViolation.m_ErrorCode );
+
+    switch( aViolation.m_ErrorCode )
+    {
+    case DRCE_CLEARANCE:
+    case DRCE_HOLE_CLEARANCE:
+        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                      aConstraint.GetName(),
+                      MessageTextFromValue( userUnits(), aViolation.m_Clearance ),
+                      MessageTextFromValue( userUnits(), aViolation.m_Actual ) );
+
+        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+        break;
+
+    case DRCE_SHORTING_ITEMS:
+        m_msg.Printf( _( "(nets %s and %s)" ),
+                      static_cast<BOARD_CONNECTED_ITEM*>( aItem )->GetNetname(),
+                      static_cast<BOARD_CONNECTED_ITEM*>( aOther )->GetNetname() );
+
+        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+        break;
+
+    default:
+        break;
+    }
+
+    drce->SetItems( aItem, aOther );
+    drce->SetViolatingRule( aConstraint.GetParentRule() );
+
+    return drce;
+}
+
+
+void DRC_TEST_PROVIDER_COPPER_CLEARANCE::reportCheckViolation(
+        const DRC_RESULT_CACHE::VIOLATION& aViolation, const DRC_CONSTRAINT& aConstraint,
+        BOARD_ITEM* aItem, BOARD_ITEM* aOther )
+{
+    if( m_cacheResult )
+        m_cacheResult->m_Violations.push_back( aViolation );
+
+    std::shared_ptr<DRC_ITEM> drce = makeViolation( aViolation, aConstraint, aItem, aOther );
+
+    reportViolation( drce, aViolation.m_Position );
+}
+
+
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackClearances()
 {
     // This is the number of tests between 2 calls to the progress bar
@@ -456,58 +617,71 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackClearances()
 
     reportAux( "Testing %d tracks & vias...", m_board->Tracks().size() );
 
-    std::map< std::pair<BOARD_ITEM*, BOARD_ITEM*>, int> checkedPairs;
+    CHECKED_PAIRS checkedPairs;
 
     for( PCB_TRACK* track : m_board->Tracks() )
     {
         if( !reportProgress( ii++, m_board->Tracks().size(), delta ) )
             break;
 
-        for( PCB_LAYER_ID layer : track->GetLayerSet().Seq() )
-        {
-            std::shared_ptr<SHAPE> trackShape = track->GetEffectiveShape( layer );
+        testTrackClearance( track, m_copperTree, checkedPairs );
+    }
+}
 
-            m_copperTree.QueryColliding( track, layer, layer,
-                    // Filter:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        // It would really be better to know what particular nets a nettie
-                        // should allow, but for now it is what it is.
-                        if( DRC_ENGINE::IsNetTie( other ) )
-                            return false;
 
-                        auto otherCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( other );
+void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackClearance( PCB_TRACK* aTrack,
+                                                             const DRC_RTREE& aTree,
+                                                             CHECKED_PAIRS& aCheckedPairs )
+{
+    for( PCB_LAYER_ID layer : aTrack->GetLayerSet().Seq() )
+    {
+        std::shared_ptr<SHAPE> trackShape = aTrack->GetEffectiveShape( layer );
 
-                        if( otherCItem && otherCItem->GetNetCode() == track->GetNetCode() )
-                            return false;
+        aTree.QueryColliding( aTrack, layer, layer,
+                // Filter:
+                [&]( BOARD_ITEM* other ) -> bool
+                {
+                    // It would really be better to know what particular nets a nettie
+                    // should allow, but for now it is what it is.
+                    if( DRC_ENGINE::IsNetTie( other ) )
+                        return false;
 
-                        BOARD_ITEM* a = track;
-                        BOARD_ITEM* b = other;
+                    auto otherCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( other );
 
-                        // store canonical order so we don't collide in both directions
-                        // (a:b and b:a)
-                        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                            std::swap( a, b );
+                    if( otherCItem && otherCItem->GetNetCode() == aTrack->GetNetCode() )
+                        return false;
 
-                        if( checkedPairs.count( { a, b } ) )
-                        {
-                            return false;
-                        }
-                        else
-                        {
-                            checkedPairs[ { a, b } ] = 1;
-                            return true;
-                        }
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* other ) -> bool
+                    BOARD_ITEM* a = aTrack;
+                    BOARD_ITEM* b = other;
+
+                    // store canonical order so we don't collide in both directions
+                    // (a:b and b:a)
+                    if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+                        std::swap( a, b );
+
+                    if( aCheckedPairs.count( { a, b } ) )
+                    {
+                        return false;
+                    }
+                    else
                     {
-                        return testTrackAgainstItem( track, trackShape.get(), layer, other );
-                    },
-                    m_largestClearance );
+                        aCheckedPairs[ { a, b } ] = 1;
+                        return true;
+                    }
+                },
+                // Visitor:
+                [&]( BOARD_ITEM* other ) -> bool
+                {
+                    return cachedCheck( "track", aTrack, other, layer,
+                            [&]()
+                            {
+                                return testTrackAgainstItem( aTrack, trackShape.get(), layer,
+                                                             other );
+                            } );
+                },
+                m_largestClearance );
 
-            testItemAgainstZones( track, layer );
-        }
+        testItemAgainstZones( aTrack, layer );
     }
 }
 
@@ -565,16 +739,9 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
                     && pad->GetNetCode() != otherPad->GetNetCode()
                     && testShorting )
             {
-                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_SHORTING_ITEMS );
-
-                m_msg.Printf( _( "(nets %s and %s)" ),
-                              pad->GetNetname(),
-                              otherPad->GetNetname() );
-
-                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                drce->SetItems( pad, otherPad );
-
-                reportViolation( drce, otherPad->GetPosition() );
+                reportCheckViolation( { DRCE_SHORTING_ITEMS, otherPad->GetPosition(),
+                                        NULL_CONSTRAINT, false, UNDEFINED_LAYER, 0, 0 },
+                                      DRC_CONSTRAINT(), pad, otherPad );
             }
 
             return true;
@@ -589,18 +756,10 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
                                                      std::max( 0, clearance - m_drcEpsilon ),
                                                      &actual, &pos ) )
             {
-                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_HOLE_CLEARANCE );
-
-                m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                              constraint.GetName(),
-                              MessageTextFromValue( userUnits(), clearance ),
-                              MessageTextFromValue( userUnits(), actual ) );
-
-                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                drce->SetItems( pad, other );
-                drce->SetViolatingRule( constraint.GetParentRule() );
-
-                reportViolation( drce, (wxPoint) pos );
+                reportCheckViolation( { DRCE_HOLE_CLEARANCE, (wxPoint) pos,
+                                        HOLE_CLEARANCE_CONSTRAINT, false, layer, clearance,
+                                        actual },
+                                      constraint, pad, other );
             }
         }
 
@@ -613,18 +772,10 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
                                                        std::max( 0, clearance - m_drcEpsilon ),
                                                        &actual, &pos ) )
             {
-                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_HOLE_CLEARANCE );
-
-                m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                              constraint.GetName(),
-                              MessageTextFromValue( userUnits(), clearance ),
-                              MessageTextFromValue( userUnits(), actual ) );
-
-                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                drce->SetItems( pad, other );
-                drce->SetViolatingRule( constraint.GetParentRule() );
-
-                reportViolation( drce, (wxPoint) pos );
+                reportCheckViolation( { DRCE_HOLE_CLEARANCE, (wxPoint) pos,
+                                        HOLE_CLEARANCE_CONSTRAINT, false, layer, clearance,
+                                        actual },
+                                      constraint, pad, other );
             }
         }
 
@@ -645,18 +796,9 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
                                                 std::max( 0, clearance - m_drcEpsilon ),
                                                 &actual, &pos ) )
         {
-            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_CLEARANCE );
-
-            m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                          constraint.GetName(),
-                          MessageTextFromValue( userUnits(), clearance ),
-                          MessageTextFromValue( userUnits(), actual ) );
-
-            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-            drce->SetItems( pad, other );
-            drce->SetViolatingRule( constraint.GetParentRule() );
-
-            reportViolation( drce, (wxPoint) pos );
+            reportCheckViolation( { DRCE_CLEARANCE, (wxPoint) pos, CLEARANCE_CONSTRAINT, false,
+                                    layer, clearance, actual },
+                                  constraint, pad, other );
         }
     }
 
@@ -675,8 +817,8 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadClearances( )
 
     reportAux( "Testing %d pads...", count );
 
-    int ii = 0;
-    std::map< std::pair<BOARD_ITEM*, BOARD_ITEM*>, int> checkedPairs;
+    int           ii = 0;
+    CHECKED_PAIRS checkedPairs;
 
     for( FOOTPRINT* footprint : m_board->Footprints() )
     {
@@ -685,85 +827,333 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadClearances( )
             if( !reportProgress( ii++, count, delta ) )
                 break;
 
-            for( PCB_LAYER_ID layer : pad->GetLayerSet().Seq() )
-            {
-                std::shared_ptr<SHAPE> padShape = DRC_ENGINE::GetShape( pad, layer );
+            testPadClearance( pad, m_copperTree, checkedPairs );
+        }
+    }
+}
 
-                m_copperTree.QueryColliding( pad, layer, layer,
-                        // Filter:
-                        [&]( BOARD_ITEM* other ) -> bool
-                        {
-                            BOARD_ITEM* a = pad;
-                            BOARD_ITEM* b = other;
 
-                            // store canonical order so we don't collide in both directions
-                            // (a:b and b:a)
-                            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                                std::swap( a, b );
+void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadClearance( PAD* aPad, const DRC_RTREE& aTree,
+                                                           CHECKED_PAIRS& aCheckedPairs )
+{
+    for( PCB_LAYER_ID layer : aPad->GetLayerSet().Seq() )
+    {
+        std::shared_ptr<SHAPE> padShape = DRC_ENGINE::GetShape( aPad, layer );
 
-                            if( checkedPairs.count( { a, b } ) )
-                            {
-                                return false;
-                            }
-                            else
+        aTree.QueryColliding( aPad, layer, layer,
+                // Filter:
+                [&]( BOARD_ITEM* other ) -> bool
+                {
+                    BOARD_ITEM* a = aPad;
+                    BOARD_ITEM* b = other;
+
+                    // store canonical order so we don't collide in both directions
+                    // (a:b and b:a)
+                    if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+                        std::swap( a, b );
+
+                    if( aCheckedPairs.count( { a, b } ) )
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        aCheckedPairs[ { a, b } ] = 1;
+                        return true;
+                    }
+                },
+                // Visitor
+                [&]( BOARD_ITEM* other ) -> bool
+                {
+                    return cachedCheck( "pad", aPad, other, layer,
+                            [&]()
                             {
-                                checkedPairs[ { a, b } ] = 1;
-                                return true;
-                            }
-                        },
-                        // Visitor
-                        [&]( BOARD_ITEM* other ) -> bool
+                                return testPadAgainstItem( aPad, padShape.get(), layer, other );
+                            } );
+                },
+                m_largestClearance );
+
+        testItemAgainstZones( aPad, layer );
+    }
+}
+
+
+void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testNeighboursAgainstItem( BOARD_ITEM* aItem,
+                                                                    const DRC_RTREE& aTree,
+                                                                    CHECKED_PAIRS& aCheckedPairs )
+{
+    LSET layers = aItem->GetLayerSet();
+
+    // Pad holes pierce all the copper layers
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        PAD* pad = static_cast<PAD*>( aItem );
+
+        if( pad->GetDrillSizeX() > 0 && pad->GetDrillSizeY() > 0 )
+            layers |= LSET::AllCuMask();
+    }
+
+    auto itemCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( aItem );
+
+    for( PCB_LAYER_ID layer : ( layers & LSET::AllCuMask() ).Seq() )
+    {
+        aTree.QueryColliding( aItem, layer, layer,
+                // Filter:
+                [&]( BOARD_ITEM* other ) -> bool
+                {
+                    bool isTrack = other->Type() == PCB_TRACE_T || other->Type() == PCB_ARC_T
+                                        || other->Type() == PCB_VIA_T;
+
+                    if( isTrack )
+                    {
+                        if( DRC_ENGINE::IsNetTie( aItem ) )
+                            return false;
+
+                        if( itemCItem && itemCItem->GetNetCode()
+                                    == static_cast<PCB_TRACK*>( other )->GetNetCode() )
                         {
-                            return testPadAgainstItem( pad, padShape.get(), layer, other );
-                        },
-                        m_largestClearance );
+                            return false;
+                        }
+                    }
+                    else if( other->Type() != PCB_PAD_T || aItem->Type() == PCB_PAD_T )
+                    {
+                        return false;
+                    }
 
-                testItemAgainstZones( pad, layer );
-            }
+                    BOARD_ITEM* a = aItem;
+                    BOARD_ITEM* b = other;
+
+                    // store canonical order so we don't collide in both directions
+                    // (a:b and b:a)
+                    if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+                        std::swap( a, b );
+
+                    if( aCheckedPairs.count( { a, b } ) )
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        aCheckedPairs[ { a, b } ] = 1;
+                        return true;
+                    }
+                },
+                // Visitor
+                [&]( BOARD_ITEM* other ) -> bool
+                {
+                    if( other->Type() == PCB_PAD_T )
+                    {
+                        PAD*                   pad = static_cast<PAD*>( other );
+                        std::shared_ptr<SHAPE> padShape = DRC_ENGINE::GetShape( pad, layer );
+
+                        return testPadAgainstItem( pad, padShape.get(), layer, aItem );
+                    }
+
+                    PCB_TRACK*             track = static_cast<PCB_TRACK*>( other );
+                    std::shared_ptr<SHAPE> trackShape = track->GetEffectiveShape( layer );
+
+                    return testTrackAgainstItem( track, trackShape.get(), layer, aItem );
+                },
+                m_largestClearance );
+    }
+}
+
+
+bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                                         const DRC_RTREE& aCopperTree )
+{
+    if( !prepare() )
+        return true;
+
+    for( ZONE* zone : m_zones )
+        zone->CacheBoundingBox();
+
+    CHECKED_PAIRS checkedPairs;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_ARC_T:
+        case PCB_VIA_T:
+            testTrackClearance( static_cast<PCB_TRACK*>( item ), aCopperTree, checkedPairs );
+            break;
+
+        case PCB_PAD_T:
+            // Tracks are tested first, as testPadAgainstItem() leaves them to the tracks
+            testNeighboursAgainstItem( item, aCopperTree, checkedPairs );
+            testPadClearance( static_cast<PAD*>( item ), aCopperTree, checkedPairs );
+            break;
+
+        default:
+            if( ( item->GetLayerSet() & LSET::AllCuMask() ).any() )
+                testNeighboursAgainstItem( item, aCopperTree, checkedPairs );
+
+            break;
         }
     }
+
+    return true;
+}
+
+
+/**
+ * A full run indexes all the copper zones up front; an incremental run only indexes those it
+ * meets.
+ */
+DRC_RTREE* DRC_TEST_PROVIDER_COPPER_CLEARANCE::getZoneTree( ZONE* aZone )
+{
+    std::unique_ptr<DRC_RTREE>& zoneTree = m_board->m_CopperZoneRTrees[ aZone ];
+
+    if( !zoneTree )
+    {
+        aZone->CacheTriangulation();
+        zoneTree = std::make_unique<DRC_RTREE>();
+
+        if( DRC_PROFILE* profile = m_drcEngine->GetProfile() )
+        {
+            profile->CountPolygonOp();
+            zoneTree->SetProfile( profile );
+        }
+
+        for( PCB_LAYER_ID layer : aZone->GetLayerSet().Seq() )
+        {
+            if( IsCopperLayer( layer ) )
+                zoneTree->Insert( aZone, layer );
+        }
+    }
+
+    return zoneTree.get();
+}
+
+
+/**
+ * A zone outline smoothed for the zone to zone tests, with its edges indexed so that the
+ * edges near another zone's edge can be found without going through all of them.
+ */
+struct SMOOTHED_ZONE_OUTLINE
+{
+    SMOOTHED_ZONE_OUTLINE( ZONE* aZone, PCB_LAYER_ID aLayer,
+                           std::vector<ZONE*> aInteractingZones ) :
+            zone( aZone ),
+            layer( aLayer ),
+            interactingZones( std::move( aInteractingZones ) )
+    {}
+
+    /// Build the outline, from a worker thread
+    void Build( const SHAPE_POLY_SET* aBoardOutline )
+    {
+        zone->BuildSmoothedPoly( poly, layer, aBoardOutline );
+
+        for( auto it = poly.IterateSegmentsWithHoles(); it; it++ )
+        {
+            SEG       edge = *it;
+            const int mmin[2] = { std::min( edge.A.x, edge.B.x ), std::min( edge.A.y, edge.B.y ) };
+            const int mmax[2] = { std::max( edge.A.x, edge.B.x ), std::max( edge.A.y, edge.B.y ) };
+
+            edgeTree.Insert( mmin, mmax, edges.size() );
+            edges.push_back( edge );
+        }
+
+        bbox = poly.BBox();
+    }
+
+    ZONE*                         zone;
+    PCB_LAYER_ID                  layer;              ///< the first layer it was built for
+    std::vector<ZONE*>            interactingZones;   ///< the same-net zones merged into it
+
+    SHAPE_POLY_SET                poly;
+    std::vector<SEG>              edges;              ///< in IterateSegmentsWithHoles() order
+    RTree<size_t, int, 2, double> edgeTree;           ///< indices into edges
+    BOX2I                         bbox;
+};
+
+
+/**
+ * Two zones to test against each other on a layer, and what was found.
+ */
+struct ZONE_TO_ZONE_TEST
+{
+    ZONE*                  zoneRef;
+    ZONE*                  zoneToTest;
+    SMOOTHED_ZONE_OUTLINE* refOutline;
+    SMOOTHED_ZONE_OUTLINE* testOutline;
+    DRC_CONSTRAINT         constraint;
+    int                    clearance;
+
+    std::vector<VECTOR2I>  refCornersInside;      ///< corners of zoneRef inside zoneToTest
+    std::vector<VECTOR2I>  testCornersInside;     ///< corners of zoneToTest inside zoneRef
+    std::map<wxPoint, int> conflictPoints;        ///< closest points of edges within clearance
+};
+
+
+/**
+ * Collect the corners of \a aOutline which are inside \a aOther.
+ */
+static void findCornersInside( const SMOOTHED_ZONE_OUTLINE& aOutline,
+                               const SMOOTHED_ZONE_OUTLINE& aOther,
+                               std::vector<VECTOR2I>& aCorners )
+{
+    for( auto iterator = aOutline.poly.CIterateWithHoles(); iterator; iterator++ )
+    {
+        const VECTOR2I& corner = *iterator;
+
+        // Contains() can't be true outside the other outline's bounding box
+        if( aOther.bbox.Contains( corner ) && aOther.poly.Contains( corner ) )
+            aCorners.push_back( corner );
+    }
 }
 
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
 {
-    const int delta = 50;  // This is the number of tests between 2 calls to the progress bar
+    std::shared_ptr<const BOARD_OUTLINE> outline = m_board->GetBoardOutline();
+    const SHAPE_POLY_SET*                boardOutline = outline ? &outline->Polygons() : nullptr;
+
+    // A smoothed zone outline only depends on the layer through the same-net zones merged
+    // into it, so most zones can share one outline between all their layers.
+    std::vector<std::unique_ptr<SMOOTHED_ZONE_OUTLINE>>  outlines;
+    std::map<ZONE*, std::vector<SMOOTHED_ZONE_OUTLINE*>> outlinesByZone;
+    std::vector<ZONE_TO_ZONE_TEST>                       tests;
+
+    auto getOutline =
+            [&]( ZONE* aZone, PCB_LAYER_ID aLayer ) -> SMOOTHED_ZONE_OUTLINE*
+            {
+                std::vector<ZONE*> interactingZones;
+                aZone->GetInteractingZones( aLayer, &interactingZones );
 
-    SHAPE_POLY_SET  buffer;
-    SHAPE_POLY_SET* boardOutline = nullptr;
+                for( SMOOTHED_ZONE_OUTLINE* candidate : outlinesByZone[aZone] )
+                {
+                    if( candidate->interactingZones == interactingZones )
+                        return candidate;
+                }
 
-    if( m_board->GetBoardPolygonOutlines( buffer ) )
-        boardOutline = &buffer;
+                outlines.push_back( std::make_unique<SMOOTHED_ZONE_OUTLINE>(
+                        aZone, aLayer, std::move( interactingZones ) ) );
+                outlinesByZone[aZone].push_back( outlines.back().get() );
+
+                return outlines.back().get();
+            };
 
+    // Find the zone pairs to test, in the order of the nested loops the violations have always
+    // been reported in.  The rules are evaluated here, as only the geometry is looked at from
+    // the worker threads.
     for( int layer_id = F_Cu; layer_id <= B_Cu; ++layer_id )
     {
         PCB_LAYER_ID layer = static_cast<PCB_LAYER_ID>( layer_id );
-        std::vector<SHAPE_POLY_SET> smoothed_polys;
-        smoothed_polys.resize( m_zones.size() );
 
         // Skip over layers not used on the current board
         if( !m_board->IsLayerEnabled( layer ) )
             continue;
 
-        for( size_t ii = 0; ii < m_zones.size(); ii++ )
-        {
-            if( m_zones[ii]->IsOnLayer( layer ) )
-                m_zones[ii]->BuildSmoothedPoly( smoothed_polys[ii], layer, boardOutline );
-        }
-
-        // iterate through all areas
         for( size_t ia = 0; ia < m_zones.size(); ia++ )
         {
-            if( !reportProgress( layer_id * m_zones.size() + ia, B_Cu * m_zones.size(), delta ) )
-                break;
-
             ZONE* zoneRef = m_zones[ia];
 
             if( !zoneRef->IsOnLayer( layer ) )
                 continue;
 
-            // If we are testing a single zone, then iterate through all other zones
-            // Otherwise, we have already tested the zone combination
             for( size_t ia2 = ia + 1; ia2 < m_zones.size(); ia2++ )
             {
                 ZONE* zoneToTest = m_zones[ia2];
@@ -787,116 +1177,156 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                 if( zoneRef->GetIsRuleArea() || zoneToTest->GetIsRuleArea() )
                     continue;
 
-                // Examine a candidate zone: compare zoneToTest to zoneRef
+                // Zones with less than 3 corners aren't smoothed and have no area; they can
+                // neither contain a corner nor have edges
+                if( zoneRef->GetNumCorners() <= 2 || zoneToTest->GetNumCorners() <= 2 )
+                    continue;
+
+                ZONE_TO_ZONE_TEST test;
+
+                test.zoneRef = zoneRef;
+                test.zoneToTest = zoneToTest;
+                test.refOutline = getOutline( zoneRef, layer );
+                test.testOutline = getOutline( zoneToTest, layer );
 
                 // Get clearance used in zone to zone test.
-                auto constraint = m_drcEngine->EvalRules( CLEARANCE_CONSTRAINT, zoneRef, zoneToTest,
-                                                          layer );
-                int  zone2zoneClearance = constraint.GetValue().Min();
+                test.constraint = m_drcEngine->EvalRules( CLEARANCE_CONSTRAINT, zoneRef,
+                                                          zoneToTest, layer );
+                test.clearance = test.constraint.GetValue().Min();
 
-                // test for some corners of zoneRef inside zoneToTest
-                for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
-                {
-                    VECTOR2I currentVertex = *iterator;
-                    wxPoint pt( currentVertex.x, currentVertex.y );
+                tests.push_back( std::move( test ) );
+            }
+        }
+    }
 
-                    if( smoothed_polys[ia2].Contains( currentVertex ) )
-                    {
-                        std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                        drce->SetItems( zoneRef, zoneToTest );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
+    if( !forEachInParallel( outlines.size(),
+                            [&]( size_t aIndex )
+                            {
+                                outlines[aIndex]->Build( boardOutline );
+                            } ) )
+    {
+        return;     // DRC cancelled
+    }
 
-                        reportViolation( drce, pt );
-                    }
-                }
+    auto testZonePair =
+            [&]( size_t aIndex )
+            {
+                ZONE_TO_ZONE_TEST&           test = tests[aIndex];
+                const SMOOTHED_ZONE_OUTLINE& refOutline = *test.refOutline;
+                const SMOOTHED_ZONE_OUTLINE& testOutline = *test.testOutline;
+                BOX2I                        inflatedBBox = refOutline.bbox;
+
+                inflatedBBox.Inflate( std::max( test.clearance, 0 ) );
+
+                // Zones further apart than the clearance have nothing to report
+                if( !inflatedBBox.Intersects( testOutline.bbox ) )
+                    return;
+
+                // test for some corners of zoneRef inside zoneToTest
+                findCornersInside( refOutline, testOutline, test.refCornersInside );
 
                 // test for some corners of zoneToTest inside zoneRef
-                for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+                findCornersInside( testOutline, refOutline, test.testCornersInside );
+
+                // No distance between edges is below a null clearance
+                if( test.clearance <= 0 )
+                    return;
+
+                // Test the segments of zoneRef against the segments of zoneToTest near them.
+                // GetClearanceBetweenSegments() rejects the same pairs the inflated query does.
+                for( const SEG& refSegment : refOutline.edges )
                 {
-                    VECTOR2I currentVertex = *iterator;
-                    wxPoint pt( currentVertex.x, currentVertex.y );
+                    BOX2I box = refSegment.BBox();
+                    box.Inflate( test.clearance );
 
-                    if( smoothed_polys[ia].Contains( currentVertex ) )
-                    {
-                        std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                        drce->SetItems( zoneToTest, zoneRef );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
+                    const int mmin[2] = { box.GetX(), box.GetY() };
+                    const int mmax[2] = { box.GetRight(), box.GetBottom() };
 
-                        reportViolation( drce, pt );
-                    }
+                    testOutline.edgeTree.Search( mmin, mmax,
+                            [&]( const size_t& aEdge ) -> bool
+                            {
+                                const SEG& testSegment = testOutline.edges[aEdge];
+                                wxPoint    pt;
+
+                                int d = GetClearanceBetweenSegments( testSegment.A.x,
+                                                                     testSegment.A.y,
+                                                                     testSegment.B.x,
+                                                                     testSegment.B.y,
+                                                                     0,
+                                                                     refSegment.A.x,
+                                                                     refSegment.A.y,
+                                                                     refSegment.B.x,
+                                                                     refSegment.B.y,
+                                                                     0,
+                                                                     test.clearance,
+                                                                     &pt.x, &pt.y );
+
+                                if( d < test.clearance )
+                                {
+                                    if( test.conflictPoints.count( pt ) )
+                                    {
+                                        test.conflictPoints[ pt ] =
+                                                std::min( test.conflictPoints[ pt ], d );
+                                    }
+                                    else
+                                    {
+                                        test.conflictPoints[ pt ] = d;
+                                    }
+                                }
+
+                                return true;
+                            } );
                 }
+            };
 
-                // Iterate through all the segments of refSmoothedPoly
-                std::map<wxPoint, int> conflictPoints;
+    if( !forEachInParallel( tests.size(), testZonePair ) )
+        return;     // DRC cancelled
 
-                for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
-                {
-                    // Build ref segment
-                    SEG refSegment = *refIt;
+    for( const ZONE_TO_ZONE_TEST& test : tests )
+    {
+        for( const VECTOR2I& corner : test.refCornersInside )
+        {
+            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+            drce->SetItems( test.zoneRef, test.zoneToTest );
+            drce->SetViolatingRule( test.constraint.GetParentRule() );
 
-                    // Iterate through all the segments in smoothed_polys[ia2]
-                    for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles(); testIt; testIt++ )
-                    {
-                        // Build test segment
-                        SEG testSegment = *testIt;
-                        wxPoint pt;
-
-                        int ax1, ay1, ax2, ay2;
-                        ax1 = refSegment.A.x;
-                        ay1 = refSegment.A.y;
-                        ax2 = refSegment.B.x;
-                        ay2 = refSegment.B.y;
-
-                        int bx1, by1, bx2, by2;
-                        bx1 = testSegment.A.x;
-                        by1 = testSegment.A.y;
-                        bx2 = testSegment.B.x;
-                        by2 = testSegment.B.y;
-
-                        int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2,
-                                                             0,
-                                                             ax1, ay1, ax2, ay2,
-                                                             0,
-                                                             zone2zoneClearance,
-                                                             &pt.x, &pt.y );
-
-                        if( d < zone2zoneClearance )
-                        {
-                            if( conflictPoints.count( pt ) )
-                                conflictPoints[ pt ] = std::min( conflictPoints[ pt ], d );
-                            else
-                                conflictPoints[ pt ] = d;
-                        }
-                    }
-                }
+            reportViolation( drce, (wxPoint) corner );
+        }
 
-                for( const std::pair<const wxPoint, int>& conflict : conflictPoints )
-                {
-                    int       actual = conflict.second;
-                    std::shared_ptr<DRC_ITEM> drce;
+        for( const VECTOR2I& corner : test.testCornersInside )
+        {
+            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+            drce->SetItems( test.zoneToTest, test.zoneRef );
+            drce->SetViolatingRule( test.constraint.GetParentRule() );
 
-                    if( actual <= 0 )
-                    {
-                        drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                    }
-                    else
-                    {
-                        drce = DRC_ITEM::Create( DRCE_CLEARANCE );
+            reportViolation( drce, (wxPoint) corner );
+        }
 
-                        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                                      constraint.GetName(),
-                                      MessageTextFromValue( userUnits(), zone2zoneClearance ),
-                                      MessageTextFromValue( userUnits(), conflict.second ) );
+        for( const std::pair<const wxPoint, int>& conflict : test.conflictPoints )
+        {
+            int       actual = conflict.second;
+            std::shared_ptr<DRC_ITEM> drce;
 
-                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                    }
+            if( actual <= 0 )
+            {
+                drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+            }
+            else
+            {
+                drce = DRC_ITEM::Create( DRCE_CLEARANCE );
 
-                    drce->SetItems( zoneRef, zoneToTest );
-                    drce->SetViolatingRule( constraint.GetParentRule() );
+                m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                              test.constraint.GetName(),
+                              MessageTextFromValue( userUnits(), test.clearance ),
+                              MessageTextFromValue( userUnits(), conflict.second ) );
 
-                    reportViolation( drce, conflict.first );
-                }
+                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
             }
+
+            drce->SetItems( test.zoneRef, test.zoneToTest );
+            drce->SetViolatingRule( test.constraint.GetParentRule() );
+
+            reportViolation( drce, conflict.first );
         }
     }
 }
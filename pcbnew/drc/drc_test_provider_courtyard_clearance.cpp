@@ -21,9 +21,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <unordered_map>
+
 #include <geometry/shape_poly_set.h>
+#include <geometry/shape_rect.h>
 #include <drc/drc_engine.h>
 #include <drc/drc_item.h>
+#include <drc/drc_rtree.h>
 #include <drc/drc_rule.h>
 #include <drc/drc_test_provider_clearance_base.h>
 #include <footprint.h>
@@ -68,6 +72,28 @@ public:
     int GetNumPhases() const override;
 
 private:
+    /// Two footprints whose courtyards on one side are within the worst clearance
+    struct COURTYARD_PAIR
+    {
+        COURTYARD_PAIR( FOOTPRINT* aFootprint, FOOTPRINT* aTest, PCB_LAYER_ID aSide ) :
+                footprint( aFootprint ),
+                test( aTest ),
+                side( aSide ),
+                clearance( -1 ),
+                collides( false ),
+                actual( 0 )
+        {}
+
+        FOOTPRINT*     footprint;   ///< the first of the two on the board
+        FOOTPRINT*     test;
+        PCB_LAYER_ID   side;        ///< F_Cu or B_Cu, as the rules know them
+        DRC_CONSTRAINT constraint;
+        int            clearance;
+        bool           collides;
+        int            actual;
+        VECTOR2I       pos;
+    };
+
     bool testFootprintCourtyardDefinitions();
 
     bool testCourtyardClearances();
@@ -143,101 +169,170 @@ bool DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testFootprintCourtyardDefinitions()
 
 bool DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testCourtyardClearances()
 {
-    const int delta = 100;  // This is the number of tests between 2 calls to the progress bar
-
     if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_FOOTPRINTS) )
         return true;   // continue with other tests
 
     if( !reportPhase( _( "Checking footprints for overlapping courtyards..." ) ) )
         return false;   // DRC cancelled
 
-    int ii = 0;
+    // Index the courtyard bounding boxes so that only footprints whose courtyards are close
+    // to each other get compared.
+    DRC_RTREE                               courtyardTree;
+    std::unordered_map<BOARD_ITEM*, size_t> boardOrder;
+
+    courtyardTree.SetProfile( m_drcEngine->GetProfile() );
 
-    for( auto it1 = m_board->Footprints().begin(); it1 != m_board->Footprints().end(); it1++ )
+    auto insertCourtyard =
+            [&]( FOOTPRINT* aFootprint, const SHAPE_POLY_SET& aCourtyard, PCB_LAYER_ID aLayer )
+            {
+                if( aCourtyard.OutlineCount() == 0 )
+                    return;
+
+                BOX2I bbox = aCourtyard.BBoxFromCaches();
+
+                courtyardTree.Insert( aFootprint, aLayer,
+                                      std::make_shared<SHAPE_RECT>( bbox.GetPosition(),
+                                                                    bbox.GetWidth(),
+                                                                    bbox.GetHeight() ) );
+            };
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
     {
-        if( !reportProgress( ii++, m_board->Footprints().size(), delta ) )
-            return false;   // DRC cancelled
+        size_t order = boardOrder.size();
+        boardOrder[footprint] = order;
+
+        insertCourtyard( footprint, footprint->GetPolyCourtyardFront(), F_CrtYd );
+        insertCourtyard( footprint, footprint->GetPolyCourtyardBack(), B_CrtYd );
+    }
+
+    const std::vector<DRC_RTREE::LAYER_PAIR> layerPairs =
+    {
+        DRC_RTREE::LAYER_PAIR( F_CrtYd, F_CrtYd ),
+        DRC_RTREE::LAYER_PAIR( B_CrtYd, B_CrtYd )
+    };
+
+    std::vector<COURTYARD_PAIR> pairs;
+
+    courtyardTree.QueryCollidingPairs( &courtyardTree, layerPairs,
+            [&]( const DRC_RTREE::LAYER_PAIR& aLayers, DRC_RTREE::ITEM_WITH_SHAPE* aRef,
+                 DRC_RTREE::ITEM_WITH_SHAPE* aTest, bool* aCollisionDetected ) -> bool
+            {
+                // Every pair is found from both sides: keep the one a loop over the footprints
+                // would have found, comparing each footprint with the ones after it.
+                if( boardOrder[aRef->parent] < boardOrder[aTest->parent] )
+                {
+                    pairs.emplace_back( static_cast<FOOTPRINT*>( aRef->parent ),
+                                        static_cast<FOOTPRINT*>( aTest->parent ),
+                                        aLayers.first == F_CrtYd ? F_Cu : B_Cu );
+                }
+
+                return true;
+            },
+            m_largestClearance,
+            []( int aCount, int aSize ) -> bool
+            {
+                return true;    // progress is reported while colliding, which takes longer
+            } );
+
+    // Report the violations in the same order as the pairwise loop did
+    std::sort( pairs.begin(), pairs.end(),
+               [&]( const COURTYARD_PAIR& a, const COURTYARD_PAIR& b )
+               {
+                   if( a.footprint != b.footprint )
+                       return boardOrder[a.footprint] < boardOrder[b.footprint];
+
+                   if( a.test != b.test )
+                       return boardOrder[a.test] < boardOrder[b.test];
 
-        if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_FOOTPRINTS) )
-            break;
+                   return a.side == F_Cu && b.side != F_Cu;
+               } );
 
-        FOOTPRINT*            footprint = *it1;
-        const SHAPE_POLY_SET& footprintFront = footprint->GetPolyCourtyardFront();
-        const SHAPE_POLY_SET& footprintBack = footprint->GetPolyCourtyardBack();
+    // The rules are evaluated here rather than in the worker threads, which only collide
+    // the courtyards.
+    for( COURTYARD_PAIR& pair : pairs )
+    {
+        pair.constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, pair.footprint,
+                                                  pair.test, pair.side );
+        pair.clearance = pair.constraint.GetValue().Min();
+    }
 
-        if( footprintFront.OutlineCount() == 0 && footprintBack.OutlineCount() == 0 )
-            continue; // No courtyards defined
+    DRC_PROFILE* profile = m_drcEngine->GetProfile();
 
-        BOX2I frontBBox = footprintFront.BBoxFromCaches();
-        BOX2I backBBox = footprintBack.BBoxFromCaches();
+    // Collide() triangulates the polygons on first use, which isn't thread safe
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        if( footprint->GetPolyCourtyardFront().OutlineCount() > 0 )
+        {
+            const_cast<SHAPE_POLY_SET&>( footprint->GetPolyCourtyardFront() ).CacheTriangulation();
 
-        frontBBox.Inflate( m_largestClearance );
-        backBBox.Inflate( m_largestClearance );
+            if( profile )
+                profile->CountPolygonOp();
+        }
 
-        for( auto it2 = it1 + 1; it2 != m_board->Footprints().end(); it2++ )
+        if( footprint->GetPolyCourtyardBack().OutlineCount() > 0 )
         {
-            FOOTPRINT*            test = *it2;
-            const SHAPE_POLY_SET& testFront = test->GetPolyCourtyardFront();
-            const SHAPE_POLY_SET& testBack = test->GetPolyCourtyardBack();
-            DRC_CONSTRAINT        constraint;
-            int                   clearance;
-            int                   actual;
-            VECTOR2I              pos;
-
-            if( footprintFront.OutlineCount() > 0 && testFront.OutlineCount() > 0
-                    && frontBBox.Intersects( testFront.BBoxFromCaches() ) )
+            const_cast<SHAPE_POLY_SET&>( footprint->GetPolyCourtyardBack() ).CacheTriangulation();
+
+            if( profile )
+                profile->CountPolygonOp();
+        }
+    }
+
+    auto collideCourtyards =
+            [&]( size_t aIndex )
             {
-                constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, footprint,
-                                                     test, F_Cu );
-                clearance = constraint.GetValue().Min();
+                COURTYARD_PAIR& pair = pairs[aIndex];
 
-                if( clearance >= 0 && footprintFront.Collide( &testFront, clearance, &actual, &pos ) )
+                if( pair.clearance >= 0 && pair.side == F_Cu )
                 {
-                    std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
+                    const SHAPE_POLY_SET& testFront = pair.test->GetPolyCourtyardFront();
 
-                    if( clearance > 0 )
-                    {
-                        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                                      constraint.GetName(),
-                                      MessageTextFromValue( userUnits(), clearance ),
-                                      MessageTextFromValue( userUnits(), actual ) );
-
-                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
-                    }
+                    pair.collides = pair.footprint->GetPolyCourtyardFront().Collide(
+                            &testFront, pair.clearance, &pair.actual, &pair.pos );
+                }
+                else if( pair.clearance >= 0 )
+                {
+                    const SHAPE_POLY_SET& testBack = pair.test->GetPolyCourtyardBack();
 
-                    drce->SetItems( footprint, test );
-                    reportViolation( drce, (wxPoint) pos );
+                    pair.collides = pair.footprint->GetPolyCourtyardBack().Collide(
+                            &testBack, pair.clearance, &pair.actual, &pair.pos );
                 }
-            }
+            };
 
-            if( footprintBack.OutlineCount() > 0 && testBack.OutlineCount() > 0
-                    && backBBox.Intersects( testBack.BBoxFromCaches() ) )
-            {
-                constraint = m_drcEngine->EvalRules( COURTYARD_CLEARANCE_CONSTRAINT, footprint,
-                                                     test, B_Cu );
-                clearance = constraint.GetValue().Min();
+    if( !forEachInParallel( pairs.size(), collideCourtyards ) )
+        return false;   // DRC cancelled
 
-                if( clearance >= 0 && footprintBack.Collide( &testBack, clearance, &actual, &pos ) )
-                {
-                    std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
+    FOOTPRINT* lastFootprint = nullptr;
 
-                    if( clearance > 0 )
-                    {
-                        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                                      constraint.GetName(),
-                                      MessageTextFromValue( userUnits(), clearance ),
-                                      MessageTextFromValue( userUnits(), actual ) );
+    for( const COURTYARD_PAIR& pair : pairs )
+    {
+        // The pairwise loop only checked the error limit when moving on to the next footprint
+        if( pair.footprint != lastFootprint )
+        {
+            if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_FOOTPRINTS ) )
+                break;
 
-                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
-                    }
+            lastFootprint = pair.footprint;
+        }
 
-                    drce->SetItems( footprint, test );
-                    reportViolation( drce, (wxPoint) pos );
-                }
-            }
+        if( !pair.collides )
+            continue;
+
+        std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_OVERLAPPING_FOOTPRINTS );
+
+        if( pair.clearance > 0 )
+        {
+            m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                          pair.constraint.GetName(),
+                          MessageTextFromValue( userUnits(), pair.clearance ),
+                          MessageTextFromValue( userUnits(), pair.actual ) );
+
+            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+            drce->SetViolatingRule( pair.constraint.GetParentRule() );
         }
+
+        drce->SetItems( pair.footprint, pair.test );
+        reportViolation( drce, (wxPoint) pair.pos );
     }
 
     return true;
@@ -32,6 +32,7 @@
 #include <geometry/shape_segment.h>
 
 #include <connectivity/connectivity_data.h>
+#include <connectivity/diff_pair_coupling_cache.h>
 #include <connectivity/from_to_cache.h>
 
 #include <view/view_overlay.h>
@@ -89,48 +90,6 @@ private:
 };
 
 
-static bool commonParallelProjection( SEG p, SEG n, SEG &pClip, SEG& nClip )
-{
-    SEG n_proj_p( p.LineProject( n.A ), p.LineProject( n.B ) );
-
-    int64_t t_a = 0;
-    int64_t t_b = p.TCoef( p.B );
-
-    int64_t tproj_a = p.TCoef( n_proj_p.A );
-    int64_t tproj_b = p.TCoef( n_proj_p.B );
-
-    if( t_b < t_a )
-        std::swap( t_b, t_a );
-
-    if( tproj_b < tproj_a )
-        std::swap( tproj_b, tproj_a );
-
-    if( t_b <= tproj_a )
-        return false;
-
-    if( t_a >= tproj_b )
-        return false;
-
-    int64_t t[4] = { 0, p.TCoef( p.B ), p.TCoef( n_proj_p.A ), p.TCoef( n_proj_p.B ) };
-    std::vector<int64_t> tv( t, t + 4 );
-    std::sort( tv.begin(), tv.end() ); // fixme: awful and disgusting way of finding 2 midpoints
-
-    int64_t pLenSq = p.SquaredLength();
-
-    VECTOR2I dp = p.B - p.A;
-    pClip.A.x = p.A.x + rescale( (int64_t)dp.x, tv[1], pLenSq );
-    pClip.A.y = p.A.y + rescale( (int64_t)dp.y, tv[1], pLenSq );
-
-    pClip.B.x = p.A.x + rescale( (int64_t)dp.x, tv[2], pLenSq );
-    pClip.B.y = p.A.y + rescale( (int64_t)dp.y, tv[2], pLenSq );
-
-    nClip.A = n.LineProject( pClip.A );
-    nClip.B = n.LineProject( pClip.B );
-
-    return true;
-}
-
-
 struct DIFF_PAIR_KEY
 {
     bool operator<( const DIFF_PAIR_KEY& b ) const
@@ -186,87 +145,53 @@ struct DIFF_PAIR_ITEMS
     int totalLengthP;
 };
 
-static void extractDiffPairCoupledItems( DIFF_PAIR_ITEMS& aDp, DRC_RTREE& aTree )
+static void extractDiffPairCoupledItems( DIFF_PAIR_ITEMS& aDp, const DIFF_PAIR_KEY& aKey,
+                                         DRC_RTREE& aTree, DIFF_PAIR_COUPLING_CACHE& aCache )
 {
-    for( BOARD_CONNECTED_ITEM* itemP : aDp.itemsP )
-    {
-        PCB_TRACK* sp = dyn_cast<PCB_TRACK*>( itemP );
-        OPT<DIFF_PAIR_COUPLED_SEGMENTS> bestCoupled;
-        int bestGap = std::numeric_limits<int>::max();
-
-        if( !sp )
-            continue;
+    using COUPLED_SEGMENTS = DIFF_PAIR_COUPLING_CACHE::COUPLED_SEGMENTS;
 
-        for ( BOARD_CONNECTED_ITEM* itemN : aDp.itemsN )
-        {
-            PCB_TRACK* sn = dyn_cast<PCB_TRACK*> ( itemN );
-
-            if( !sn )
-                continue;
-
-            if( ( sn->GetLayerSet() & sp->GetLayerSet() ).none() )
-                continue;
-
-            SEG ssp ( sp->GetStart(), sp->GetEnd() );
-            SEG ssn ( sn->GetStart(), sn->GetEnd() );
-
-            // Segments that are == 1 IU in length are approximately parallel with everything and their
-            // parallel projection is < 1 IU, leading to bad distance calculations
-            if( ssp.SquaredLength() > 1 && ssn.SquaredLength() > 1 && ssp.ApproxParallel(ssn) )
-            {
-                DIFF_PAIR_COUPLED_SEGMENTS cpair;
-                bool coupled = commonParallelProjection( ssp, ssn, cpair.coupledP, cpair.coupledN );
-
-                if( coupled )
+    for( const COUPLED_SEGMENTS& bestCoupled : aCache.GetCoupledSegments( aKey.netP, aKey.netN,
+                                                                          aDp.itemsP,
+                                                                          aDp.itemsN ) )
+    {
+        auto excludeSelf =
+                [&] ( BOARD_ITEM *aItem )
                 {
-                    cpair.parentP = sp;
-                    cpair.parentN = sn;
-                    cpair.layer = sp->GetLayer();
-
-                    int gap = (cpair.coupledP.A - cpair.coupledN.A).EuclideanNorm();
-                    if( gap < bestGap )
+                    if( aItem == bestCoupled.parentN || aItem == bestCoupled.parentP )
                     {
-                        bestGap = gap;
-                        bestCoupled = cpair;
+                        return false;
                     }
-                }
-
-            }
-        }
 
-        if( bestCoupled )
-        {
-            auto excludeSelf =
-                    [&] ( BOARD_ITEM *aItem )
+                    if( aItem->Type() == PCB_TRACE_T || aItem->Type() == PCB_VIA_T )
                     {
-                        if( aItem == bestCoupled->parentN || aItem == bestCoupled->parentP )
-                        {
+                        auto bci = static_cast<BOARD_CONNECTED_ITEM*>( aItem );
+
+                        if( bci->GetNetCode() == bestCoupled.parentN->GetNetCode()
+                        ||  bci->GetNetCode() == bestCoupled.parentP->GetNetCode() )
                             return false;
-                        }
+                    }
 
-                        if( aItem->Type() == PCB_TRACE_T || aItem->Type() == PCB_VIA_T )
-                        {
-                            auto bci = static_cast<BOARD_CONNECTED_ITEM*>( aItem );
+                    return true;
+                };
 
-                            if( bci->GetNetCode() == bestCoupled->parentN->GetNetCode()
-                            ||  bci->GetNetCode() == bestCoupled->parentP->GetNetCode() )
-                                return false;
-                        }
+        SHAPE_SEGMENT checkSegStart( bestCoupled.coupledP.A, bestCoupled.coupledN.A );
+        SHAPE_SEGMENT checkSegEnd( bestCoupled.coupledP.B, bestCoupled.coupledN.B );
 
-                        return true;
-                    };
+        // check if there's anything in between the segments suspected to be coupled. If
+        // there's nothing, assume they are really coupled.
 
-            SHAPE_SEGMENT checkSegStart( bestCoupled->coupledP.A, bestCoupled->coupledN.A );
-            SHAPE_SEGMENT checkSegEnd( bestCoupled->coupledP.B, bestCoupled->coupledN.B );
+        if( !aTree.CheckColliding( &checkSegStart, bestCoupled.layer, 0, excludeSelf )
+              && !aTree.CheckColliding( &checkSegEnd, bestCoupled.layer, 0, excludeSelf ) )
+        {
+            DIFF_PAIR_COUPLED_SEGMENTS cpair;
 
-            // check if there's anything in between the segments suspected to be coupled. If
-            // there's nothing, assume they are really coupled.
+            cpair.coupledP = bestCoupled.coupledP;
+            cpair.coupledN = bestCoupled.coupledN;
+            cpair.parentP = bestCoupled.parentP;
+            cpair.parentN = bestCoupled.parentN;
+            cpair.layer = bestCoupled.layer;
 
-            if( !aTree.CheckColliding( &checkSegStart, sp->GetLayer(), 0, excludeSelf )
-                  && !aTree.CheckColliding( &checkSegEnd, sp->GetLayer(), 0, excludeSelf ) )
-            {
-                aDp.coupled.push_back( *bestCoupled );
-            }
+            aDp.coupled.push_back( cpair );
         }
     }
 }
@@ -329,6 +254,8 @@ bool test::DRC_TEST_PROVIDER_DIFF_PAIR_COUPLING::Run()
 
     DRC_RTREE copperTree;
 
+    copperTree.SetProfile( m_drcEngine->GetProfile() );
+
     auto addToTree =
             [&copperTree]( BOARD_ITEM *item ) -> bool
             {
@@ -345,6 +272,33 @@ bool test::DRC_TEST_PROVIDER_DIFF_PAIR_COUPLING::Run()
                          LSET::AllCuMask(), addToTree );
 
 
+    DIFF_PAIR_COUPLING_CACHE& couplingCache =
+            *m_board->GetConnectivity()->GetDiffPairCouplingCache();
+
+    if( !reportPhase( _( "Checking differential pair coupling..." ) ) )
+        return false;   // DRC cancelled
+
+    std::vector<std::pair<const DIFF_PAIR_KEY*, DIFF_PAIR_ITEMS*>> pairs;
+
+    for( auto& it : dpRuleMatches )
+        pairs.emplace_back( &it.first, &it.second );
+
+    // The tree and the tracks are only read from here on, so the pairs are extracted in
+    // parallel.  They are reported below in the order of the rule matches.
+    if( !forEachInParallel( pairs.size(),
+                            [&]( size_t aIndex )
+                            {
+                                extractDiffPairCoupledItems( *pairs[aIndex].second,
+                                                             *pairs[aIndex].first, copperTree,
+                                                             couplingCache );
+                            } ) )
+    {
+        return false;   // DRC cancelled
+    }
+
+    // The pairs of this run are all looked up; the others belong to tracks which are gone
+    couplingCache.DropUnused();
+
     reportAux( wxString::Format( _("DPs evaluated:") ) );
 
     for( auto& it : dpRuleMatches )
@@ -361,8 +315,6 @@ bool test::DRC_TEST_PROVIDER_DIFF_PAIR_COUPLING::Run()
         reportAux( wxString::Format( "Rule '%s', DP: (+) %s - (-) %s",
                                      it.first.parentRule->m_Name, nameP, nameN ) );
 
-        extractDiffPairCoupledItems( it.second, copperTree );
-
         it.second.totalCoupled = 0;
         it.second.totalLengthN = 0;
         it.second.totalLengthP = 0;
@@ -146,6 +146,8 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
     DRC_RTREE                               edgesTree;
     std::vector<BOARD_ITEM*>                boardItems;     // we don't own these
 
+    edgesTree.SetProfile( m_drcEngine->GetProfile() );
+
     auto queryBoardOutlineItems =
             [&]( BOARD_ITEM *item ) -> bool
             {
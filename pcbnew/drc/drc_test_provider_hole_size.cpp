@@ -24,6 +24,7 @@
 #include <footprint.h>
 #include <pad.h>
 #include <pcb_track.h>
+#include <track_columns.h>
 #include <drc/drc_engine.h>
 #include <drc/drc_item.h>
 #include <drc/drc_rule.h>
@@ -111,12 +112,13 @@ bool DRC_TEST_PROVIDER_HOLE_SIZE::Run()
                 return false;   // DRC cancelled
         }
 
-        std::vector<PCB_VIA*> vias;
+        std::shared_ptr<const TRACK_COLUMNS> tracks = m_board->GetTrackColumns();
+        std::vector<PCB_VIA*>                vias;
 
-        for( PCB_TRACK* track : m_board->Tracks() )
+        for( size_t row = 0; row < tracks->Size(); ++row )
         {
-            if( track->Type() == PCB_VIA_T )
-                vias.push_back( static_cast<PCB_VIA*>( track ) );
+            if( tracks->Type( row ) == PCB_VIA_T )
+                vias.push_back( static_cast<PCB_VIA*>( tracks->Item( row ) ) );
         }
 
         for( PCB_VIA* via : vias )
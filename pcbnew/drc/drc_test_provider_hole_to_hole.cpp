@@ -26,6 +26,7 @@
 #include <footprint.h>
 #include <pad.h>
 #include <pcb_track.h>
+#include <track_columns.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_circle.h>
 #include <drc/drc_engine.h>
@@ -73,7 +74,17 @@ public:
     int GetNumPhases() const override;
 
 private:
-    bool testHoleAgainstHole( BOARD_ITEM* aItem, SHAPE_CIRCLE* aHole, BOARD_ITEM* aOther );
+    /// Two holes near enough to each other to be tested, measured by a worker thread
+    struct HOLE_PAIR
+    {
+        BOARD_ITEM* item;
+        BOARD_ITEM* other;
+        VECTOR2I    center;     ///< of the hole of item
+        bool        colocated;
+        int         actual;     ///< distance between the edges of the holes
+    };
+
+    bool testHoleAgainstHole( const HOLE_PAIR& aPair, int aEpsilon );
 
     BOARD*    m_board;
     DRC_RTREE m_holeTree;
@@ -130,6 +141,7 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::Run()
     size_t       ii = 0;
 
     m_holeTree.clear();
+    m_holeTree.SetProfile( m_drcEngine->GetProfile() );
 
     auto countItems =
             [&]( BOARD_ITEM* item ) -> bool
@@ -169,102 +181,93 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::Run()
             };
 
     forEachGeometryItem( { PCB_PAD_T, PCB_VIA_T }, LSET::AllLayersMask(), countItems );
-
-    count *= 2;  // One for adding to tree; one for checking
-
     forEachGeometryItem( { PCB_PAD_T, PCB_VIA_T }, LSET::AllLayersMask(), addToHoleTree );
 
-    std::map< std::pair<BOARD_ITEM*, BOARD_ITEM*>, int> checkedPairs;
+    // The holes to test, vias first, and the index of each
+    std::vector<BOARD_ITEM*>                holes;
+    std::unordered_map<BOARD_ITEM*, size_t> holeIndices;
 
-    for( PCB_TRACK* track : m_board->Tracks() )
+    std::shared_ptr<const TRACK_COLUMNS> tracks = m_board->GetTrackColumns();
+
+    for( size_t row = 0; row < tracks->Size(); ++row )
     {
-        if( track->Type() != PCB_VIA_T )
+        if( tracks->Type( row ) != PCB_VIA_T )
             continue;
 
-        PCB_VIA* via = static_cast<PCB_VIA*>( track );
-
-        if( !reportProgress( ii++, count, delta ) )
-            return false;   // DRC cancelled
+        PCB_VIA* via = static_cast<PCB_VIA*>( tracks->Item( row ) );
 
         // We only care about mechanically drilled (ie: non-laser) holes
         if( via->GetViaType() == VIATYPE::THROUGH )
         {
-            std::shared_ptr<SHAPE_CIRCLE> holeShape = getDrilledHoleShape( via );
-
-            m_holeTree.QueryColliding( via, F_Cu, F_Cu,
-                    // Filter:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        BOARD_ITEM* a = via;
-                        BOARD_ITEM* b = other;
-
-                        // store canonical order so we don't collide in both directions
-                        // (a:b and b:a)
-                        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                            std::swap( a, b );
-
-                        if( checkedPairs.count( { a, b } ) )
-                        {
-                            return false;
-                        }
-                        else
-                        {
-                            checkedPairs[ { a, b } ] = 1;
-                            return true;
-                        }
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        return testHoleAgainstHole( via, holeShape.get(), other );
-                    },
-                    m_largestClearance );
+            holeIndices[via] = holes.size();
+            holes.push_back( via );
         }
     }
 
-    checkedPairs.clear();
-
     for( FOOTPRINT* footprint : m_board->Footprints() )
     {
         for( PAD* pad : footprint->Pads() )
         {
-            if( !reportProgress( ii++, count, delta ) )
-                return false;   // DRC cancelled
-
             // We only care about drilled (ie: round) holes
             if( pad->GetDrillSize().x && pad->GetDrillSize().x == pad->GetDrillSize().y )
             {
-                std::shared_ptr<SHAPE_CIRCLE> holeShape = getDrilledHoleShape( pad );
+                holeIndices[pad] = holes.size();
+                holes.push_back( pad );
+            }
+        }
+    }
 
-                m_holeTree.QueryColliding( pad, F_Cu, F_Cu,
+    int                                 epsilon = m_board->GetDesignSettings().GetDRCEpsilon();
+    SEG::ecoord                         epsilon_sq = SEG::Square( epsilon );
+    std::vector<std::vector<HOLE_PAIR>> holePairs( holes.size() );
+
+    // The tree is only read from here on, so the holes are measured in parallel.  A pair of
+    // vias, or of pads, is tested by whichever comes first; a via and a pad are tested by both.
+    bool completed = forEachInParallel( holes.size(),
+            [&]( size_t aIndex )
+            {
+                BOARD_ITEM*                   item = holes[aIndex];
+                std::shared_ptr<SHAPE_CIRCLE> holeShape = getDrilledHoleShape( item );
+
+                m_holeTree.QueryColliding( item, F_Cu, F_Cu,
                         // Filter:
                         [&]( BOARD_ITEM* other ) -> bool
                         {
-                            BOARD_ITEM* a = pad;
-                            BOARD_ITEM* b = other;
-
-                            // store canonical order so we don't collide in both directions
-                            // (a:b and b:a)
-                            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                                std::swap( a, b );
-
-                            if( checkedPairs.count( { a, b } ) )
-                            {
-                                return false;
-                            }
-                            else
-                            {
-                                checkedPairs[ { a, b } ] = 1;
+                            if( other->Type() != item->Type() )
                                 return true;
-                            }
+
+                            auto it = holeIndices.find( other );
+
+                            return it == holeIndices.end() || it->second > aIndex;
                         },
                         // Visitor:
                         [&]( BOARD_ITEM* other ) -> bool
                         {
-                            return testHoleAgainstHole( pad, holeShape.get(), other );
+                            std::shared_ptr<SHAPE_CIRCLE> otherHole = getDrilledHoleShape( other );
+
+                            VECTOR2I offset = holeShape->GetCenter() - otherHole->GetCenter();
+                            int      actual = offset.EuclideanNorm();
+
+                            actual -= holeShape->GetRadius() + otherHole->GetRadius();
+
+                            holePairs[aIndex].push_back( { item, other, holeShape->GetCenter(),
+                                                           offset.SquaredEuclideanNorm()
+                                                                   < epsilon_sq,
+                                                           std::max( 0, actual ) } );
+                            return true;
                         },
                         m_largestClearance );
-            }
+            } );
+
+    if( !completed )
+        return false;   // DRC cancelled
+
+    for( const std::vector<HOLE_PAIR>& pairs : holePairs )
+    {
+        for( const HOLE_PAIR& pair : pairs )
+        {
+            if( !testHoleAgainstHole( pair, epsilon ) )
+                break;
         }
     }
 
@@ -274,8 +277,7 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::Run()
 }
 
 
-bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoleAgainstHole( BOARD_ITEM* aItem, SHAPE_CIRCLE* aHole,
-                                                          BOARD_ITEM* aOther )
+bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoleAgainstHole( const HOLE_PAIR& aPair, int aEpsilon )
 {
     bool reportCoLocation = !m_drcEngine->IsErrorLimitExceeded( DRCE_DRILLED_HOLES_COLOCATED );
     bool reportHole2Hole = !m_drcEngine->IsErrorLimitExceeded( DRCE_DRILLED_HOLES_TOO_CLOSE );
@@ -283,43 +285,39 @@ bool DRC_TEST_PROVIDER_HOLE_TO_HOLE::testHoleAgainstHole( BOARD_ITEM* aItem, SHA
     if( !reportCoLocation && !reportHole2Hole )
         return false;
 
-    std::shared_ptr<SHAPE_CIRCLE> otherHole = getDrilledHoleShape( aOther );
-    int                           epsilon = m_board->GetDesignSettings().GetDRCEpsilon();
-    SEG::ecoord                   epsilon_sq = SEG::Square( epsilon );
-
     // Holes at same location generate a separate violation
-    if( ( aHole->GetCenter() - otherHole->GetCenter() ).SquaredEuclideanNorm() < epsilon_sq )
+    if( aPair.colocated )
     {
         if( reportCoLocation )
         {
             std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_DRILLED_HOLES_COLOCATED );
-            drce->SetItems( aItem, aOther );
-            reportViolation( drce, (wxPoint) aHole->GetCenter() );
+            drce->SetItems( aPair.item, aPair.other );
+            reportViolation( drce, (wxPoint) aPair.center );
         }
     }
-    else if( reportHole2Hole )
+    else if( reportHole2Hole && aPair.actual < m_largestClearance - aEpsilon )
     {
-        int actual = ( aHole->GetCenter() - otherHole->GetCenter() ).EuclideanNorm();
-        actual = std::max( 0, actual - aHole->GetRadius() - otherHole->GetRadius() );
-
-        auto constraint = m_drcEngine->EvalRules( HOLE_TO_HOLE_CONSTRAINT, aItem, aOther,
+        // Holes further apart than the worst clearance can't violate any rule, and aren't
+        // worth evaluating the rules for.
+        auto constraint = m_drcEngine->EvalRules( HOLE_TO_HOLE_CONSTRAINT, aPair.item,
+                                                  aPair.other,
                                                   UNDEFINED_LAYER /* holes pierce all layers */ );
-        int  minClearance = constraint.GetValue().Min() - epsilon;
+        int  minClearance = constraint.GetValue().Min() - aEpsilon;
 
-        if( minClearance >= 0 && actual < minClearance )
+        if( minClearance >= 0 && aPair.actual < minClearance )
         {
             std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_DRILLED_HOLES_TOO_CLOSE );
 
             m_msg.Printf( _( "(%s min %s; actual %s)" ),
                           constraint.GetName(),
                           MessageTextFromValue( userUnits(), minClearance ),
-                          MessageTextFromValue( userUnits(), actual ) );
+                          MessageTextFromValue( userUnits(), aPair.actual ) );
 
             drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
-            drce->SetItems( aItem, aOther );
+            drce->SetItems( aPair.item, aPair.other );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, (wxPoint) aHole->GetCenter() );
+            reportViolation( drce, (wxPoint) aPair.center );
         }
     }
 
@@ -27,6 +27,7 @@
 #include <pcb_shape.h>
 
 #include <geometry/seg.h>
+#include <geometry/shape_poly_set.h>
 #include <geometry/shape_segment.h>
 
 #include <drc/drc_engine.h>
@@ -76,6 +77,19 @@ public:
     virtual std::set<DRC_CONSTRAINT_T> GetConstraintTypes() const override;
 
 private:
+    /// A silkscreen shape and a board item shape near enough to it to be tested
+    struct SILK_PAIR
+    {
+        DRC_RTREE::ITEM_WITH_SHAPE* refItem;
+        DRC_RTREE::ITEM_WITH_SHAPE* testItem;
+        DRC_RULE*                   rule;
+        int                         minClearance;
+
+        // Found by the worker threads
+        bool                        collides;
+        int                         actual;
+        VECTOR2I                    pos;
+    };
 
     BOARD* m_board;
     int m_largestClearance;
@@ -111,6 +125,9 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
     int       ii = 0;
     int       targets = 0;
 
+    silkTree.SetProfile( m_drcEngine->GetProfile() );
+    targetTree.SetProfile( m_drcEngine->GetProfile() );
+
     auto addToSilkTree =
             [&silkTree]( BOARD_ITEM* item ) -> bool
             {
@@ -142,31 +159,18 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                 return true;
             };
 
-    auto checkClearance =
+    std::vector<SILK_PAIR> silkPairs;
+
+    // The rules are evaluated on this thread, once for all the shapes of two items
+    std::map<std::tuple<BOARD_ITEM*, BOARD_ITEM*, PCB_LAYER_ID>, DRC_CONSTRAINT> constraints;
+
+    auto gatherPair =
             [&]( const DRC_RTREE::LAYER_PAIR& aLayers, DRC_RTREE::ITEM_WITH_SHAPE* aRefItem,
                  DRC_RTREE::ITEM_WITH_SHAPE* aTestItem, bool* aCollisionDetected ) -> bool
             {
-                if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_SILK ) )
-                    return false;
-
                 if( isInvisibleText( aRefItem->parent ) || isInvisibleText( aTestItem->parent ) )
                     return true;
 
-                auto constraint = m_drcEngine->EvalRules( SILK_CLEARANCE_CONSTRAINT,
-                                                          aRefItem->parent, aTestItem->parent,
-                                                          aLayers.second );
-
-                if( constraint.IsNull() )
-                    return true;
-
-                int minClearance = constraint.GetValue().Min();
-
-                if( minClearance < 0 )
-                    return true;
-
-                int      actual;
-                VECTOR2I pos;
-
                 // Graphics are often compound shapes so ignore collisions between shapes in a
                 // single footprint or on the board.
                 PCB_SHAPE* refGraphic = dynamic_cast<PCB_SHAPE*>( aRefItem->parent );
@@ -181,27 +185,26 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
                         return true;
                 }
 
-                if( aRefItem->shape->Collide( aTestItem->shape, minClearance, &actual, &pos ) )
-                {
-                    std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_OVERLAPPING_SILK );
+                auto key = std::make_tuple( aRefItem->parent, aTestItem->parent, aLayers.second );
+                auto it = constraints.find( key );
 
-                    if( minClearance > 0 )
-                    {
-                        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                                      constraint.GetParentRule()->m_Name,
-                                      MessageTextFromValue( userUnits(), minClearance ),
-                                      MessageTextFromValue( userUnits(), actual ) );
+                if( it == constraints.end() )
+                {
+                    DRC_CONSTRAINT constraint = m_drcEngine->EvalRules( SILK_CLEARANCE_CONSTRAINT,
+                                                                        aRefItem->parent,
+                                                                        aTestItem->parent,
+                                                                        aLayers.second );
 
-                        drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + m_msg );
-                    }
+                    it = constraints.emplace( key, constraint ).first;
+                }
 
-                    drcItem->SetItems( aRefItem->parent, aTestItem->parent );
-                    drcItem->SetViolatingRule( constraint.GetParentRule() );
+                const DRC_CONSTRAINT& constraint = it->second;
 
-                    reportViolation( drcItem, (wxPoint) pos );
+                if( constraint.IsNull() || constraint.GetValue().Min() < 0 )
+                    return true;
 
-                    *aCollisionDetected = true;
-                }
+                silkPairs.push_back( { aRefItem, aTestItem, constraint.GetParentRule(),
+                                       constraint.GetValue().Min(), false, 0, VECTOR2I() } );
 
                 return true;
             };
@@ -243,12 +246,80 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
         DRC_RTREE::LAYER_PAIR( B_SilkS, Margin )
     };
 
-    targetTree.QueryCollidingPairs( &silkTree, layerPairs, checkClearance, m_largestClearance,
+    targetTree.QueryCollidingPairs( &silkTree, layerPairs, gatherPair, m_largestClearance,
                                     [&]( int aCount, int aSize ) -> bool
                                     {
                                         return reportProgress( ++ii, targets, delta );
                                     } );
 
+    // Collide() triangulates polygons on demand, which mustn't happen on the worker threads
+    for( const SILK_PAIR& pair : silkPairs )
+    {
+        for( SHAPE* shape : { pair.refItem->shape, pair.testItem->shape } )
+        {
+            if( shape->Type() == SH_POLY_SET )
+            {
+                static_cast<SHAPE_POLY_SET*>( shape )->CacheTriangulation();
+
+                if( DRC_PROFILE* profile = m_drcEngine->GetProfile() )
+                    profile->CountPolygonOp();
+            }
+        }
+    }
+
+    bool completed = forEachInParallel( silkPairs.size(),
+            [&]( size_t aIndex )
+            {
+                SILK_PAIR& pair = silkPairs[aIndex];
+
+                pair.collides = pair.refItem->shape->Collide( pair.testItem->shape,
+                                                              pair.minClearance, &pair.actual,
+                                                              &pair.pos );
+            } );
+
+    if( !completed )
+        return false;   // DRC cancelled
+
+    // keep track of BOARD_ITEMs pairs that have been already found to collide (some items
+    // might be build of COMPOUND/triangulated shapes and a single subshape collision
+    // means we have a hit)
+    std::set<std::pair<BOARD_ITEM*, BOARD_ITEM*>> collidingCompounds;
+
+    for( const SILK_PAIR& pair : silkPairs )
+    {
+        BOARD_ITEM* a = pair.refItem->parent;
+        BOARD_ITEM* b = pair.testItem->parent;
+
+        // store canonical order so we don't collide in both directions (a:b and b:a)
+        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+            std::swap( a, b );
+
+        if( !pair.collides || collidingCompounds.count( { a, b } ) )
+            continue;
+
+        if( m_drcEngine->IsErrorLimitExceeded( DRCE_OVERLAPPING_SILK ) )
+            break;
+
+        std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_OVERLAPPING_SILK );
+
+        if( pair.minClearance > 0 )
+        {
+            m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                          pair.rule->m_Name,
+                          MessageTextFromValue( userUnits(), pair.minClearance ),
+                          MessageTextFromValue( userUnits(), pair.actual ) );
+
+            drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + m_msg );
+        }
+
+        drcItem->SetItems( pair.refItem->parent, pair.testItem->parent );
+        drcItem->SetViolatingRule( pair.rule );
+
+        reportViolation( drcItem, (wxPoint) pair.pos );
+
+        collidingCompounds.insert( { a, b } );
+    }
+
     reportRuleStatistics();
 
     return true;
@@ -48,6 +48,14 @@ public:
 
     virtual bool Run() override;
 
+    virtual std::set<int> GetIncrementalErrorCodes() const override
+    {
+        return { DRCE_TRACK_WIDTH };
+    }
+
+    virtual bool RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                 const DRC_RTREE& aCopperTree ) override;
+
     virtual const wxString GetName() const override
     {
         return "width";
@@ -61,6 +69,9 @@ public:
     virtual std::set<DRC_CONSTRAINT_T> GetConstraintTypes() const override;
 
     int GetNumPhases() const override;
+
+private:
+    bool checkTrackWidth( BOARD_ITEM* item );
 };
 
 
@@ -83,77 +94,6 @@ bool DRC_TEST_PROVIDER_TRACK_WIDTH::Run()
     if( !reportPhase( _( "Checking track widths..." ) ) )
         return false;       // DRC cancelled
 
-    auto checkTrackWidth =
-            [&]( BOARD_ITEM* item ) -> bool
-            {
-                if( m_drcEngine->IsErrorLimitExceeded( DRCE_TRACK_WIDTH ) )
-                    return false;
-
-                int     actual;
-                wxPoint p0;
-
-                if( PCB_ARC* arc = dyn_cast<PCB_ARC*>( item ) )
-                {
-                    actual = arc->GetWidth();
-                    p0 = arc->GetStart();
-                }
-                else if( PCB_TRACK* trk = dyn_cast<PCB_TRACK*>( item ) )
-                {
-                    actual = trk->GetWidth();
-                    p0 = ( trk->GetStart() + trk->GetEnd() ) / 2;
-                }
-                else
-                {
-                    return true;
-                }
-
-                auto constraint = m_drcEngine->EvalRules( TRACK_WIDTH_CONSTRAINT, item, nullptr,
-                                                          item->GetLayer() );
-                bool fail_min = false;
-                bool fail_max = false;
-                int  constraintWidth;
-
-                if( constraint.Value().HasMin() && actual < constraint.Value().Min() )
-                {
-                    fail_min        = true;
-                    constraintWidth = constraint.Value().Min();
-                }
-
-                if( constraint.Value().HasMax() && actual > constraint.Value().Max() )
-                {
-                    fail_max        = true;
-                    constraintWidth = constraint.Value().Max();
-                }
-
-                if( fail_min || fail_max )
-                {
-                    std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_TRACK_WIDTH );
-
-                    if( fail_min )
-                    {
-                        m_msg.Printf( _( "(%s min width %s; actual %s)" ),
-                                      constraint.GetName(),
-                                      MessageTextFromValue( userUnits(), constraintWidth ),
-                                      MessageTextFromValue( userUnits(), actual ) );
-                    }
-                    else
-                    {
-                        m_msg.Printf( _( "(%s max width %s; actual %s)" ),
-                                      constraint.GetName(),
-                                      MessageTextFromValue( userUnits(), constraintWidth ),
-                                      MessageTextFromValue( userUnits(), actual ) );
-                    }
-
-                    drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + m_msg );
-                    drcItem->SetItems( item );
-                    drcItem->SetViolatingRule( constraint.GetParentRule() );
-
-                    reportViolation( drcItem, p0 );
-                }
-
-                return true;
-            };
-
     int ii = 0;
 
     for( PCB_TRACK* item : m_drcEngine->GetBoard()->Tracks() )
@@ -171,6 +111,93 @@ bool DRC_TEST_PROVIDER_TRACK_WIDTH::Run()
 }
 
 
+bool DRC_TEST_PROVIDER_TRACK_WIDTH::checkTrackWidth( BOARD_ITEM* item )
+{
+    if( m_drcEngine->IsErrorLimitExceeded( DRCE_TRACK_WIDTH ) )
+        return false;
+
+    int     actual;
+    wxPoint p0;
+
+    if( PCB_ARC* arc = dyn_cast<PCB_ARC*>( item ) )
+    {
+        actual = arc->GetWidth();
+        p0 = arc->GetStart();
+    }
+    else if( PCB_TRACK* trk = dyn_cast<PCB_TRACK*>( item ) )
+    {
+        actual = trk->GetWidth();
+        p0 = ( trk->GetStart() + trk->GetEnd() ) / 2;
+    }
+    else
+    {
+        return true;
+    }
+
+    auto constraint = m_drcEngine->EvalRules( TRACK_WIDTH_CONSTRAINT, item, nullptr,
+                                              item->GetLayer() );
+    bool fail_min = false;
+    bool fail_max = false;
+    int  constraintWidth;
+
+    if( constraint.Value().HasMin() && actual < constraint.Value().Min() )
+    {
+        fail_min        = true;
+        constraintWidth = constraint.Value().Min();
+    }
+
+    if( constraint.Value().HasMax() && actual > constraint.Value().Max() )
+    {
+        fail_max        = true;
+        constraintWidth = constraint.Value().Max();
+    }
+
+    if( fail_min || fail_max )
+    {
+        std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_TRACK_WIDTH );
+
+        if( fail_min )
+        {
+            m_msg.Printf( _( "(%s min width %s; actual %s)" ),
+                          constraint.GetName(),
+                          MessageTextFromValue( userUnits(), constraintWidth ),
+                          MessageTextFromValue( userUnits(), actual ) );
+        }
+        else
+        {
+            m_msg.Printf( _( "(%s max width %s; actual %s)" ),
+                          constraint.GetName(),
+                          MessageTextFromValue( userUnits(), constraintWidth ),
+                          MessageTextFromValue( userUnits(), actual ) );
+        }
+
+        drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + m_msg );
+        drcItem->SetItems( item );
+        drcItem->SetViolatingRule( constraint.GetParentRule() );
+
+        reportViolation( drcItem, p0 );
+    }
+
+    return true;
+}
+
+
+bool DRC_TEST_PROVIDER_TRACK_WIDTH::RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                                    const DRC_RTREE& aCopperTree )
+{
+    if( !m_drcEngine->HasRulesForConstraintType( TRACK_WIDTH_CONSTRAINT ) )
+        return true;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( !checkTrackWidth( item ) )
+            break;
+    }
+
+    return true;
+}
+
+
 int DRC_TEST_PROVIDER_TRACK_WIDTH::GetNumPhases() const
 {
     return 1;
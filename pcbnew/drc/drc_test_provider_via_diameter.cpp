@@ -47,6 +47,14 @@ public:
 
     virtual bool Run() override;
 
+    virtual std::set<int> GetIncrementalErrorCodes() const override
+    {
+        return { DRCE_VIA_DIAMETER };
+    }
+
+    virtual bool RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                 const DRC_RTREE& aCopperTree ) override;
+
     virtual const wxString GetName() const override
     {
         return "diameter";
@@ -60,6 +68,9 @@ public:
     virtual std::set<DRC_CONSTRAINT_T> GetConstraintTypes() const override;
 
     int GetNumPhases() const override;
+
+private:
+    bool checkViaDiameter( BOARD_ITEM* item );
 };
 
 
@@ -82,67 +93,6 @@ bool DRC_TEST_PROVIDER_VIA_DIAMETER::Run()
     if( !reportPhase( _( "Checking via diameters..." ) ) )
         return false;       // DRC cancelled
 
-    auto checkViaDiameter =
-            [&]( BOARD_ITEM* item ) -> bool
-            {
-                if( m_drcEngine->IsErrorLimitExceeded( DRCE_VIA_DIAMETER ) )
-                    return false;
-
-                PCB_VIA* via = dyn_cast<PCB_VIA*>( item );
-
-                // fixme: move to pad stack check?
-                if( !via )
-                    return true;
-
-                // TODO: once we have padstacks this will need to run per-layer...
-                auto constraint = m_drcEngine->EvalRules( VIA_DIAMETER_CONSTRAINT, item, nullptr,
-                                                          UNDEFINED_LAYER );
-                bool fail_min = false;
-                bool fail_max = false;
-                int  constraintDiameter = 0;
-                int  actual = via->GetWidth();
-
-                if( constraint.Value().HasMin() && actual < constraint.Value().Min() )
-                {
-                    fail_min = true;
-                    constraintDiameter = constraint.Value().Min();
-                }
-
-                if( constraint.Value().HasMax() && actual > constraint.Value().Max() )
-                {
-                    fail_max = true;
-                    constraintDiameter = constraint.Value().Max();
-                }
-
-                if( fail_min )
-                {
-                    m_msg.Printf( _( "(%s min diameter %s; actual %s)" ),
-                                  constraint.GetName(),
-                                  MessageTextFromValue( userUnits(), constraintDiameter ),
-                                  MessageTextFromValue( userUnits(), actual ) );
-                }
-                else if( fail_max )
-                {
-                    m_msg.Printf( _( "(%s max diameter %s; actual %s)" ),
-                                  constraint.GetName(),
-                                  MessageTextFromValue( userUnits(), constraintDiameter ),
-                                  MessageTextFromValue( userUnits(), actual ) );
-                }
-
-                if( fail_min || fail_max )
-                {
-                    std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_VIA_DIAMETER );
-
-                    drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + m_msg );
-                    drcItem->SetItems( item );
-                    drcItem->SetViolatingRule( constraint.GetParentRule() );
-
-                    reportViolation( drcItem, via->GetPosition() );
-                }
-
-                return true;
-            };
-
     int ii = 0;
 
     for( PCB_TRACK* item : m_drcEngine->GetBoard()->Tracks() )
@@ -160,6 +110,83 @@ bool DRC_TEST_PROVIDER_VIA_DIAMETER::Run()
 }
 
 
+bool DRC_TEST_PROVIDER_VIA_DIAMETER::checkViaDiameter( BOARD_ITEM* item )
+{
+    if( m_drcEngine->IsErrorLimitExceeded( DRCE_VIA_DIAMETER ) )
+        return false;
+
+    PCB_VIA* via = dyn_cast<PCB_VIA*>( item );
+
+    // fixme: move to pad stack check?
+    if( !via )
+        return true;
+
+    // TODO: once we have padstacks this will need to run per-layer...
+    auto constraint = m_drcEngine->EvalRules( VIA_DIAMETER_CONSTRAINT, item, nullptr,
+                                              UNDEFINED_LAYER );
+    bool fail_min = false;
+    bool fail_max = false;
+    int  constraintDiameter = 0;
+    int  actual = via->GetWidth();
+
+    if( constraint.Value().HasMin() && actual < constraint.Value().Min() )
+    {
+        fail_min = true;
+        constraintDiameter = constraint.Value().Min();
+    }
+
+    if( constraint.Value().HasMax() && actual > constraint.Value().Max() )
+    {
+        fail_max = true;
+        constraintDiameter = constraint.Value().Max();
+    }
+
+    if( fail_min )
+    {
+        m_msg.Printf( _( "(%s min diameter %s; actual %s)" ),
+                      constraint.GetName(),
+                      MessageTextFromValue( userUnits(), constraintDiameter ),
+                      MessageTextFromValue( userUnits(), actual ) );
+    }
+    else if( fail_max )
+    {
+        m_msg.Printf( _( "(%s max diameter %s; actual %s)" ),
+                      constraint.GetName(),
+                      MessageTextFromValue( userUnits(), constraintDiameter ),
+                      MessageTextFromValue( userUnits(), actual ) );
+    }
+
+    if( fail_min || fail_max )
+    {
+        std::shared_ptr<DRC_ITEM> drcItem = DRC_ITEM::Create( DRCE_VIA_DIAMETER );
+
+        drcItem->SetErrorMessage( drcItem->GetErrorText() + wxS( " " ) + m_msg );
+        drcItem->SetItems( item );
+        drcItem->SetViolatingRule( constraint.GetParentRule() );
+
+        reportViolation( drcItem, via->GetPosition() );
+    }
+
+    return true;
+}
+
+
+bool DRC_TEST_PROVIDER_VIA_DIAMETER::RunIncremental( const std::vector<BOARD_ITEM*>& aItems,
+                                                     const DRC_RTREE& aCopperTree )
+{
+    if( !m_drcEngine->HasRulesForConstraintType( VIA_DIAMETER_CONSTRAINT ) )
+        return true;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        if( !checkViaDiameter( item ) )
+            break;
+    }
+
+    return true;
+}
+
+
 int DRC_TEST_PROVIDER_VIA_DIAMETER::GetNumPhases() const
 {
     return 1;
@@ -0,0 +1,574 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drill_path_optimizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+
+// Smallest shortening of the path worth a move, in internal units.  Keeps rounding noise from
+// undoing and redoing the same moves.
+static const double MIN_GAIN = 0.5;
+
+
+static double squaredDistance( const wxPoint& aA, const wxPoint& aB )
+{
+    double dx = double( aA.x ) - aB.x;
+    double dy = double( aA.y ) - aB.y;
+
+    return dx * dx + dy * dy;
+}
+
+
+static double distance( const wxPoint& aA, const wxPoint& aB )
+{
+    return std::sqrt( squaredDistance( aA, aB ) );
+}
+
+
+DRILL_PATH_OPTIMIZER::DRILL_PATH_OPTIMIZER( const wxPoint& aStart,
+                                            const std::vector<wxPoint>& aPoints ) :
+        m_work( 0 ),
+        m_cellSize( 1.0 ),
+        m_columns( 1 ),
+        m_rows( 1 )
+{
+    m_points.reserve( aPoints.size() + 1 );
+    m_points.push_back( aStart );
+    m_points.insert( m_points.end(), aPoints.begin(), aPoints.end() );
+}
+
+
+double DRILL_PATH_OPTIMIZER::PathLength( const wxPoint& aStart,
+                                         const std::vector<wxPoint>& aPoints )
+{
+    double  length = 0.0;
+    wxPoint last = aStart;
+
+    for( const wxPoint& point : aPoints )
+    {
+        length += distance( last, point );
+        last = point;
+    }
+
+    return length;
+}
+
+
+double DRILL_PATH_OPTIMIZER::dist( int aA, int aB ) const
+{
+    return distance( m_points[aA], m_points[aB] );
+}
+
+
+std::vector<int> DRILL_PATH_OPTIMIZER::Optimize( int aEffort )
+{
+    int              count = m_points.size();
+    std::vector<int> order( count - 1 );
+
+    std::iota( order.begin(), order.end(), 0 );
+
+    if( count <= 2 )
+        return order;
+
+    buildGrid();
+    buildNeighbours();
+    buildNearestNeighbourPath();
+
+    m_position.resize( count );
+
+    for( int ii = 0; ii < count; ++ii )
+        m_position[m_path[ii]] = ii;
+
+    // Refine the path until no hole can be moved to advantage, or the work budget is spent
+    m_queued.assign( count, 0 );
+
+    for( int ii = 1; ii < count; ++ii )
+        requeue( ii );
+
+    long long budget = (long long) aEffort * ( count - 1 );
+
+    m_work = 0;
+
+    while( !m_queue.empty() && m_work < budget )
+    {
+        int point = m_queue.front();
+
+        m_queue.pop_front();
+        m_queued[point] = 0;
+
+        if( !improveTwoOpt( point ) )
+            improveOrOpt( point );
+    }
+
+    double optimizedLength = 0.0;
+    double givenLength = 0.0;
+
+    for( int ii = 1; ii < count; ++ii )
+    {
+        optimizedLength += dist( m_path[ii - 1], m_path[ii] );
+        givenLength += dist( ii - 1, ii );
+    }
+
+    if( optimizedLength < givenLength )
+    {
+        for( int ii = 1; ii < count; ++ii )
+            order[ii - 1] = m_path[ii] - 1;
+    }
+
+    return order;
+}
+
+
+void DRILL_PATH_OPTIMIZER::buildGrid()
+{
+    int count = m_points.size();
+    int minX = m_points[0].x;
+    int minY = m_points[0].y;
+    int maxX = minX;
+    int maxY = minY;
+
+    for( const wxPoint& point : m_points )
+    {
+        minX = std::min( minX, point.x );
+        minY = std::min( minY, point.y );
+        maxX = std::max( maxX, point.x );
+        maxY = std::max( maxY, point.y );
+    }
+
+    double width = double( maxX ) - minX;
+    double height = double( maxY ) - minY;
+
+    // About one point per cell, without making a single row or column longer than the point
+    // count when all points are in a line
+    m_cellSize = std::max( { std::sqrt( width * height / count ),
+                             std::max( width, height ) / count,
+                             1.0 } );
+
+    m_columns = int( width / m_cellSize ) + 1;
+    m_rows = int( height / m_cellSize ) + 1;
+
+    m_cells.assign( (size_t) m_columns * m_rows, std::vector<int>() );
+    m_cellOf.resize( count );
+    m_slotOf.resize( count );
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        int column = int( ( double( m_points[ii].x ) - minX ) / m_cellSize );
+        int row = int( ( double( m_points[ii].y ) - minY ) / m_cellSize );
+        int cell = row * m_columns + column;
+
+        m_cellOf[ii] = cell;
+        m_slotOf[ii] = m_cells[cell].size();
+        m_cells[cell].push_back( ii );
+    }
+}
+
+
+void DRILL_PATH_OPTIMIZER::ringCells( int aColumn, int aRow, int aRing,
+                                      std::vector<int>& aCells ) const
+{
+    aCells.clear();
+
+    for( int row = aRow - aRing; row <= aRow + aRing; ++row )
+    {
+        if( row < 0 || row >= m_rows )
+            continue;
+
+        // Only the first and last rows of the ring are full, the others only have their ends
+        bool fullRow = row == aRow - aRing || row == aRow + aRing;
+        int  step = fullRow ? 1 : 2 * aRing;
+
+        for( int column = aColumn - aRing; column <= aColumn + aRing; column += step )
+        {
+            if( column >= 0 && column < m_columns )
+                aCells.push_back( row * m_columns + column );
+        }
+    }
+}
+
+
+void DRILL_PATH_OPTIMIZER::buildNeighbours()
+{
+    typedef std::pair<double, int> CANDIDATE;    // squared distance and point
+
+    int                    count = m_points.size();
+    int                    wanted = std::min( NEIGHBOURS, count - 1 );
+    int                    maxRing = std::max( m_columns, m_rows );
+    std::vector<CANDIDATE> found;
+    std::vector<int>       cells;
+
+    m_neighbours.assign( (size_t) count * NEIGHBOURS, -1 );
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        int column = m_cellOf[ii] % m_columns;
+        int row = m_cellOf[ii] / m_columns;
+
+        found.clear();
+
+        for( int ring = 0; ring <= maxRing; ++ring )
+        {
+            ringCells( column, row, ring, cells );
+
+            for( int cell : cells )
+            {
+                for( int point : m_cells[cell] )
+                {
+                    if( point != ii )
+                        found.emplace_back( squaredDistance( m_points[ii], m_points[point] ),
+                                            point );
+                }
+            }
+
+            // Points beyond this ring are at least ring cells away
+            if( (int) found.size() >= wanted )
+            {
+                std::nth_element( found.begin(), found.begin() + wanted - 1, found.end() );
+
+                double bound = ring * m_cellSize;
+
+                if( found[wanted - 1].first < bound * bound )
+                    break;
+            }
+        }
+
+        std::partial_sort( found.begin(), found.begin() + wanted, found.end() );
+
+        for( int jj = 0; jj < wanted; ++jj )
+            m_neighbours[(size_t) ii * NEIGHBOURS + jj] = found[jj].second;
+    }
+}
+
+
+int DRILL_PATH_OPTIMIZER::nearestInGrid( int aPoint ) const
+{
+    int              column = m_cellOf[aPoint] % m_columns;
+    int              row = m_cellOf[aPoint] / m_columns;
+    int              maxRing = std::max( m_columns, m_rows );
+    int              nearest = -1;
+    double           nearestDist = 0.0;
+    std::vector<int> cells;
+
+    for( int ring = 0; ring <= maxRing; ++ring )
+    {
+        ringCells( column, row, ring, cells );
+
+        for( int cell : cells )
+        {
+            for( int point : m_cells[cell] )
+            {
+                double d = squaredDistance( m_points[aPoint], m_points[point] );
+
+                // Ties go to the lowest index, as in the neighbour lists
+                if( nearest < 0 || d < nearestDist || ( d == nearestDist && point < nearest ) )
+                {
+                    nearest = point;
+                    nearestDist = d;
+                }
+            }
+        }
+
+        double bound = ring * m_cellSize;
+
+        if( nearest >= 0 && nearestDist < bound * bound )
+            break;
+    }
+
+    return nearest;
+}
+
+
+void DRILL_PATH_OPTIMIZER::removeFromGrid( int aPoint )
+{
+    std::vector<int>& cell = m_cells[m_cellOf[aPoint]];
+    int               slot = m_slotOf[aPoint];
+
+    cell[slot] = cell.back();
+    m_slotOf[cell[slot]] = slot;
+    cell.pop_back();
+}
+
+
+void DRILL_PATH_OPTIMIZER::buildNearestNeighbourPath()
+{
+    int               count = m_points.size();
+    std::vector<char> drilled( count, 0 );
+    int               current = 0;
+
+    m_path.clear();
+    m_path.reserve( count );
+    m_path.push_back( 0 );
+    drilled[0] = 1;
+    removeFromGrid( 0 );
+
+    for( int ii = 1; ii < count; ++ii )
+    {
+        int next = -1;
+
+        // The neighbour lists hold the nearest points in order, so the first one not drilled
+        // yet is the nearest of all those not drilled yet.  Only when they have all been
+        // drilled does the grid need searching.
+        for( int jj = 0; jj < NEIGHBOURS && next < 0; ++jj )
+        {
+            int neighbour = m_neighbours[(size_t) current * NEIGHBOURS + jj];
+
+            if( neighbour < 0 )
+                break;
+
+            if( !drilled[neighbour] )
+                next = neighbour;
+        }
+
+        if( next < 0 )
+            next = nearestInGrid( current );
+
+        drilled[next] = 1;
+        removeFromGrid( next );
+        m_path.push_back( next );
+        current = next;
+    }
+}
+
+
+void DRILL_PATH_OPTIMIZER::requeue( int aPosition )
+{
+    // The start point at position 0 never moves
+    if( aPosition < 1 || aPosition >= (int) m_path.size() )
+        return;
+
+    int point = m_path[aPosition];
+
+    if( !m_queued[point] )
+    {
+        m_queued[point] = 1;
+        m_queue.push_back( point );
+    }
+}
+
+
+double DRILL_PATH_OPTIMIZER::reverseGain( int aFirst, int aLast ) const
+{
+    int    before = m_path[aFirst - 1];
+    int    first = m_path[aFirst];
+    int    last = m_path[aLast];
+    double gain = dist( before, first ) - dist( before, last );
+
+    if( aLast + 1 < (int) m_path.size() )
+    {
+        int after = m_path[aLast + 1];
+
+        gain += dist( last, after ) - dist( first, after );
+    }
+
+    return gain;
+}
+
+
+void DRILL_PATH_OPTIMIZER::reverse( int aFirst, int aLast )
+{
+    std::reverse( m_path.begin() + aFirst, m_path.begin() + aLast + 1 );
+
+    for( int ii = aFirst; ii <= aLast; ++ii )
+        m_position[m_path[ii]] = ii;
+
+    m_work += aLast - aFirst + 1;
+
+    requeue( aFirst - 1 );
+    requeue( aFirst );
+    requeue( aLast );
+    requeue( aLast + 1 );
+}
+
+
+bool DRILL_PATH_OPTIMIZER::improveTwoOpt( int aPoint )
+{
+    int pos = m_position[aPoint];
+
+    for( int jj = 0; jj < NEIGHBOURS; ++jj )
+    {
+        int neighbour = m_neighbours[(size_t) aPoint * NEIGHBOURS + jj];
+
+        if( neighbour < 0 )
+            break;
+
+        int other = m_position[neighbour];
+
+        m_work++;
+
+        // Reversing one of these runs makes the point and its neighbour adjacent, either
+        // directly or as the ends of the reversed run
+        std::pair<int, int> runs[2];
+        int                 runCount = 0;
+
+        if( other > pos )
+        {
+            runs[runCount++] = { pos + 1, other };
+
+            if( pos >= 1 )
+                runs[runCount++] = { pos, other - 1 };
+        }
+        else
+        {
+            runs[runCount++] = { other + 1, pos };
+
+            if( other >= 1 )
+                runs[runCount++] = { other, pos - 1 };
+        }
+
+        for( int ii = 0; ii < runCount; ++ii )
+        {
+            if( runs[ii].first < runs[ii].second
+                    && reverseGain( runs[ii].first, runs[ii].second ) > MIN_GAIN )
+            {
+                reverse( runs[ii].first, runs[ii].second );
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+bool DRILL_PATH_OPTIMIZER::improveOrOpt( int aPoint )
+{
+    int lastPos = m_path.size() - 1;
+    int pos = m_position[aPoint];
+
+    for( int length = 1; length <= 3 && pos + length - 1 <= lastPos; ++length )
+    {
+        int end = pos + length - 1;
+        int first = m_path[pos];
+        int last = m_path[end];
+        int before = m_path[pos - 1];
+
+        // Shortening from taking the run out of the path
+        double removeGain = dist( before, first );
+
+        if( end < lastPos )
+        {
+            int after = m_path[end + 1];
+
+            removeGain += dist( last, after ) - dist( before, after );
+        }
+
+        if( removeGain <= MIN_GAIN )
+            continue;
+
+        for( int runEnd = 0; runEnd < ( length > 1 ? 2 : 1 ); ++runEnd )
+        {
+            int endPoint = runEnd ? last : first;
+
+            for( int jj = 0; jj < NEIGHBOURS; ++jj )
+            {
+                int neighbour = m_neighbours[(size_t) endPoint * NEIGHBOURS + jj];
+
+                if( neighbour < 0 )
+                    break;
+
+                int other = m_position[neighbour];
+
+                if( other >= pos && other <= end )
+                    continue;
+
+                m_work++;
+
+                // Put the run right after the neighbour, or right before it, turned so that the
+                // end point is next to the neighbour
+                for( int side = 0; side < 2; ++side )
+                {
+                    int  slot = side ? other - 1 : other;   // the run goes after this position
+                    bool reversed = side ? endPoint == first : endPoint == last;
+
+                    if( slot < 0 || ( slot >= pos - 1 && slot <= end ) )
+                        continue;
+
+                    int    slotFirst = reversed ? last : first;
+                    int    slotLast = reversed ? first : last;
+                    double insertCost = dist( m_path[slot], slotFirst );
+
+                    if( slot < lastPos )
+                    {
+                        insertCost += dist( slotLast, m_path[slot + 1] )
+                                      - dist( m_path[slot], m_path[slot + 1] );
+                    }
+
+                    if( removeGain - insertCost > MIN_GAIN )
+                    {
+                        moveRun( pos, end, slot, reversed );
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+
+void DRILL_PATH_OPTIMIZER::moveRun( int aFirst, int aLast, int aSlot, bool aReversed )
+{
+    int length = aLast - aFirst + 1;
+    int runStart;
+    int changedFirst;
+    int changedLast;
+
+    if( aSlot > aLast )
+    {
+        std::rotate( m_path.begin() + aFirst, m_path.begin() + aLast + 1,
+                     m_path.begin() + aSlot + 1 );
+        runStart = aSlot - length + 1;
+        changedFirst = aFirst;
+        changedLast = aSlot;
+    }
+    else
+    {
+        std::rotate( m_path.begin() + aSlot + 1, m_path.begin() + aFirst,
+                     m_path.begin() + aLast + 1 );
+        runStart = aSlot + 1;
+        changedFirst = aSlot + 1;
+        changedLast = aLast;
+    }
+
+    if( aReversed )
+        std::reverse( m_path.begin() + runStart, m_path.begin() + runStart + length );
+
+    for( int ii = changedFirst; ii <= changedLast; ++ii )
+        m_position[m_path[ii]] = ii;
+
+    m_work += changedLast - changedFirst + 1;
+
+    requeue( changedFirst - 1 );
+    requeue( changedFirst );
+    requeue( changedLast );
+    requeue( changedLast + 1 );
+    requeue( runStart - 1 );
+    requeue( runStart );
+    requeue( runStart + length - 1 );
+    requeue( runStart + length );
+}
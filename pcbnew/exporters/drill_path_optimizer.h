@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRILL_PATH_OPTIMIZER_H
+#define DRILL_PATH_OPTIMIZER_H
+
+#include <deque>
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+
+/**
+ * Find a short path for a drilling machine through a set of holes drilled with the same tool.
+ *
+ * The path starts at a given point (the drill origin) and ends at whichever hole is drilled
+ * last.  It is seeded with the nearest neighbour heuristic and then refined with 2-opt and
+ * Or-opt moves between each hole and its nearest neighbours.
+ *
+ * The refinement is bounded by an amount of work per hole rather than by time, so that the
+ * result only depends on the input and not on the speed or load of the machine.
+ */
+class DRILL_PATH_OPTIMIZER
+{
+public:
+    /// Default bound of the refinement work per hole.
+    static const int DEFAULT_EFFORT = 1000;
+
+    /**
+     * @param aStart is the position of the drill before the first hole.
+     * @param aPoints are the holes to drill.
+     */
+    DRILL_PATH_OPTIMIZER( const wxPoint& aStart, const std::vector<wxPoint>& aPoints );
+
+    /**
+     * @param aEffort bounds the number of candidate moves evaluated, and points moved, per hole.
+     * @return the order in which to drill the holes, as indices in the hole list.  The path is
+     *         never longer than drilling the holes in the given order.
+     */
+    std::vector<int> Optimize( int aEffort = DEFAULT_EFFORT );
+
+    /**
+     * @return the length of the path from @a aStart through @a aPoints, in the given order.
+     */
+    static double PathLength( const wxPoint& aStart, const std::vector<wxPoint>& aPoints );
+
+private:
+    /// Number of nearest neighbours considered for each hole.
+    static const int NEIGHBOURS = 8;
+
+    double dist( int aA, int aB ) const;
+
+    /// Sort the points into grid cells, to find near points without looking at all of them.
+    void buildGrid();
+
+    /// Collect the cells at @a aRing cells from a cell in either direction.
+    void ringCells( int aColumn, int aRow, int aRing, std::vector<int>& aCells ) const;
+
+    void buildNeighbours();
+
+    /// Build the initial path, always going to the nearest hole not drilled yet.
+    void buildNearestNeighbourPath();
+
+    /// @return the nearest point still in the grid to @a aPoint, or -1 if there is none.
+    int nearestInGrid( int aPoint ) const;
+
+    void removeFromGrid( int aPoint );
+
+    /**
+     * @return the change of length from reversing the path between positions @a aFirst and
+     *         @a aLast, positive when shorter.
+     */
+    double reverseGain( int aFirst, int aLast ) const;
+
+    void reverse( int aFirst, int aLast );
+
+    /**
+     * Try to shorten the path by reconnecting the point @a aPoint with one of its neighbours.
+     */
+    bool improveTwoOpt( int aPoint );
+
+    /**
+     * Try to shorten the path by moving a run of one to three points starting at @a aPoint
+     * next to a neighbour of one of its ends.
+     */
+    bool improveOrOpt( int aPoint );
+
+    /**
+     * Move the run of points between path positions @a aFirst and @a aLast to just after
+     * position @a aSlot, optionally reversed.
+     */
+    void moveRun( int aFirst, int aLast, int aSlot, bool aReversed );
+
+    /// Mark the point at a path position as worth another look.
+    void requeue( int aPosition );
+
+    std::vector<wxPoint>          m_points;     ///< the start point, then the holes
+    std::vector<int>              m_path;       ///< point indices in path order
+    std::vector<int>              m_position;   ///< path position of each point
+    std::vector<int>              m_neighbours; ///< NEIGHBOURS nearest points of each point
+
+    std::deque<int>               m_queue;      ///< points which may still be improved on
+    std::vector<char>             m_queued;
+    long long                     m_work;
+
+    // Point grid
+    double                        m_cellSize;
+    int                           m_columns;
+    int                           m_rows;
+    std::vector<std::vector<int>> m_cells;
+    std::vector<int>              m_cellOf;
+    std::vector<int>              m_slotOf;     ///< index of each point in its cell
+};
+
+#endif // DRILL_PATH_OPTIMIZER_H
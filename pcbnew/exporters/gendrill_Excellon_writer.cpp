@@ -126,6 +126,10 @@ void EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
                     }
                 }
 
+                // Round holes are all drilled before the oblong ones
+                if( m_optimizeDrillPath )
+                    optimizeDrillPath( true, aReporter );
+
                 TYPE_FILE file_type = TYPE_FILE::PTH_FILE;
 
                 // Only external layer pair can have non plated hole
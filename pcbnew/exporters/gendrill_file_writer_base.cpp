@@ -29,8 +29,14 @@
 #include <pcb_track.h>
 #include <collectors.h>
 #include <reporter.h>
+#include <convert_to_biu.h>
 
 #include <gendrill_file_writer_base.h>
+#include <drill_path_optimizer.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
 
 
 /* Helper function for sorting hole list.
@@ -203,6 +209,104 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
 }
 
 
+void GENDRILL_WRITER_BASE::optimizeDrillPath( bool aOblongHolesLast, REPORTER* aReporter )
+{
+    double before = drillPathLength( aOblongHolesLast );
+
+    // Each tool's round holes, then its oblong ones, are drilled in a row: these are the
+    // ranges of holes to reorder
+    std::vector<std::pair<size_t, size_t>> ranges;
+
+    for( size_t first = 0; first < m_holeListBuffer.size(); )
+    {
+        size_t last = first;
+        int    tool = m_holeListBuffer[first].m_Tool_Reference;
+
+        while( last < m_holeListBuffer.size() && m_holeListBuffer[last].m_Tool_Reference == tool )
+            last++;
+
+        auto oblongStart = std::stable_partition( m_holeListBuffer.begin() + first,
+                                                  m_holeListBuffer.begin() + last,
+                                                  []( const HOLE_INFO& aHole )
+                                                  {
+                                                      return aHole.m_Hole_Shape == 0;
+                                                  } );
+        size_t oblongFirst = oblongStart - m_holeListBuffer.begin();
+
+        if( oblongFirst > first )
+            ranges.emplace_back( first, oblongFirst );
+
+        if( last > oblongFirst )
+            ranges.emplace_back( oblongFirst, last );
+
+        first = last;
+    }
+
+    std::atomic<size_t> next( 0 );
+
+    auto optimize_lambda =
+            [&]()
+            {
+                for( size_t ii = next++; ii < ranges.size(); ii = next++ )
+                {
+                    auto                 begin = m_holeListBuffer.begin() + ranges[ii].first;
+                    auto                 end = m_holeListBuffer.begin() + ranges[ii].second;
+                    std::vector<wxPoint> positions;
+
+                    for( auto hole = begin; hole != end; ++hole )
+                        positions.push_back( hole->m_Hole_Pos );
+
+                    DRILL_PATH_OPTIMIZER   optimizer( m_offset, positions );
+                    std::vector<int>       order = optimizer.Optimize();
+                    std::vector<HOLE_INFO> holes( begin, end );
+
+                    for( size_t jj = 0; jj < order.size(); ++jj )
+                        *( begin + jj ) = holes[order[jj]];
+                }
+            };
+
+    // Each range is reordered by a single thread, so the result does not depend on the
+    // thread count
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), ranges.size() );
+    std::vector<std::future<void>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, optimize_lambda );
+
+    for( std::future<void>& ret : returns )
+        ret.get();
+
+    if( aReporter )
+    {
+        double after = drillPathLength( aOblongHolesLast );
+
+        aReporter->Report( wxString::Format( _( "Drill travel: %.1f mm, %.1f mm before "
+                                                "optimization\n" ),
+                                             after / IU_PER_MM, before / IU_PER_MM ) );
+    }
+}
+
+
+double GENDRILL_WRITER_BASE::drillPathLength( bool aOblongHolesLast ) const
+{
+    std::vector<wxPoint> positions;
+
+    positions.reserve( m_holeListBuffer.size() );
+
+    for( int pass = 0; pass < ( aOblongHolesLast ? 2 : 1 ); ++pass )
+    {
+        for( const HOLE_INFO& hole : m_holeListBuffer )
+        {
+            if( !aOblongHolesLast || ( hole.m_Hole_Shape != 0 ) == ( pass == 1 ) )
+                positions.push_back( hole.m_Hole_Pos );
+        }
+    }
+
+    return DRILL_PATH_OPTIMIZER::PathLength( m_offset, positions );
+}
+
+
 std::vector<DRILL_LAYER_PAIR> GENDRILL_WRITER_BASE::getUniqueLayerPairs() const
 {
     wxASSERT( m_pcb );
@@ -177,6 +177,14 @@ public:
      */
     void SetMergeOption( bool aMerge ) { m_merge_PTH_NPTH = aMerge; }
 
+    /**
+     * Set the option to reorder the holes of each tool to shorten the drilling machine travel.
+     *
+     * Without it, the holes of each tool are sorted by X then Y position.  Either way the
+     * order only depends on the board.
+     */
+    void SetDrillPathOptimization( bool aOptimize ) { m_optimizeDrillPath = aOptimize; }
+
     /**
      * Return the plot offset (usually the position of the auxiliary axis.
      */
@@ -294,6 +302,26 @@ protected:
 
     int  getHolesCount() const { return m_holeListBuffer.size(); }
 
+    /**
+     * Reorder the holes of each tool, round and oblong holes apart, to shorten the travel
+     * between them, starting from the drill origin.
+     *
+     * Tools are processed in parallel.  The travel before and after is reported to
+     * @a aReporter.
+     *
+     * @param aOblongHolesLast is true if the file lists all round holes before the oblong
+     *                         ones, false if it lists the holes in hole list order.
+     * @param aReporter is a REPORTER to return the travel distances (can be NULL).
+     */
+    void optimizeDrillPath( bool aOblongHolesLast, REPORTER* aReporter );
+
+    /**
+     * @param aOblongHolesLast is true if the file lists all round holes before the oblong ones.
+     * @return the distance travelled by the drill from the drill origin through all holes,
+     *         in the order of the file.
+     */
+    double drillPathLength( bool aOblongHolesLast ) const;
+
     /**
      * Write the drill marks in HPGL, POSTSCRIPT or other supported formats/
      *
@@ -368,6 +396,7 @@ protected:
         m_mapFileFmt      = PLOT_FORMAT::PDF;
         m_pageInfo        = nullptr;
         m_merge_PTH_NPTH  = false;
+        m_optimizeDrillPath = false;
         m_zeroFormat      = DECIMAL_FORMAT;
     }
 
@@ -382,6 +411,8 @@ protected:
                                                         // inches or mm)
     wxPoint                  m_offset;                  // Drill offset coordinates
     bool                     m_merge_PTH_NPTH;          // True to generate only one drill file
+    bool                     m_optimizeDrillPath;       // True to reorder holes to shorten the
+                                                        // drill travel
     std::vector<HOLE_INFO>   m_holeListBuffer;          // Buffer containing holes
     std::vector<DRILL_TOOL>  m_toolListBuffer;          // Buffer containing tools
 
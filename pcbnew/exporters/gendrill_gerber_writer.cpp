@@ -95,6 +95,9 @@ void GERBER_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory, b
             {
                 wxString fullFilename = fn.GetFullPath();
 
+                if( m_optimizeDrillPath )
+                    optimizeDrillPath( false, aReporter );
+
                 int result = createDrillFile( fullFilename, doing_npth, pair );
 
                 if( result < 0 )
@@ -29,6 +29,10 @@
 #include <pcb_shape.h>
 #include <fp_shape.h>
 #include <graphics_cleaner.h>
+#include <hash_eda.h>
+#include <core/wx_stl_compat.h>
+
+#include <unordered_map>
 
 
 GRAPHICS_CLEANER::GRAPHICS_CLEANER( DRAWINGS& aDrawings, FOOTPRINT* aParentFootprint,
@@ -95,51 +99,58 @@ bool GRAPHICS_CLEANER::isNullSegment( PCB_SHAPE* aSegment )
 }
 
 
-bool GRAPHICS_CLEANER::areEquivalent( PCB_SHAPE* aShape1, PCB_SHAPE* aShape2 )
+void GRAPHICS_CLEANER::cleanupSegments()
 {
-    if( aShape1->GetShape() != aShape2->GetShape()
-            || aShape1->GetLayer() != aShape2->GetLayer()
-            || aShape1->GetWidth() != aShape2->GetWidth() )
+    // Two segments are equivalent exactly when they share a layer, a width, a start and an
+    // end, so bucket the segments on those and only compare within a bucket rather than
+    // comparing every segment against every later drawing.
+    struct SEGMENT_KEY
     {
-        return false;
-    }
+        PCB_LAYER_ID layer;
+        int          width;
+        wxPoint      start;
+        wxPoint      end;
+
+        bool operator==( const SEGMENT_KEY& aOther ) const
+        {
+            return layer == aOther.layer && width == aOther.width && start == aOther.start
+                    && end == aOther.end;
+        }
+    };
 
-    switch( aShape1->GetShape() )
+    struct SEGMENT_KEY_HASH
     {
-    case PCB_SHAPE_TYPE::SEGMENT:
-    case PCB_SHAPE_TYPE::RECT:
-    case PCB_SHAPE_TYPE::CIRCLE:
-        return aShape1->GetStart() == aShape2->GetStart()
-                && aShape1->GetEnd() == aShape2->GetEnd();
+        std::size_t operator()( const SEGMENT_KEY& aKey ) const
+        {
+            return hash_val( static_cast<int>( aKey.layer ), aKey.width, aKey.start, aKey.end );
+        }
+    };
 
-    case PCB_SHAPE_TYPE::ARC:
-        return aShape1->GetCenter() == aShape2->GetCenter()
-                && aShape1->GetArcStart() == aShape2->GetArcStart()
-                && aShape1->GetAngle() == aShape2->GetAngle();
+    auto keyOf =
+            []( PCB_SHAPE* aSegment ) -> SEGMENT_KEY
+            {
+                return { aSegment->GetLayer(), aSegment->GetWidth(), aSegment->GetStart(),
+                         aSegment->GetEnd() };
+            };
 
-    case PCB_SHAPE_TYPE::POLYGON:
-        // TODO
-        return false;
+    // Buckets hold their segments in drawing order
+    std::unordered_map<SEGMENT_KEY, std::vector<PCB_SHAPE*>, SEGMENT_KEY_HASH> buckets;
 
-    case PCB_SHAPE_TYPE::CURVE:
-        return aShape1->GetBezControl1() == aShape2->GetBezControl1()
-                && aShape1->GetBezControl2() == aShape2->GetBezControl2()
-                && aShape1->GetBezierPoints() == aShape2->GetBezierPoints();
+    for( BOARD_ITEM* drawing : m_drawings )
+    {
+        PCB_SHAPE* segment = dynamic_cast<PCB_SHAPE*>( drawing );
 
-    default:
-        wxFAIL_MSG( "GRAPHICS_CLEANER::areEquivalent unsupported PCB_SHAPE shape: "
-                    + PCB_SHAPE_TYPE_T_asString( aShape1->GetShape() ) );
-        return false;
+        if( segment && segment->GetShape() == PCB_SHAPE_TYPE::SEGMENT
+                && !isNullSegment( segment ) )
+        {
+            buckets[ keyOf( segment ) ].push_back( segment );
+        }
     }
-}
-
 
-void GRAPHICS_CLEANER::cleanupSegments()
-{
     // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_drawings.begin(); it != m_drawings.end(); it++ )
+    for( BOARD_ITEM* drawing : m_drawings )
     {
-        PCB_SHAPE* segment = dynamic_cast<PCB_SHAPE*>( *it );
+        PCB_SHAPE* segment = dynamic_cast<PCB_SHAPE*>( drawing );
 
         if( !segment || segment->GetShape() != PCB_SHAPE_TYPE::SEGMENT
             || segment->HasFlag( IS_DELETED ) )
@@ -157,25 +168,26 @@ void GRAPHICS_CLEANER::cleanupSegments()
             continue;
         }
 
-        for( auto it2 = it + 1; it2 != m_drawings.end(); it2++ )
-        {
-            PCB_SHAPE* segment2 = dynamic_cast<PCB_SHAPE*>( *it2 );
+        // The first surviving segment of a bucket is necessarily its first segment, and all
+        // the others follow it in drawing order.
+        std::vector<PCB_SHAPE*>& bucket = buckets[ keyOf( segment ) ];
 
-            if( !segment2 || segment2->HasFlag( IS_DELETED ) )
+        for( PCB_SHAPE* segment2 : bucket )
+        {
+            if( segment2 == segment || segment2->HasFlag( IS_DELETED ) )
                 continue;
 
-            if( areEquivalent( segment, segment2 ) )
-            {
-                std::shared_ptr<CLEANUP_ITEM> item = std::make_shared<CLEANUP_ITEM>( CLEANUP_DUPLICATE_GRAPHIC );
-                item->SetItems( segment2 );
-                m_itemsList->push_back( item );
+            std::shared_ptr<CLEANUP_ITEM> item = std::make_shared<CLEANUP_ITEM>( CLEANUP_DUPLICATE_GRAPHIC );
+            item->SetItems( segment2 );
+            m_itemsList->push_back( item );
 
-                segment2->SetFlags( IS_DELETED );
+            segment2->SetFlags( IS_DELETED );
 
-                if( !m_dryRun )
-                    m_commit.Removed( segment2 );
-            }
+            if( !m_dryRun )
+                m_commit.Removed( segment2 );
         }
+
+        bucket.clear();
     }
 }
 
@@ -47,7 +47,6 @@ public:
 
 private:
     bool isNullSegment( PCB_SHAPE* aShape );
-    bool areEquivalent( PCB_SHAPE* aShape1, PCB_SHAPE* aShape2 );
 
     void cleanupSegments();
     void mergeRects();
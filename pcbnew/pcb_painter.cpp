@@ -1703,7 +1703,19 @@ void PCB_PAINTER::draw( const ZONE* aZone, int aLayer )
             m_gal->SetIsStroke( true );
         }
 
-        m_gal->DrawPolygon( polySet );
+        // Cairo redraws the fill through each of its vertices on each repaint, so give it a
+        // version simplified to within half a pixel.  OpenGL caches the geometry it is given
+        // for all zoom levels, so it needs the full resolution fill.
+        if( m_gal->IsCairoEngine() )
+        {
+            int maxError = KiROUND( 0.5 / m_gal->GetWorldScale() );
+
+            m_gal->DrawPolygon( aZone->GetFilledPolysLOD( layer, maxError ) );
+        }
+        else
+        {
+            m_gal->DrawPolygon( polySet );
+        }
     }
 }
 
@@ -37,6 +37,7 @@
 
 #include <board.h>
 #include <board_design_settings.h>
+#include <board_outline.h>
 #include <core/arraydim.h>
 #include <footprint.h>
 #include <pcb_track.h>
@@ -805,11 +806,9 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
 {
     int             maxError = aBoard->GetDesignSettings().m_MaxError;
     PCB_LAYER_ID    layer = aLayerMask[B_Mask] ? B_Mask : F_Mask;
-    SHAPE_POLY_SET  buffer;
-    SHAPE_POLY_SET* boardOutline = nullptr;
 
-    if( aBoard->GetBoardPolygonOutlines( buffer ) )
-        boardOutline = &buffer;
+    std::shared_ptr<const BOARD_OUTLINE> outline = aBoard->GetBoardOutline();
+    const SHAPE_POLY_SET*                boardOutline = outline ? &outline->Polygons() : nullptr;
 
     // We remove 1nm as we expand both sides of the shapes, so allowing for
     // a strictly greater than or equal comparison in the shape separation (boolean add)
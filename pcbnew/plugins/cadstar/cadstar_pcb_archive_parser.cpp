@@ -31,81 +31,104 @@
 
 void CADSTAR_PCB_ARCHIVE_PARSER::Parse()
 {
-    XNODE* fileRootNode = LoadArchiveFile( Filename, wxT( "CADSTARPCB" ) );
+    bool sectionsFound = false;
+
+    // Sections are parsed as soon as they have been read.  The library, parts and layout hold
+    // nearly all of a design, so each of their elements is parsed (and freed) as soon as it has
+    // been read, and the whole file is never held in memory at once.
+    XNODE* fileRootNode = LoadArchiveFile( Filename, wxT( "CADSTARPCB" ),
+            { wxT( "LIBRARY" ), wxT( "PARTS" ), wxT( "LAYOUT" ) },
+            [&]( XNODE* aNode ) -> bool
+            {
+                XNODE* parent = aNode->GetParent();
+
+                if( parent->GetParent() )
+                {
+                    // An element of a streamed section: the elements read before it have been
+                    // freed so the section can be parsed with just this one.
+                    parseSection( parent );
+                }
+                else
+                {
+                    sectionsFound = true;
+                    parseSection( aNode );
+                }
 
-    XNODE* cNode = fileRootNode->GetChildren();
+                return true;
+            } );
 
-    if( !cNode )
+    delete fileRootNode;
+
+    if( !sectionsFound )
         THROW_MISSING_NODE_IO_ERROR( wxT( "HEADER" ), wxT( "CADSTARPCB" ) );
+}
 
-    for( ; cNode; cNode = cNode->GetNext() )
+
+void CADSTAR_PCB_ARCHIVE_PARSER::parseSection( XNODE* aSection )
+{
+    if( aSection->GetName() == wxT( "HEADER" ) )
     {
-        if( cNode->GetName() == wxT( "HEADER" ) )
+        Header.Parse( aSection, &m_context );
+
+        switch( Header.Resolution )
         {
-            Header.Parse( cNode, &m_context );
+        case RESOLUTION::HUNDREDTH_MICRON:
+            KiCadUnitMultiplier = PCB_IU_PER_MM / 1e5;
+            break;
 
-            switch( Header.Resolution )
-            {
-            case RESOLUTION::HUNDREDTH_MICRON:
-                KiCadUnitMultiplier = PCB_IU_PER_MM / 1e5;
-                break;
+        default:
+            wxASSERT_MSG( true, wxT( "Unknown File Resolution" ) );
+            break;
+        }
 
-            default:
-                wxASSERT_MSG( true, wxT( "Unknown File Resolution" ) );
-                break;
+        if( Header.Format.Type != wxT( "LAYOUT" ) )
+        {
+            if( Header.Format.Type == wxT( "LIBRARY" ) )
+            {
+                THROW_IO_ERROR(
+                        "The selected file is a CADSTAR Library file (as opposed to a Layout "
+                        "file). CADSTAR libraries cannot yet be imported into KiCad." );
             }
-
-            if( Header.Format.Type != wxT( "LAYOUT" ) )
+            else
             {
-                if( Header.Format.Type == wxT( "LIBRARY" ) )
-                {
-                    THROW_IO_ERROR(
-                            "The selected file is a CADSTAR Library file (as opposed to a Layout "
-                            "file). CADSTAR libraries cannot yet be imported into KiCad." );
-                }
-                else
-                {
-                    THROW_IO_ERROR(
-                            "The selected file is an unknown CADSTAR format so cannot be "
-                            "imported into KiCad." );
-                }
+                THROW_IO_ERROR(
+                        "The selected file is an unknown CADSTAR format so cannot be "
+                        "imported into KiCad." );
             }
         }
-        else if( cNode->GetName() == wxT( "ASSIGNMENTS" ) )
-        {
-            Assignments.Parse( cNode, &m_context );
-        }
-        else if( cNode->GetName() == wxT( "LIBRARY" ) )
-        {
-            Library.Parse( cNode, &m_context );
-        }
-        else if( cNode->GetName() == wxT( "DEFAULTS" ) )
-        {
-            // No design information here (no need to parse)
-            // Only contains CADSTAR configuration data such as default shapes, text and units
-            // In future some of this could be converted to KiCad but limited value
-        }
-        else if( cNode->GetName() == wxT( "PARTS" ) )
-        {
-            Parts.Parse( cNode, &m_context );
-        }
-        else if( cNode->GetName() == wxT( "LAYOUT" ) )
-        {
-            Layout.Parse( cNode, &m_context );
-        }
-        else if( cNode->GetName() == wxT( "DISPLAY" ) )
-        {
-            // No design information here (no need to parse)
-            // Contains CADSTAR Display settings such as layer/element colours and visibility.
-            // In the future these settings could be converted to KiCad
-        }
-        else
-        {
-            THROW_UNKNOWN_NODE_IO_ERROR( cNode->GetName(), wxT( "[root]" ) );
-        }
     }
-
-    delete fileRootNode;
+    else if( aSection->GetName() == wxT( "ASSIGNMENTS" ) )
+    {
+        Assignments.Parse( aSection, &m_context );
+    }
+    else if( aSection->GetName() == wxT( "LIBRARY" ) )
+    {
+        Library.Parse( aSection, &m_context );
+    }
+    else if( aSection->GetName() == wxT( "DEFAULTS" ) )
+    {
+        // No design information here (no need to parse)
+        // Only contains CADSTAR configuration data such as default shapes, text and units
+        // In future some of this could be converted to KiCad but limited value
+    }
+    else if( aSection->GetName() == wxT( "PARTS" ) )
+    {
+        Parts.Parse( aSection, &m_context );
+    }
+    else if( aSection->GetName() == wxT( "LAYOUT" ) )
+    {
+        Layout.Parse( aSection, &m_context );
+    }
+    else if( aSection->GetName() == wxT( "DISPLAY" ) )
+    {
+        // No design information here (no need to parse)
+        // Contains CADSTAR Display settings such as layer/element colours and visibility.
+        // In the future these settings could be converted to KiCad
+    }
+    else
+    {
+        THROW_UNKNOWN_NODE_IO_ERROR( aSection->GetName(), wxT( "[root]" ) );
+    }
 }
 
 
@@ -2439,15 +2462,13 @@ void CADSTAR_PCB_ARCHIVE_PARSER::LAYOUT::Parse( XNODE* aNode, PARSER_CONTEXT* aC
 {
     wxASSERT( aNode->GetName() == wxT( "LAYOUT" ) );
 
-    XNODE* cNode            = aNode->GetChildren();
-    bool   netSynchParsed   = false;
-    bool   dimensionsParsed = false;
+    XNODE* cNode = aNode->GetChildren();
 
     for( ; cNode; cNode = cNode->GetNext() )
     {
         wxString cNodeName = cNode->GetName();
 
-        if( !netSynchParsed && cNodeName == wxT( "NETSYNCH" ) )
+        if( !m_netSynchParsed && cNodeName == wxT( "NETSYNCH" ) )
         {
             std::map<wxString, NETSYNCH> netSynchMap = { { wxT( "WARNING" ), NETSYNCH::WARNING },
                 { wxT( "FULL" ), NETSYNCH::FULL } };
@@ -2457,8 +2478,8 @@ void CADSTAR_PCB_ARCHIVE_PARSER::LAYOUT::Parse( XNODE* aNode, PARSER_CONTEXT* aC
             if( netSynchMap.find( nsString ) == netSynchMap.end() )
                 THROW_UNKNOWN_PARAMETER_IO_ERROR( nsString, aNode->GetName() );
 
-            NetSynch       = netSynchMap[nsString];
-            netSynchParsed = true;
+            NetSynch         = netSynchMap[nsString];
+            m_netSynchParsed = true;
         }
         else if( cNodeName == wxT( "GROUP" ) )
         {
@@ -2532,7 +2553,7 @@ void CADSTAR_PCB_ARCHIVE_PARSER::LAYOUT::Parse( XNODE* aNode, PARSER_CONTEXT* aC
             docsym.Parse( cNode, aContext );
             DocumentationSymbols.insert( std::make_pair( docsym.ID, docsym ) );
         }
-        else if( !dimensionsParsed && cNodeName == wxT( "DIMENSIONS" ) )
+        else if( !m_dimensionsParsed && cNodeName == wxT( "DIMENSIONS" ) )
         {
             XNODE* dimensionNode = cNode->GetChildren();
 
@@ -2550,7 +2571,7 @@ void CADSTAR_PCB_ARCHIVE_PARSER::LAYOUT::Parse( XNODE* aNode, PARSER_CONTEXT* aC
                 }
             }
 
-            dimensionsParsed = true;
+            m_dimensionsParsed = true;
         }
         else if( cNodeName == wxT( "DRILLTABLE" ) )
         {
@@ -1194,6 +1194,12 @@ public:
         VARIANT_HIERARCHY                                       VariantHierarchy;
 
         void Parse( XNODE* aNode, PARSER_CONTEXT* aContext ) override;
+
+    private:
+        /// The layout is streamed one element per call, so the sections which may only appear
+        /// once are remembered across the calls.
+        bool m_netSynchParsed   = false;
+        bool m_dimensionsParsed = false;
     };
 
 
@@ -1207,6 +1213,12 @@ public:
 
     int KiCadUnitMultiplier; ///<Use this value to convert units in this CPA file to KiCad units
 
+private:
+    /**
+     * Parse one of the top level sections of the file (HEADER, LAYOUT, etc).
+     */
+    void parseSection( XNODE* aSection );
+
 }; //CADSTAR_PCB_ARCHIVE_PARSER
 
 #endif // CADSTAR_PCB_ARCHIVE_PARSER_H_
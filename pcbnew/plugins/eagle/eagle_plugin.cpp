@@ -80,6 +80,7 @@ Load() TODO's
 #include <pcb_dimension.h>
 
 #include <plugins/eagle/eagle_plugin.h>
+#include <plugins/eagle/eagle_xml_reader.h>
 
 using namespace std;
 
@@ -333,24 +334,20 @@ BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
     try
     {
         wxFileName fn = aFileName;
-        // Load the document
-        wxFFileInputStream stream( fn.GetFullPath() );
-        wxXmlDocument xmlDocument;
 
-        if( !stream.IsOk() || !xmlDocument.Load( stream ) )
-        {
-            THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ),
-                                              fn.GetFullPath() ) );
-        }
+        // Read the document up to the signals, which are the bulk of a board and are then
+        // loaded one at a time rather than being held in memory all at once.
+        EAGLE_XML_READER reader( fn.GetFullPath() );
+        bool             streamSignals = reader.ReadUntil( wxT( "signals" ) );
 
-        doc = xmlDocument.GetRoot();
+        doc = reader.GetRoot();
 
         m_min_trace    = INT_MAX;
         m_min_hole     = INT_MAX;
         m_min_via      = INT_MAX;
         m_min_annulus  = INT_MAX;
 
-        loadAllSections( doc );
+        loadAllSections( doc, streamSignals ? &reader : nullptr );
 
         BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
 
@@ -450,7 +447,7 @@ void EAGLE_PLUGIN::clear_cu_map()
 }
 
 
-void EAGLE_PLUGIN::loadAllSections( wxXmlNode* aDoc )
+void EAGLE_PLUGIN::loadAllSections( wxXmlNode* aDoc, EAGLE_XML_READER* aReader )
 {
     wxXmlNode* drawing       = MapChildren( aDoc )["drawing"];
     NODE_MAP drawingChildren = MapChildren( drawing );
@@ -486,7 +483,14 @@ void EAGLE_PLUGIN::loadAllSections( wxXmlNode* aDoc )
         loadPlain( plain );
 
         wxXmlNode*  signals = boardChildren["signals"];
-        loadSignals( signals );
+        loadSignals( signals, aReader );
+
+        if( aReader )
+        {
+            // Whatever follows the signals has not been read yet
+            aReader->ReadToEnd();
+            boardChildren = MapChildren( board );
+        }
 
         wxXmlNode*  libs = boardChildren["libraries"];
         loadLibraries( libs );
@@ -2291,7 +2295,7 @@ void EAGLE_PLUGIN::deleteTemplates()
 }
 
 
-void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
+void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals, EAGLE_XML_READER* aReader )
 {
     ZONES zones;      // per net
 
@@ -2299,8 +2303,19 @@ void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
 
     int netCode = 1;
 
-    // Get the first signal and iterate
-    wxXmlNode* net = aSignals->GetChildren();
+    // Get the first signal and iterate.  A streamed signal is freed when the next one is read.
+    std::unique_ptr<wxXmlNode> streamedNet;
+    wxXmlNode*                 net = nullptr;
+
+    if( aReader )
+    {
+        streamedNet = aReader->ReadChild();
+        net = streamedNet.get();
+    }
+    else if( aSignals )
+    {
+        net = aSignals->GetChildren();
+    }
 
     while( net )
     {
@@ -2517,7 +2532,15 @@ void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
             netCode++;
 
         // Get next signal
-        net = net->GetNext();
+        if( aReader )
+        {
+            streamedNet = aReader->ReadChild();
+            net = streamedNet.get();
+        }
+        else
+        {
+            net = net->GetNext();
+        }
     }
 
     m_xpath->pop();     // "signals.signal"
@@ -38,6 +38,7 @@
 class PAD;
 class FP_TEXT;
 class ZONE;
+class EAGLE_XML_READER;
 
 typedef std::map<wxString, FOOTPRINT*> FOOTPRINT_MAP;
 typedef std::vector<ZONE*>             ZONES;
@@ -211,11 +212,23 @@ private:
 
     // all these loadXXX() throw IO_ERROR or ptree_error exceptions:
 
-    void loadAllSections( wxXmlNode* aDocument );
+    /**
+     * @param aReader if not null, is reading the document and stopped at the start of the
+     *                "signals" element, whose children are then streamed from it.
+     */
+    void loadAllSections( wxXmlNode* aDocument, EAGLE_XML_READER* aReader = nullptr );
     void loadDesignRules( wxXmlNode* aDesignRules );
     void loadLayerDefs( wxXmlNode* aLayers );
     void loadPlain( wxXmlNode* aPlain );
-    void loadSignals( wxXmlNode* aSignals );
+
+    /**
+     * Load the nets and their copper.
+     *
+     * @param aSignals is the "signals" element.
+     * @param aReader if not null, the signals are read one at a time from it rather than from
+     *                the children of @a aSignals, and each is freed once loaded.
+     */
+    void loadSignals( wxXmlNode* aSignals, EAGLE_XML_READER* aReader = nullptr );
 
     /**
      * Load the Eagle "library" XML element, which can occur either under a "libraries"
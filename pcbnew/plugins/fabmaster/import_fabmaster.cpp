@@ -27,12 +27,17 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <string>
 #include <sstream>
+#include <thread>
 #include <vector>
 #include <utility>
 
@@ -58,76 +63,122 @@
 #include <wx/filename.h>
 
 
-double FABMASTER::readDouble( const std::string aStr ) const
+double FABMASTER::readDouble( const std::string& aStr ) const
 {
-    std::istringstream istr( aStr );
-    istr.imbue( std::locale::classic() );
+    // Allegro writes plain decimals, which are read here without the cost of a stream.  As long
+    // as the digits fit in the mantissa, a single division by an exact power of ten rounds the
+    // same way a full conversion does.
+    static const double pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
 
-    double doubleValue;
-    istr >> doubleValue;
-    return doubleValue;
-}
+    const char* ch = aStr.c_str();
+    bool        negative = *ch == '-';
 
+    if( *ch == '-' || *ch == '+' )
+        ++ch;
 
-int FABMASTER::readInt( const std::string aStr ) const
-{
+    uint64_t mantissa = 0;
+    int      digits = 0;
+    int      decimals = 0;
+    bool     point = false;
+
+    for( ; digits <= 15; ++ch )
+    {
+        if( *ch >= '0' && *ch <= '9' )
+        {
+            mantissa = mantissa * 10 + ( *ch - '0' );
+            digits++;
+
+            if( point )
+                decimals++;
+        }
+        else if( *ch == '.' && !point )
+        {
+            point = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if( *ch == '\0' && digits > 0 && digits <= 15 )
+    {
+        double value = mantissa / pow10[decimals];
+        return negative ? -value : value;
+    }
+
+    // Anything else, such as exponents or surrounding text, goes the long way
     std::istringstream istr( aStr );
     istr.imbue( std::locale::classic() );
 
-    int intValue;
-    istr >> intValue;
-    return intValue;
+    double doubleValue = 0.0;
+    istr >> doubleValue;
+    return doubleValue;
 }
 
 
-bool FABMASTER::Read( const std::string& aFile )
+int FABMASTER::readInt( const std::string& aStr ) const
 {
+    const char* ch = aStr.c_str();
+    bool        negative = *ch == '-';
 
-    std::ifstream ifs( aFile, std::ios::in | std::ios::binary );
+    if( *ch == '-' || *ch == '+' )
+        ++ch;
 
-    if( !ifs.is_open() )
-        return false;
+    const char* digit = ch;
+    int         value = 0;
 
-    m_filename = aFile;
+    // Nine digits cannot overflow
+    while( *digit >= '0' && *digit <= '9' && digit - ch < 9 )
+        value = value * 10 + ( *digit++ - '0' );
 
-    // Read/ignore all bytes in the file to find the size and then go back to the beginning
-    ifs.ignore( std::numeric_limits<std::streamsize>::max() );
-    std::streamsize length = ifs.gcount();
-    ifs.clear();
-    ifs.seekg( 0, std::ios_base::beg );
+    if( *digit == '\0' && digit != ch )
+        return negative ? -value : value;
 
-    std::string buffer( std::istreambuf_iterator<char>{ ifs }, {} );
+    std::istringstream istr( aStr );
+    istr.imbue( std::locale::classic() );
 
-    std::vector < std::string > row;
+    int intValue = 0;
+    istr >> intValue;
+    return intValue;
+}
 
-    // Reserve an estimate of the number of rows to prevent continual re-allocation
-    // crashing (Looking at you MSVC)
-    row.reserve( length / 100 );
-    std::string cell;
-    cell.reserve( 100 );
 
-    bool quoted = false;
+/**
+ * Split the lines from @a aBegin to @a aEnd into rows of cells, appending them to @a aRows.
+ *
+ * Cells are separated by '!', except within quotes, and are upper-cased.  Each cell is built
+ * once from its span of the buffer, and is short enough to not need an allocation of its own
+ * in most cases.
+ */
+static void tokenizeRows( const char* aBegin, const char* aEnd,
+                          std::deque<FABMASTER::single_row>& aRows )
+{
+    FABMASTER::single_row row;
+    std::string           cell;
+    bool                  quoted = false;
 
-    for( auto ch : buffer )
+    for( const char* ch = aBegin; ch < aEnd; ++ch )
     {
-        switch( ch )
+        switch( *ch )
         {
         case  '"':
 
             if( cell.empty() || cell[0] == '"' )
                 quoted = !quoted;
 
-            cell += ch;
+            cell += *ch;
             break;
 
         case '!':
             if( !quoted )
             {
-                row.push_back( cell );
+                row.push_back( std::move( cell ) );
                 cell.clear();
             }
             else
-                cell += ch;
+                cell += *ch;
 
             break;
 
@@ -135,11 +186,14 @@ bool FABMASTER::Read( const std::string& aFile )
 
             /// Rows end with "!" and we don't want to keep the empty cell
             if( !cell.empty() )
-                row.push_back( cell );
+                row.push_back( std::move( cell ) );
 
             cell.clear();
-            rows.push_back( row );
-            row.clear();
+
+            // The next row is most likely as wide as this one
+            aRows.emplace_back();
+            aRows.back().reserve( row.size() );
+            aRows.back().swap( row );
             quoted = false;
             break;
 
@@ -147,38 +201,115 @@ bool FABMASTER::Read( const std::string& aFile )
             break;
 
         default:
-            cell += std::toupper( ch );
+        {
+            // Take the whole run of plain characters at once
+            const char* runEnd = ch + 1;
+
+            while( runEnd < aEnd && *runEnd != '"' && *runEnd != '!' && *runEnd != '\n'
+                   && *runEnd != '\r' )
+            {
+                ++runEnd;
+            }
+
+            size_t runStart = cell.size();
+
+            cell.append( ch, runEnd );
+
+            for( size_t ii = runStart; ii < cell.size(); ++ii )
+                cell[ii] = std::toupper( (unsigned char) cell[ii] );
+
+            ch = runEnd - 1;
+        }
         }
     }
 
     // Handle last line without linebreak
     if( !cell.empty() || !row.empty() )
     {
-        row.push_back( cell );
-        cell.clear();
-        rows.push_back( row );
-        row.clear();
+        row.push_back( std::move( cell ) );
+        aRows.push_back( std::move( row ) );
     }
-
-    return true;
 }
 
-FABMASTER::section_type FABMASTER::detectType( size_t aOffset )
+
+bool FABMASTER::Read( const std::string& aFile )
 {
-    single_row row;
-    try
+
+    std::ifstream ifs( aFile, std::ios::in | std::ios::binary );
+
+    if( !ifs.is_open() )
+        return false;
+
+    m_filename = aFile;
+
+    // Read the whole file in one go
+    ifs.seekg( 0, std::ios_base::end );
+    std::streamoff length = ifs.tellg();
+    ifs.seekg( 0, std::ios_base::beg );
+
+    if( length < 0 )
+        return false;
+
+    std::vector<char> buffer( length );
+
+    if( length > 0 && !ifs.read( buffer.data(), length ) )
+        return false;
+
+    // Lines are independent of each other, so large files are split at line ends into chunks
+    // of a megabyte or more which are tokenized in parallel
+    const size_t minChunk = 1 << 20;
+    size_t       chunks = std::min<size_t>( std::max( 1u, std::thread::hardware_concurrency() ),
+                                            buffer.size() / minChunk + 1 );
+
+    const char*              begin = buffer.data();
+    const char*              end = begin + buffer.size();
+    std::vector<const char*> bounds = { begin };
+
+    for( size_t ii = 1; ii < chunks; ++ii )
     {
-        row = rows.at( aOffset );
+        const char* bound = std::max( bounds.back(), begin + buffer.size() * ii / chunks );
+        const char* lineEnd = static_cast<const char*>( memchr( bound, '\n', end - bound ) );
+
+        if( !lineEnd )
+            break;
+
+        bounds.push_back( lineEnd + 1 );
     }
-    catch( std::out_of_range& )
+
+    bounds.push_back( end );
+
+    std::vector<std::deque<single_row>> chunkRows( bounds.size() - 1 );
+    std::vector<std::future<void>>      returns;
+
+    for( size_t ii = 1; ii < chunkRows.size(); ++ii )
     {
-        return UNKNOWN_EXTRACT;
+        returns.push_back( std::async( std::launch::async, tokenizeRows, bounds[ii],
+                                       bounds[ii + 1], std::ref( chunkRows[ii] ) ) );
+    }
+
+    tokenizeRows( bounds[0], bounds[1], rows );
+
+    for( size_t ii = 1; ii < chunkRows.size(); ++ii )
+    {
+        returns[ii - 1].get();
+        std::move( chunkRows[ii].begin(), chunkRows[ii].end(), std::back_inserter( rows ) );
+        chunkRows[ii].clear();
     }
 
+    return true;
+}
+
+FABMASTER::section_type FABMASTER::detectType( size_t aOffset )
+{
+    if( aOffset >= rows.size() )
+        return UNKNOWN_EXTRACT;
+
+    const single_row& row = rows[aOffset];
+
     if( row.size() < 3 )
         return UNKNOWN_EXTRACT;
 
-    if( row[0].back() != 'A' )
+    if( row[0].empty() || row[0].back() != 'A' )
         return UNKNOWN_EXTRACT;
 
     std::string row1 = row[1];
@@ -344,18 +475,18 @@ size_t FABMASTER::processPadStackLayers( size_t aRow )
             continue;
         }
 
-        auto pad_name = row[pad_name_col];
-        auto pad_num = row[pad_num_col];
-        auto pad_layer = row[pad_lay_col];
-        auto pad_is_fixed = row[pad_fix_col];
-        auto pad_is_via = row[pad_via_col];
-        auto pad_shape = row[pad_shape_col];
-        auto pad_width = row[pad_width_col];
-        auto pad_height = row[pad_height_col];
-        auto pad_xoff = row[pad_xoff_col];
-        auto pad_yoff = row[pad_yoff_col];
-        auto pad_flash = row[pad_flash_col];
-        auto pad_shapename = row[pad_shape_name_col];
+        const auto& pad_name = row[pad_name_col];
+        const auto& pad_num = row[pad_num_col];
+        const auto& pad_layer = row[pad_lay_col];
+        const auto& pad_is_fixed = row[pad_fix_col];
+        const auto& pad_is_via = row[pad_via_col];
+        const auto& pad_shape = row[pad_shape_col];
+        const auto& pad_width = row[pad_width_col];
+        const auto& pad_height = row[pad_height_col];
+        const auto& pad_xoff = row[pad_xoff_col];
+        const auto& pad_yoff = row[pad_yoff_col];
+        const auto& pad_flash = row[pad_flash_col];
+        const auto& pad_shapename = row[pad_shape_name_col];
 
         // This layer setting seems to be unused
         if( pad_layer == "INTERNAL_PAD_DEF" || pad_layer == "internal_pad_def" )
@@ -425,18 +556,18 @@ size_t FABMASTER::processPadStacks( size_t aRow )
             continue;
         }
 
-        auto pad_name = row[pad_name_col];
-        auto pad_num = row[pad_num_col];
-        auto pad_layer = row[pad_lay_col];
-        auto pad_is_fixed = row[pad_fix_col];
-        auto pad_is_via = row[pad_via_col];
-        auto pad_shape = row[pad_shape_col];
-        auto pad_width = row[pad_width_col];
-        auto pad_height = row[pad_height_col];
-        auto pad_xoff = row[pad_xoff_col];
-        auto pad_yoff = row[pad_yoff_col];
-        auto pad_flash = row[pad_flash_col];
-        auto pad_shapename = row[pad_shape_name_col];
+        const auto& pad_name = row[pad_name_col];
+        const auto& pad_num = row[pad_num_col];
+        const auto& pad_layer = row[pad_lay_col];
+        const auto& pad_is_fixed = row[pad_fix_col];
+        const auto& pad_is_via = row[pad_via_col];
+        const auto& pad_shape = row[pad_shape_col];
+        const auto& pad_width = row[pad_width_col];
+        const auto& pad_height = row[pad_height_col];
+        const auto& pad_xoff = row[pad_xoff_col];
+        const auto& pad_yoff = row[pad_yoff_col];
+        const auto& pad_flash = row[pad_flash_col];
+        const auto& pad_shapename = row[pad_shape_name_col];
 
         // This layer setting seems to be unused
         if( pad_layer == "INTERNAL_PAD_DEF" || pad_layer == "internal_pad_def" )
@@ -804,14 +935,14 @@ size_t FABMASTER::processLayers( size_t aRow )
             continue;
         }
 
-        auto layer_sort = row[layer_sort_col];
-        auto layer_subclass = row[layer_subclass_col];
-        auto layer_art = row[layer_art_col];
-        auto layer_use = row[layer_use_col];
-        auto layer_cond = row[layer_cond_col];
-        auto layer_er = row[layer_er_col];
-        auto layer_rho = row[layer_rho_col];
-        auto layer_mat = row[layer_mat_col];
+        const auto& layer_sort = row[layer_sort_col];
+        const auto& layer_subclass = row[layer_subclass_col];
+        const auto& layer_art = row[layer_art_col];
+        const auto& layer_use = row[layer_use_col];
+        const auto& layer_cond = row[layer_cond_col];
+        const auto& layer_er = row[layer_er_col];
+        const auto& layer_rho = row[layer_rho_col];
+        const auto& layer_mat = row[layer_mat_col];
 
         if( layer_mat == "AIR" )
             continue;
@@ -1190,7 +1321,7 @@ size_t FABMASTER::processGeometry( size_t aRow )
             continue;
         }
 
-        auto geo_tag = row[geo_tag_col];
+        const auto& geo_tag = row[geo_tag_col];
 
         GRAPHIC_DATA gr_data;
         gr_data.graphic_dataname = row[geo_name_col];
@@ -1205,7 +1336,7 @@ size_t FABMASTER::processGeometry( size_t aRow )
         gr_data.graphic_data8 = row[geo_grdata8_col];
         gr_data.graphic_data9 = row[geo_grdata9_col];
 
-        auto geo_refdes = row[geo_refdes_col];
+        const auto& geo_refdes = row[geo_refdes_col];
 
         // Grouped graphics are a series of records with the same record ID but incrementing
         // Sequence numbers.
@@ -1698,106 +1829,88 @@ size_t FABMASTER::processNets( size_t aRow )
 }
 
 
-bool FABMASTER::Process()
+void FABMASTER::processSection( section_type aType, size_t aRow )
 {
+    switch( aType )
+    {
+    case EXTRACT_PADSTACKS:
+        /// We extract the basic layers from the padstacks first as this is the only place
+        /// the stackup is kept in the basic fabmaster export
+        processPadStackLayers( aRow );
+        assignLayers();
+        processPadStacks( aRow );
+        break;
+
+    case EXTRACT_FULL_LAYERS:  processLayers( aRow );       break;
+    case EXTRACT_BASIC_LAYERS: processSimpleLayers( aRow ); break;
+    case EXTRACT_VIAS:         processVias( aRow );         break;
+    case EXTRACT_TRACES:       processTraces( aRow );       break;
+    case EXTRACT_REFDES:       processFootprints( aRow );   break;
+    case EXTRACT_NETS:         processNets( aRow );         break;
+    case EXTRACT_GRAPHICS:     processGeometry( aRow );     break;
+    case EXTRACT_PINS:         processPins( aRow );         break;
+    case EXTRACT_PAD_SHAPES:   processCustomPads( aRow );   break;
+    default:                                                break;
+    }
+}
 
-    for( size_t i = 0; i < rows.size(); )
+
+bool FABMASTER::Process()
+{
+    // Vias, traces, footprints, nets, geometry and pins each fill containers of their own and
+    // only read the rows, so each of these kinds of section is processed on a thread of its own.
+    // Layers and pad stacks build on each other and are processed on this thread in file order.
+    std::map<section_type, std::vector<size_t>>  independent;
+    std::vector<std::pair<section_type, size_t>> dependent;
+
+    // Section headers are the only rows ending their first cell with 'A', so the data rows are
+    // quickly passed over
+    for( size_t i = 0; i < rows.size(); ++i )
     {
-        auto type = detectType( i );
+        section_type type = detectType( i );
 
         switch( type )
         {
         case EXTRACT_PADSTACKS:
-        {
-            /// We extract the basic layers from the padstacks first as this is the only place
-            /// the stackup is kept in the basic fabmaster export
-            processPadStackLayers( i );
-            assignLayers();
-            int retval = processPadStacks( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_FULL_LAYERS:
-        {
-            int retval = processLayers( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_BASIC_LAYERS:
-        {
-            int retval = processSimpleLayers( i );
-
-            i += std::max( retval, 1 );
+        case EXTRACT_PAD_SHAPES:
+            dependent.emplace_back( type, i );
             break;
-        }
 
         case EXTRACT_VIAS:
-        {
-            int retval = processVias( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_TRACES:
-        {
-            int retval = processTraces( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_REFDES:
-        {
-            int retval = processFootprints( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_NETS:
-        {
-            int retval = processNets( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_GRAPHICS:
-        {
-            int retval = processGeometry( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
-
         case EXTRACT_PINS:
-        {
-            int retval = processPins( i );
-
-            i += std::max( retval, 1 );
+            independent[type].push_back( i );
             break;
-        }
-
-        case EXTRACT_PAD_SHAPES:
-        {
-            int retval = processCustomPads( i );
-
-            i += std::max( retval, 1 );
-            break;
-        }
 
         default:
-            ++i;
             break;
         }
+    }
+
+    std::vector<std::future<void>> returns;
 
+    for( const auto& kind : independent )
+    {
+        returns.push_back( std::async( std::launch::async,
+                [this, &kind]()
+                {
+                    for( size_t row : kind.second )
+                        processSection( kind.first, row );
+                } ) );
     }
 
+    for( const auto& section : dependent )
+        processSection( section.first, section.second );
+
+    // Rethrows anything thrown while processing
+    for( std::future<void>& ret : returns )
+        ret.get();
+
     return true;
 }
 
@@ -522,6 +522,11 @@ private:
     size_t processSymbols( size_t aRow );
     size_t processPins( size_t aRow );
 
+    /**
+     * Process the section of type @a aType whose header is in row @a aRow.
+     */
+    void processSection( section_type aType, size_t aRow );
+
     /**
      * Specialty functions for processing graphical data rows into the internal
      * database
@@ -543,8 +548,8 @@ private:
      * @param aStr string to generate value from
      * @return 0 if value cannot be created
      */
-    double readDouble( const std::string aStr ) const;
-    int readInt( const std::string aStr ) const;
+    double readDouble( const std::string& aStr ) const;
+    int readInt( const std::string& aStr ) const;
 
     /**
      * Sets zone priorities based on zone BB size.  Larger bounding boxes get smaller priorities
@@ -22,6 +22,7 @@
 #include <board.h>
 #include <board_connected_item.h>
 #include <board_design_settings.h>
+#include <board_outline.h>
 #include <fp_text.h>
 #include <footprint.h>
 #include <pad.h>
@@ -1022,7 +1023,8 @@ std::unique_ptr<PNS::VIA> PNS_KICAD_IFACE_BASE::syncVia( PCB_VIA* aVia )
 }
 
 
-bool PNS_KICAD_IFACE_BASE::syncZone( PNS::NODE* aWorld, ZONE* aZone, SHAPE_POLY_SET* aBoardOutline )
+bool PNS_KICAD_IFACE_BASE::syncZone( PNS::NODE* aWorld, ZONE* aZone,
+                                     const SHAPE_POLY_SET* aBoardOutline )
 {
     SHAPE_POLY_SET* poly;
 
@@ -1293,11 +1295,8 @@ void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
         }
     }
 
-    SHAPE_POLY_SET  buffer;
-    SHAPE_POLY_SET* boardOutline = nullptr;
-
-    if( m_board->GetBoardPolygonOutlines( buffer ) )
-        boardOutline = &buffer;
+    std::shared_ptr<const BOARD_OUTLINE> outline = m_board->GetBoardOutline();
+    const SHAPE_POLY_SET*                boardOutline = outline ? &outline->Polygons() : nullptr;
 
     for( ZONE* zone : m_board->Zones() )
     {
@@ -886,10 +886,14 @@ int BOARD_INSPECTION_TOOL::HighlightItem( const TOOL_EVENT& aEvent )
         guide.SetPreferredLayer( activeLayer );
 
         // Find a connected item for which we are going to highlight a net
-        collector.Collect( board, GENERAL_COLLECTOR::PadsOrTracks, (wxPoint) aPosition, guide );
+        collector.Collect( board, GENERAL_COLLECTOR::PadsOrTracks, (wxPoint) aPosition, guide,
+                           view() );
 
         if( collector.GetCount() == 0 )
-            collector.Collect( board, GENERAL_COLLECTOR::Zones, (wxPoint) aPosition, guide );
+        {
+            collector.Collect( board, GENERAL_COLLECTOR::Zones, (wxPoint) aPosition, guide,
+                               view() );
+        }
 
         // Apply the active selection filter, except we want to allow picking locked items for
         // highlighting even if the user has disabled them for selection
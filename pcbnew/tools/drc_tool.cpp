@@ -22,6 +22,7 @@
  */
 
 #include <pcb_edit_frame.h>
+#include <advanced_config.h>
 #include <bitmaps.h>
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
@@ -29,11 +30,15 @@
 #include <tools/zone_filler_tool.h>
 #include <tools/drc_tool.h>
 #include <kiface_i.h>
+#include <project.h>
 #include <dialog_drc.h>
 #include <board_commit.h>
 #include <board_design_settings.h>
 #include <widgets/progress_reporter.h>
 #include <drc/drc_engine.h>
+#include <drc/drc_incremental.h>
+#include <drc/drc_profile.h>
+#include <drc/drc_result_cache.h>
 #include <drc/drc_results_provider.h>
 #include <netlist_reader/pcb_netlist.h>
 
@@ -61,9 +66,27 @@ void DRC_TOOL::Reset( RESET_REASON aReason )
         if( m_drcDialog )
             DestroyDRCDialog();
 
+        // The previous board has been deleted along with its listeners
+        m_incremental.reset();
+
+        // The board may be of another project
+        m_resultCache.reset();
+
         m_pcb = m_editFrame->GetBoard();
         m_drcEngine = m_pcb->GetDesignSettings().m_DRCEngine;
     }
+    else if( aReason == MODEL_RELOAD && m_incremental )
+    {
+        // The board is about to be replaced, or its rules have changed
+        m_pcb->RemoveListener( m_incremental.get() );
+        m_incremental.reset();
+    }
+
+    if( !m_incremental && m_pcb && ADVANCED_CFG::GetCfg().m_IncrementalDRC )
+    {
+        m_incremental = std::make_unique<DRC_INCREMENTAL>( m_pcb, m_drcEngine );
+        m_pcb->AddListener( m_incremental.get() );
+    }
 }
 
 
@@ -170,6 +193,26 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
 
     m_drcEngine->SetProgressReporter( aProgressReporter );
 
+    wxString resultCacheFile = m_editFrame->Prj().GetProjectPath() + "drc-cache";
+    bool     useResultCache = ADVANCED_CFG::GetCfg().m_DRCResultCache;
+
+    if( useResultCache )
+    {
+        if( !m_resultCache )
+        {
+            m_resultCache = std::make_unique<DRC_RESULT_CACHE>();
+            m_resultCache->Load( resultCacheFile );
+        }
+
+        m_drcEngine->SetResultCache( m_resultCache.get() );
+    }
+
+    DRC_PROFILE profile;
+    bool        useProfile = ADVANCED_CFG::GetCfg().m_DRCProfile;
+
+    if( useProfile )
+        m_drcEngine->SetProfile( &profile );
+
     m_drcEngine->SetViolationHandler(
             [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
             {
@@ -196,6 +239,27 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
     m_drcEngine->SetProgressReporter( nullptr );
     m_drcEngine->ClearViolationHandler();
 
+    if( useResultCache )
+    {
+        m_drcEngine->SetResultCache( nullptr );
+
+        aProgressReporter->Report( wxString::Format( _( "Reused %d cached checks, "
+                                                        "recomputed %d." ),
+                                                     m_resultCache->GetReusedCount(),
+                                                     m_resultCache->GetRecomputedCount() ) );
+
+        if( wxFileName::IsDirWritable( m_editFrame->Prj().GetProjectPath() ) )
+            m_resultCache->Save( resultCacheFile );
+    }
+
+    if( useProfile )
+    {
+        m_drcEngine->SetProfile( nullptr );
+
+        if( wxFileName::IsDirWritable( m_editFrame->Prj().GetProjectPath() ) )
+            profile.Save( m_editFrame->Prj().GetProjectPath() + "drc-profile.json" );
+    }
+
     if( m_drcDialog )
     {
         m_drcDialog->SetDrcRun();
@@ -210,6 +274,9 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
 
     // update the m_drcDialog listboxes
     updatePointers();
+
+    if( m_incremental )
+        m_incremental->Reset();
 }
 
 
@@ -274,12 +341,63 @@ int DRC_TOOL::ExcludeMarker( const TOOL_EVENT& aEvent )
 }
 
 
+int DRC_TOOL::UpdateIncrementalDRC( const TOOL_EVENT& aEvent )
+{
+    if( !m_incremental || m_drcRunning || !m_incremental->IsDirty() )
+        return 0;
+
+    std::vector<DRC_INCREMENTAL::VIOLATION> found;
+    std::vector<std::shared_ptr<DRC_ITEM>>  withdrawn;
+
+    m_incremental->Update( userUnits(), found, withdrawn );
+
+    if( found.empty() && withdrawn.empty() )
+        return 0;
+
+    BOARD_COMMIT       commit( m_editFrame );
+    std::set<wxString> excluded;
+
+    for( PCB_MARKER* marker : m_pcb->Markers() )
+    {
+        if( std::find( withdrawn.begin(), withdrawn.end(), marker->GetRCItem() )
+                != withdrawn.end() )
+        {
+            if( marker->IsExcluded() )
+                excluded.insert( marker->Serialize() );
+
+            commit.Remove( marker );
+        }
+    }
+
+    for( const DRC_INCREMENTAL::VIOLATION& violation : found )
+    {
+        PCB_MARKER* marker = new PCB_MARKER( violation.item, violation.position );
+
+        // A violation found again keeps its exclusion
+        if( excluded.count( marker->Serialize() ) )
+            marker->SetExcluded( true );
+
+        commit.Add( marker );
+    }
+
+    commit.Push( _( "DRC" ), false, false );
+
+    if( m_drcDialog )
+        m_drcDialog->SetMarkersProvider( new BOARD_DRC_ITEMS_PROVIDER( m_pcb ) );
+
+    return 0;
+}
+
+
 void DRC_TOOL::setTransitions()
 {
     Go( &DRC_TOOL::ShowDRCDialog,              PCB_ACTIONS::runDRC.MakeEvent() );
     Go( &DRC_TOOL::PrevMarker,                 ACTIONS::prevMarker.MakeEvent() );
     Go( &DRC_TOOL::NextMarker,                 ACTIONS::nextMarker.MakeEvent() );
     Go( &DRC_TOOL::ExcludeMarker,              ACTIONS::excludeMarker.MakeEvent() );
+
+    Go( &DRC_TOOL::UpdateIncrementalDRC, TOOL_EVENT( TC_MESSAGE, TA_MODEL_CHANGE, AS_GLOBAL ) );
+    Go( &DRC_TOOL::UpdateIncrementalDRC, TOOL_EVENT( TC_MESSAGE, TA_UNDO_REDO_POST, AS_GLOBAL ) );
 }
 
 
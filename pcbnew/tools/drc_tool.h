@@ -39,6 +39,8 @@ class DIALOG_DRC;
 class DRC_ITEM;
 class WX_PROGRESS_REPORTER;
 class DRC_ENGINE;
+class DRC_INCREMENTAL;
+class DRC_RESULT_CACHE;
 
 
 class DRC_TOOL : public PCB_TOOL_BASE
@@ -98,6 +100,11 @@ public:
     int NextMarker( const TOOL_EVENT& aEvent );
     int ExcludeMarker( const TOOL_EVENT& aEvent );
 
+    /**
+     * Check again the items changed by the last commit or undo, when incremental DRC is on.
+     */
+    int UpdateIncrementalDRC( const TOOL_EVENT& aEvent );
+
 private:
     ///< Set up handlers for various events.
     void setTransitions() override;
@@ -115,6 +122,8 @@ private:
     bool             m_drcRunning;
 
     std::shared_ptr<DRC_ENGINE>            m_drcEngine;
+    std::unique_ptr<DRC_INCREMENTAL>       m_incremental;
+    std::unique_ptr<DRC_RESULT_CACHE>      m_resultCache;      // loaded on the first run
 
     std::vector<std::shared_ptr<DRC_ITEM>> m_unconnected;      // list of unconnected pads
     std::vector<std::shared_ptr<DRC_ITEM>> m_footprints;       // list of footprint warnings
@@ -689,7 +689,7 @@ bool PCB_SELECTION_TOOL::selectPoint( const VECTOR2I& aWhere, bool aOnDrag,
 
     collector.Collect( board(), m_isFootprintEditor ? GENERAL_COLLECTOR::FootprintItems
                                                     : GENERAL_COLLECTOR::AllBoardItems,
-                       (wxPoint) aWhere, guide );
+                       (wxPoint) aWhere, guide, view() );
 
     // Remove unselectable items
     for( int i = collector.GetCount() - 1; i >= 0; --i )
@@ -2248,7 +2248,7 @@ bool PCB_SELECTION_TOOL::selectionContains( const VECTOR2I& aPoint ) const
 
     collector.Collect( board(), m_isFootprintEditor ? GENERAL_COLLECTOR::FootprintItems
                                                     : GENERAL_COLLECTOR::AllBoardItems,
-                       (wxPoint) aPoint, guide );
+                       (wxPoint) aPoint, guide, view() );
 
     for( int i = collector.GetCount() - 1; i >= 0; --i )
     {
@@ -0,0 +1,58 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <track_columns.h>
+
+#include <pcb_track.h>
+
+
+TRACK_COLUMNS::TRACK_COLUMNS( const TRACKS& aTracks )
+{
+    size_t count = aTracks.size();
+
+    m_items.reserve( count );
+    m_types.reserve( count );
+    m_layers.reserve( count );
+    m_starts.reserve( count );
+    m_ends.reserve( count );
+    m_mids.reserve( count );
+    m_widths.reserve( count );
+    m_netCodes.reserve( count );
+
+    for( PCB_TRACK* track : aTracks )
+    {
+        m_items.push_back( track );
+        m_types.push_back( track->Type() );
+        m_layers.push_back( track->GetLayerSet() );
+        m_starts.emplace_back( track->GetStart() );
+        m_ends.emplace_back( track->GetEnd() );
+
+        if( track->Type() == PCB_ARC_T )
+            m_mids.emplace_back( static_cast<PCB_ARC*>( track )->GetMid() );
+        else
+            m_mids.emplace_back( track->GetStart() );
+
+        m_widths.push_back( track->GetWidth() );
+        m_netCodes.push_back( track->GetNetCode() );
+    }
+}
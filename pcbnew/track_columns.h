@@ -0,0 +1,85 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef TRACK_COLUMNS_H
+#define TRACK_COLUMNS_H
+
+#include <vector>
+
+#include <core/typeinfo.h>
+#include <layers_id_colors_and_visibility.h>
+#include <math/vector2d.h>
+#include <pcb_item_containers.h>
+
+class PCB_TRACK;
+
+
+/**
+ * A read-only copy of the board tracks, stored column by column.
+ *
+ * Every track, arc and via is a separate heap object, so a loop over half a million of them
+ * spends most of its time waiting for memory.  Loops which only look at positions, widths,
+ * layers or nets can instead run over these contiguous columns, and only go to the track
+ * object (which remains the way to edit it) for the rows they are interested in.
+ *
+ * The columns are a snapshot: they don't follow later changes to the tracks.
+ */
+class TRACK_COLUMNS
+{
+public:
+    TRACK_COLUMNS( const TRACKS& aTracks );
+
+    size_t Size() const { return m_items.size(); }
+
+    PCB_TRACK* Item( size_t aRow ) const { return m_items[aRow]; }
+
+    /// @return PCB_TRACE_T, PCB_ARC_T or PCB_VIA_T.
+    KICAD_T Type( size_t aRow ) const { return m_types[aRow]; }
+
+    /// @return the layer of a track or arc, or all the layers spanned by a via.
+    const LSET& Layers( size_t aRow ) const { return m_layers[aRow]; }
+
+    const VECTOR2I& Start( size_t aRow ) const { return m_starts[aRow]; }
+
+    const VECTOR2I& End( size_t aRow ) const { return m_ends[aRow]; }
+
+    /// @return the mid point of an arc, or the start of anything else.
+    const VECTOR2I& Mid( size_t aRow ) const { return m_mids[aRow]; }
+
+    /// @return the width of a track or arc, or the diameter of a via.
+    int Width( size_t aRow ) const { return m_widths[aRow]; }
+
+    int NetCode( size_t aRow ) const { return m_netCodes[aRow]; }
+
+private:
+    std::vector<PCB_TRACK*> m_items;
+    std::vector<KICAD_T>    m_types;
+    std::vector<LSET>       m_layers;
+    std::vector<VECTOR2I>   m_starts;
+    std::vector<VECTOR2I>   m_ends;
+    std::vector<VECTOR2I>   m_mids;
+    std::vector<int>        m_widths;
+    std::vector<int>        m_netCodes;
+};
+
+#endif // TRACK_COLUMNS_H
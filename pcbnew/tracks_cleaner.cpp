@@ -31,8 +31,10 @@
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
 #include <tools/global_edit_tool.h>
-#include <drc/drc_rtree.h>
 #include <tracks_cleaner.h>
+#include <core/wx_stl_compat.h>
+
+#include <unordered_map>
 
 TRACKS_CLEANER::TRACKS_CLEANER( BOARD* aPcb, BOARD_COMMIT& aCommit ) :
         m_brd( aPcb ),
@@ -270,14 +272,29 @@ void TRACKS_CLEANER::deleteTracksInPads()
 void TRACKS_CLEANER::cleanup( bool aDeleteDuplicateVias, bool aDeleteNullSegments,
                               bool aDeleteDuplicateSegments, bool aMergeSegments )
 {
-    DRC_RTREE rtree;
+    // Duplicates share their end points, so index vias by position and tracks by start point
+    // rather than querying the bounding boxes of every track.  Indexes are in board order.
+    std::unordered_map<wxPoint, std::vector<PCB_VIA*>>   viasByPosition;
+    std::unordered_map<wxPoint, std::vector<PCB_TRACK*>> tracksByStart;
 
     for( PCB_TRACK* track : m_brd->Tracks() )
     {
         track->ClearFlags( IS_DELETED | SKIP_STRUCT );
-        rtree.Insert( track, track->GetLayer() );
+
+        if( track->Type() == PCB_VIA_T )
+            viasByPosition[ track->GetStart() ].push_back( static_cast<PCB_VIA*>( track ) );
+        else if( track->Type() == PCB_TRACE_T )
+            tracksByStart[ track->GetStart() ].push_back( track );
     }
 
+    auto isCandidate =
+            []( BOARD_ITEM* aRefItem, BOARD_ITEM* aItem ) -> bool
+            {
+                return aItem != aRefItem
+                          && !aItem->HasFlag( SKIP_STRUCT )
+                          && !aItem->HasFlag( IS_DELETED );
+            };
+
     std::set<BOARD_ITEM*> toRemove;
 
     for( PCB_TRACK* track : m_brd->Tracks() )
@@ -292,33 +309,28 @@ void TRACKS_CLEANER::cleanup( bool aDeleteDuplicateVias, bool aDeleteNullSegment
             if( via->GetStart() != via->GetEnd() )
                 via->SetEnd( via->GetStart() );
 
-            rtree.QueryColliding( via, via->GetLayer(), via->GetLayer(),
-                    // Filter:
-                    [&]( BOARD_ITEM* aItem ) -> bool
-                    {
-                        return aItem->Type() == PCB_VIA_T
-                                  && !aItem->HasFlag( SKIP_STRUCT )
-                                  && !aItem->HasFlag( IS_DELETED );
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* aItem ) -> bool
-                    {
-                        PCB_VIA* other = static_cast<PCB_VIA*>( aItem );
+            auto it = viasByPosition.find( via->GetPosition() );
 
-                        if( via->GetPosition() == other->GetPosition()
-                                && via->GetViaType() == other->GetViaType()
-                                && via->GetLayerSet() == other->GetLayerSet() )
-                        {
-                            auto item = std::make_shared<CLEANUP_ITEM>( CLEANUP_REDUNDANT_VIA );
-                            item->SetItems( via );
-                            m_itemsList->push_back( item );
+            if( it != viasByPosition.end() )
+            {
+                for( PCB_VIA* other : it->second )
+                {
+                    if( !isCandidate( via, other ) )
+                        continue;
 
-                            via->SetFlags( IS_DELETED );
-                            toRemove.insert( via );
-                        }
+                    if( via->GetLayer() == other->GetLayer()
+                            && via->GetViaType() == other->GetViaType()
+                            && via->GetLayerSet() == other->GetLayerSet() )
+                    {
+                        auto item = std::make_shared<CLEANUP_ITEM>( CLEANUP_REDUNDANT_VIA );
+                        item->SetItems( via );
+                        m_itemsList->push_back( item );
 
-                        return true;
-                    } );
+                        via->SetFlags( IS_DELETED );
+                        toRemove.insert( via );
+                    }
+                }
+            }
 
             // To delete through Via on THT pads at same location
             // Examine the list of connected pads: if a through pad is found, the via is redundant
@@ -356,34 +368,38 @@ void TRACKS_CLEANER::cleanup( bool aDeleteDuplicateVias, bool aDeleteNullSegment
 
         if( aDeleteDuplicateSegments && track->Type() == PCB_TRACE_T )
         {
-            rtree.QueryColliding( track, track->GetLayer(), track->GetLayer(),
-                    // Filter:
-                    [&]( BOARD_ITEM* aItem ) -> bool
+            // A duplicate starts on one of our ends (and ends on one of them too)
+            auto checkDuplicates =
+                    [&]( const wxPoint& aPoint )
                     {
-                        return aItem->Type() == PCB_TRACE_T
-                                  && !aItem->HasFlag( SKIP_STRUCT )
-                                  && !aItem->HasFlag( IS_DELETED );
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* aItem ) -> bool
-                    {
-                        PCB_TRACK* other = static_cast<PCB_TRACK*>( aItem );
+                        auto it = tracksByStart.find( aPoint );
+
+                        if( it == tracksByStart.end() )
+                            return;
 
-                        if( track->IsPointOnEnds( other->GetStart() )
-                                && track->IsPointOnEnds( other->GetEnd() )
-                                && track->GetWidth() == other->GetWidth()
-                                && track->GetLayer() == other->GetLayer() )
+                        for( PCB_TRACK* other : it->second )
                         {
-                            auto item = std::make_shared<CLEANUP_ITEM>( CLEANUP_DUPLICATE_TRACK );
-                            item->SetItems( track );
-                            m_itemsList->push_back( item );
+                            if( !isCandidate( track, other ) )
+                                continue;
 
-                            track->SetFlags( IS_DELETED );
-                            toRemove.insert( track );
+                            if( track->IsPointOnEnds( other->GetEnd() )
+                                    && track->GetWidth() == other->GetWidth()
+                                    && track->GetLayer() == other->GetLayer() )
+                            {
+                                auto item = std::make_shared<CLEANUP_ITEM>( CLEANUP_DUPLICATE_TRACK );
+                                item->SetItems( track );
+                                m_itemsList->push_back( item );
+
+                                track->SetFlags( IS_DELETED );
+                                toRemove.insert( track );
+                            }
                         }
+                    };
+
+            checkDuplicates( track->GetStart() );
 
-                        return true;
-                    } );
+            if( track->GetEnd() != track->GetStart() )
+                checkDuplicates( track->GetEnd() );
 
             track->SetFlags( SKIP_STRUCT );
         }
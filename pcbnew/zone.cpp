@@ -166,6 +166,8 @@ void ZONE::InitDataFromSrcInCopyCtor( const ZONE& aZone )
         m_insulatedIslands[layer] = aZone.m_insulatedIslands.at( layer );
     }
 
+    m_filledPolysLOD.clear();
+
     m_borderStyle             = aZone.m_borderStyle;
     m_borderHatchPitch        = aZone.m_borderHatchPitch;
     m_borderHatchLines        = aZone.m_borderHatchLines;
@@ -196,6 +198,8 @@ bool ZONE::UnFill()
         pair.second.RemoveAllContours();
     }
 
+    m_filledPolysLOD.clear();
+
     for( std::pair<const PCB_LAYER_ID, ZONE_SEGMENT_FILL>& pair : m_FillSegmList )
     {
         change |= !pair.second.empty();
@@ -264,6 +268,7 @@ void ZONE::SetLayerSet( LSET aLayerSet )
         m_FilledPolysList.clear();
         m_RawPolysList.clear();
         m_filledPolysHash.clear();
+        m_filledPolysLOD.clear();
         m_insulatedIslands.clear();
 
         for( PCB_LAYER_ID layer : aLayerSet.Seq() )
@@ -680,6 +685,8 @@ void ZONE::Move( const wxPoint& offset )
     for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET>& pair : m_FilledPolysList )
         pair.second.Move( offset );
 
+    m_filledPolysLOD.clear();
+
     for( std::pair<const PCB_LAYER_ID, ZONE_SEGMENT_FILL>& pair : m_FillSegmList )
     {
         for( SEG& seg : pair.second )
@@ -717,6 +724,8 @@ void ZONE::Rotate( const wxPoint& aCentre, double aAngle )
     for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET>& pair : m_FilledPolysList )
         pair.second.Rotate( aAngle, VECTOR2I( aCentre ) );
 
+    m_filledPolysLOD.clear();
+
     for( std::pair<const PCB_LAYER_ID, ZONE_SEGMENT_FILL>& pair : m_FillSegmList )
     {
         for( SEG& seg : pair.second )
@@ -754,6 +763,8 @@ void ZONE::Mirror( const wxPoint& aMirrorRef, bool aMirrorLeftRight )
     for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET>& pair : m_FilledPolysList )
         pair.second.Mirror( aMirrorLeftRight, !aMirrorLeftRight, VECTOR2I( aMirrorRef ) );
 
+    m_filledPolysLOD.clear();
+
     for( std::pair<const PCB_LAYER_ID, ZONE_SEGMENT_FILL>& pair : m_FillSegmList )
     {
         for( SEG& seg : pair.second )
@@ -1109,6 +1120,149 @@ void ZONE::SwapData( BOARD_ITEM* aImage )
 }
 
 
+/// The error allowed by the first level of detail of a fill; each next level doubles it
+static constexpr int ZONE_LOD_BASE_ERROR = ARC_HIGH_DEF;
+
+static constexpr int ZONE_LOD_LEVELS = 10;
+
+
+/**
+ * Simplify the closed chain \a aChain with the Douglas-Peucker algorithm, keeping all its
+ * vertices within \a aMaxError of the result.
+ *
+ * @return false if the chain is within \a aMaxError of a segment, and would be left with less
+ *         than 3 vertices.
+ */
+static bool simplifyChain( const SHAPE_LINE_CHAIN& aChain, int aMaxError,
+                           SHAPE_LINE_CHAIN& aResult )
+{
+    int count = aChain.PointCount();
+
+    if( count < 3 )
+        return false;
+
+    // Split the closed chain at its first vertex and at the vertex farthest from it
+    const VECTOR2I& first = aChain.CPoint( 0 );
+    int             farthest = 0;
+    SEG::ecoord     farthestDist = 0;
+
+    for( int ii = 1; ii < count; ++ii )
+    {
+        SEG::ecoord dist = ( aChain.CPoint( ii ) - first ).SquaredEuclideanNorm();
+
+        if( dist > farthestDist )
+        {
+            farthest = ii;
+            farthestDist = dist;
+        }
+    }
+
+    if( farthest == 0 )
+        return false;
+
+    SEG::ecoord                      maxDist = SEG::Square( aMaxError );
+    std::vector<bool>                keep( count, false );
+    std::vector<std::pair<int, int>> spans = { { 0, farthest }, { farthest, count } };
+
+    keep[0] = true;
+    keep[farthest] = true;
+
+    // Index count stands for the first vertex, which closes the chain
+    while( !spans.empty() )
+    {
+        std::pair<int, int> span = spans.back();
+        SEG                 seg( aChain.CPoint( span.first ),
+                                 aChain.CPoint( span.second % count ) );
+        int                 worst = -1;
+        SEG::ecoord         worstDist = maxDist;
+
+        spans.pop_back();
+
+        for( int ii = span.first + 1; ii < span.second; ++ii )
+        {
+            SEG::ecoord dist = seg.SquaredDistance( aChain.CPoint( ii ) );
+
+            if( dist > worstDist )
+            {
+                worst = ii;
+                worstDist = dist;
+            }
+        }
+
+        if( worst >= 0 )
+        {
+            keep[worst] = true;
+            spans.emplace_back( span.first, worst );
+            spans.emplace_back( worst, span.second );
+        }
+    }
+
+    aResult.Clear();
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        if( keep[ii] )
+            aResult.Append( aChain.CPoint( ii ) );
+    }
+
+    aResult.SetClosed( true );
+
+    return aResult.PointCount() >= 3;
+}
+
+
+const SHAPE_POLY_SET& ZONE::GetFilledPolysLOD( PCB_LAYER_ID aLayer, int aMaxError ) const
+{
+    const SHAPE_POLY_SET& fill = GetFilledPolysList( aLayer );
+    int                   level = -1;
+
+    while( level + 1 < ZONE_LOD_LEVELS && ( ZONE_LOD_BASE_ERROR << ( level + 1 ) ) <= aMaxError )
+        level++;
+
+    if( level < 0 || fill.OutlineCount() == 0 )
+        return fill;
+
+    std::map<int, SHAPE_POLY_SET>&          levels = m_filledPolysLOD[aLayer];
+    std::map<int, SHAPE_POLY_SET>::iterator it = levels.find( level );
+
+    if( it != levels.end() )
+        return it->second;
+
+    SHAPE_POLY_SET&  simplified = levels[level];
+    SHAPE_LINE_CHAIN chain;
+    int              maxError = ZONE_LOD_BASE_ERROR << level;
+
+    for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+    {
+        const SHAPE_LINE_CHAIN& outline = fill.COutline( ii );
+        BOX2I                   bbox = outline.BBox();
+
+        // Outlines smaller than the allowed error would not be seen
+        if( bbox.GetWidth() <= maxError && bbox.GetHeight() <= maxError )
+            continue;
+
+        if( !simplifyChain( outline, maxError, chain ) )
+            continue;
+
+        int idx = simplified.AddOutline( chain );
+
+        for( int jj = 0; jj < fill.HoleCount( ii ); ++jj )
+        {
+            const SHAPE_LINE_CHAIN& hole = fill.CHole( ii, jj );
+            BOX2I                   holeBox = hole.BBox();
+
+            if( holeBox.GetWidth() <= maxError && holeBox.GetHeight() <= maxError )
+                continue;
+
+            if( simplifyChain( hole, maxError, chain ) )
+                simplified.AddHole( chain, idx );
+        }
+    }
+
+    return simplified;
+}
+
+
 void ZONE::CacheTriangulation( PCB_LAYER_ID aLayer )
 {
     if( aLayer == UNDEFINED_LAYER )
@@ -1167,7 +1321,7 @@ void ZONE::GetInteractingZones( PCB_LAYER_ID aLayer, std::vector<ZONE*>* aZones
 
 
 bool ZONE::BuildSmoothedPoly( SHAPE_POLY_SET& aSmoothedPoly, PCB_LAYER_ID aLayer,
-                              SHAPE_POLY_SET* aBoardOutline,
+                              const SHAPE_POLY_SET* aBoardOutline,
                               SHAPE_POLY_SET* aSmoothedPolyWithApron ) const
 {
     if( GetNumCorners() <= 2 )  // malformed zone. polygon calculations will not like it ...
@@ -1234,10 +1388,7 @@ bool ZONE::BuildSmoothedPoly( SHAPE_POLY_SET& aSmoothedPoly, PCB_LAYER_ID aLayer
         aSmoothedPoly.BooleanAdd( *zone->Outline(), SHAPE_POLY_SET::PM_FAST );
 
     if( aBoardOutline )
-    {
-        SHAPE_POLY_SET poly = *aBoardOutline;
-        aSmoothedPoly.BooleanIntersection( poly, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-    }
+        aSmoothedPoly.BooleanIntersection( *aBoardOutline, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
     smooth( aSmoothedPoly );
 
@@ -1279,7 +1430,7 @@ double ZONE::CalculateFilledArea()
 
 
 void ZONE::TransformSmoothedOutlineToPolygon( SHAPE_POLY_SET& aCornerBuffer, int aClearance,
-                                              SHAPE_POLY_SET* aBoardOutline ) const
+                                              const SHAPE_POLY_SET* aBoardOutline ) const
 {
     // Creates the zone outline polygon (with holes if any)
     SHAPE_POLY_SET polybuffer;
@@ -390,7 +390,7 @@ public:
      * @param aBoardOutline is the board outline (if a valid one exists; nullptr otherwise)
      */
     void TransformSmoothedOutlineToPolygon( SHAPE_POLY_SET& aCornerBuffer, int aClearance,
-                                            SHAPE_POLY_SET* aBoardOutline ) const;
+                                            const SHAPE_POLY_SET* aBoardOutline ) const;
 
     /**
      * Convert the zone shape to a closed polygon
@@ -635,6 +635,18 @@ public:
         return m_FilledPolysList.at( aLayer );
     }
 
+    /**
+     * Return the filled polygons of \a aLayer simplified for drawing at a low zoom level.
+     *
+     * The simplified versions are built when first asked for, and kept until the fill of the
+     * layer changes.  Outlines smaller than the allowed error are left out.
+     *
+     * @param aMaxError is the largest distance allowed between the simplified outlines and
+     *                  the filled polygons.
+     * @return the most simplified version within \a aMaxError, or the filled polygons.
+     */
+    const SHAPE_POLY_SET& GetFilledPolysLOD( PCB_LAYER_ID aLayer, int aMaxError ) const;
+
     /**
      * Create a list of triangles that "fill" the solid areas used for instance to draw
      * these solid areas on OpenGL.
@@ -647,6 +659,16 @@ public:
     void SetFilledPolysList( PCB_LAYER_ID aLayer, const SHAPE_POLY_SET& aPolysList )
     {
         m_FilledPolysList[aLayer] = aPolysList;
+        m_filledPolysLOD.erase( aLayer );
+    }
+
+    /**
+     * Exchange the filled polygons of all the layers with \a aPolysLists, without copying them.
+     */
+    void SwapFilledPolysLists( std::map<PCB_LAYER_ID, SHAPE_POLY_SET>& aPolysLists )
+    {
+        m_FilledPolysList.swap( aPolysLists );
+        m_filledPolysLOD.clear();
     }
 
     /**
@@ -672,7 +694,7 @@ public:
     }
 
     bool BuildSmoothedPoly( SHAPE_POLY_SET& aSmoothedPoly, PCB_LAYER_ID aLayer,
-                            SHAPE_POLY_SET* aBoardOutline,
+                            const SHAPE_POLY_SET* aBoardOutline,
                             SHAPE_POLY_SET* aSmoothedPolyWithApron = nullptr ) const;
 
     void SetCornerSmoothingType( int aType ) { m_cornerSmoothingType = aType; };
@@ -914,6 +936,12 @@ protected:
     std::map<PCB_LAYER_ID, SHAPE_POLY_SET> m_FilledPolysList;
     std::map<PCB_LAYER_ID, SHAPE_POLY_SET> m_RawPolysList;
 
+    /**
+     * Simplified versions of m_FilledPolysList, by level of detail, built by
+     * GetFilledPolysLOD().  Must be cleared whenever m_FilledPolysList changes.
+     */
+    mutable std::map<PCB_LAYER_ID, std::map<int, SHAPE_POLY_SET>> m_filledPolysLOD;
+
     /// Temp variables used while filling
     EDA_RECT                               m_bboxCache;
     std::map<PCB_LAYER_ID, bool>           m_fillFlags;
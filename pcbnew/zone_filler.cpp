@@ -30,6 +30,7 @@
 #include <advanced_config.h>
 #include <board.h>
 #include <board_design_settings.h>
+#include <board_outline.h>
 #include <zone.h>
 #include <footprint.h>
 #include <pad.h>
@@ -53,7 +54,6 @@ static const double s_RoundPadThermalSpokeAngle = 450;      // in deci-degrees
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
         m_board( aBoard ),
-        m_brdOutlinesValid( false ),
         m_commit( aCommit ),
         m_progressReporter( nullptr ),
         m_maxError( ARC_HIGH_DEF ),
@@ -84,11 +84,38 @@ void ZONE_FILLER::SetProgressReporter( PROGRESS_REPORTER* aReporter )
 }
 
 
+/**
+ * @return the hash of the fill of \a aZone on \a aLayer.  The hash cached by a polygon set is
+ *         only reliable while its triangulation is up to date.
+ */
+static MD5_HASH filledPolysHash( const ZONE* aZone, PCB_LAYER_ID aLayer )
+{
+    if( !aZone->HasFilledPolysForLayer( aLayer ) )
+        return SHAPE_POLY_SET().GetHash();
+
+    const SHAPE_POLY_SET& polys = aZone->GetFilledPolysList( aLayer );
+
+    if( polys.IsTriangulationUpToDate() )
+        return polys.GetHash();
+
+    // A copy without a triangulation hashes its outlines
+    return SHAPE_POLY_SET( polys ).GetHash();
+}
+
+
 bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aParent )
 {
     std::vector<std::pair<ZONE*, PCB_LAYER_ID>> toFill;
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> islandsList;
 
+    // The hashes of the fills the connectivity of the zones is built from.  The zones which
+    // come out of the refill unchanged keep their connectivity items.
+    std::map<std::pair<ZONE*, PCB_LAYER_ID>, MD5_HASH> previousHashes;
+
+    // The previous fills which are triangulated, taken out of the zones rather than copied.
+    // Those which come out of the refill unchanged are put back with their triangulations.
+    std::map<ZONE*, std::map<PCB_LAYER_ID, SHAPE_POLY_SET>> previousFills;
+
     std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board->GetConnectivity();
 
     // Rebuild just in case. This really needs to be reliable.
@@ -108,8 +135,7 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
     }
 
     // The board outlines is used to clip solid areas inside the board (when outlines are valid)
-    m_boardOutline.RemoveAllContours();
-    m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
+    m_boardOutline = m_board->GetBoardOutline();
 
     // Update and cache zone bounding boxes and pad effective shapes so that we don't have to
     // make them thread-safe.
@@ -164,12 +190,31 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
         {
             zone->BuildHashValue( layer );
 
+            previousHashes[ std::make_pair( zone, layer ) ] = filledPolysHash( zone, layer );
+
             // Add the zone to the list of zones to test or refill
             toFill.emplace_back( std::make_pair( zone, layer ) );
         }
 
         islandsList.emplace_back( CN_ZONE_ISOLATED_ISLAND_LIST( zone ) );
 
+        // Take the fills out of the zone, which gets empty ones in exchange.  Only the
+        // triangulated ones might be restored; drop the others.
+        std::map<PCB_LAYER_ID, SHAPE_POLY_SET>& previous = previousFills[ zone ];
+
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+            previous[ layer ];
+
+        zone->SwapFilledPolysLists( previous );
+
+        for( auto it = previous.begin(); it != previous.end(); )
+        {
+            if( it->second.IsTriangulationUpToDate() )
+                ++it;
+            else
+                it = previous.erase( it );
+        }
+
         // Remove existing fill first to prevent drawing invalid polygons
         // on some platforms
         zone->UnFill();
@@ -314,6 +359,22 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
         m_progressReporter->KeepRefreshing();
     }
 
+    // Only the zones whose fill changed need new connectivity items
+    for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : islandsList )
+    {
+        zone.m_dirty = false;
+
+        for( PCB_LAYER_ID layer : zone.m_zone->GetLayerSet().Seq() )
+        {
+            if( filledPolysHash( zone.m_zone, layer )
+                    != previousHashes[ std::make_pair( zone.m_zone, layer ) ] )
+            {
+                zone.m_dirty = true;
+                break;
+            }
+        }
+    }
+
     connectivity->SetProgressReporter( m_progressReporter );
     connectivity->FindIsolatedCopperIslands( islandsList );
     connectivity->SetProgressReporter( nullptr );
@@ -371,9 +432,13 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
         }
     }
 
-    // Now remove islands outside the board edge
+    // Now remove islands outside the board edge.  Without a valid edge the fills aren't clipped
+    // to the board, so there is nothing to remove.
     for( ZONE* zone : aZones )
     {
+        if( !m_boardOutline )
+            break;
+
         LSET zoneCopperLayers = zone->GetLayerSet() & LSET::AllCuMask( MAX_CU_LAYERS );
 
         for( PCB_LAYER_ID layer : zoneCopperLayers.Seq() )
@@ -387,7 +452,7 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
             {
                 std::vector<SHAPE_LINE_CHAIN>& island = poly.Polygon( ii );
 
-                if( island.empty() || !m_boardOutline.Contains( island.front().CPoint( 0 ) ) )
+                if( island.empty() || !m_boardOutline->Contains( island.front().CPoint( 0 ) ) )
                     poly.DeletePolygon( ii );
             }
 
@@ -433,11 +498,40 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
         }
     }
 
+    // Fills which came out unchanged get their previous triangulation back
+    std::vector<std::pair<ZONE*, std::vector<PCB_LAYER_ID>>> toTriangulate;
+
+    for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : islandsList )
+    {
+        std::vector<PCB_LAYER_ID> layers;
+
+        const std::map<PCB_LAYER_ID, SHAPE_POLY_SET>& previous = previousFills[ zone.m_zone ];
+
+        for( PCB_LAYER_ID layer : zone.m_zone->GetLayerSet().Seq() )
+        {
+            auto previousFill = previous.find( layer );
+
+            if( previousFill != previous.end()
+                    && filledPolysHash( zone.m_zone, layer )
+                               == previousHashes[ std::make_pair( zone.m_zone, layer ) ] )
+            {
+                zone.m_zone->SetFilledPolysList( layer, previousFill->second );
+            }
+            else
+            {
+                layers.push_back( layer );
+            }
+        }
+
+        if( !layers.empty() )
+            toTriangulate.emplace_back( zone.m_zone, layers );
+    }
+
     if( m_progressReporter )
     {
         m_progressReporter->AdvancePhase();
         m_progressReporter->Report( _( "Performing polygon fills..." ) );
-        m_progressReporter->SetMaxProgress( islandsList.size() );
+        m_progressReporter->SetMaxProgress( toTriangulate.size() );
     }
 
     nextItem = 0;
@@ -447,9 +541,11 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
             {
                 size_t num = 0;
 
-                for( size_t i = nextItem++; i < islandsList.size(); i = nextItem++ )
+                for( size_t i = nextItem++; i < toTriangulate.size(); i = nextItem++ )
                 {
-                    islandsList[i].m_zone->CacheTriangulation();
+                    for( PCB_LAYER_ID layer : toTriangulate[i].second )
+                        toTriangulate[i].first->CacheTriangulation( layer );
+
                     num++;
 
                     if( m_progressReporter )
@@ -464,7 +560,7 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
                 return num;
             };
 
-    size_t parallelThreadCount = std::min( cores, islandsList.size() );
+    size_t parallelThreadCount = std::min( cores, toTriangulate.size() );
     std::vector<std::future<size_t>> returns( parallelThreadCount );
 
     if( parallelThreadCount <= 1 )
@@ -1187,7 +1283,7 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE* aZone,
 bool ZONE_FILLER::fillSingleZone( ZONE* aZone, PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aRawPolys,
                                   SHAPE_POLY_SET& aFinalPolys )
 {
-    SHAPE_POLY_SET* boardOutline = m_brdOutlinesValid ? &m_boardOutline : nullptr;
+    const SHAPE_POLY_SET* boardOutline = m_boardOutline ? &m_boardOutline->Polygons() : nullptr;
     SHAPE_POLY_SET  maxExtents;
     SHAPE_POLY_SET  smoothedPoly;
     PCB_LAYER_ID    debugLayer = UNDEFINED_LAYER;
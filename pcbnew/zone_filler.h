@@ -26,11 +26,13 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <memory>
 #include <vector>
 #include <zone.h>
 
 class WX_PROGRESS_REPORTER;
 class BOARD;
+class BOARD_OUTLINE;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
@@ -120,8 +122,7 @@ private:
                                  SHAPE_POLY_SET& aRawPolys );
 
     BOARD*                m_board;
-    SHAPE_POLY_SET        m_boardOutline;       // the board outlines, if exists
-    bool                  m_brdOutlinesValid;   // true if m_boardOutline is well-formed
+    std::shared_ptr<const BOARD_OUTLINE> m_boardOutline;  // the board outline, if well-formed
     COMMIT*               m_commit;
     PROGRESS_REPORTER*    m_progressReporter;
 
@@ -0,0 +1,245 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_eagle_xml_reader.cpp
+ * Test suite for #EAGLE_XML_READER
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <common/plugins/eagle/eagle_parser.h>
+#include <common/plugins/eagle/eagle_xml_reader.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <cstring>
+#include <vector>
+
+
+static const char* const EAGLE_DOCUMENT =
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<!DOCTYPE eagle SYSTEM \"eagle.dtd\">\n"
+        "<eagle version=\"9.6.2\">\n"
+        "<!-- a comment -->\n"
+        "<drawing>\n"
+        "<layers>\n"
+        "<layer number=\"1\" name=\"Top\" color=\"4\" fill=\"1\" visible=\"yes\" active=\"yes\"/>\n"
+        "</layers>\n"
+        "<board>\n"
+        "<description>R&amp;D board &lt;v2&gt; &#x3a9;&#937;\r\nsecond line</description>\n"
+        "<plain>\n"
+        "<text x=\"1\" y='2' size=\"1.27\" layer=\"1\">&quot;A&apos;\tB</text>\n"
+        "</plain>\n"
+        "<signals>\n"
+        "<signal name=\"GND\">\n"
+        "<wire x1=\"0\" y1=\"0\" x2=\"1\" y2=\"0\" width=\"0.2\" layer=\"1\"/>\n"
+        "<via x=\"1\" y=\"0\" extent=\"1-16\" drill=\"0.3\"/>\n"
+        "</signal>\n"
+        "<signal name=\"V&lt;CC\"/>\n"
+        "</signals>\n"
+        "<errors/>\n"
+        "</board>\n"
+        "</drawing>\n"
+        "<compatibility>\n"
+        "<note><![CDATA[a < b]]></note>\n"
+        "</compatibility>\n"
+        "</eagle>\n";
+
+
+struct EAGLE_XML_READER_FIXTURE
+{
+    EAGLE_XML_READER_FIXTURE()
+    {
+        m_fileName = wxFileName::CreateTempFileName( "eagle_xml_reader" );
+    }
+
+    ~EAGLE_XML_READER_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    void WriteDocument( const char* aDocument )
+    {
+        wxFFile file( m_fileName, "wb" );
+        file.Write( aDocument, strlen( aDocument ) );
+    }
+
+    wxString m_fileName;
+};
+
+
+/**
+ * Check that two trees hold the same elements, attributes and content.
+ */
+static void CheckSameTree( const wxXmlNode* aExpected, const wxXmlNode* aActual )
+{
+    for( ; aExpected && aActual; aExpected = aExpected->GetNext(), aActual = aActual->GetNext() )
+    {
+        BOOST_TEST_CONTEXT( "Node " << aExpected->GetName() )
+        {
+            BOOST_CHECK_EQUAL( aExpected->GetType(), aActual->GetType() );
+            BOOST_CHECK_EQUAL( aExpected->GetName(), aActual->GetName() );
+            BOOST_CHECK_EQUAL( aExpected->GetContent(), aActual->GetContent() );
+
+            const wxXmlAttribute* expAttr = aExpected->GetAttributes();
+            const wxXmlAttribute* actAttr = aActual->GetAttributes();
+
+            for( ; expAttr && actAttr; expAttr = expAttr->GetNext(), actAttr = actAttr->GetNext() )
+            {
+                BOOST_CHECK_EQUAL( expAttr->GetName(), actAttr->GetName() );
+                BOOST_CHECK_EQUAL( expAttr->GetValue(), actAttr->GetValue() );
+            }
+
+            BOOST_CHECK( !expAttr && !actAttr );
+
+            CheckSameTree( aExpected->GetChildren(), aActual->GetChildren() );
+        }
+    }
+
+    BOOST_CHECK( !aExpected && !aActual );
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( EagleXmlReader, EAGLE_XML_READER_FIXTURE )
+
+
+/**
+ * Reading a whole document gives the same tree as wxXmlDocument.
+ */
+BOOST_AUTO_TEST_CASE( WholeDocument )
+{
+    WriteDocument( EAGLE_DOCUMENT );
+
+    wxXmlDocument expected;
+    BOOST_REQUIRE( expected.Load( m_fileName ) );
+
+    EAGLE_XML_READER reader( m_fileName );
+    reader.ReadToEnd();
+
+    CheckSameTree( expected.GetRoot(), reader.GetRoot() );
+}
+
+
+/**
+ * Streamed children are handed out in order and left out of the tree, which otherwise gets
+ * all the rest of the document.
+ */
+BOOST_AUTO_TEST_CASE( StreamChildren )
+{
+    WriteDocument( EAGLE_DOCUMENT );
+
+    wxXmlDocument expected;
+    BOOST_REQUIRE( expected.Load( m_fileName ) );
+
+    EAGLE_XML_READER reader( m_fileName );
+    BOOST_REQUIRE( reader.ReadUntil( "signals" ) );
+
+    // Find the expected signals and take them out of the expected tree
+    wxXmlNode* signals = expected.GetRoot()->GetChildren();
+
+    while( signals && signals->GetName() != "drawing" )
+        signals = signals->GetNext();
+
+    BOOST_REQUIRE( signals );
+    signals = signals->GetChildren();
+
+    while( signals && signals->GetName() != "board" )
+        signals = signals->GetNext();
+
+    BOOST_REQUIRE( signals );
+    signals = signals->GetChildren();
+
+    while( signals && signals->GetName() != "signals" )
+        signals = signals->GetNext();
+
+    BOOST_REQUIRE( signals );
+
+    while( wxXmlNode* expectedSignal = signals->GetChildren() )
+    {
+        std::unique_ptr<wxXmlNode> signal = reader.ReadChild();
+
+        BOOST_REQUIRE( signal );
+        BOOST_CHECK( !signal->GetParent() );
+
+        signals->RemoveChild( expectedSignal );
+
+        // Only compare this one node and its children, not its siblings
+        std::unique_ptr<wxXmlNode> expectedOwner( expectedSignal );
+        expectedSignal->SetNext( nullptr );
+        CheckSameTree( expectedSignal, signal.get() );
+    }
+
+    BOOST_CHECK( !reader.ReadChild() );
+
+    reader.ReadToEnd();
+    CheckSameTree( expected.GetRoot(), reader.GetRoot() );
+}
+
+
+/**
+ * Without the streamed element, the whole document is read at once.
+ */
+BOOST_AUTO_TEST_CASE( NoStreamedElement )
+{
+    WriteDocument( "<eagle><drawing><schematic/></drawing></eagle>" );
+
+    EAGLE_XML_READER reader( m_fileName );
+    BOOST_CHECK( !reader.ReadUntil( "signals" ) );
+    BOOST_CHECK( !reader.ReadChild() );
+
+    BOOST_REQUIRE( reader.GetRoot() );
+    BOOST_CHECK_EQUAL( reader.GetRoot()->GetName(), "eagle" );
+    BOOST_CHECK( reader.GetRoot()->GetChildren()->GetChildren() );
+}
+
+
+/**
+ * Malformed documents are reported.
+ */
+BOOST_AUTO_TEST_CASE( Malformed )
+{
+    const std::vector<const char*> documents = {
+        "<eagle><drawing></board></eagle>",
+        "<eagle><signals><signal>",
+        "<eagle/><eagle/>",
+        "<eagle version=9/>",
+        "<eagle>&unknown;</eagle>",
+        ""
+    };
+
+    for( const char* document : documents )
+    {
+        BOOST_TEST_CONTEXT( document )
+        {
+            WriteDocument( document );
+
+            EAGLE_XML_READER reader( m_fileName );
+            BOOST_CHECK_THROW( reader.ReadToEnd(), XML_PARSER_ERROR );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <item_pool.h>
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( ItemPool )
+
+
+/**
+ * Blocks are aligned, don't overlap and are reused once freed.
+ */
+BOOST_AUTO_TEST_CASE( AllocateAndReuse )
+{
+    ITEM_POOL::STATS    before = ITEM_POOL::GetStats();
+    std::vector<void*>  blocks;
+
+    for( int ii = 0; ii < 1000; ++ii )
+    {
+        void* block = ITEM_POOL::Allocate( 40 );
+
+        BOOST_CHECK_EQUAL( reinterpret_cast<uintptr_t>( block ) % alignof( std::max_align_t ), 0 );
+        std::memset( block, ii & 0xFF, 40 );
+        blocks.push_back( block );
+    }
+
+    for( int ii = 0; ii < 1000; ++ii )
+        BOOST_CHECK_EQUAL( static_cast<unsigned char*>( blocks[ii] )[39], ii & 0xFF );
+
+    std::set<void*> freed( blocks.begin(), blocks.end() );
+
+    for( void* block : blocks )
+        ITEM_POOL::Free( block, 40 );
+
+    // Anything from 33 to 48 bytes comes from the same size class
+    void* reused = ITEM_POOL::Allocate( 33 );
+
+    BOOST_CHECK( freed.count( reused ) );
+    ITEM_POOL::Free( reused, 33 );
+
+    ITEM_POOL::STATS after = ITEM_POOL::GetStats();
+
+    BOOST_CHECK_EQUAL( after.allocations - before.allocations, 1001 );
+    BOOST_CHECK_EQUAL( after.frees - before.frees, 1001 );
+    BOOST_CHECK_EQUAL( after.bytesInUse, before.bytesInUse );
+}
+
+
+/**
+ * Large blocks bypass the pools.
+ */
+BOOST_AUTO_TEST_CASE( LargeBlocks )
+{
+    ITEM_POOL::STATS before = ITEM_POOL::GetStats();
+
+    void* block = ITEM_POOL::Allocate( 100000 );
+    std::memset( block, 0, 100000 );
+    ITEM_POOL::Free( block, 100000 );
+
+    ITEM_POOL::STATS after = ITEM_POOL::GetStats();
+
+    BOOST_CHECK_EQUAL( after.allocations, before.allocations );
+    BOOST_CHECK_EQUAL( after.chunkBytes, before.chunkBytes );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
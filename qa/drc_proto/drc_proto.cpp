@@ -32,6 +32,7 @@
 
 #include <pcbnew_utils/board_file_utils.h>
 #include <pcbnew/drc/drc_engine.h>
+#include <pcbnew/drc/drc_profile.h>
 #include <pcbnew/board.h>
 #include <pcbnew/drc/drc_rule_parser.h>
 #include <pcbnew/drc/drc_test_provider.h>
@@ -102,7 +103,8 @@ PROJECT_CONTEXT loadKicadProject( wxString filename, OPT<wxString> rulesFilePath
 }
 
 
-int runDRCProto( PROJECT_CONTEXT project, std::shared_ptr<KIGFX::VIEW_OVERLAY> aDebugOverlay )
+int runDRCProto( PROJECT_CONTEXT project, std::shared_ptr<KIGFX::VIEW_OVERLAY> aDebugOverlay,
+                 const wxString& aProfilePath )
 {
     std::shared_ptr<DRC_ENGINE> drcEngine( new DRC_ENGINE );
 
@@ -133,6 +135,11 @@ int runDRCProto( PROJECT_CONTEXT project, std::shared_ptr<KIGFX::VIEW_OVERLAY> a
           //  provider->Enable(false);
     }
 
+    DRC_PROFILE profile;
+
+    if( !aProfilePath.IsEmpty() )
+        drcEngine->SetProfile( &profile );
+
     try
     {
         drcEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
@@ -142,5 +149,13 @@ int runDRCProto( PROJECT_CONTEXT project, std::shared_ptr<KIGFX::VIEW_OVERLAY> a
         consoleLog.Print( wxString::Format( "Clipper exception %s occurred.", e.what() ) );
     }
 
+    drcEngine->SetProfile( nullptr );
+
+    if( !aProfilePath.IsEmpty() && !profile.Save( aProfilePath ) )
+    {
+        consoleLog.Print( wxString::Format( "Cannot write the profile to %s.\n", aProfilePath ) );
+        return -1;
+    }
+
     return 0;
 }
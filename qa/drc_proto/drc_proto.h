@@ -165,7 +165,9 @@ struct PROJECT_CONTEXT {
 };
 
 PROJECT_CONTEXT loadKicadProject( wxString filename, OPT<wxString> rulesFilePath );
-int runDRCProto( PROJECT_CONTEXT project, std::shared_ptr<KIGFX::VIEW_OVERLAY> aDebugOverlay = nullptr);
+int runDRCProto( PROJECT_CONTEXT project,
+                 std::shared_ptr<KIGFX::VIEW_OVERLAY> aDebugOverlay = nullptr,
+                 const wxString& aProfilePath = wxEmptyString );
 
 #endif
 
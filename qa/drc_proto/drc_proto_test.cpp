@@ -44,20 +44,33 @@ int main( int argc, char** argv )
     PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
     propMgr.Rebuild();
 
-    if( argc < 2 )
+    std::vector<wxString> args;
+    wxString              profilePath;
+
+    for( int ii = 1; ii < argc; ii++ )
+    {
+        wxString arg( argv[ii] );
+
+        if( !arg.StartsWith( "--profile=", &profilePath ) )
+            args.push_back( arg );
+    }
+
+    if( args.empty() )
     {
-        printf("usage: %s <project-file/board-file> [drc-rules-file]\n", argv[0] );
+        printf("usage: %s [--profile=<json-file>] <project-file/board-file> [drc-rules-file]\n",
+               argv[0] );
         Pgm().Destroy();
         wxUninitialize();
         return -1;
     }
 
-    PROJECT_CONTEXT project = loadKicadProject( argv[1], argv[2] ? wxString( argv[2] ) : OPT<wxString>() );
+    PROJECT_CONTEXT project = loadKicadProject( args[0], args.size() > 1 ? OPT<wxString>( args[1] )
+                                                                         : OPT<wxString>() );
 
     // This causes some glib warnings on GTK3 (http://trac.wxwidgets.org/ticket/18274)
     // but without it, Valgrind notices a lot of leaks from WX
 
-    runDRCProto( project );
+    runDRCProto( project, nullptr, profilePath );
 
     Pgm().Destroy();
 
@@ -462,6 +462,34 @@ BOOST_AUTO_TEST_CASE( Inheritance )
 }
 
 
+/**
+ * Check that the cached flattened copy of a derived symbol follows the edits of its parent.
+ */
+BOOST_AUTO_TEST_CASE( FlattenedFollowsParent )
+{
+    std::unique_ptr<LIB_SYMBOL> parent = std::make_unique<LIB_SYMBOL>( "parent" );
+    std::unique_ptr<LIB_SYMBOL> child = std::make_unique<LIB_SYMBOL>( "child", parent.get() );
+
+    const LIB_SYMBOL* flattened = child->GetFlattened();
+    BOOST_CHECK( flattened->IsRoot() );
+    BOOST_CHECK_EQUAL( flattened->GetUnitCount(), 1 );
+    BOOST_CHECK( flattened->GetDrawItems().empty( LIB_RECTANGLE_T ) );
+
+    // Nothing changed, so the same copy is returned
+    BOOST_CHECK_EQUAL( child->GetFlattened(), flattened );
+
+    parent->SetUnitCount( 4 );
+    BOOST_CHECK_EQUAL( child->GetFlattened()->GetUnitCount(), 4 );
+
+    parent->AddDrawItem( new LIB_RECTANGLE( parent.get() ) );
+    BOOST_CHECK_EQUAL( child->GetFlattened()->GetDrawItems().size( LIB_RECTANGLE_T ), 1 );
+
+    // Edits of the child itself are followed too
+    child->SetDescription( "derived" );
+    BOOST_CHECK_EQUAL( child->GetFlattened()->GetDescription(), "derived" );
+}
+
+
 /**
  * Check the copy constructor.
  */
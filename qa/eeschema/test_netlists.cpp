@@ -25,11 +25,15 @@
 #include <netlist_reader/netlist_reader.h>
 #include <netlist_reader/pcb_netlist.h>
 #include <project.h>
+#include <richio.h>
 #include <sch_io_mgr.h>
 #include <sch_sheet.h>
 #include <schematic.h>
 #include <settings/settings_manager.h>
 #include <wildcards_and_files_ext.h>
+#include <xnode.h>
+
+#include <wx/mstream.h>
 
 
 class TEST_NETLISTS_FIXTURE
@@ -221,6 +225,47 @@ void TEST_NETLISTS_FIXTURE::doNetlistTest( const wxString& aBaseName )
 }
 
 
+/**
+ * Give access to the netlist document tree, to write it the way the XML netlist used to be.
+ */
+class TEST_NETLIST_EXPORTER_XML : public NETLIST_EXPORTER_XML
+{
+public:
+    TEST_NETLIST_EXPORTER_XML( SCHEMATIC* aSchematic ) :
+            NETLIST_EXPORTER_XML( aSchematic )
+    {}
+
+    std::string SaveTree( unsigned aCtl )
+    {
+        wxXmlDocument         xdoc;
+        wxMemoryOutputStream  stream;
+
+        xdoc.SetRoot( makeRoot( aCtl ) );
+        BOOST_REQUIRE( xdoc.Save( stream, 2 ) );
+
+        std::string buffer( stream.GetLength(), '\0' );
+        stream.CopyTo( &buffer[0], buffer.size() );
+        return buffer;
+    }
+};
+
+
+/**
+ * Replace the content of the first date element of \a aNetlist, as the netlists are written
+ * at different times.
+ */
+static std::string clearDate( std::string aNetlist )
+{
+    size_t start = aNetlist.find( "<date>" );
+    size_t end = aNetlist.find( "</date>" );
+
+    if( start != std::string::npos && end != std::string::npos && start < end )
+        aNetlist.erase( start + 6, end - start - 6 );
+
+    return aNetlist;
+}
+
+
 BOOST_FIXTURE_TEST_SUITE( Netlists, TEST_NETLISTS_FIXTURE )
 
 
@@ -296,4 +341,28 @@ BOOST_AUTO_TEST_CASE( TopLevelHierPins )
 }
 
 
+BOOST_AUTO_TEST_CASE( StreamedXmlMatchesTree )
+{
+    for( const wxString& name : { "video", "complex_hierarchy", "noconnects", "bus_junctions",
+                                  "test_hier_renaming" } )
+    {
+        loadSchematic( name );
+
+        TEST_NETLIST_EXPORTER_XML exporter( &m_schematic );
+
+        for( unsigned ctl : { GNL_ALL, GNL_ALL | GNL_OPT_BOM } )
+        {
+            STRING_FORMATTER formatter;
+
+            exporter.FormatXML( &formatter, ctl );
+
+            BOOST_CHECK_EQUAL( clearDate( formatter.GetString() ),
+                               clearDate( exporter.SaveTree( ctl ) ) );
+        }
+
+        m_schematic.Reset();
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
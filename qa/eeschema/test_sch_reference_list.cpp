@@ -0,0 +1,601 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the annotation of a #SCH_REFERENCE_LIST.
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+// Code under test
+#include <sch_reference_list.h>
+
+#include <random>
+#include <unordered_set>
+
+#include <lib_symbol.h>
+#include <sch_sheet.h>
+#include <sch_symbol.h>
+
+
+/**
+ * What the annotation reads and writes of a #SCH_REFERENCE, to annotate it the reference way.
+ */
+struct REF_DATA
+{
+    wxString    m_Ref;
+    int         m_NumRef;
+    int         m_Unit;
+    bool        m_IsNew;
+    bool        m_Flag;
+    wxString    m_Value;
+    wxString    m_LibName;
+    SCH_SYMBOL* m_Symbol;
+    KIID_PATH   m_Path;
+    int         m_UnitCount;
+    int         m_SheetNum;
+
+    bool IsSameInstance( const REF_DATA& aOther ) const
+    {
+        return m_Symbol == aOther.m_Symbol && m_Path == aOther.m_Path;
+    }
+
+    wxString GetRefNumber() const
+    {
+        return m_NumRef < 0 ? wxString( wxT( "?" ) ) : wxString::Format( "%d", m_NumRef );
+    }
+
+    wxString FullRef( int aUnit = -1 ) const
+    {
+        return wxString::Format( "%s%s..%d", m_Ref, GetRefNumber(), aUnit < 0 ? m_Unit : aUnit );
+    }
+};
+
+
+typedef std::map<wxString, std::vector<REF_DATA>> REF_DATA_MAP;
+
+
+/**
+ * The annotation as SCH_REFERENCE_LIST::Annotate() did it before indexing the list, rescanning
+ * it for each reference: the result of the annotation must not depend on the indexing.
+ */
+static void referenceAnnotate( std::vector<REF_DATA>& aRefs, bool aUseSheetNum,
+                               int aSheetIntervalId, int aStartNumber,
+                               REF_DATA_MAP aLockedUnitMap,
+                               const std::vector<REF_DATA>& aAdditionalRefs, bool aStartAtCurrent )
+{
+    size_t                       originalSize = aRefs.size();
+    std::unordered_set<wxString> inUseRefs;
+
+    for( REF_DATA additionalRef : aAdditionalRefs )
+    {
+        if( !additionalRef.m_IsNew )
+            inUseRefs.insert( additionalRef.FullRef() );
+
+        additionalRef.m_IsNew = false;
+        aRefs.push_back( additionalRef );
+    }
+
+    auto findUnit =
+            [&]( size_t aIndex, int aUnit ) -> bool
+            {
+                for( size_t ii = 0; ii < aRefs.size(); ii++ )
+                {
+                    if( ii != aIndex && !aRefs[ii].m_IsNew
+                            && aRefs[ii].m_NumRef == aRefs[aIndex].m_NumRef
+                            && aRefs[ii].m_Ref == aRefs[aIndex].m_Ref
+                            && aRefs[ii].m_Unit == aUnit )
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+    auto getRefsInUse =
+            [&]( size_t aIndex, std::vector<int>& aIdList, int aMinRefId )
+            {
+                aIdList.clear();
+
+                for( const REF_DATA& ref : aRefs )
+                {
+                    if( ref.m_Ref == aRefs[aIndex].m_Ref && ref.m_NumRef >= aMinRefId
+                            && !ref.m_IsNew )
+                    {
+                        aIdList.push_back( ref.m_NumRef );
+                    }
+                }
+
+                std::sort( aIdList.begin(), aIdList.end() );
+                aIdList.erase( std::unique( aIdList.begin(), aIdList.end() ), aIdList.end() );
+            };
+
+    auto createFirstFreeRefId =
+            []( std::vector<int>& aIdList, int aFirstValue ) -> int
+            {
+                int expectedId = aFirstValue;
+                size_t ii = 0;
+
+                while( ii < aIdList.size() && aIdList[ii] < expectedId )
+                    ii++;
+
+                for( ; ii < aIdList.size(); ii++ )
+                {
+                    if( expectedId != aIdList[ii] )
+                    {
+                        aIdList.insert( aIdList.begin() + ii, expectedId );
+                        return expectedId;
+                    }
+
+                    expectedId++;
+                }
+
+                aIdList.push_back( expectedId );
+                return expectedId;
+            };
+
+    size_t           first = 0;
+    int              minRefId = aUseSheetNum ? aRefs[first].m_SheetNum * aSheetIntervalId + 1
+                                             : aStartNumber + 1;
+    std::vector<int> idList;
+
+    getRefsInUse( first, idList, minRefId );
+
+    for( size_t ii = 0; ii < aRefs.size(); ii++ )
+    {
+        REF_DATA& refUnit = aRefs[ii];
+
+        if( refUnit.m_Flag )
+            continue;
+
+        std::vector<REF_DATA>* lockedList = nullptr;
+
+        for( REF_DATA_MAP::value_type& pair : aLockedUnitMap )
+        {
+            for( const REF_DATA& thisRef : pair.second )
+            {
+                if( thisRef.IsSameInstance( refUnit ) )
+                {
+                    lockedList = &pair.second;
+                    break;
+                }
+            }
+
+            if( lockedList )
+                break;
+        }
+
+        if( aRefs[first].m_Ref != refUnit.m_Ref
+                || ( aUseSheetNum && aRefs[first].m_SheetNum != refUnit.m_SheetNum ) )
+        {
+            first = ii;
+            minRefId = aUseSheetNum ? refUnit.m_SheetNum * aSheetIntervalId + 1
+                                    : aStartNumber + 1;
+            getRefsInUse( first, idList, minRefId );
+        }
+
+        if( aStartAtCurrent && refUnit.m_NumRef > 0 )
+        {
+            minRefId = refUnit.m_NumRef;
+            getRefsInUse( first, idList, minRefId );
+        }
+
+        if( refUnit.m_UnitCount <= 1 )
+        {
+            if( refUnit.m_IsNew )
+                refUnit.m_NumRef = createFirstFreeRefId( idList, minRefId );
+
+            refUnit.m_Flag = true;
+            refUnit.m_IsNew = false;
+            continue;
+        }
+
+        if( refUnit.m_IsNew )
+        {
+            refUnit.m_NumRef = createFirstFreeRefId( idList, minRefId );
+            refUnit.m_Flag = true;
+        }
+
+        if( lockedList )
+        {
+            for( const REF_DATA& thisRef : *lockedList )
+            {
+                if( thisRef.IsSameInstance( refUnit ) )
+                {
+                    refUnit.m_Unit = thisRef.m_Unit;
+                    inUseRefs.insert( refUnit.FullRef() );
+                }
+
+                if( thisRef.m_Value != refUnit.m_Value || thisRef.m_LibName != refUnit.m_LibName )
+                    continue;
+
+                for( size_t jj = ii + 1; jj < aRefs.size(); jj++ )
+                {
+                    if( !thisRef.IsSameInstance( aRefs[jj] ) )
+                        continue;
+
+                    wxString candidate = refUnit.FullRef( thisRef.m_Unit );
+
+                    if( inUseRefs.count( candidate ) == 0 )
+                    {
+                        aRefs[jj].m_NumRef = refUnit.m_NumRef;
+                        aRefs[jj].m_IsNew = false;
+                        aRefs[jj].m_Flag = true;
+                        inUseRefs.insert( candidate );
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for( int unit = 1; unit <= refUnit.m_UnitCount; unit++ )
+            {
+                if( refUnit.m_Unit == unit || findUnit( ii, unit ) )
+                    continue;
+
+                for( size_t jj = ii + 1; jj < aRefs.size(); jj++ )
+                {
+                    REF_DATA& cmpUnit = aRefs[jj];
+
+                    if( cmpUnit.m_Flag || !cmpUnit.m_IsNew || cmpUnit.m_Ref != refUnit.m_Ref
+                            || cmpUnit.m_Value != refUnit.m_Value
+                            || cmpUnit.m_LibName != refUnit.m_LibName
+                            || ( aUseSheetNum && cmpUnit.m_Path != refUnit.m_Path ) )
+                    {
+                        continue;
+                    }
+
+                    if( cmpUnit.m_Unit == unit )
+                    {
+                        cmpUnit.m_NumRef = refUnit.m_NumRef;
+                        cmpUnit.m_Flag = true;
+                        cmpUnit.m_IsNew = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    aRefs.resize( originalSize );
+}
+
+
+/**
+ * A hierarchy of a few sheets each used many times, holding resistors, capacitors and single
+ * or multi-unit ICs, some of them annotated (with duplicates) and the others not.
+ */
+class TEST_SCH_REFERENCE_LIST_FIXTURE
+{
+public:
+    TEST_SCH_REFERENCE_LIST_FIXTURE() :
+            m_root( nullptr )
+    {
+        struct LIB_DEF
+        {
+            const char*              name;
+            int                      unitCount;
+            const char*              prefix;
+            std::vector<const char*> values;
+        };
+
+        const std::vector<LIB_DEF> libDefs = {
+            { "R",          1, "R", { "10k", "4k7", "100" } },
+            { "C",          1, "C", { "100n", "10u" } },
+            { "OPAMP",      2, "U", { "TL072", "LM358" } },
+            { "QUAD_NAND",  4, "U", { "74HC00" } },
+            { "REGULATOR",  1, "U", { "LM7805" } },
+            { "DUAL_DIODE", 2, "D", { "BAV99" } }
+        };
+
+        const int screenCount = 6;
+        const int symbolsPerScreen = 50;
+        const int sheetCount = 60;
+
+        std::mt19937                                          rng( 42 );
+        std::vector<std::vector<std::unique_ptr<SCH_SYMBOL>>> screens( screenCount );
+        std::map<SCH_SYMBOL*, const LIB_DEF*>                 symbolDefs;
+
+        for( const LIB_DEF& def : libDefs )
+        {
+            m_libSymbols.emplace_back( std::make_unique<LIB_SYMBOL>( def.name ) );
+            m_libSymbols.back()->SetUnitCount( def.unitCount );
+        }
+
+        for( std::vector<std::unique_ptr<SCH_SYMBOL>>& screen : screens )
+        {
+            for( int ii = 0; ii < symbolsPerScreen; ++ii )
+            {
+                size_t         libIdx = rng() % libDefs.size();
+                const LIB_DEF& def = libDefs[libIdx];
+                SCH_SYMBOL*    symbol = new SCH_SYMBOL( wxPoint( ii * 100, ii * 50 ) );
+
+                symbol->SetLibId( LIB_ID( "test", def.name ) );
+                symbol->SetValue( def.values[rng() % def.values.size()] );
+
+                screen.emplace_back( symbol );
+                symbolDefs[symbol] = &def;
+                m_symbolLibs[symbol] = m_libSymbols[libIdx].get();
+            }
+        }
+
+        // One more sheet for the additional references
+        for( int ii = 0; ii <= sheetCount; ++ii )
+        {
+            m_sheets.emplace_back( std::make_unique<SCH_SHEET>( &m_root ) );
+
+            SCH_SHEET_PATH path;
+            path.push_back( &m_root );
+            path.push_back( m_sheets.back().get() );
+            m_paths.push_back( path );
+            m_sheetNums[path.Path()] = ii + 2;
+        }
+
+        for( int ii = 0; ii < sheetCount; ++ii )
+        {
+            for( std::unique_ptr<SCH_SYMBOL>& symbol : screens[ii % screenCount] )
+            {
+                const LIB_DEF* def = symbolDefs[symbol.get()];
+                wxString       ref = def->prefix;
+
+                if( rng() % 10 < 3 )
+                    ref << "?";
+                else
+                    ref << 1 + rng() % 200;
+
+                symbol->AddHierarchicalReference( m_paths[ii].Path(), ref,
+                                                  1 + rng() % def->unitCount );
+            }
+        }
+
+        for( std::vector<std::unique_ptr<SCH_SYMBOL>>& screen : screens )
+        {
+            for( std::unique_ptr<SCH_SYMBOL>& symbol : screen )
+                m_symbols.emplace_back( std::move( symbol ) );
+        }
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            const LIB_DEF& def = libDefs[ii % libDefs.size()];
+            SCH_SYMBOL*    symbol = new SCH_SYMBOL();
+
+            symbol->SetLibId( LIB_ID( "test", def.name ) );
+            symbol->SetValue( def.values.front() );
+            symbol->AddHierarchicalReference( m_paths.back().Path(),
+                                              wxString::Format( "%s%d", def.prefix, 1 + ii * 7 ),
+                                              1 + ii % def.unitCount );
+
+            m_symbols.emplace_back( symbol );
+            m_symbolLibs[symbol] = m_libSymbols[ii % libDefs.size()].get();
+            m_additionalSymbols.push_back( symbol );
+        }
+    }
+
+    /**
+     * @return the references of the hierarchy, not split.
+     */
+    SCH_REFERENCE_LIST buildReferences() const
+    {
+        SCH_REFERENCE_LIST refs;
+
+        for( size_t ii = 0; ii + 1 < m_paths.size(); ++ii )
+        {
+            for( const std::unique_ptr<SCH_SYMBOL>& symbol : m_symbols )
+            {
+                if( isInstanced( symbol.get(), m_paths[ii] ) )
+                    refs.AddItem( makeReference( symbol.get(), m_paths[ii] ) );
+            }
+        }
+
+        return refs;
+    }
+
+    /**
+     * @return the additional references, of symbols of another sheet, not split.
+     */
+    SCH_REFERENCE_LIST buildAdditionalReferences() const
+    {
+        SCH_REFERENCE_LIST refs;
+
+        for( SCH_SYMBOL* symbol : m_additionalSymbols )
+            refs.AddItem( makeReference( symbol, m_paths.back() ) );
+
+        return refs;
+    }
+
+    /**
+     * @return what the annotation reads of split references \a aRefs.
+     */
+    std::vector<REF_DATA> getData( const SCH_REFERENCE_LIST& aRefs ) const
+    {
+        std::vector<REF_DATA> data;
+
+        for( size_t ii = 0; ii < aRefs.GetCount(); ++ii )
+        {
+            const SCH_REFERENCE& ref = aRefs[ii];
+            REF_DATA             refData;
+            long                 numRef;
+
+            if( !ref.GetRefNumber().ToLong( &numRef ) )
+                numRef = -1;
+
+            refData.m_Ref = ref.GetRef();
+            refData.m_NumRef = numRef;
+            refData.m_Unit = ref.GetUnit();
+            refData.m_IsNew = numRef < 0;
+            refData.m_Flag = false;
+            refData.m_Value = ref.GetValue();
+            refData.m_LibName = ref.GetSymbol()->GetLibId().GetLibItemName().wx_str();
+            refData.m_Symbol = ref.GetSymbol();
+            refData.m_Path = ref.GetSheetPath().Path();
+            refData.m_UnitCount = ref.GetLibPart()->GetUnitCount();
+            refData.m_SheetNum = m_sheetNums.at( refData.m_Path );
+            data.push_back( refData );
+        }
+
+        return data;
+    }
+
+    /**
+     * Check the annotation of \a aRefs is the reference annotation \a aExpected.
+     */
+    void checkAnnotation( const SCH_REFERENCE_LIST& aRefs,
+                          const std::vector<REF_DATA>& aExpected ) const
+    {
+        BOOST_REQUIRE_EQUAL( aRefs.GetCount(), aExpected.size() );
+
+        int mismatches = 0;
+
+        for( size_t ii = 0; ii < aExpected.size(); ++ii )
+        {
+            const SCH_REFERENCE& ref = aRefs[ii];
+
+            if( ref.GetRef() != aExpected[ii].m_Ref
+                    || ref.GetRefNumber() != aExpected[ii].GetRefNumber()
+                    || ref.GetUnit() != aExpected[ii].m_Unit )
+            {
+                BOOST_TEST_MESSAGE( "Reference " << ii << ": " << ref.GetRef() << ref.GetRefNumber()
+                                    << " unit " << ref.GetUnit() << ", expected "
+                                    << aExpected[ii].m_Ref << aExpected[ii].GetRefNumber()
+                                    << " unit " << aExpected[ii].m_Unit );
+                mismatches++;
+            }
+        }
+
+        BOOST_CHECK_EQUAL( mismatches, 0 );
+    }
+
+private:
+    bool isInstanced( SCH_SYMBOL* aSymbol, const SCH_SHEET_PATH& aPath ) const
+    {
+        for( const SYMBOL_INSTANCE_REFERENCE& instance : aSymbol->GetInstanceReferences() )
+        {
+            if( instance.m_Path == aPath.Path() )
+                return true;
+        }
+
+        return false;
+    }
+
+    SCH_REFERENCE makeReference( SCH_SYMBOL* aSymbol, const SCH_SHEET_PATH& aPath ) const
+    {
+        SCH_REFERENCE ref( aSymbol, m_symbolLibs.at( aSymbol ), aPath );
+
+        ref.SetSheetNumber( m_sheetNums.at( aPath.Path() ) );
+        return ref;
+    }
+
+    SCH_SHEET                                 m_root;
+    std::vector<std::unique_ptr<SCH_SHEET>>   m_sheets;
+    std::vector<SCH_SHEET_PATH>               m_paths;
+    std::map<KIID_PATH, int>                  m_sheetNums;
+    std::vector<std::unique_ptr<LIB_SYMBOL>>  m_libSymbols;
+    std::vector<std::unique_ptr<SCH_SYMBOL>>  m_symbols;
+    std::map<SCH_SYMBOL*, LIB_SYMBOL*>        m_symbolLibs;
+    std::vector<SCH_SYMBOL*>                  m_additionalSymbols;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SchReferenceList, TEST_SCH_REFERENCE_LIST_FIXTURE )
+
+
+/**
+ * Annotate the references not annotated yet, keeping the others, as the annotation dialog does.
+ */
+BOOST_AUTO_TEST_CASE( AnnotateNew )
+{
+    SCH_REFERENCE_LIST refs = buildReferences();
+
+    refs.SplitReferences();
+    refs.SortByRefAndValue();
+
+    std::vector<REF_DATA> expected = getData( refs );
+
+    referenceAnnotate( expected, false, 0, 0, REF_DATA_MAP(), {}, false );
+    refs.Annotate( false, 0, 0, SCH_MULTI_UNIT_REFERENCE_MAP(), SCH_REFERENCE_LIST() );
+
+    checkAnnotation( refs, expected );
+}
+
+
+/**
+ * Annotate by sheet number, with references of other sheets to keep.
+ */
+BOOST_AUTO_TEST_CASE( AnnotateBySheet )
+{
+    SCH_REFERENCE_LIST refs = buildReferences();
+    SCH_REFERENCE_LIST additionalRefs = buildAdditionalReferences();
+    SCH_REFERENCE_LIST splitAdditionalRefs = additionalRefs;
+
+    refs.SplitReferences();
+    refs.SortByRefAndValue();
+    splitAdditionalRefs.SplitReferences();
+
+    std::vector<REF_DATA> expected = getData( refs );
+
+    referenceAnnotate( expected, true, 100, 0, REF_DATA_MAP(), getData( splitAdditionalRefs ),
+                       false );
+    refs.Annotate( true, 100, 0, SCH_MULTI_UNIT_REFERENCE_MAP(), additionalRefs );
+
+    checkAnnotation( refs, expected );
+}
+
+
+/**
+ * Reannotate the duplicates, as pasting does: all the units are locked, and references are
+ * annotated from their current number.
+ */
+BOOST_AUTO_TEST_CASE( ReannotateDuplicates )
+{
+    SCH_REFERENCE_LIST refs = buildReferences();
+    SCH_REFERENCE_LIST additionalRefs = buildAdditionalReferences();
+    SCH_REFERENCE_LIST splitRefs = refs;
+    SCH_REFERENCE_LIST splitAdditionalRefs = additionalRefs;
+
+    splitRefs.SplitReferences();
+    splitAdditionalRefs.SplitReferences();
+
+    std::vector<REF_DATA> expected = getData( splitRefs );
+    REF_DATA_MAP          lockedRefs;
+
+    for( size_t ii = 0; ii < refs.GetCount(); ++ii )
+    {
+        wxString refstr = refs[ii].GetSymbol()->GetRef( &refs[ii].GetSheetPath() );
+
+        if( refstr.Last() == '?' )
+            continue;
+
+        lockedRefs[refstr].push_back( expected[ii] );
+        expected[ii].m_IsNew = true;
+    }
+
+    referenceAnnotate( expected, false, 0, 0, lockedRefs, getData( splitAdditionalRefs ), true );
+    refs.ReannotateDuplicates( additionalRefs );
+
+    checkAnnotation( refs, expected );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
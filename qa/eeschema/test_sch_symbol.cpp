@@ -31,6 +31,7 @@
 // Code under test
 #include <sch_symbol.h>
 
+#include <lib_pin.h>
 #include <sch_edit_frame.h>
 
 class TEST_SCH_SYMBOL_FIXTURE
@@ -77,4 +78,37 @@ BOOST_AUTO_TEST_CASE( Orientation )
 }
 
 
+/**
+ * Check that copies of a symbol share its library symbol until one of them changes it.
+ */
+BOOST_AUTO_TEST_CASE( SharedLibSymbol )
+{
+    std::shared_ptr<LIB_SYMBOL> libSymbol = std::make_shared<LIB_SYMBOL>( "part", nullptr );
+    LIB_PIN*                    libPin = new LIB_PIN( libSymbol.get() );
+
+    libPin->SetNumber( "1" );
+    libSymbol->AddDrawItem( libPin );
+
+    m_symbol.SetLibSymbol( libSymbol );
+
+    SCH_SYMBOL copy( m_symbol );
+
+    BOOST_CHECK_EQUAL( copy.GetLibSymbolRef().get(), libSymbol.get() );
+    BOOST_CHECK_EQUAL( copy.GetPin( "1" )->GetLibPin(), libPin );
+
+    LIB_SYMBOL* unique = copy.GetUniqueLibSymbol();
+
+    BOOST_CHECK_NE( unique, libSymbol.get() );
+    BOOST_CHECK_EQUAL( copy.GetLibSymbolRef().get(), unique );
+    BOOST_CHECK_EQUAL( copy.GetPin( "1" )->GetLibPin(), unique->GetPin( "1" ) );
+
+    // The original symbol is left alone
+    BOOST_CHECK_EQUAL( m_symbol.GetLibSymbolRef().get(), libSymbol.get() );
+    BOOST_CHECK_EQUAL( m_symbol.GetPin( "1" )->GetLibPin(), libPin );
+
+    // A symbol which doesn't share its library symbol doesn't copy it
+    BOOST_CHECK_EQUAL( copy.GetUniqueLibSymbol(), unique );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,325 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/check_report.h>
+#include <qa_utils/utility_registry.h>
+
+#include <cstdio>
+#include <iostream>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/textfile.h>
+
+#include <connection_graph.h>
+#include <convert_to_biu.h>
+#include <erc.h>
+#include <erc_settings.h>
+#include <locale_io.h>
+#include <profile.h>
+#include <project.h>
+#include <sch_io_mgr.h>
+#include <sch_marker.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <schematic.h>
+#include <settings/settings_manager.h>
+#include <wildcards_and_files_ext.h>
+
+
+using KI_TEST::CHECK_REPORT;
+using KI_TEST::STDERR_PROGRESS_REPORTER;
+
+
+/**
+ * Load the schematic \a aFileName with its project, and run the ERC on it as the ERC dialog
+ * does.
+ */
+static CHECK_REPORT::FILE_RESULT checkSchematic( const wxString& aFileName,
+                                                 SETTINGS_MANAGER& aSettingsManager,
+                                                 STDERR_PROGRESS_REPORTER& aReporter )
+{
+    CHECK_REPORT::FILE_RESULT result;
+    PROF_COUNTER              timer;
+
+    result.m_File = aFileName;
+
+    wxFileName pro( aFileName );
+    pro.SetExt( ProjectFileExtension );
+    pro.MakeAbsolute();
+
+    aSettingsManager.LoadProject( pro.GetFullPath() );
+
+    PROJECT*    project = &aSettingsManager.Prj();
+    SCHEMATIC   sch( nullptr );
+    SCH_PLUGIN* pi = SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_KICAD );
+
+    project->SetElem( PROJECT::ELEM_SCH_SYMBOL_LIBS, nullptr );
+
+    sch.Reset();
+    sch.SetProject( project );
+
+    try
+    {
+        // Ensure the "C" locale is temporary set, before reading any file
+        LOCALE_IO dummy;
+
+        sch.SetRoot( pi->Load( aFileName, &sch ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        result.m_Error = ioe.What();
+    }
+
+    if( result.m_Error.IsEmpty() && !pi->GetError().IsEmpty() )
+        result.m_Error = pi->GetError();
+
+    if( result.m_Error.IsEmpty() && sch.IsValid() )
+    {
+        sch.CurrentSheet().push_back( &sch.Root() );
+
+        SCH_SCREENS screens( sch.Root() );
+
+        for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+            screen->UpdateLocalLibSymbolLinks();
+
+        SCH_SHEET_LIST sheets = sch.GetSheets();
+
+        // Restore all of the loaded symbol instances from the root sheet screen.
+        sheets.UpdateSymbolInstances( sch.RootScreen()->GetSymbolInstances() );
+        sheets.AnnotatePowerSymbols();
+
+        // Required for multi-unit symbols to be correct
+        for( SCH_SHEET_PATH& sheet : sheets )
+            sheet.UpdateAllScreenReferences();
+
+        aReporter.AdvancePhase( _( "Building connectivity..." ) );
+        sch.ConnectionGraph()->Recalculate( sheets, true );
+
+        // Start from the markers of this run only, as ERC does
+        screens.DeleteAllMarkers( MARKER_BASE::MARKER_ERC, true );
+
+        ERC_TESTER tester( &sch );
+
+        tester.TestAnnotation();
+        tester.RunTests( nullptr, &aReporter );
+
+        // Mark the violations the project excludes, and restore the excluded markers
+        for( SCH_MARKER* marker : sch.ResolveERCExclusions() )
+            sch.RootScreen()->Append( marker );
+
+        ERC_SETTINGS& settings = sch.ErcSettings();
+
+        for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        {
+            for( SCH_ITEM* item : screen->Items().OfType( SCH_MARKER_T ) )
+            {
+                SCH_MARKER* marker = static_cast<SCH_MARKER*>( item );
+                SEVERITY    severity = settings.GetSeverity( marker->GetRCItem()->GetErrorCode() );
+
+                if( marker->GetMarkerType() != MARKER_BASE::MARKER_ERC
+                        || severity == RPT_SEVERITY_IGNORE )
+                {
+                    continue;
+                }
+
+                CHECK_REPORT::VIOLATION violation = CHECK_REPORT::MakeViolation(
+                        *marker->GetRCItem(), severity,
+                        Iu2Millimeter( marker->GetPosition().x ),
+                        Iu2Millimeter( marker->GetPosition().y ),
+                        [&]( const KIID& aId ) -> EDA_ITEM*
+                        {
+                            return sheets.GetItem( aId );
+                        } );
+
+                violation.m_Excluded = marker->IsExcluded();
+                result.m_Violations.push_back( violation );
+            }
+        }
+    }
+    else if( result.m_Error.IsEmpty() )
+    {
+        result.m_Error = _( "The schematic could not be loaded." );
+    }
+
+    sch.Reset();
+    SCH_IO_MGR::ReleasePlugin( pi );
+    aSettingsManager.UnloadProject( project, false );
+
+    result.m_Time = timer.msecs();
+    return result;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "o", "output", _( "the report file, instead of stdout" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "f", "format", _( "the report format: json (default) or junit" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "l", "list",
+            _( "a file listing the schematics to check, one per line, or - for stdin" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_SWITCH, nullptr, "fail-on-warnings",
+            _( "exit with the violations status for warnings too" ).mb_str() },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "schematic files" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum BATCH_ERC_RET_CODES
+{
+    /// Some schematics have violations
+    VIOLATIONS_FOUND = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+
+    /// Some schematics could not be checked
+    CHECK_FAILED,
+
+    /// The report could not be written
+    REPORT_FAILED
+};
+
+
+/**
+ * Append the lines of \a aListFile, or of stdin, to \a aFiles.
+ */
+static bool readFileList( const wxString& aListFile, std::vector<wxString>& aFiles )
+{
+    if( aListFile == wxT( "-" ) )
+    {
+        std::string line;
+
+        while( std::getline( std::cin, line ) )
+        {
+            if( !line.empty() )
+                aFiles.push_back( wxString::FromUTF8( line.c_str() ) );
+        }
+
+        return true;
+    }
+
+    wxTextFile list;
+
+    if( !list.Open( aListFile ) )
+        return false;
+
+    for( size_t ii = 0; ii < list.GetLineCount(); ++ii )
+    {
+        wxString line = list[ii];
+
+        if( !line.Trim().IsEmpty() )
+            aFiles.push_back( line );
+    }
+
+    return true;
+}
+
+
+int batch_erc_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program runs the ERC on the given schematics, in one process, and writes a "
+               "report of the violations found.  The progress is printed on stderr." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    CHECK_REPORT::FORMAT format = CHECK_REPORT::FORMAT::JSON;
+    wxString             value;
+
+    if( cl_parser.Found( "format", &value ) )
+    {
+        if( value == wxT( "junit" ) )
+            format = CHECK_REPORT::FORMAT::JUNIT;
+        else if( value != wxT( "json" ) )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::vector<wxString> files;
+
+    for( size_t ii = 0; ii < cl_parser.GetParamCount(); ++ii )
+        files.push_back( cl_parser.GetParam( ii ) );
+
+    if( cl_parser.Found( "list", &value ) && !readFileList( value, files ) )
+    {
+        fprintf( stderr, "Cannot read %s\n", TO_UTF8( value ) );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    // One settings manager for the whole batch, as starting one is the slow part
+    SETTINGS_MANAGER         settingsManager( true );
+    STDERR_PROGRESS_REPORTER reporter;
+    CHECK_REPORT             report( "erc" );
+
+    // The JUnit report fails the files the exit status fails on
+    if( cl_parser.Found( "fail-on-warnings" ) )
+        report.SetFailSeverity( RPT_SEVERITY_WARNING );
+
+    for( size_t ii = 0; ii < files.size(); ++ii )
+    {
+        reporter.SetPrefix( wxString::Format( "[%d/%d] %s: ", (int) ii + 1, (int) files.size(),
+                                              files[ii] ) );
+
+        report.AddResult( checkSchematic( files[ii], settingsManager, reporter ) );
+
+        const CHECK_REPORT::FILE_RESULT& result = report.GetResults().back();
+
+        if( !result.m_Error.IsEmpty() )
+            reporter.Report( result.m_Error );
+        else
+            reporter.Report( wxString::Format( _( "%d errors, %d warnings" ),
+                                               result.Count( RPT_SEVERITY_ERROR ),
+                                               result.Count( RPT_SEVERITY_WARNING ) ) );
+    }
+
+    if( cl_parser.Found( "output", &value ) )
+    {
+        if( !report.Save( value, format ) )
+            return BATCH_ERC_RET_CODES::REPORT_FAILED;
+    }
+    else
+    {
+        std::cout << report.Format( format );
+    }
+
+    if( report.HasErrors() )
+        return BATCH_ERC_RET_CODES::CHECK_FAILED;
+
+    if( report.HasViolations( report.GetFailSeverity() ) )
+        return BATCH_ERC_RET_CODES::VIOLATIONS_FOUND;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register(
+        { "batch_erc", "Run the ERC on a batch of schematics", batch_erc_main_func } );
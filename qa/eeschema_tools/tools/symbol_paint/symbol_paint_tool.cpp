@@ -0,0 +1,234 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <wx/cmdline.h>
+
+#include <cairo.h>
+
+#include <convert_to_biu.h>
+#include <gal/cairo/cairo_gal.h>
+#include <gal/gal_display_options.h>
+#include <lib_pin.h>
+#include <lib_rectangle.h>
+#include <lib_symbol.h>
+#include <profile.h>
+#include <sch_painter.h>
+#include <sch_view.h>
+
+
+using SYMBOL_PAINT_DURATION = std::chrono::duration<double, std::milli>;
+
+
+/**
+ * A Cairo GAL drawing into an image in memory, so that painting can be timed without a window.
+ */
+class IMAGE_CAIRO_GAL : public KIGFX::CAIRO_GAL_BASE
+{
+public:
+    IMAGE_CAIRO_GAL( KIGFX::GAL_DISPLAY_OPTIONS& aOptions, int aWidth, int aHeight ) :
+            CAIRO_GAL_BASE( aOptions )
+    {
+        m_surface = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, aWidth, aHeight );
+        m_context = m_currentContext = cairo_create( m_surface );
+
+        SetScreenSize( VECTOR2I( aWidth, aHeight ) );
+        SetWorldUnitLength( SCH_WORLD_UNIT );
+        SetZoomFactor( 5.0 );
+        ComputeWorldScreenMatrix();
+        resetContext();
+    }
+};
+
+
+/**
+ * Make a library of \a aParentCount symbols of \a aPinCount pins, with \a aDerivedCount
+ * symbols derived from each, as in libraries of parts which only differ by their value.
+ */
+static void makeLibrary( int aParentCount, int aDerivedCount, int aPinCount,
+                         std::vector<std::unique_ptr<LIB_SYMBOL>>& aParents,
+                         std::vector<std::unique_ptr<LIB_SYMBOL>>& aDerived )
+{
+    const int pitch = Mils2iu( 100 );
+
+    for( int ii = 0; ii < aParentCount; ++ii )
+    {
+        LIB_SYMBOL*    parent = new LIB_SYMBOL( wxString::Format( "PART_%d", ii ) );
+        LIB_RECTANGLE* body = new LIB_RECTANGLE( parent );
+
+        body->MoveTo( wxPoint( -Mils2iu( 300 ), -pitch ) );
+        body->SetEnd( wxPoint( Mils2iu( 300 ), pitch * ( aPinCount / 2 + 1 ) ) );
+        body->SetFillMode( FILL_TYPE::FILLED_WITH_BG_BODYCOLOR );
+        parent->AddDrawItem( body );
+
+        for( int jj = 0; jj < aPinCount; ++jj )
+        {
+            bool     left = jj < aPinCount / 2;
+            int      row = left ? jj : jj - aPinCount / 2;
+            LIB_PIN* pin = new LIB_PIN( parent, wxString::Format( "P%d", jj + 1 ),
+                                        wxString::Format( "%d", jj + 1 ),
+                                        left ? PIN_RIGHT : PIN_LEFT,
+                                        ELECTRICAL_PINTYPE::PT_PASSIVE, pitch * 2,
+                                        Mils2iu( 50 ), Mils2iu( 50 ), 0,
+                                        wxPoint( left ? -Mils2iu( 500 ) : Mils2iu( 500 ),
+                                                 row * pitch ),
+                                        0 );
+
+            parent->AddDrawItem( pin );
+        }
+
+        aParents.emplace_back( parent );
+
+        for( int jj = 0; jj < aDerivedCount; ++jj )
+        {
+            LIB_SYMBOL* derived = new LIB_SYMBOL( wxString::Format( "PART_%d_%d", ii, jj ),
+                                                  parent );
+
+            derived->GetValueField().SetText( derived->GetName() );
+            aDerived.emplace_back( derived );
+        }
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "p", "parents", _( "number of parent symbols (default 50)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "d", "derived",
+            _( "number of symbols derived from each parent (default 20)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "n", "pins", _( "number of pins of each symbol (default 40)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "r", "repeat", _( "number of repaints (default 10)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Repaint the derived symbols of a generated library with the Cairo GAL, as the symbol viewer
+ * does, flattening each symbol for each layer as painting used to, and then from the flattened
+ * symbol cache.  The symbol chooser preview flattens its symbol itself and doesn't use the cache.
+ */
+int symbol_paint_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program benchmarks painting derived library symbols." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long parentCount = 50;
+    long derivedCount = 20;
+    long pinCount = 40;
+    long repeat = 10;
+
+    cl_parser.Found( "parents", &parentCount );
+    cl_parser.Found( "derived", &derivedCount );
+    cl_parser.Found( "pins", &pinCount );
+    cl_parser.Found( "repeat", &repeat );
+
+    std::vector<std::unique_ptr<LIB_SYMBOL>> parents;
+    std::vector<std::unique_ptr<LIB_SYMBOL>> derived;
+
+    makeLibrary( parentCount, derivedCount, pinCount, parents, derived );
+
+    KIGFX::GAL_DISPLAY_OPTIONS options;
+    IMAGE_CAIRO_GAL            gal( options, 1024, 768 );
+    KIGFX::SCH_PAINTER         painter( &gal );
+
+    auto repaint =
+            [&]( bool aFlatten )
+            {
+                KIGFX::GAL_DRAWING_CONTEXT ctx( &gal );
+
+                for( const std::unique_ptr<LIB_SYMBOL>& symbol : derived )
+                {
+                    int layers[KIGFX::VIEW::VIEW_MAX_LAYERS];
+                    int layerCount = 0;
+
+                    symbol->ViewGetLayers( layers, layerCount );
+
+                    for( int ii = 0; ii < layerCount; ++ii )
+                    {
+                        if( aFlatten )
+                            painter.Draw( symbol->Flatten().get(), layers[ii] );
+                        else
+                            painter.Draw( symbol.get(), layers[ii] );
+                    }
+                }
+            };
+
+    SYMBOL_PAINT_DURATION flattenTime{};
+    SYMBOL_PAINT_DURATION cacheTime{};
+
+    for( long ii = 0; ii < repeat; ++ii )
+    {
+        SYMBOL_PAINT_DURATION duration;
+
+        {
+            SCOPED_PROF_COUNTER<SYMBOL_PAINT_DURATION> timer( duration );
+            repaint( true );
+        }
+
+        flattenTime += duration;
+
+        {
+            SCOPED_PROF_COUNTER<SYMBOL_PAINT_DURATION> timer( duration );
+            repaint( false );
+        }
+
+        cacheTime += duration;
+    }
+
+    std::cout << "Derived symbols:  " << derived.size() << std::endl;
+    std::cout << "Flattened:        " << flattenTime.count() / repeat << "ms per repaint"
+              << std::endl;
+    std::cout << "Cached:           " << cacheTime.count() / repeat << "ms per repaint"
+              << std::endl;
+
+    if( cacheTime.count() > 0 )
+        std::cout << "Speedup:          " << flattenTime.count() / cacheTime.count() << std::endl;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "symbol_paint",
+        "Benchmark painting derived library symbols",
+        symbol_paint_main_func,
+} );
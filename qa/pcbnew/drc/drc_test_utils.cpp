@@ -23,6 +23,14 @@
 
 #include "drc_test_utils.h"
 
+#include <wx/filename.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <netinfo.h>
+#include <pcb_track.h>
+#include <drc/drc_engine.h>
+
 
 std::ostream& operator<<( std::ostream& os, const PCB_MARKER& aMarker )
 {
@@ -43,4 +51,38 @@ bool IsDrcMarkerOfType( const PCB_MARKER& aMarker, int aErrorCode )
     return aMarker.GetRCItem()->GetErrorCode() == aErrorCode;
 }
 
+
+DRC_BOARD_FIXTURE::DRC_BOARD_FIXTURE() :
+        m_board( std::make_unique<BOARD>() )
+{
+    m_netA = new NETINFO_ITEM( m_board.get(), "A", 1 );
+    m_netB = new NETINFO_ITEM( m_board.get(), "B", 2 );
+
+    m_board->Add( m_netA );
+    m_board->Add( m_netB );
+
+    m_engine = std::make_shared<DRC_ENGINE>( m_board.get(), &m_board->GetDesignSettings() );
+    m_engine->InitEngine( wxFileName() );
+}
+
+
+DRC_BOARD_FIXTURE::~DRC_BOARD_FIXTURE()
+{
+}
+
+
+PCB_TRACK* DRC_BOARD_FIXTURE::addTrack( NETINFO_ITEM* aNet, int aY )
+{
+    PCB_TRACK* track = new PCB_TRACK( m_board.get() );
+
+    track->SetStart( wxPoint( 0, aY ) );
+    track->SetEnd( wxPoint( Millimeter2iu( 10 ), aY ) );
+    track->SetWidth( Millimeter2iu( 0.25 ) );
+    track->SetLayer( F_Cu );
+    track->SetNet( aNet );
+
+    m_board->Add( track );
+    return track;
+}
+
 } // namespace KI_TEST
\ No newline at end of file
@@ -30,9 +30,15 @@
 #define QA_PCBNEW_DRC_TEST_UTILS__H
 
 #include <iostream>
+#include <memory>
 
 #include <pcb_marker.h>
 
+class BOARD;
+class DRC_ENGINE;
+class NETINFO_ITEM;
+class PCB_TRACK;
+
 /**
  * Define a stream function for logging #PCB_MARKER test assertions.
  *
@@ -58,6 +64,29 @@ namespace KI_TEST
  */
 bool IsDrcMarkerOfType( const PCB_MARKER& aMarker, int aErrorCode );
 
+
+/**
+ * A board with the nets "A" and "B", and a DRC engine with the default rules for it.
+ *
+ * Tests add their tracks with addTrack().
+ */
+struct DRC_BOARD_FIXTURE
+{
+    DRC_BOARD_FIXTURE();
+
+    ~DRC_BOARD_FIXTURE();
+
+    /**
+     * Add a 0.25mm wide track of \a aNet on F_Cu, from ( 0, \a aY ) to ( 10mm, \a aY ).
+     */
+    PCB_TRACK* addTrack( NETINFO_ITEM* aNet, int aY );
+
+    std::unique_ptr<BOARD>      m_board;
+    NETINFO_ITEM*               m_netA;
+    NETINFO_ITEM*               m_netB;
+    std::shared_ptr<DRC_ENGINE> m_engine;
+};
+
 } // namespace KI_TEST
 
 #endif // QA_PCBNEW_DRC_TEST_UTILS__H
\ No newline at end of file
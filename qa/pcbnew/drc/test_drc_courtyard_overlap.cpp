@@ -487,4 +487,40 @@ BOOST_AUTO_TEST_CASE( OverlapCases )
     }
 }
 
+/**
+ * A row of footprints on each side, where each footprint only overlaps its neighbours, so that
+ * most pairs of footprints are far apart.
+ */
+BOOST_AUTO_TEST_CASE( OverlapRows )
+{
+    COURTYARD_OVERLAP_TEST_CASE rows;
+    const int                   count = 40;
+
+    rows.m_case_name = "rows of footprints overlapping their neighbours";
+
+    for( bool front : { true, false } )
+    {
+        for( int ii = 0; ii < count; ++ii )
+        {
+            std::string refdes = ( front ? "F" : "B" ) + std::to_string( ii );
+            VECTOR2I    pos( Millimeter2iu( 0.9 ) * ii, front ? 0 : Millimeter2iu( 10 ) );
+
+            rows.m_fpDefs.push_back( { refdes,
+                                       { { { 0, 0 },
+                                           { Millimeter2iu( 1 ), Millimeter2iu( 1 ) },
+                                           0,
+                                           front } },
+                                       pos } );
+
+            if( ii > 0 )
+            {
+                std::string previous = ( front ? "F" : "B" ) + std::to_string( ii - 1 );
+                rows.m_collisions.push_back( { previous, refdes } );
+            }
+        }
+    }
+
+    DoCourtyardOverlapTest( rows, m_dumper );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include "drc_test_utils.h"
+
+#include <board.h>
+#include <pcb_track.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_incremental.h>
+#include <drc/drc_item.h>
+
+
+/**
+ * Two parallel tracks on different nets, 5mm apart.
+ */
+struct DRC_INCREMENTAL_FIXTURE : public KI_TEST::DRC_BOARD_FIXTURE
+{
+    DRC_INCREMENTAL_FIXTURE()
+    {
+        m_trackA = addTrack( m_netA, 0 );
+        m_trackB = addTrack( m_netB, Millimeter2iu( 5 ) );
+    }
+
+    void moveTrackB( int aY )
+    {
+        m_trackB->SetStart( wxPoint( 0, aY ) );
+        m_trackB->SetEnd( wxPoint( Millimeter2iu( 10 ), aY ) );
+
+        m_board->IncrementTimeStamp();
+        m_board->OnItemChanged( m_trackB );
+    }
+
+    /// @return the clearance violations found by a full DRC run
+    size_t fullRunClearanceViolations()
+    {
+        size_t count = 0;
+
+        m_engine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+                {
+                    if( aItem->GetErrorCode() == DRCE_CLEARANCE )
+                        count++;
+                } );
+
+        m_engine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+        m_engine->ClearViolationHandler();
+
+        return count;
+    }
+
+    PCB_TRACK* m_trackA;
+    PCB_TRACK* m_trackB;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DRCIncremental, DRC_INCREMENTAL_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( MatchesFullRun )
+{
+    DRC_INCREMENTAL incremental( m_board.get(), m_engine );
+    m_board->AddListener( &incremental );
+
+    std::vector<DRC_INCREMENTAL::VIOLATION> found;
+    std::vector<std::shared_ptr<DRC_ITEM>>  withdrawn;
+
+    BOOST_CHECK( !incremental.IsDirty() );
+
+    // Move the second track well within the default clearance of the first one
+    moveTrackB( Millimeter2iu( 0.3 ) );
+    BOOST_CHECK( incremental.IsDirty() );
+
+    incremental.Update( EDA_UNITS::MILLIMETRES, found, withdrawn );
+
+    BOOST_CHECK( !incremental.IsDirty() );
+    BOOST_CHECK( withdrawn.empty() );
+    BOOST_REQUIRE( !found.empty() );
+    BOOST_CHECK_EQUAL( found.size(), fullRunClearanceViolations() );
+
+    for( const DRC_INCREMENTAL::VIOLATION& violation : found )
+    {
+        BOOST_CHECK_EQUAL( violation.item->GetErrorCode(), DRCE_CLEARANCE );
+
+        KIID main = violation.item->GetMainItemID();
+        KIID aux = violation.item->GetAuxItemID();
+
+        BOOST_CHECK( ( main == m_trackA->m_Uuid && aux == m_trackB->m_Uuid )
+                     || ( main == m_trackB->m_Uuid && aux == m_trackA->m_Uuid ) );
+    }
+
+    size_t violationCount = found.size();
+
+    // Moving it back away withdraws the violations without finding new ones
+    found.clear();
+    moveTrackB( Millimeter2iu( 5 ) );
+    incremental.Update( EDA_UNITS::MILLIMETRES, found, withdrawn );
+
+    BOOST_CHECK( found.empty() );
+    BOOST_CHECK_EQUAL( withdrawn.size(), violationCount );
+    BOOST_CHECK_EQUAL( fullRunClearanceViolations(), 0u );
+
+    m_board->RemoveListener( &incremental );
+}
+
+
+BOOST_AUTO_TEST_CASE( RemovedItemsWithdrawViolations )
+{
+    DRC_INCREMENTAL incremental( m_board.get(), m_engine );
+    m_board->AddListener( &incremental );
+
+    std::vector<DRC_INCREMENTAL::VIOLATION> found;
+    std::vector<std::shared_ptr<DRC_ITEM>>  withdrawn;
+
+    moveTrackB( Millimeter2iu( 0.3 ) );
+    incremental.Update( EDA_UNITS::MILLIMETRES, found, withdrawn );
+    BOOST_REQUIRE( !found.empty() );
+
+    size_t violationCount = found.size();
+
+    found.clear();
+    m_board->Remove( m_trackB );
+    std::unique_ptr<PCB_TRACK> removed( m_trackB );
+
+    BOOST_CHECK( incremental.IsDirty() );
+
+    incremental.Update( EDA_UNITS::MILLIMETRES, found, withdrawn );
+
+    BOOST_CHECK( found.empty() );
+    BOOST_CHECK_EQUAL( withdrawn.size(), violationCount );
+
+    m_board->RemoveListener( &incremental );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <nlohmann/json.hpp>
+#include <wx/filename.h>
+
+#include <board.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <drc/drc_profile.h>
+#include <drc/drc_test_provider.h>
+
+#include "drc_test_utils.h"
+
+
+/**
+ * Two tracks too close to each other.
+ */
+struct DRC_PROFILE_FIXTURE : public KI_TEST::DRC_BOARD_FIXTURE
+{
+    DRC_PROFILE_FIXTURE()
+    {
+        addTrack( m_netA, 0 );
+        addTrack( m_netB, Millimeter2iu( 0.3 ) );
+    }
+
+    /// @return the number of violations found by a DRC run
+    int runDRC( DRC_PROFILE& aProfile )
+    {
+        int violations = 0;
+
+        m_engine->SetProfile( &aProfile );
+        m_engine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+                {
+                    violations++;
+                } );
+
+        m_engine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+        m_engine->ClearViolationHandler();
+        m_engine->SetProfile( nullptr );
+
+        return violations;
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DRCProfile, DRC_PROFILE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( ProfilesEveryProvider )
+{
+    DRC_PROFILE profile;
+    int         violations = runDRC( profile );
+
+    BOOST_CHECK( !profile.IsRunning() );
+    BOOST_CHECK( m_engine->GetProfile() == nullptr );
+
+    std::vector<wxString> expected = { wxT( "setup" ) };
+
+    for( DRC_TEST_PROVIDER* provider : m_engine->GetTestProviders() )
+    {
+        if( provider->IsEnabled() )
+            expected.push_back( provider->GetName() );
+    }
+
+    BOOST_REQUIRE_EQUAL( profile.GetProviders().size(), expected.size() );
+
+    DRC_PROFILE::COUNTS sum;
+
+    for( size_t ii = 0; ii < expected.size(); ++ii )
+    {
+        const DRC_PROFILE::PROVIDER& provider = profile.GetProviders()[ii];
+
+        BOOST_CHECK_EQUAL( provider.m_Name, expected[ii] );
+        BOOST_CHECK_LE( provider.m_Time, profile.GetTime() );
+
+        sum.m_EvalRules += provider.m_Counts.m_EvalRules;
+        sum.m_RTreeQueries += provider.m_Counts.m_RTreeQueries;
+        sum.m_Violations += provider.m_Counts.m_Violations;
+    }
+
+    BOOST_CHECK_GT( violations, 0 );
+    BOOST_CHECK_EQUAL( profile.GetCounts().m_Violations, violations );
+    BOOST_CHECK_EQUAL( sum.m_Violations, violations );
+
+    BOOST_CHECK_GT( profile.GetCounts().m_EvalRules, 0 );
+    BOOST_CHECK_EQUAL( sum.m_EvalRules, profile.GetCounts().m_EvalRules );
+
+    BOOST_CHECK_GT( profile.GetCounts().m_RTreeQueries, 0 );
+    BOOST_CHECK_EQUAL( sum.m_RTreeQueries, profile.GetCounts().m_RTreeQueries );
+
+    int64_t ruleEvaluations = 0;
+
+    for( const DRC_PROFILE::RULE& rule : profile.GetRules() )
+        ruleEvaluations += rule.m_Evaluations;
+
+    BOOST_CHECK_GT( ruleEvaluations, 0 );
+    BOOST_CHECK_LE( ruleEvaluations, profile.GetCounts().m_EvalRules );
+}
+
+
+BOOST_AUTO_TEST_CASE( CountsAreDeterministic )
+{
+    DRC_PROFILE first;
+    DRC_PROFILE second;
+
+    runDRC( first );
+    runDRC( second );
+
+    BOOST_REQUIRE_EQUAL( first.GetProviders().size(), second.GetProviders().size() );
+
+    for( size_t ii = 0; ii < first.GetProviders().size(); ++ii )
+    {
+        const DRC_PROFILE::COUNTS& a = first.GetProviders()[ii].m_Counts;
+        const DRC_PROFILE::COUNTS& b = second.GetProviders()[ii].m_Counts;
+
+        BOOST_CHECK_EQUAL( a.m_EvalRules, b.m_EvalRules );
+        BOOST_CHECK_EQUAL( a.m_RTreeQueries, b.m_RTreeQueries );
+        BOOST_CHECK_EQUAL( a.m_PolygonOps, b.m_PolygonOps );
+        BOOST_CHECK_EQUAL( a.m_Violations, b.m_Violations );
+    }
+
+    BOOST_REQUIRE_EQUAL( first.GetRules().size(), second.GetRules().size() );
+
+    for( size_t ii = 0; ii < first.GetRules().size(); ++ii )
+    {
+        BOOST_CHECK_EQUAL( first.GetRules()[ii].m_Name, second.GetRules()[ii].m_Name );
+        BOOST_CHECK_EQUAL( first.GetRules()[ii].m_Evaluations,
+                           second.GetRules()[ii].m_Evaluations );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( CountsBelongToTheProfile )
+{
+    DRC_PROFILE profile;
+
+    runDRC( profile );
+
+    DRC_PROFILE::COUNTS counts = profile.GetCounts();
+
+    // Neither a run without a profile nor a run with another one counts in this one
+    m_engine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+    DRC_PROFILE other;
+    runDRC( other );
+
+    BOOST_CHECK_EQUAL( profile.GetCounts().m_RTreeQueries, counts.m_RTreeQueries );
+    BOOST_CHECK_EQUAL( profile.GetCounts().m_PolygonOps, counts.m_PolygonOps );
+    BOOST_CHECK_EQUAL( other.GetCounts().m_RTreeQueries, counts.m_RTreeQueries );
+}
+
+
+BOOST_AUTO_TEST_CASE( FormatsJSON )
+{
+    DRC_PROFILE profile;
+
+    runDRC( profile );
+
+    nlohmann::json js = nlohmann::json::parse( profile.Format() );
+
+    BOOST_CHECK_EQUAL( js.at( "version" ).get<int>(), 1 );
+    BOOST_CHECK_EQUAL( js.at( "providers" ).size(), profile.GetProviders().size() );
+    BOOST_CHECK_EQUAL( js.at( "rules" ).size(), profile.GetRules().size() );
+    BOOST_CHECK_EQUAL( js.at( "counts" ).at( "evalRules" ).get<int64_t>(),
+                       profile.GetCounts().m_EvalRules );
+    BOOST_CHECK_EQUAL( js.at( "providers" ).at( 0 ).at( "name" ).get<std::string>(), "setup" );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
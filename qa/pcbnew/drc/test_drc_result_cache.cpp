@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <algorithm>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <netclass.h>
+#include <pcb_track.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <drc/drc_result_cache.h>
+
+#include "drc_test_utils.h"
+
+
+/**
+ * Two tracks too close to each other, and a third one far away.
+ */
+struct DRC_RESULT_CACHE_FIXTURE : public KI_TEST::DRC_BOARD_FIXTURE
+{
+    DRC_RESULT_CACHE_FIXTURE()
+    {
+        addTrack( m_netA, 0 );
+        addTrack( m_netB, Millimeter2iu( 0.3 ) );
+        m_farTrack = addTrack( m_netB, Millimeter2iu( 5 ) );
+    }
+
+    /// @return the error messages and items of the violations found by a DRC run
+    std::vector<wxString> runDRC( DRC_RESULT_CACHE* aCache )
+    {
+        std::vector<wxString> violations;
+
+        m_engine->SetResultCache( aCache );
+        m_engine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+                {
+                    violations.push_back( wxString::Format( "%d %s %s %s %d %d",
+                                                            aItem->GetErrorCode(),
+                                                            aItem->GetErrorMessage(),
+                                                            aItem->GetMainItemID().AsString(),
+                                                            aItem->GetAuxItemID().AsString(),
+                                                            aPos.x, aPos.y ) );
+                } );
+
+        m_engine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+        m_engine->ClearViolationHandler();
+        m_engine->SetResultCache( nullptr );
+
+        std::sort( violations.begin(), violations.end() );
+        return violations;
+    }
+
+    PCB_TRACK* m_farTrack;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DRCResultCache, DRC_RESULT_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( ReusesUnchangedChecks )
+{
+    DRC_RESULT_CACHE      cache;
+    std::vector<wxString> expected = runDRC( nullptr );
+
+    BOOST_REQUIRE( !expected.empty() );
+
+    BOOST_CHECK( runDRC( &cache ) == expected );
+    BOOST_CHECK_EQUAL( cache.GetReusedCount(), 0 );
+
+    int checkCount = cache.GetRecomputedCount();
+    BOOST_REQUIRE_GT( checkCount, 0 );
+
+    // Nothing changed: the violations come from the cache
+    BOOST_CHECK( runDRC( &cache ) == expected );
+    BOOST_CHECK_EQUAL( cache.GetReusedCount(), checkCount );
+    BOOST_CHECK_EQUAL( cache.GetRecomputedCount(), 0 );
+
+    // Moving a track next to the others only checks it again
+    m_farTrack->Move( wxPoint( 0, -Millimeter2iu( 4.4 ) ) );
+
+    std::vector<wxString> moved = runDRC( nullptr );
+
+    BOOST_CHECK( runDRC( &cache ) == moved );
+    BOOST_CHECK_GT( cache.GetReusedCount(), 0 );
+    BOOST_CHECK_GT( cache.GetRecomputedCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( PersistsAcrossSessions )
+{
+    wxFileName cacheFile( wxFileName::CreateTempFileName( "drc-cache" ) );
+
+    std::vector<wxString> expected;
+
+    {
+        DRC_RESULT_CACHE cache;
+
+        expected = runDRC( &cache );
+        BOOST_CHECK( cache.Save( cacheFile.GetFullPath() ) );
+    }
+
+    DRC_RESULT_CACHE cache;
+
+    BOOST_CHECK( cache.Load( cacheFile.GetFullPath() ) );
+    BOOST_CHECK( runDRC( &cache ) == expected );
+    BOOST_CHECK_GT( cache.GetReusedCount(), 0 );
+    BOOST_CHECK_EQUAL( cache.GetRecomputedCount(), 0 );
+
+    wxRemoveFile( cacheFile.GetFullPath() );
+}
+
+
+BOOST_AUTO_TEST_CASE( ChangedRulesDiscardResults )
+{
+    DRC_RESULT_CACHE cache;
+
+    runDRC( &cache );
+
+    m_board->GetDesignSettings().GetDefault()->SetClearance( Millimeter2iu( 0.1 ) );
+    m_engine->InitEngine( wxFileName() );
+
+    std::vector<wxString> expected = runDRC( nullptr );
+
+    BOOST_CHECK( runDRC( &cache ) == expected );
+    BOOST_CHECK_EQUAL( cache.GetReusedCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( BoardDependentRulesDisableReuse )
+{
+    wxFileName rulesFile( wxFileName::CreateTempFileName( "drc-rules" ) );
+
+    {
+        wxFFile file( rulesFile.GetFullPath(), "w" );
+
+        file.Write( "(version 1)\n"
+                    "(rule \"path\"\n"
+                    "    (condition \"A.fromTo('U1-1', 'U2-1')\")\n"
+                    "    (constraint clearance (min 1mm)))\n" );
+    }
+
+    m_engine->InitEngine( rulesFile );
+
+    DRC_RESULT_CACHE      cache;
+    std::vector<wxString> expected = runDRC( nullptr );
+
+    BOOST_CHECK( runDRC( &cache ) == expected );
+    BOOST_CHECK( runDRC( &cache ) == expected );
+    BOOST_CHECK_EQUAL( cache.GetReusedCount(), 0 );
+
+    wxRemoveFile( rulesFile.GetFullPath() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
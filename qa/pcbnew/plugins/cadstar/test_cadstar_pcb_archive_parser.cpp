@@ -0,0 +1,104 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_cadstar_pcb_archive_parser.cpp
+ * Test suite for #CADSTAR_PCB_ARCHIVE_PARSER
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <plugins/cadstar/cadstar_pcb_archive_parser.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+struct CADSTAR_PCB_ARCHIVE_PARSER_FIXTURE
+{
+    CADSTAR_PCB_ARCHIVE_PARSER_FIXTURE()
+    {
+        m_fileName = wxFileName::CreateTempFileName( "cadstar_pcb_archive_parser" );
+    }
+
+    ~CADSTAR_PCB_ARCHIVE_PARSER_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    /**
+     * Write an archive holding a header and a layout made of \a aLayout.
+     */
+    void WriteArchive( const wxString& aLayout )
+    {
+        wxFFile file( m_fileName, "wb" );
+
+        file.Write( wxT( "(CADSTARPCB\n"
+                         "(HEADER (FORMAT LAYOUT 0 1) (RESOLUTION (METRIC HUNDREDTH MICRON)))\n"
+                         "(LAYOUT\n" )
+                    + aLayout
+                    + wxT( "))\n" ) );
+    }
+
+    wxString m_fileName;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( CadstarPcbArchiveParser, CADSTAR_PCB_ARCHIVE_PARSER_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( SingleSections )
+{
+    WriteArchive( wxT( "(NETSYNCH FULL)\n(DIMENSIONS)\n" ) );
+
+    CADSTAR_PCB_ARCHIVE_PARSER parser( m_fileName );
+
+    BOOST_CHECK_NO_THROW( parser.Parse() );
+    BOOST_CHECK( parser.Layout.NetSynch == CADSTAR_PCB_ARCHIVE_PARSER::NETSYNCH::FULL );
+}
+
+
+/**
+ * The layout is parsed one element at a time, which must still find the sections which may
+ * only appear once but are duplicated.
+ */
+BOOST_AUTO_TEST_CASE( DuplicatedNetSynch )
+{
+    WriteArchive( wxT( "(NETSYNCH FULL)\n(NETSYNCH WARNING)\n" ) );
+
+    CADSTAR_PCB_ARCHIVE_PARSER parser( m_fileName );
+
+    BOOST_CHECK_THROW( parser.Parse(), IO_ERROR );
+}
+
+
+BOOST_AUTO_TEST_CASE( DuplicatedDimensions )
+{
+    WriteArchive( wxT( "(DIMENSIONS)\n(DIMENSIONS)\n" ) );
+
+    CADSTAR_PCB_ARCHIVE_PARSER parser( m_fileName );
+
+    BOOST_CHECK_THROW( parser.Parse(), IO_ERROR );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <board.h>
+#include <board_outline.h>
+#include <pcb_shape.h>
+#include <geometry/shape_poly_set.h>
+#include <convert_drawsegment_list_to_polygon.h>
+
+
+/**
+ * Add a closed square of side aSize, centred on the origin, to the board as aCount segments
+ * per side on Edge.Cuts.  The segments are added in a shuffled order so that chaining can't
+ * rely on the list order.
+ */
+static void AddSquareOutline( BOARD& aBoard, int aSize, int aCount, unsigned aSeed )
+{
+    std::vector<PCB_SHAPE*> shapes;
+    int                     half = aSize / 2;
+    int                     step = aSize / aCount;
+
+    const wxPoint corners[] = { wxPoint( -half, -half ), wxPoint( half, -half ),
+                                wxPoint( half, half ), wxPoint( -half, half ) };
+
+    for( int side = 0; side < 4; ++side )
+    {
+        wxPoint start = corners[side];
+        wxPoint dir = corners[( side + 1 ) % 4] - start;
+
+        dir.x = ( dir.x > 0 ) - ( dir.x < 0 );
+        dir.y = ( dir.y > 0 ) - ( dir.y < 0 );
+
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            PCB_SHAPE* shape = new PCB_SHAPE( &aBoard );
+
+            shape->SetShape( PCB_SHAPE_TYPE::SEGMENT );
+            shape->SetLayer( Edge_Cuts );
+            shape->SetStart( start + dir * ( ii * step ) );
+            shape->SetEnd( ii == aCount - 1 ? corners[( side + 1 ) % 4]
+                                            : start + dir * ( ( ii + 1 ) * step ) );
+            shapes.push_back( shape );
+        }
+    }
+
+    std::shuffle( shapes.begin(), shapes.end(), std::mt19937( aSeed ) );
+
+    for( PCB_SHAPE* shape : shapes )
+        aBoard.Add( shape );
+}
+
+
+BOOST_AUTO_TEST_SUITE( BoardOutline )
+
+
+/**
+ * An outline made of many small segments, with a hole, chains to a single polygon.
+ */
+BOOST_AUTO_TEST_CASE( ChainManySegments )
+{
+    BOARD board;
+
+    AddSquareOutline( board, Millimeter2iu( 100 ), 500, 1 );
+    AddSquareOutline( board, Millimeter2iu( 10 ), 50, 2 );
+
+    SHAPE_POLY_SET outline;
+    int            errors = 0;
+
+    OUTLINE_ERROR_HANDLER errorHandler =
+            [&]( const wxString& msg, BOARD_ITEM* itemA, BOARD_ITEM* itemB, const wxPoint& pt )
+            {
+                errors++;
+            };
+
+    BOOST_CHECK( board.GetBoardPolygonOutlines( outline, &errorHandler ) );
+    BOOST_CHECK_EQUAL( errors, 0 );
+    BOOST_REQUIRE_EQUAL( outline.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( outline.HoleCount( 0 ), 1 );
+
+    double expectedArea = pow( Millimeter2iu( 100 ), 2 ) - pow( Millimeter2iu( 10 ), 2 );
+    BOOST_CHECK_CLOSE( outline.Area(), expectedArea, 1e-6 );
+}
+
+
+/**
+ * A gap larger than the chaining epsilon is reported, and doesn't get cached.
+ */
+BOOST_AUTO_TEST_CASE( OpenOutline )
+{
+    BOARD board;
+
+    AddSquareOutline( board, Millimeter2iu( 20 ), 20, 3 );
+
+    PCB_SHAPE* moved = static_cast<PCB_SHAPE*>( board.Drawings().front() );
+    moved->SetEnd( moved->GetEnd() + wxPoint( Millimeter2iu( 0.1 ), 0 ) );
+
+    SHAPE_POLY_SET outline;
+    int            errors = 0;
+
+    OUTLINE_ERROR_HANDLER errorHandler =
+            [&]( const wxString& msg, BOARD_ITEM* itemA, BOARD_ITEM* itemB, const wxPoint& pt )
+            {
+                errors++;
+            };
+
+    BOOST_CHECK( !board.GetBoardPolygonOutlines( outline, &errorHandler ) );
+    BOOST_CHECK_GT( errors, 0 );
+    BOOST_CHECK( !board.GetBoardPolygonOutlines( outline ) );
+}
+
+
+/**
+ * The cached outline follows changes to the Edge.Cuts graphics.
+ */
+BOOST_AUTO_TEST_CASE( OutlineCache )
+{
+    BOARD board;
+
+    AddSquareOutline( board, Millimeter2iu( 20 ), 4, 4 );
+
+    SHAPE_POLY_SET first;
+    SHAPE_POLY_SET second;
+
+    BOOST_CHECK( board.GetBoardPolygonOutlines( first ) );
+    BOOST_CHECK( board.GetBoardPolygonOutlines( second ) );
+    BOOST_CHECK_EQUAL( first.Area(), second.Area() );
+
+    // Grow the board by moving every edge outwards
+    for( BOARD_ITEM* item : board.Drawings() )
+    {
+        PCB_SHAPE* shape = static_cast<PCB_SHAPE*>( item );
+
+        shape->SetStart( shape->GetStart() * 2 );
+        shape->SetEnd( shape->GetEnd() * 2 );
+    }
+
+    BOOST_CHECK( board.GetBoardPolygonOutlines( second ) );
+    BOOST_CHECK_CLOSE( second.Area(), first.Area() * 4, 1e-6 );
+}
+
+
+/**
+ * Back to back users share one outline, which can tell points on the board from points off it
+ * or in a hole.
+ */
+BOOST_AUTO_TEST_CASE( SharedOutline )
+{
+    BOARD board;
+
+    AddSquareOutline( board, Millimeter2iu( 100 ), 500, 5 );
+    AddSquareOutline( board, Millimeter2iu( 10 ), 50, 6 );
+
+    std::shared_ptr<const BOARD_OUTLINE> outline = board.GetBoardOutline();
+
+    BOOST_REQUIRE( outline );
+    BOOST_CHECK( board.GetBoardOutline() == outline );
+    BOOST_CHECK( outline->Polygons().IsTriangulationUpToDate() );
+
+    std::mt19937                       rng( 7 );
+    std::uniform_int_distribution<int> coord( Millimeter2iu( -60 ), Millimeter2iu( 60 ) );
+
+    for( int ii = 0; ii < 10000; ++ii )
+    {
+        VECTOR2I pt( coord( rng ), coord( rng ) );
+
+        BOOST_CHECK_EQUAL( outline->Contains( pt ), outline->Polygons().Contains( pt ) );
+    }
+
+    // A change to Edge.Cuts gives a new outline, and leaves the old one as it was
+    for( BOARD_ITEM* item : board.Drawings() )
+        item->Move( wxPoint( Millimeter2iu( 20 ), 0 ) );
+
+    std::shared_ptr<const BOARD_OUTLINE> moved = board.GetBoardOutline();
+    VECTOR2I                             pt( Millimeter2iu( 60 ), 0 );
+
+    BOOST_REQUIRE( moved );
+    BOOST_CHECK( moved != outline );
+    BOOST_CHECK( moved->Contains( pt ) );
+    BOOST_CHECK( !outline->Contains( pt ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,178 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <netinfo.h>
+#include <pcb_track.h>
+#include <connectivity/diff_pair_coupling_cache.h>
+
+
+using COUPLED_SEGMENTS = DIFF_PAIR_COUPLING_CACHE::COUPLED_SEGMENTS;
+
+
+/**
+ * A pair of nets routed side by side on F_Cu, then on B_Cu.
+ */
+struct DIFF_PAIR_COUPLING_CACHE_FIXTURE
+{
+    DIFF_PAIR_COUPLING_CACHE_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+
+        m_netP = new NETINFO_ITEM( m_board.get(), "CLK_P", 1 );
+        m_netN = new NETINFO_ITEM( m_board.get(), "CLK_N", 2 );
+        m_board->Add( m_netP );
+        m_board->Add( m_netN );
+
+        const int gap = Millimeter2iu( 0.2 );
+        const int run = Millimeter2iu( 10 );
+
+        for( PCB_LAYER_ID layer : { F_Cu, B_Cu } )
+        {
+            int x = ( layer == F_Cu ) ? 0 : run;
+
+            m_allP.insert( addTrack( m_netP, layer, wxPoint( x, 0 ), wxPoint( x + run, 0 ) ) );
+            m_allN.insert( addTrack( m_netN, layer, wxPoint( x, gap ), wxPoint( x + run, gap ) ) );
+        }
+
+        for( BOARD_CONNECTED_ITEM* item : m_allP )
+        {
+            if( item->GetLayer() == F_Cu )
+                m_frontP.insert( item );
+        }
+
+        for( BOARD_CONNECTED_ITEM* item : m_allN )
+        {
+            if( item->GetLayer() == F_Cu )
+                m_frontN.insert( item );
+        }
+    }
+
+    PCB_TRACK* addTrack( NETINFO_ITEM* aNet, PCB_LAYER_ID aLayer, const wxPoint& aStart,
+                         const wxPoint& aEnd )
+    {
+        PCB_TRACK* track = new PCB_TRACK( m_board.get() );
+
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetWidth( Millimeter2iu( 0.1 ) );
+        track->SetLayer( aLayer );
+        track->SetNet( aNet );
+
+        m_board->Add( track );
+        return track;
+    }
+
+    /**
+     * Check that the cache returns the same segments as pairing \a aItemsP and \a aItemsN
+     * without it.
+     */
+    void checkMatchesUncached( const std::set<BOARD_CONNECTED_ITEM*>& aItemsP,
+                               const std::set<BOARD_CONNECTED_ITEM*>& aItemsN )
+    {
+        std::vector<COUPLED_SEGMENTS> expected =
+                DIFF_PAIR_COUPLING_CACHE::FindCoupledSegments( aItemsP, aItemsN );
+        std::vector<COUPLED_SEGMENTS> cached =
+                m_cache.GetCoupledSegments( m_netP->GetNetCode(), m_netN->GetNetCode(), aItemsP,
+                                            aItemsN );
+
+        BOOST_CHECK( !expected.empty() );
+        BOOST_CHECK( cached == expected );
+    }
+
+    std::unique_ptr<BOARD>          m_board;
+    NETINFO_ITEM*                   m_netP;
+    NETINFO_ITEM*                   m_netN;
+    std::set<BOARD_CONNECTED_ITEM*> m_allP;
+    std::set<BOARD_CONNECTED_ITEM*> m_allN;
+    std::set<BOARD_CONNECTED_ITEM*> m_frontP;
+    std::set<BOARD_CONNECTED_ITEM*> m_frontN;
+    DIFF_PAIR_COUPLING_CACHE        m_cache;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DiffPairCouplingCache, DIFF_PAIR_COUPLING_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( MatchesUncached )
+{
+    checkMatchesUncached( m_allP, m_allN );
+    BOOST_CHECK_EQUAL( m_cache.GetComputedCount(), 1 );
+    BOOST_CHECK_EQUAL( m_cache.GetReusedCount(), 0 );
+
+    checkMatchesUncached( m_allP, m_allN );
+    BOOST_CHECK_EQUAL( m_cache.GetComputedCount(), 1 );
+    BOOST_CHECK_EQUAL( m_cache.GetReusedCount(), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( RulesSelectingDifferentTracks )
+{
+    // Two rules matching the same pair of nets, one of them only on F_Cu
+    checkMatchesUncached( m_allP, m_allN );
+    checkMatchesUncached( m_frontP, m_frontN );
+    BOOST_CHECK_EQUAL( m_cache.GetComputedCount(), 2 );
+
+    // Looking up either set doesn't drop the other
+    checkMatchesUncached( m_allP, m_allN );
+    checkMatchesUncached( m_frontP, m_frontN );
+    BOOST_CHECK_EQUAL( m_cache.GetComputedCount(), 2 );
+    BOOST_CHECK_EQUAL( m_cache.GetReusedCount(), 2 );
+}
+
+
+BOOST_AUTO_TEST_CASE( MovedTracksArePairedAgain )
+{
+    checkMatchesUncached( m_frontP, m_frontN );
+
+    // Shorten the N track, which shortens the coupled part of both
+    PCB_TRACK* track = static_cast<PCB_TRACK*>( *m_frontN.begin() );
+    track->SetEnd( track->GetEnd() - wxPoint( Millimeter2iu( 5 ), 0 ) );
+
+    checkMatchesUncached( m_frontP, m_frontN );
+    BOOST_CHECK_EQUAL( m_cache.GetComputedCount(), 2 );
+    BOOST_CHECK_EQUAL( m_cache.GetReusedCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( DropsPairsNotLookedUp )
+{
+    checkMatchesUncached( m_allP, m_allN );
+    checkMatchesUncached( m_frontP, m_frontN );
+
+    // Both were looked up, so both are kept
+    m_cache.DropUnused();
+    checkMatchesUncached( m_allP, m_allN );
+    BOOST_CHECK_EQUAL( m_cache.GetReusedCount(), 1 );
+
+    // Only the first one was looked up since, so the second one is dropped and paired again
+    m_cache.DropUnused();
+    checkMatchesUncached( m_allP, m_allN );
+    checkMatchesUncached( m_frontP, m_frontN );
+    BOOST_CHECK_EQUAL( m_cache.GetReusedCount(), 2 );
+    BOOST_CHECK_EQUAL( m_cache.GetComputedCount(), 3 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
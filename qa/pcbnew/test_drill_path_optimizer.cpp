@@ -0,0 +1,154 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <random>
+
+#include <exporters/drill_path_optimizer.h>
+
+
+/**
+ * Make aCount random holes on a 100 x 100 mm board, sorted by X then Y as the drill writers
+ * sort them.
+ */
+static std::vector<wxPoint> RandomHoles( int aCount, unsigned aSeed )
+{
+    std::mt19937                       rng( aSeed );
+    std::uniform_int_distribution<int> coord( 0, 100000000 );
+    std::vector<wxPoint>               holes;
+
+    for( int ii = 0; ii < aCount; ++ii )
+        holes.emplace_back( coord( rng ), coord( rng ) );
+
+    std::sort( holes.begin(), holes.end(),
+               []( const wxPoint& a, const wxPoint& b )
+               {
+                   return a.x != b.x ? a.x < b.x : a.y < b.y;
+               } );
+
+    return holes;
+}
+
+
+static std::vector<wxPoint> Reorder( const std::vector<wxPoint>& aHoles,
+                                     const std::vector<int>& aOrder )
+{
+    std::vector<wxPoint> reordered;
+
+    for( int index : aOrder )
+        reordered.push_back( aHoles[index] );
+
+    return reordered;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DrillPathOptimizer )
+
+
+/**
+ * The result is an order of all the holes, each drilled once.
+ */
+BOOST_AUTO_TEST_CASE( AllHolesOnce )
+{
+    for( int count : { 0, 1, 2, 3, 10, 1000 } )
+    {
+        BOOST_TEST_CONTEXT( count << " holes" )
+        {
+            std::vector<wxPoint> holes = RandomHoles( count, count );
+            std::vector<int>     order = DRILL_PATH_OPTIMIZER( wxPoint( 0, 0 ), holes ).Optimize();
+
+            std::sort( order.begin(), order.end() );
+
+            std::vector<int> expected( count );
+
+            for( int ii = 0; ii < count; ++ii )
+                expected[ii] = ii;
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( order.begin(), order.end(), expected.begin(),
+                                           expected.end() );
+        }
+    }
+}
+
+
+/**
+ * Random holes need far less travel than in X then Y order, and the same input always gives
+ * the same path.
+ */
+BOOST_AUTO_TEST_CASE( ShorterAndDeterministic )
+{
+    std::vector<wxPoint> holes = RandomHoles( 5000, 1 );
+    std::vector<int>     order = DRILL_PATH_OPTIMIZER( wxPoint( 0, 0 ), holes ).Optimize();
+
+    double before = DRILL_PATH_OPTIMIZER::PathLength( wxPoint( 0, 0 ), holes );
+    double after = DRILL_PATH_OPTIMIZER::PathLength( wxPoint( 0, 0 ), Reorder( holes, order ) );
+
+    BOOST_CHECK_LT( after, before / 10 );
+
+    BOOST_CHECK( DRILL_PATH_OPTIMIZER( wxPoint( 0, 0 ), holes ).Optimize() == order );
+}
+
+
+/**
+ * Holes on a grid can be drilled row by row, back and forth, which is the shortest path.
+ */
+BOOST_AUTO_TEST_CASE( Grid )
+{
+    const int            size = 30;
+    const int            pitch = 1000000;
+    std::vector<wxPoint> holes;
+
+    for( int x = 0; x < size; ++x )
+    {
+        for( int y = 0; y < size; ++y )
+            holes.emplace_back( x * pitch, y * pitch );
+    }
+
+    std::vector<int> order = DRILL_PATH_OPTIMIZER( wxPoint( 0, 0 ), holes ).Optimize();
+    double after = DRILL_PATH_OPTIMIZER::PathLength( wxPoint( 0, 0 ), Reorder( holes, order ) );
+
+    // A few diagonal steps at most
+    BOOST_CHECK_LT( after, ( size * size - 1 ) * pitch * 1.02 );
+}
+
+
+/**
+ * An order which cannot be improved is kept.
+ */
+BOOST_AUTO_TEST_CASE( NeverLonger )
+{
+    std::vector<wxPoint> holes;
+
+    for( int ii = 0; ii < 100; ++ii )
+        holes.emplace_back( ii * 1000, 0 );
+
+    std::vector<int> order = DRILL_PATH_OPTIMIZER( wxPoint( 0, 0 ), holes ).Optimize();
+
+    for( int ii = 0; ii < 100; ++ii )
+        BOOST_CHECK_EQUAL( order[ii], ii );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <footprint.h>
+#include <netinfo.h>
+#include <pad.h>
+#include <pcb_track.h>
+#include <connectivity/from_to_cache.h>
+
+
+/**
+ * Two footprints U1 and U2 of one pad each, joined by two tracks with a stub track off their
+ * middle point.
+ */
+struct FROM_TO_CACHE_FIXTURE
+{
+    FROM_TO_CACHE_FIXTURE()
+    {
+        m_board = std::make_unique<BOARD>();
+
+        m_net = new NETINFO_ITEM( m_board.get(), "A", 1 );
+        m_board->Add( m_net );
+
+        addFootprint( "U1", wxPoint( 0, 0 ) );
+        addFootprint( "U2", wxPoint( Millimeter2iu( 20 ), 0 ) );
+
+        m_trackA = addTrack( wxPoint( 0, 0 ), wxPoint( Millimeter2iu( 10 ), 0 ) );
+        m_trackB = addTrack( wxPoint( Millimeter2iu( 10 ), 0 ), wxPoint( Millimeter2iu( 20 ), 0 ) );
+        m_stub = addTrack( wxPoint( Millimeter2iu( 10 ), 0 ),
+                           wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 5 ) ) );
+    }
+
+    void addFootprint( const wxString& aReference, const wxPoint& aPos )
+    {
+        FOOTPRINT* footprint = new FOOTPRINT( m_board.get() );
+        PAD*       pad = new PAD( footprint );
+
+        footprint->SetReference( aReference );
+        footprint->SetPosition( aPos );
+
+        pad->SetName( "1" );
+        pad->SetAttribute( PAD_ATTRIB::SMD );
+        pad->SetLayerSet( PAD::SMDMask() );
+        pad->SetShape( PAD_SHAPE::RECT );
+        pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+        pad->SetPosition( aPos );
+        pad->SetNet( m_net );
+
+        footprint->Add( pad );
+        m_board->Add( footprint );
+    }
+
+    PCB_TRACK* addTrack( const wxPoint& aStart, const wxPoint& aEnd )
+    {
+        PCB_TRACK* track = new PCB_TRACK( m_board.get() );
+
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNet( m_net );
+
+        m_board->Add( track );
+        return track;
+    }
+
+    /// @return a cache of the paths of the board, with its connectivity up to date
+    FROM_TO_CACHE& rebuild()
+    {
+        m_board->BuildConnectivity();
+        m_cache.Rebuild( m_board.get() );
+        return m_cache;
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    NETINFO_ITEM*          m_net;
+    PCB_TRACK*             m_trackA;
+    PCB_TRACK*             m_trackB;
+    PCB_TRACK*             m_stub;
+    FROM_TO_CACHE          m_cache;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FromToCache, FROM_TO_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( FindsPath )
+{
+    FROM_TO_CACHE& cache = rebuild();
+
+    BOOST_CHECK( cache.IsOnFromToPath( m_trackA, "U1-1", "U2-1" ) );
+    BOOST_CHECK( cache.IsOnFromToPath( m_trackB, "U1-1", "U2-1" ) );
+    BOOST_CHECK( !cache.IsOnFromToPath( m_stub, "U1-1", "U2-1" ) );
+
+    // No pad of U3, so no path
+    BOOST_CHECK( !cache.IsOnFromToPath( m_trackA, "U1-1", "U3-1" ) );
+
+    std::set<BOARD_CONNECTED_ITEM*> items;
+
+    for( PAD* pad : m_board->Footprints().front()->Pads() )
+        items.insert( pad );
+
+    for( PAD* pad : m_board->Footprints().back()->Pads() )
+        items.insert( pad );
+
+    items.insert( m_trackA );
+    items.insert( m_trackB );
+
+    FROM_TO_CACHE::FT_PATH* path = cache.QueryFromToPath( items );
+
+    BOOST_REQUIRE( path != nullptr );
+    BOOST_CHECK( path->isUnique );
+    BOOST_CHECK_EQUAL( path->fromName, "U1-1" );
+    BOOST_CHECK_EQUAL( path->toName, "U2-1" );
+
+    items.insert( m_stub );
+    BOOST_CHECK( cache.QueryFromToPath( items ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_CASE( FindsMultiplePaths )
+{
+    // A second route of the same length, below the first one
+    PCB_TRACK* trackC = addTrack( wxPoint( 0, 0 ),
+                                  wxPoint( Millimeter2iu( 10 ), Millimeter2iu( -5 ) ) );
+    PCB_TRACK* trackD = addTrack( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( -5 ) ),
+                                  wxPoint( Millimeter2iu( 20 ), 0 ) );
+
+    FROM_TO_CACHE& cache = rebuild();
+
+    BOOST_CHECK( cache.IsOnFromToPath( m_trackA, "U1", "U2" )
+                 != cache.IsOnFromToPath( trackC, "U1", "U2" ) );
+
+    std::set<BOARD_CONNECTED_ITEM*> items;
+
+    items.insert( m_board->Footprints().front()->Pads().front() );
+    items.insert( m_board->Footprints().back()->Pads().front() );
+
+    if( cache.IsOnFromToPath( m_trackA, "U1", "U2" ) )
+    {
+        items.insert( m_trackA );
+        items.insert( m_trackB );
+    }
+    else
+    {
+        items.insert( trackC );
+        items.insert( trackD );
+    }
+
+    FROM_TO_CACHE::FT_PATH* path = cache.QueryFromToPath( items );
+
+    BOOST_REQUIRE( path != nullptr );
+    BOOST_CHECK( !path->isUnique );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <pcb_track.h>
+#include <track_columns.h>
+
+
+struct TRACK_COLUMNS_FIXTURE
+{
+    TRACK_COLUMNS_FIXTURE()
+    {
+        m_track = new PCB_TRACK( &m_board );
+        m_track->SetStart( wxPoint( 0, 0 ) );
+        m_track->SetEnd( wxPoint( 1000, 0 ) );
+        m_track->SetWidth( 200 );
+        m_track->SetLayer( B_Cu );
+        m_board.Add( m_track, ADD_MODE::APPEND );
+
+        m_arc = new PCB_ARC( &m_board );
+        m_arc->SetStart( wxPoint( 1000, 0 ) );
+        m_arc->SetMid( wxPoint( 1500, 500 ) );
+        m_arc->SetEnd( wxPoint( 2000, 0 ) );
+        m_arc->SetWidth( 300 );
+        m_arc->SetLayer( F_Cu );
+        m_board.Add( m_arc, ADD_MODE::APPEND );
+
+        m_via = new PCB_VIA( &m_board );
+        m_via->SetPosition( wxPoint( 2000, 0 ) );
+        m_via->SetWidth( 600 );
+        m_via->SetLayerPair( F_Cu, B_Cu );
+        m_board.Add( m_via, ADD_MODE::APPEND );
+    }
+
+    BOARD      m_board;
+    PCB_TRACK* m_track;
+    PCB_ARC*   m_arc;
+    PCB_VIA*   m_via;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( TrackColumns, TRACK_COLUMNS_FIXTURE )
+
+
+/**
+ * Each row holds the values of the track it points to.
+ */
+BOOST_AUTO_TEST_CASE( Rows )
+{
+    std::shared_ptr<const TRACK_COLUMNS> tracks = m_board.GetTrackColumns();
+
+    BOOST_REQUIRE_EQUAL( tracks->Size(), 3 );
+
+    for( size_t row = 0; row < tracks->Size(); ++row )
+    {
+        PCB_TRACK* item = tracks->Item( row );
+
+        BOOST_CHECK( item == m_board.Tracks()[row] );
+        BOOST_CHECK_EQUAL( tracks->Type( row ), item->Type() );
+        BOOST_CHECK( tracks->Layers( row ) == item->GetLayerSet() );
+        BOOST_CHECK( tracks->Start( row ) == VECTOR2I( item->GetStart() ) );
+        BOOST_CHECK( tracks->End( row ) == VECTOR2I( item->GetEnd() ) );
+        BOOST_CHECK_EQUAL( tracks->Width( row ), item->GetWidth() );
+        BOOST_CHECK_EQUAL( tracks->NetCode( row ), item->GetNetCode() );
+    }
+
+    BOOST_CHECK( tracks->Mid( 0 ) == VECTOR2I( m_track->GetStart() ) );
+    BOOST_CHECK( tracks->Mid( 1 ) == VECTOR2I( m_arc->GetMid() ) );
+    BOOST_CHECK( tracks->Layers( 2 ) == LSET::AllCuMask() );
+}
+
+
+/**
+ * The columns are shared until tracks are added or removed, or the board time stamp moves.
+ */
+BOOST_AUTO_TEST_CASE( Invalidation )
+{
+    std::shared_ptr<const TRACK_COLUMNS> tracks = m_board.GetTrackColumns();
+
+    BOOST_CHECK( m_board.GetTrackColumns() == tracks );
+
+    m_board.Remove( m_via );
+    delete m_via;
+
+    std::shared_ptr<const TRACK_COLUMNS> removed = m_board.GetTrackColumns();
+
+    BOOST_CHECK( removed != tracks );
+    BOOST_CHECK_EQUAL( removed->Size(), 2 );
+    BOOST_CHECK_EQUAL( tracks->Size(), 3 );
+
+    m_track->SetWidth( 250 );
+    BOOST_CHECK_EQUAL( m_board.GetTrackColumns()->Width( 0 ), 200 );
+
+    m_board.IncrementTimeStamp();
+    BOOST_CHECK_EQUAL( m_board.GetTrackColumns()->Width( 0 ), 250 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
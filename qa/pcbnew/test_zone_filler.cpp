@@ -0,0 +1,172 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <wx/filename.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <convert_to_biu.h>
+#include <netinfo.h>
+#include <pcb_track.h>
+#include <zone.h>
+#include <zone_filler.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+#include <drc/drc_engine.h>
+
+
+/**
+ * Two zones of the same net on F_Cu, side by side, with the connectivity and the design rules
+ * of their board.
+ */
+struct ZONE_FILLER_FIXTURE
+{
+    ZONE_FILLER_FIXTURE() :
+            m_board( std::make_unique<BOARD>() )
+    {
+        m_net = new NETINFO_ITEM( m_board.get(), "A", 1 );
+        m_board->Add( m_net );
+
+        m_left = addZone( 0 );
+        m_right = addZone( Millimeter2iu( 30 ) );
+
+        m_board->BuildConnectivity();
+
+        BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+
+        bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( m_board.get(), &bds );
+        bds.m_DRCEngine->InitEngine( wxFileName() );
+    }
+
+    ZONE* addZone( int aX )
+    {
+        ZONE* zone = new ZONE( m_board.get() );
+
+        zone->SetLayer( F_Cu );
+        zone->SetNet( m_net );
+        zone->SetIslandRemovalMode( ISLAND_REMOVAL_MODE::NEVER );
+
+        for( wxPoint corner : { wxPoint( 0, 0 ), wxPoint( Millimeter2iu( 20 ), 0 ),
+                                wxPoint( Millimeter2iu( 20 ), Millimeter2iu( 20 ) ),
+                                wxPoint( 0, Millimeter2iu( 20 ) ) } )
+        {
+            zone->AppendCorner( corner + wxPoint( aX, 0 ), -1 );
+        }
+
+        m_board->Add( zone );
+        return zone;
+    }
+
+    /**
+     * Fill both zones.  The filler doesn't need a commit to bring the connectivity up to date,
+     * so none is used: BOARD_COMMIT::Push() needs an editor frame.
+     */
+    void fill()
+    {
+        ZONE_FILLER        filler( m_board.get(), nullptr );
+        std::vector<ZONE*> zones = { m_left, m_right };
+
+        BOOST_REQUIRE( filler.Fill( zones ) );
+    }
+
+    std::list<CN_ITEM*> connectivityItems( ZONE* aZone )
+    {
+        return m_board->GetConnectivity()->GetConnectivityAlgo()->ItemEntry( aZone ).GetItems();
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    NETINFO_ITEM*          m_net;
+    ZONE*                  m_left;
+    ZONE*                  m_right;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFiller, ZONE_FILLER_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( KeepsUnchangedFills )
+{
+    fill();
+
+    SHAPE_POLY_SET leftFill = m_left->GetFilledPolysList( F_Cu );
+    SHAPE_POLY_SET rightFill = m_right->GetFilledPolysList( F_Cu );
+
+    BOOST_REQUIRE_GT( leftFill.OutlineCount(), 0 );
+
+    // Nothing changed: both fills come back triangulated
+    fill();
+    BOOST_CHECK( m_left->GetFilledPolysList( F_Cu ).IsTriangulationUpToDate() );
+    BOOST_CHECK( m_left->GetFilledPolysList( F_Cu ).GetHash() == leftFill.GetHash() );
+    BOOST_CHECK( m_right->GetFilledPolysList( F_Cu ).IsTriangulationUpToDate() );
+    BOOST_CHECK( m_right->GetFilledPolysList( F_Cu ).GetHash() == rightFill.GetHash() );
+
+    // A track of another net in the left zone only changes its fill
+    NETINFO_ITEM* other = new NETINFO_ITEM( m_board.get(), "B", 2 );
+    PCB_TRACK*    track = new PCB_TRACK( m_board.get() );
+
+    m_board->Add( other );
+    track->SetStart( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 10 ) ) );
+    track->SetEnd( wxPoint( Millimeter2iu( 15 ), Millimeter2iu( 10 ) ) );
+    track->SetWidth( Millimeter2iu( 0.25 ) );
+    track->SetLayer( F_Cu );
+    track->SetNet( other );
+    m_board->Add( track );
+
+    fill();
+    BOOST_CHECK( m_left->GetFilledPolysList( F_Cu ).GetHash() != leftFill.GetHash() );
+    BOOST_CHECK( m_left->GetFilledPolysList( F_Cu ).IsTriangulationUpToDate() );
+    BOOST_CHECK( m_right->GetFilledPolysList( F_Cu ).GetHash() == rightFill.GetHash() );
+    BOOST_CHECK( m_right->GetFilledPolysList( F_Cu ).IsTriangulationUpToDate() );
+}
+
+
+BOOST_AUTO_TEST_CASE( FollowsZoneEditsNotInConnectivity )
+{
+    fill();
+
+    BOOST_REQUIRE( !connectivityItems( m_left ).empty() );
+
+    // Edit the zone the way the zone properties dialog does: the fill comes before the commit
+    // which would update the connectivity with the new layer.
+    m_left->SetLayer( B_Cu );
+
+    fill();
+
+    BOOST_CHECK( !m_left->HasFilledPolysForLayer( F_Cu ) );
+    BOOST_REQUIRE_GT( m_left->GetFilledPolysList( B_Cu ).OutlineCount(), 0 );
+
+    std::list<CN_ITEM*> leftItems = connectivityItems( m_left );
+
+    BOOST_REQUIRE( !leftItems.empty() );
+
+    // No item is left from the layer the zone was moved off
+    for( CN_ITEM* item : leftItems )
+    {
+        BOOST_CHECK( item->Valid() );
+        BOOST_CHECK_EQUAL( item->Layer(), B_Cu );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <convert_to_biu.h>
+#include <zone.h>
+
+
+/**
+ * A zone on F_Cu filled with a finely approximated disc, a square with a square hole, and a
+ * speck smaller than the errors tested.
+ */
+struct ZONE_LOD_FIXTURE
+{
+    ZONE_LOD_FIXTURE() :
+            m_board( std::make_unique<BOARD>() ),
+            m_zone( m_board.get() )
+    {
+        m_zone.SetLayer( F_Cu );
+
+        SHAPE_LINE_CHAIN disc;
+        int              radius = Millimeter2iu( 10 );
+
+        for( int ii = 0; ii < 3600; ++ii )
+        {
+            double angle = 2 * M_PI * ii / 3600;
+
+            disc.Append( KiROUND( radius * cos( angle ) ), KiROUND( radius * sin( angle ) ) );
+        }
+
+        disc.SetClosed( true );
+        m_fill.AddOutline( disc );
+
+        m_fill.AddOutline( square( Millimeter2iu( 30 ), Millimeter2iu( 10 ) ) );
+        m_fill.AddHole( square( Millimeter2iu( 32 ), Millimeter2iu( 2 ) ) );
+
+        m_fill.AddOutline( square( Millimeter2iu( 50 ), Millimeter2iu( 0.01 ) ) );
+
+        m_zone.SetFilledPolysList( F_Cu, m_fill );
+    }
+
+    static SHAPE_LINE_CHAIN square( int aX, int aSize )
+    {
+        SHAPE_LINE_CHAIN chain;
+
+        chain.Append( aX, 0 );
+        chain.Append( aX + aSize, 0 );
+        chain.Append( aX + aSize, aSize );
+        chain.Append( aX, aSize );
+        chain.SetClosed( true );
+
+        return chain;
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    ZONE                   m_zone;
+    SHAPE_POLY_SET         m_fill;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneLOD, ZONE_LOD_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( FullResolution )
+{
+    const SHAPE_POLY_SET& fill = m_zone.GetFilledPolysList( F_Cu );
+
+    // Below the first level of detail, the fill itself is drawn
+    BOOST_CHECK( &m_zone.GetFilledPolysLOD( F_Cu, 0 ) == &fill );
+    BOOST_CHECK( &m_zone.GetFilledPolysLOD( F_Cu, ARC_HIGH_DEF - 1 ) == &fill );
+}
+
+
+BOOST_AUTO_TEST_CASE( WithinError )
+{
+    for( int maxError : { ARC_HIGH_DEF, Millimeter2iu( 0.1 ), Millimeter2iu( 1 ) } )
+    {
+        BOOST_TEST_CONTEXT( "Max error " << maxError )
+        {
+            const SHAPE_POLY_SET& lod = m_zone.GetFilledPolysLOD( F_Cu, maxError );
+
+            // The speck is left out, the square and its hole are kept whole
+            BOOST_REQUIRE_EQUAL( lod.OutlineCount(), 2 );
+            BOOST_CHECK_LT( lod.COutline( 0 ).PointCount(), m_fill.COutline( 0 ).PointCount() );
+            BOOST_CHECK_EQUAL( lod.COutline( 1 ).PointCount(), 4 );
+            BOOST_CHECK_EQUAL( lod.HoleCount( 1 ), 1 );
+
+            for( int ii = 0; ii < 2; ++ii )
+            {
+                const SHAPE_LINE_CHAIN& original = m_fill.COutline( ii );
+
+                for( int jj = 0; jj < original.PointCount(); ++jj )
+                {
+                    BOOST_CHECK_LE( lod.COutline( ii ).Distance( original.CPoint( jj ), true ),
+                                    maxError );
+                }
+            }
+
+            // The levels of detail are kept
+            BOOST_CHECK( &m_zone.GetFilledPolysLOD( F_Cu, maxError ) == &lod );
+        }
+    }
+
+    // Coarser levels have fewer vertices
+    BOOST_CHECK_LT( m_zone.GetFilledPolysLOD( F_Cu, Millimeter2iu( 1 ) ).COutline( 0 ).PointCount(),
+                    m_zone.GetFilledPolysLOD( F_Cu, ARC_HIGH_DEF ).COutline( 0 ).PointCount() );
+}
+
+
+BOOST_AUTO_TEST_CASE( FollowsFill )
+{
+    int     maxError = Millimeter2iu( 0.1 );
+    BOX2I   before = m_zone.GetFilledPolysLOD( F_Cu, maxError ).BBox();
+    wxPoint offset( Millimeter2iu( 5 ), Millimeter2iu( 7 ) );
+
+    m_zone.Move( offset );
+
+    BOOST_CHECK_EQUAL( m_zone.GetFilledPolysLOD( F_Cu, maxError ).BBox().GetOrigin(),
+                       before.GetOrigin() + VECTOR2I( offset ) );
+
+    m_zone.SetFilledPolysList( F_Cu, SHAPE_POLY_SET() );
+
+    BOOST_CHECK_EQUAL( m_zone.GetFilledPolysLOD( F_Cu, maxError ).OutlineCount(), 0 );
+
+    m_zone.SetFilledPolysList( F_Cu, m_fill );
+
+    BOOST_CHECK_EQUAL( m_zone.GetFilledPolysLOD( F_Cu, maxError ).OutlineCount(), 2 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,366 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/check_report.h>
+#include <qa_utils/utility_registry.h>
+
+#include <cstdio>
+#include <iostream>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/textfile.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <connectivity/connectivity_data.h>
+#include <convert_to_biu.h>
+#include <drawing_sheet/ds_proxy_view_item.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <io_mgr.h>
+#include <locale_io.h>
+#include <pcb_marker.h>
+#include <profile.h>
+#include <project.h>
+#include <settings/settings_manager.h>
+#include <wildcards_and_files_ext.h>
+#include <zone.h>
+#include <zone_filler.h>
+
+
+using KI_TEST::CHECK_REPORT;
+using KI_TEST::STDERR_PROGRESS_REPORTER;
+
+
+/// How the boards of a batch are checked
+struct BATCH_DRC_OPTIONS
+{
+    int  m_threadCount = 0;
+    bool m_fillZones = true;
+    bool m_reportAllTrackErrors = false;
+};
+
+
+/**
+ * Load the board \a aFileName with its project, and run the DRC on it as the DRC dialog does.
+ */
+static CHECK_REPORT::FILE_RESULT checkBoard( const wxString& aFileName,
+                                             SETTINGS_MANAGER& aSettingsManager,
+                                             const BATCH_DRC_OPTIONS& aOptions,
+                                             STDERR_PROGRESS_REPORTER& aReporter )
+{
+    CHECK_REPORT::FILE_RESULT result;
+    PROF_COUNTER              timer;
+
+    result.m_File = aFileName;
+
+    wxFileName pro( aFileName );
+    pro.SetExt( ProjectFileExtension );
+    pro.MakeAbsolute();
+
+    aSettingsManager.LoadProject( pro.GetFullPath() );
+
+    PROJECT*               project = &aSettingsManager.Prj();
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        // Ensure the "C" locale is temporary set, before reading any file
+        LOCALE_IO dummy;
+
+        if( aFileName.EndsWith( KiCadPcbFileExtension ) )
+            board.reset( IO_MGR::Load( IO_MGR::KICAD_SEXP, aFileName ) );
+        else
+            board.reset( IO_MGR::Load( IO_MGR::LEGACY, aFileName ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        result.m_Error = ioe.What();
+    }
+
+    if( !board )
+    {
+        if( result.m_Error.IsEmpty() )
+            result.m_Error = _( "The board could not be loaded." );
+
+        aSettingsManager.UnloadProject( project, false );
+        result.m_Time = timer.msecs();
+        return result;
+    }
+
+    board->SetProject( project );
+
+    BOARD_DESIGN_SETTINGS&      bds = board->GetDesignSettings();
+    std::shared_ptr<DRC_ENGINE> drcEngine = std::make_shared<DRC_ENGINE>( board.get(), &bds );
+
+    // The zone filler gets its clearances from the engine of the board
+    bds.m_DRCEngine = drcEngine;
+
+    try
+    {
+        wxFileName rules = pro;
+        rules.SetExt( DesignRulesFileExtension );
+        drcEngine->InitEngine( rules );
+    }
+    catch( const PARSE_ERROR& pe )
+    {
+        result.m_Error = wxString::Format( _( "The design rules cannot be compiled: %s" ),
+                                           pe.What() );
+    }
+
+    if( result.m_Error.IsEmpty() )
+    {
+        board->BuildConnectivity();
+        board->BuildListOfNets();
+        board->SynchronizeNetsAndNetClasses();
+
+        if( aOptions.m_fillZones )
+        {
+            std::vector<ZONE*> toFill = board->Zones();
+            ZONE_FILLER        filler( board.get(), nullptr );
+
+            aReporter.AdvancePhase( _( "Refilling all zones..." ) );
+            board->IncrementTimeStamp();    // Clear caches
+
+            std::lock_guard<KISPINLOCK> lock( board->GetConnectivity()->GetLock() );
+            filler.Fill( toFill );
+        }
+
+        DS_PROXY_VIEW_ITEM drawingSheet( IU_PER_MILS, &board->GetPageSettings(), project,
+                                         &board->GetTitleBlock() );
+
+        drcEngine->SetDrawingSheet( &drawingSheet );
+        drcEngine->SetThreadCount( aOptions.m_threadCount );
+        drcEngine->SetProgressReporter( &aReporter );
+
+        drcEngine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+                {
+                    SEVERITY severity = bds.GetSeverity( aItem->GetErrorCode() );
+
+                    if( severity == RPT_SEVERITY_IGNORE )
+                        return;
+
+                    CHECK_REPORT::VIOLATION violation = CHECK_REPORT::MakeViolation(
+                            *aItem, severity, Iu2Millimeter( aPos.x ), Iu2Millimeter( aPos.y ),
+                            [&]( const KIID& aId ) -> EDA_ITEM*
+                            {
+                                return board->GetItem( aId );
+                            } );
+
+                    // Exclusions are known by their markers
+                    PCB_MARKER marker( aItem, aPos );
+
+                    violation.m_Excluded = bds.m_DrcExclusions.count( marker.Serialize() ) > 0;
+                    aItem->SetParent( nullptr );
+
+                    result.m_Violations.push_back( violation );
+                } );
+
+        drcEngine->RunTests( EDA_UNITS::MILLIMETRES, aOptions.m_reportAllTrackErrors, false );
+
+        drcEngine->SetProgressReporter( nullptr );
+        drcEngine->ClearViolationHandler();
+        drcEngine->SetDrawingSheet( nullptr );
+    }
+
+    board->ClearProject();
+    aSettingsManager.UnloadProject( project, false );
+
+    result.m_Time = timer.msecs();
+    return result;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "o", "output", _( "the report file, instead of stdout" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "f", "format", _( "the report format: json (default) or junit" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "j", "threads",
+            _( "the number of threads to run the tests on (default: one per core)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "l", "list",
+            _( "a file listing the boards to check, one per line, or - for stdin" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_SWITCH, nullptr, "no-fill", _( "don't refill the zones first" ).mb_str() },
+    { wxCMD_LINE_SWITCH, nullptr, "all-track-errors",
+            _( "report all errors for each track" ).mb_str() },
+    { wxCMD_LINE_SWITCH, nullptr, "fail-on-warnings",
+            _( "exit with the violations status for warnings too" ).mb_str() },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "board files" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum BATCH_DRC_RET_CODES
+{
+    /// Some boards have violations
+    VIOLATIONS_FOUND = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+
+    /// Some boards could not be checked
+    CHECK_FAILED,
+
+    /// The report could not be written
+    REPORT_FAILED
+};
+
+
+/**
+ * Append the lines of \a aListFile, or of stdin, to \a aFiles.
+ */
+static bool readFileList( const wxString& aListFile, std::vector<wxString>& aFiles )
+{
+    if( aListFile == wxT( "-" ) )
+    {
+        std::string line;
+
+        while( std::getline( std::cin, line ) )
+        {
+            if( !line.empty() )
+                aFiles.push_back( wxString::FromUTF8( line.c_str() ) );
+        }
+
+        return true;
+    }
+
+    wxTextFile list;
+
+    if( !list.Open( aListFile ) )
+        return false;
+
+    for( size_t ii = 0; ii < list.GetLineCount(); ++ii )
+    {
+        wxString line = list[ii];
+
+        if( !line.Trim().IsEmpty() )
+            aFiles.push_back( line );
+    }
+
+    return true;
+}
+
+
+int batch_drc_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program runs the DRC on the given boards, in one process, and writes a "
+               "report of the violations found.  The progress is printed on stderr." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    BATCH_DRC_OPTIONS    options;
+    CHECK_REPORT::FORMAT format = CHECK_REPORT::FORMAT::JSON;
+    wxString             value;
+    long                 threads = 0;
+
+    if( cl_parser.Found( "format", &value ) )
+    {
+        if( value == wxT( "junit" ) )
+            format = CHECK_REPORT::FORMAT::JUNIT;
+        else if( value != wxT( "json" ) )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    if( cl_parser.Found( "threads", &threads ) )
+    {
+        if( threads < 0 )
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+        options.m_threadCount = (int) threads;
+    }
+
+    options.m_fillZones = !cl_parser.Found( "no-fill" );
+    options.m_reportAllTrackErrors = cl_parser.Found( "all-track-errors" );
+
+    std::vector<wxString> files;
+
+    for( size_t ii = 0; ii < cl_parser.GetParamCount(); ++ii )
+        files.push_back( cl_parser.GetParam( ii ) );
+
+    if( cl_parser.Found( "list", &value ) && !readFileList( value, files ) )
+    {
+        fprintf( stderr, "Cannot read %s\n", TO_UTF8( value ) );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    // One settings manager for the whole batch, as starting one is the slow part
+    SETTINGS_MANAGER         settingsManager( true );
+    STDERR_PROGRESS_REPORTER reporter;
+    CHECK_REPORT             report( "drc" );
+
+    // The JUnit report fails the files the exit status fails on
+    if( cl_parser.Found( "fail-on-warnings" ) )
+        report.SetFailSeverity( RPT_SEVERITY_WARNING );
+
+    for( size_t ii = 0; ii < files.size(); ++ii )
+    {
+        reporter.SetPrefix( wxString::Format( "[%d/%d] %s: ", (int) ii + 1, (int) files.size(),
+                                              files[ii] ) );
+
+        report.AddResult( checkBoard( files[ii], settingsManager, options, reporter ) );
+
+        const CHECK_REPORT::FILE_RESULT& result = report.GetResults().back();
+
+        if( !result.m_Error.IsEmpty() )
+            reporter.Report( result.m_Error );
+        else
+            reporter.Report( wxString::Format( _( "%d errors, %d warnings" ),
+                                               result.Count( RPT_SEVERITY_ERROR ),
+                                               result.Count( RPT_SEVERITY_WARNING ) ) );
+    }
+
+    if( cl_parser.Found( "output", &value ) )
+    {
+        if( !report.Save( value, format ) )
+            return BATCH_DRC_RET_CODES::REPORT_FAILED;
+    }
+    else
+    {
+        std::cout << report.Format( format );
+    }
+
+    if( report.HasErrors() )
+        return BATCH_DRC_RET_CODES::CHECK_FAILED;
+
+    if( report.HasViolations( report.GetFailSeverity() ) )
+        return BATCH_DRC_RET_CODES::VIOLATIONS_FOUND;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register(
+        { "batch_drc", "Run the DRC on a batch of boards", batch_drc_main_func } );
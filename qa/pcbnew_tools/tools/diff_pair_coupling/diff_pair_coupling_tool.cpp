@@ -0,0 +1,286 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <connectivity/diff_pair_coupling_cache.h>
+#include <convert_to_biu.h>
+#include <netinfo.h>
+#include <pcb_track.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <thread>
+
+
+using DIFF_PAIR_COUPLING_DURATION = std::chrono::duration<double, std::milli>;
+using COUPLED_SEGMENTS = DIFF_PAIR_COUPLING_CACHE::COUPLED_SEGMENTS;
+
+
+/**
+ * The tracks of the two nets of a generated pair.
+ */
+struct GENERATED_PAIR
+{
+    int                             netP;
+    int                             netN;
+    std::set<BOARD_CONNECTED_ITEM*> itemsP;
+    std::set<BOARD_CONNECTED_ITEM*> itemsN;
+};
+
+
+/**
+ * Add \a aPairCount length-tuned pairs to \a aBoard, side by side like the byte lanes and strobes
+ * of a DDR bus.  Each net is a trombone meander of \a aSegmentCount segments, and the N net
+ * follows the P net at a constant gap.
+ */
+static std::vector<GENERATED_PAIR> generatePairs( BOARD& aBoard, int aPairCount,
+                                                  int aSegmentCount )
+{
+    const int width = Millimeter2iu( 0.1 );
+    const int gap = Millimeter2iu( 0.2 );
+    const int pitch = Millimeter2iu( 1.5 );
+    const int run = Millimeter2iu( 0.5 );
+    const int amplitude = Millimeter2iu( 0.8 );
+
+    std::vector<GENERATED_PAIR> pairs;
+
+    for( int ii = 0; ii < aPairCount; ++ii )
+    {
+        GENERATED_PAIR pair;
+        NETINFO_ITEM*  netP = new NETINFO_ITEM( &aBoard, wxString::Format( "DQS%d_P", ii ),
+                                                2 * ii + 1 );
+        NETINFO_ITEM*  netN = new NETINFO_ITEM( &aBoard, wxString::Format( "DQS%d_N", ii ),
+                                                2 * ii + 2 );
+
+        aBoard.Add( netP );
+        aBoard.Add( netN );
+
+        pair.netP = netP->GetNetCode();
+        pair.netN = netN->GetNetCode();
+
+        wxPoint pos( 0, ii * pitch );
+        int     direction = 1;
+
+        for( int jj = 0; jj < aSegmentCount; ++jj )
+        {
+            wxPoint next = pos;
+
+            if( jj % 2 == 0 )
+            {
+                next.x += run;
+            }
+            else
+            {
+                next.y += direction * amplitude;
+                direction = -direction;
+            }
+
+            for( NETINFO_ITEM* net : { netP, netN } )
+            {
+                wxPoint    offset( 0, net == netN ? gap : 0 );
+                PCB_TRACK* track = new PCB_TRACK( &aBoard );
+
+                track->SetStart( pos + offset );
+                track->SetEnd( next + offset );
+                track->SetWidth( width );
+                track->SetLayer( F_Cu );
+                track->SetNet( net );
+                aBoard.Add( track );
+
+                ( net == netN ? pair.itemsN : pair.itemsP ).insert( track );
+            }
+
+            pos = next;
+        }
+
+        pairs.push_back( pair );
+    }
+
+    return pairs;
+}
+
+
+static size_t countSegments( const std::vector<std::vector<COUPLED_SEGMENTS>>& aResults )
+{
+    size_t count = 0;
+
+    for( const std::vector<COUPLED_SEGMENTS>& segments : aResults )
+        count += segments.size();
+
+    return count;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "p", "pairs", _( "number of differential pairs (default 72)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "s", "segments",
+            _( "number of track segments of each net (default 200)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum DIFF_PAIR_COUPLING_RET_CODES
+{
+    RESULTS_DIFFER = KI_TEST::RET_CODES::TOOL_SPECIFIC
+};
+
+
+/**
+ * Time finding the coupled segments of the pairs of a generated DDR-style board one pair after
+ * the other, on all the cores, and again from the coupling cache.  All must find the same
+ * segments.
+ */
+int diff_pair_coupling_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks finding the coupled segments of differential pairs." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long pairCount = 72;
+    long segmentCount = 200;
+
+    cl_parser.Found( "pairs", &pairCount );
+    cl_parser.Found( "segments", &segmentCount );
+
+    BOARD                       board;
+    std::vector<GENERATED_PAIR> pairs = generatePairs( board, pairCount, segmentCount );
+
+    std::vector<std::vector<COUPLED_SEGMENTS>> serial( pairs.size() );
+    std::vector<std::vector<COUPLED_SEGMENTS>> parallel( pairs.size() );
+    std::vector<std::vector<COUPLED_SEGMENTS>> cached( pairs.size() );
+    DIFF_PAIR_COUPLING_DURATION                serialTime;
+    DIFF_PAIR_COUPLING_DURATION                parallelTime;
+    DIFF_PAIR_COUPLING_DURATION                firstRunTime;
+    DIFF_PAIR_COUPLING_DURATION                cachedTime;
+
+    {
+        SCOPED_PROF_COUNTER<DIFF_PAIR_COUPLING_DURATION> timer( serialTime );
+
+        for( size_t ii = 0; ii < pairs.size(); ++ii )
+        {
+            serial[ii] = DIFF_PAIR_COUPLING_CACHE::FindCoupledSegments( pairs[ii].itemsP,
+                                                                        pairs[ii].itemsN );
+        }
+    }
+
+    size_t threadCount = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+
+    auto runInParallel =
+            [&]( const std::function<void( size_t )>& aFunc )
+            {
+                std::atomic<size_t> next( 0 );
+
+                auto worker =
+                        [&]()
+                        {
+                            for( size_t ii = next.fetch_add( 1 ); ii < pairs.size();
+                                 ii = next.fetch_add( 1 ) )
+                            {
+                                aFunc( ii );
+                            }
+                        };
+
+                std::vector<std::future<void>> returns( threadCount );
+
+                for( size_t ii = 0; ii < threadCount; ++ii )
+                    returns[ii] = std::async( std::launch::async, worker );
+
+                for( std::future<void>& ret : returns )
+                    ret.wait();
+            };
+
+    {
+        SCOPED_PROF_COUNTER<DIFF_PAIR_COUPLING_DURATION> timer( parallelTime );
+
+        runInParallel(
+                [&]( size_t aIndex )
+                {
+                    parallel[aIndex] = DIFF_PAIR_COUPLING_CACHE::FindCoupledSegments(
+                            pairs[aIndex].itemsP, pairs[aIndex].itemsN );
+                } );
+    }
+
+    DIFF_PAIR_COUPLING_CACHE cache;
+
+    auto fromCache =
+            [&]( size_t aIndex )
+            {
+                cached[aIndex] = cache.GetCoupledSegments( pairs[aIndex].netP, pairs[aIndex].netN,
+                                                           pairs[aIndex].itemsP,
+                                                           pairs[aIndex].itemsN );
+            };
+
+    {
+        SCOPED_PROF_COUNTER<DIFF_PAIR_COUPLING_DURATION> timer( firstRunTime );
+        runInParallel( fromCache );
+    }
+
+    {
+        SCOPED_PROF_COUNTER<DIFF_PAIR_COUPLING_DURATION> timer( cachedTime );
+        runInParallel( fromCache );
+    }
+
+    std::cout << "Pairs:            " << pairs.size() << std::endl;
+    std::cout << "Coupled segments: " << countSegments( serial ) << std::endl;
+    std::cout << "Threads:          " << threadCount << std::endl;
+    std::cout << "Serial:           " << serialTime.count() << "ms" << std::endl;
+    std::cout << "Parallel:         " << parallelTime.count() << "ms" << std::endl;
+    std::cout << "Cache, first run: " << firstRunTime.count() << "ms" << std::endl;
+    std::cout << "Cache, next run:  " << cachedTime.count() << "ms ("
+              << cache.GetReusedCount() << " pairs reused)" << std::endl;
+
+    // The segments are found in the same order whichever way they are looked up
+    if( parallel != serial || cached != serial )
+    {
+        std::cerr << "The coupled segments differ" << std::endl;
+        return DIFF_PAIR_COUPLING_RET_CODES::RESULTS_DIFFER;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "diff_pair_coupling",
+        "Benchmark finding the coupled segments of differential pairs",
+        diff_pair_coupling_main_func,
+} );
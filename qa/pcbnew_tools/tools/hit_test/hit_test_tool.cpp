@@ -0,0 +1,194 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <collectors.h>
+#include <footprint.h>
+#include <pcb_marker.h>
+#include <pcb_track.h>
+#include <pcb_view.h>
+#include <zone.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <random>
+
+
+using HIT_TEST_DURATION = std::chrono::duration<double, std::micro>;
+
+
+/**
+ * Add the board items to the view the same way PCB_DRAW_PANEL_GAL::DisplayBoard() does.
+ */
+static void addBoardToView( BOARD& aBoard, KIGFX::PCB_VIEW& aView )
+{
+    for( BOARD_ITEM* drawing : aBoard.Drawings() )
+        aView.Add( drawing );
+
+    for( PCB_TRACK* track : aBoard.Tracks() )
+        aView.Add( track );
+
+    for( FOOTPRINT* footprint : aBoard.Footprints() )
+        aView.Add( footprint );
+
+    for( PCB_MARKER* marker : aBoard.Markers() )
+        aView.Add( marker );
+
+    for( ZONE* zone : aBoard.Zones() )
+        aView.Add( zone );
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "c", "clicks", _( "number of clicks to simulate (default 1000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "p", "pixel", _( "size of a screen pixel in nm (default 10000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum HIT_TEST_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RESULTS_DIFFER
+};
+
+
+/**
+ * Simulate clicks at random (but repeatable) points on a board and compare the click latency
+ * of a plain board visit with that of the view-assisted collector.  Both must return exactly
+ * the same items in the same order.
+ */
+int hit_test_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program benchmarks click selection hit testing on a board." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long clicks = 1000;
+    long pixel = 10000;
+    std::string filename;
+
+    cl_parser.Found( "clicks", &clicks );
+    cl_parser.Found( "pixel", &pixel );
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    // The view must outlive the board, as board items unregister themselves on destruction
+    KIGFX::PCB_VIEW        view( true );
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return HIT_TEST_RET_CODES::LOAD_FAILED;
+
+    addBoardToView( *board, view );
+
+    GENERAL_COLLECTORS_GUIDE guide( LSET::AllLayersMask(), F_Cu, nullptr );
+    guide.SetOnePixelInIU( pixel );
+
+    EDA_RECT                           bbox = board->ComputeBoundingBox();
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> distX( bbox.GetX(), bbox.GetRight() );
+    std::uniform_int_distribution<int> distY( bbox.GetY(), bbox.GetBottom() );
+
+    HIT_TEST_DURATION visitTime{};
+    HIT_TEST_DURATION viewTime{};
+    long              hits = 0;
+    long              mismatches = 0;
+
+    for( long ii = 0; ii < clicks; ++ii )
+    {
+        wxPoint           refPos( distX( rng ), distY( rng ) );
+        GENERAL_COLLECTOR visitCollector;
+        GENERAL_COLLECTOR viewCollector;
+        HIT_TEST_DURATION duration;
+
+        {
+            SCOPED_PROF_COUNTER<HIT_TEST_DURATION> timer( duration );
+            visitCollector.Collect( board.get(), GENERAL_COLLECTOR::AllBoardItems, refPos, guide );
+        }
+
+        visitTime += duration;
+
+        {
+            SCOPED_PROF_COUNTER<HIT_TEST_DURATION> timer( duration );
+            viewCollector.Collect( board.get(), GENERAL_COLLECTOR::AllBoardItems, refPos, guide,
+                                   &view );
+        }
+
+        viewTime += duration;
+
+        hits += visitCollector.GetCount();
+
+        bool same = visitCollector.GetCount() == viewCollector.GetCount()
+                    && visitCollector.GetPrimaryCount() == viewCollector.GetPrimaryCount();
+
+        for( int jj = 0; same && jj < visitCollector.GetCount(); ++jj )
+            same = visitCollector[jj] == viewCollector[jj];
+
+        if( !same )
+        {
+            std::cerr << "Results differ at (" << refPos.x << ", " << refPos.y << ")" << std::endl;
+            mismatches++;
+        }
+    }
+
+    std::cout << "Clicks:           " << clicks << " (" << hits << " items hit)" << std::endl;
+    std::cout << "Board visit:      " << visitTime.count() / clicks << "us per click" << std::endl;
+    std::cout << "View R-tree:      " << viewTime.count() / clicks << "us per click" << std::endl;
+
+    // Tear down the view's spatial index in one go rather than item by item
+    view.Clear();
+
+    if( mismatches )
+        return HIT_TEST_RET_CODES::RESULTS_DIFFER;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "hit_test",
+        "Benchmark click selection hit testing on a PCB",
+        hit_test_main_func,
+} );
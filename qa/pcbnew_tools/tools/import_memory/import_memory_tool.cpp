@@ -0,0 +1,247 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <io_mgr.h>
+#include <profile.h>
+#include <richio.h>
+
+#include <wx/cmdline.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/xml/xml.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+
+using IMPORT_DURATION = std::chrono::milliseconds;
+
+
+/**
+ * @return the peak resident set size of the process in kB, or -1 where it is not known.
+ */
+static long peakMemoryKb()
+{
+    std::ifstream status( "/proc/self/status" );
+    std::string   line;
+
+    while( std::getline( status, line ) )
+    {
+        if( line.compare( 0, 6, "VmHWM:" ) == 0 )
+            return std::stol( line.substr( 6 ) );
+    }
+
+    return -1;
+}
+
+
+/**
+ * Write an Eagle board with @a aSignals nets of @a aWires wires and a via each, and a copper
+ * pour on every tenth net.
+ */
+static void writeEagleBoard( const wxString& aFileName, long aSignals, long aWires )
+{
+    wxFFile file( aFileName, "wb" );
+
+    file.Write( "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                "<!DOCTYPE eagle SYSTEM \"eagle.dtd\">\n"
+                "<eagle version=\"9.6.2\">\n"
+                "<drawing>\n"
+                "<layers>\n"
+                "<layer number=\"1\" name=\"Top\" color=\"4\" fill=\"1\" "
+                "visible=\"yes\" active=\"yes\"/>\n"
+                "<layer number=\"16\" name=\"Bottom\" color=\"1\" fill=\"1\" "
+                "visible=\"yes\" active=\"yes\"/>\n"
+                "<layer number=\"20\" name=\"Dimension\" color=\"24\" fill=\"1\" "
+                "visible=\"yes\" active=\"yes\"/>\n"
+                "</layers>\n"
+                "<board>\n"
+                "<plain>\n"
+                "<wire x1=\"0\" y1=\"0\" x2=\"1000\" y2=\"0\" width=\"0\" layer=\"20\"/>\n"
+                "<wire x1=\"1000\" y1=\"0\" x2=\"1000\" y2=\"1000\" width=\"0\" layer=\"20\"/>\n"
+                "<wire x1=\"1000\" y1=\"1000\" x2=\"0\" y2=\"1000\" width=\"0\" layer=\"20\"/>\n"
+                "<wire x1=\"0\" y1=\"1000\" x2=\"0\" y2=\"0\" width=\"0\" layer=\"20\"/>\n"
+                "</plain>\n"
+                "<libraries>\n"
+                "</libraries>\n"
+                "<elements>\n"
+                "</elements>\n"
+                "<signals>\n" );
+
+    for( long ii = 0; ii < aSignals; ++ii )
+    {
+        double y = 1.0 + ( ii % 9980 ) * 0.1;
+        double x = 1.0;
+
+        file.Write( wxString::Format( "<signal name=\"N%ld\">\n", ii ) );
+
+        for( long jj = 0; jj < aWires; ++jj, x += 0.5 )
+        {
+            file.Write( wxString::Format( "<wire x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" "
+                                          "width=\"0.1524\" layer=\"%d\"/>\n",
+                                          x, y, x + 0.5, y, jj % 2 ? 16 : 1 ) );
+        }
+
+        file.Write( wxString::Format( "<via x=\"%.2f\" y=\"%.2f\" extent=\"1-16\" "
+                                      "drill=\"0.3\"/>\n", x, y ) );
+
+        if( ii % 10 == 0 )
+        {
+            file.Write( wxString::Format( "<polygon width=\"0.2\" layer=\"1\">\n"
+                                          "<vertex x=\"1\" y=\"%.2f\"/>\n"
+                                          "<vertex x=\"%.2f\" y=\"%.2f\"/>\n"
+                                          "<vertex x=\"%.2f\" y=\"%.2f\"/>\n"
+                                          "</polygon>\n", y, x, y, x, y + 0.05 ) );
+        }
+
+        file.Write( "</signal>\n" );
+    }
+
+    file.Write( "</signals>\n"
+                "</board>\n"
+                "</drawing>\n"
+                "</eagle>\n" );
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "s", "signals",
+            _( "number of nets of the synthetic board (default 20000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "w", "wires", _( "number of wires per net (default 50)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_SWITCH, "d", "dom",
+            _( "only read the file into a wxXmlDocument, for comparison" ).mb_str() },
+    { wxCMD_LINE_PARAM, nullptr, nullptr,
+            _( "Eagle (.brd) or CADSTAR (.cpa) board to import instead of a synthetic one" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum IMPORT_MEMORY_RET_CODES
+{
+    IMPORT_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+/**
+ * Import a large board and report the time taken and the peak memory use of the process.
+ *
+ * Peak memory only ever grows, so each measurement needs a run of its own.
+ */
+int import_memory_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program measures the peak memory use of board imports." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long signals = 20000;
+    long wires = 50;
+    bool synthetic = !cl_parser.GetParamCount();
+
+    cl_parser.Found( "signals", &signals );
+    cl_parser.Found( "wires", &wires );
+
+    wxString filename;
+
+    if( synthetic )
+    {
+        wxString tempName = wxFileName::CreateTempFileName( "import_memory" );
+
+        wxRemoveFile( tempName );
+        filename = tempName + ".brd";
+        writeEagleBoard( filename, signals, wires );
+    }
+    else
+    {
+        filename = cl_parser.GetParam( 0 );
+    }
+
+    long            before = peakMemoryKb();
+    IMPORT_DURATION duration;
+    int             ret = KI_TEST::RET_CODES::OK;
+
+    try
+    {
+        SCOPED_PROF_COUNTER<IMPORT_DURATION> timer( duration );
+
+        if( cl_parser.Found( "dom" ) )
+        {
+            wxXmlDocument xmlDocument;
+
+            if( !xmlDocument.Load( filename ) )
+                ret = IMPORT_MEMORY_RET_CODES::IMPORT_FAILED;
+        }
+        else
+        {
+            IO_MGR::PCB_FILE_T type = filename.Lower().EndsWith( ".cpa" )
+                                              ? IO_MGR::CADSTAR_PCB_ARCHIVE
+                                              : IO_MGR::EAGLE;
+
+            std::unique_ptr<BOARD> board( IO_MGR::Load( type, filename ) );
+
+            std::cout << "Tracks:           " << board->Tracks().size() << std::endl;
+            std::cout << "Zones:            " << board->Zones().size() << std::endl;
+        }
+    }
+    catch( const IO_ERROR& e )
+    {
+        std::cerr << e.What().ToStdString() << std::endl;
+        ret = IMPORT_MEMORY_RET_CODES::IMPORT_FAILED;
+    }
+
+    std::cout << "File size:        " << wxFileName::GetSize( filename ).ToULong() / 1024 << " kB"
+              << std::endl;
+    std::cout << "Time:             " << duration.count() << " ms" << std::endl;
+    std::cout << "Peak memory:      " << peakMemoryKb() << " kB (" << before << " kB before)"
+              << std::endl;
+
+    if( synthetic )
+        wxRemoveFile( filename );
+
+    return ret;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "import_memory",
+        "Measure the peak memory use of Eagle and CADSTAR board imports",
+        import_memory_main_func,
+} );
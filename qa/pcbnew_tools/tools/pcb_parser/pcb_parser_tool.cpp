@@ -23,7 +23,10 @@
 
 #include <qa_utils/utility_registry.h>
 
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
+#include <new>
 #include <string>
 
 #include <common.h>
@@ -32,6 +35,7 @@
 #include <wx/cmdline.h>
 
 #include <board_item.h>
+#include <item_pool.h>
 #include <plugins/kicad/kicad_plugin.h>
 #include <plugins/kicad/pcb_parser.h>
 #include <richio.h>
@@ -45,6 +49,41 @@
 using PARSE_DURATION = std::chrono::microseconds;
 
 
+#ifdef QA_COUNT_HEAP_ALLOCATIONS
+
+/*
+ * Count every heap allocation made by this program, so that the cost of creating and
+ * destroying the parsed items can be seen next to the time taken.  This replaces the
+ * allocator of the whole program, so it is only built into its own executable.
+ */
+static std::atomic<size_t> s_heapAllocations{ 0 };
+static std::atomic<size_t> s_heapBytes{ 0 };
+static std::atomic<size_t> s_heapFrees{ 0 };
+
+
+void* operator new( size_t aSize )
+{
+    s_heapAllocations++;
+    s_heapBytes += aSize;
+
+    if( void* block = std::malloc( aSize ? aSize : 1 ) )
+        return block;
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete( void* aBlock ) noexcept
+{
+    if( aBlock )
+        s_heapFrees++;
+
+    std::free( aBlock );
+}
+
+#endif
+
+
 /**
  * Parse a PCB or footprint file from the given input stream
  *
@@ -64,6 +103,13 @@ bool parse( std::istream& aStream, bool aVerbose )
     BOARD_ITEM* board = nullptr;
 
     PARSE_DURATION duration{};
+    PARSE_DURATION teardown{};
+
+#ifdef QA_COUNT_HEAP_ALLOCATIONS
+    size_t allocations = s_heapAllocations;
+    size_t bytes = s_heapBytes;
+    size_t frees = 0;
+#endif
 
     try
     {
@@ -76,12 +122,49 @@ bool parse( std::istream& aStream, bool aVerbose )
     {
     }
 
+#ifdef QA_COUNT_HEAP_ALLOCATIONS
+    allocations = s_heapAllocations - allocations;
+    bytes = s_heapBytes - bytes;
+#endif
+
+    bool ok = board != nullptr;
+
+    if( board )
+    {
+#ifdef QA_COUNT_HEAP_ALLOCATIONS
+        frees = s_heapFrees;
+#endif
+
+        PROF_COUNTER timer;
+        delete board;
+
+        teardown = timer.SinceStart<PARSE_DURATION>();
+
+#ifdef QA_COUNT_HEAP_ALLOCATIONS
+        frees = s_heapFrees - frees;
+#endif
+    }
+
     if( aVerbose )
     {
         std::cout << "Took: " << duration.count() << "us" << std::endl;
+        std::cout << "Teardown: " << teardown.count() << "us" << std::endl;
+
+#ifdef QA_COUNT_HEAP_ALLOCATIONS
+        std::cout << "Heap allocations: " << allocations << " (" << bytes << " bytes), "
+                  << frees << " heap frees on teardown" << std::endl;
+#endif
+
+#ifdef KICAD_ITEM_POOL
+        ITEM_POOL::STATS pool = ITEM_POOL::GetStats();
+
+        std::cout << "Item pool: " << pool.allocations << " allocations, " << pool.frees
+                  << " frees, " << pool.bytesInUse << " bytes in use, " << pool.chunkBytes
+                  << " bytes reserved" << std::endl;
+#endif
     }
 
-    return board != nullptr;
+    return ok;
 }
 
 
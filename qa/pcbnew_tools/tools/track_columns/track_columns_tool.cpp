@@ -0,0 +1,240 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <pcb_track.h>
+#include <track_columns.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <climits>
+
+
+using TRACK_COLUMNS_DURATION = std::chrono::duration<double, std::micro>;
+
+
+/**
+ * What the benchmark loops compute, so that both ways of iterating can be compared.
+ */
+struct TRACK_STATS
+{
+    std::vector<int>    countPerLayer;      ///< items on each copper layer
+    std::vector<int>    minWidthPerLayer;   ///< narrowest track or arc on each copper layer
+    std::vector<double> lengthPerNet;       ///< length of the straight tracks of each net
+
+    TRACK_STATS( int aNetCount ) :
+            countPerLayer( PCB_LAYER_ID_COUNT, 0 ),
+            minWidthPerLayer( PCB_LAYER_ID_COUNT, INT_MAX ),
+            lengthPerNet( aNetCount, 0.0 )
+    {
+    }
+
+    bool operator==( const TRACK_STATS& aOther ) const
+    {
+        return countPerLayer == aOther.countPerLayer
+               && minWidthPerLayer == aOther.minWidthPerLayer
+               && lengthPerNet == aOther.lengthPerNet;
+    }
+};
+
+
+static void statsFromObjects( const BOARD& aBoard, TRACK_STATS& aStats )
+{
+    for( PCB_LAYER_ID layer : aBoard.GetEnabledLayers().CuStack() )
+    {
+        for( PCB_TRACK* track : aBoard.Tracks() )
+        {
+            if( !track->GetLayerSet().test( layer ) )
+                continue;
+
+            aStats.countPerLayer[layer]++;
+
+            if( track->Type() != PCB_VIA_T )
+            {
+                aStats.minWidthPerLayer[layer] = std::min( aStats.minWidthPerLayer[layer],
+                                                           track->GetWidth() );
+            }
+        }
+    }
+
+    for( PCB_TRACK* track : aBoard.Tracks() )
+    {
+        if( track->Type() == PCB_TRACE_T )
+        {
+            VECTOR2I delta = track->GetEnd() - track->GetStart();
+            aStats.lengthPerNet[track->GetNetCode()] += delta.EuclideanNorm();
+        }
+    }
+}
+
+
+static void statsFromColumns( const BOARD& aBoard, const TRACK_COLUMNS& aTracks,
+                              TRACK_STATS& aStats )
+{
+    for( PCB_LAYER_ID layer : aBoard.GetEnabledLayers().CuStack() )
+    {
+        for( size_t row = 0; row < aTracks.Size(); ++row )
+        {
+            if( !aTracks.Layers( row ).test( layer ) )
+                continue;
+
+            aStats.countPerLayer[layer]++;
+
+            if( aTracks.Type( row ) != PCB_VIA_T )
+            {
+                aStats.minWidthPerLayer[layer] = std::min( aStats.minWidthPerLayer[layer],
+                                                           aTracks.Width( row ) );
+            }
+        }
+    }
+
+    for( size_t row = 0; row < aTracks.Size(); ++row )
+    {
+        if( aTracks.Type( row ) == PCB_TRACE_T )
+        {
+            VECTOR2I delta = aTracks.End( row ) - aTracks.Start( row );
+            aStats.lengthPerNet[aTracks.NetCode( row )] += delta.EuclideanNorm();
+        }
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "r", "repeat", _( "number of passes (default 100)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum TRACK_COLUMNS_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RESULTS_DIFFER
+};
+
+
+/**
+ * Compare read-only passes over the tracks of a board through the track objects and through
+ * the board's track columns.  Both must compute exactly the same results.
+ */
+int track_columns_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program benchmarks iterating over the tracks of a board." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long        repeat = 100;
+    std::string filename;
+
+    cl_parser.Found( "repeat", &repeat );
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return TRACK_COLUMNS_RET_CODES::LOAD_FAILED;
+
+    int netCount = 1;
+
+    for( PCB_TRACK* track : board->Tracks() )
+        netCount = std::max( netCount, track->GetNetCode() + 1 );
+
+    TRACK_COLUMNS_DURATION               buildTime;
+    std::shared_ptr<const TRACK_COLUMNS> tracks;
+
+    {
+        SCOPED_PROF_COUNTER<TRACK_COLUMNS_DURATION> timer( buildTime );
+        tracks = board->GetTrackColumns();
+    }
+
+    TRACK_COLUMNS_DURATION objectTime{};
+    TRACK_COLUMNS_DURATION columnTime{};
+    long                   mismatches = 0;
+
+    for( long ii = 0; ii < repeat; ++ii )
+    {
+        TRACK_STATS            fromObjects( netCount );
+        TRACK_STATS            fromColumns( netCount );
+        TRACK_COLUMNS_DURATION duration;
+
+        {
+            SCOPED_PROF_COUNTER<TRACK_COLUMNS_DURATION> timer( duration );
+            statsFromObjects( *board, fromObjects );
+        }
+
+        objectTime += duration;
+
+        {
+            SCOPED_PROF_COUNTER<TRACK_COLUMNS_DURATION> timer( duration );
+            statsFromColumns( *board, *tracks, fromColumns );
+        }
+
+        columnTime += duration;
+
+        if( !( fromObjects == fromColumns ) )
+            mismatches++;
+    }
+
+    std::cout << "Tracks:           " << tracks->Size() << std::endl;
+    std::cout << "Column build:     " << buildTime.count() << "us" << std::endl;
+    std::cout << "Track objects:    " << objectTime.count() / repeat << "us per pass" << std::endl;
+    std::cout << "Track columns:    " << columnTime.count() / repeat << "us per pass" << std::endl;
+
+    if( columnTime.count() > 0 )
+        std::cout << "Speedup:          " << objectTime.count() / columnTime.count() << std::endl;
+
+    if( mismatches )
+    {
+        std::cerr << "Results differ in " << mismatches << " passes" << std::endl;
+        return TRACK_COLUMNS_RET_CODES::RESULTS_DIFFER;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "track_columns",
+        "Benchmark iterating over the tracks of a PCB",
+        track_columns_main_func,
+} );
@@ -0,0 +1,298 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/check_report.h>
+
+#include <cstdio>
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+#include <wx/wfstream.h>
+
+#include <eda_item.h>
+#include <kiid.h>
+#include <macros.h>
+#include <rc_item.h>
+
+
+/// Bumped whenever the meaning of a field of the JSON report changes
+static const int REPORT_FORMAT_VERSION = 1;
+
+
+namespace KI_TEST
+{
+
+int CHECK_REPORT::FILE_RESULT::Count( SEVERITY aSeverity ) const
+{
+    int count = 0;
+
+    for( const VIOLATION& violation : m_Violations )
+    {
+        if( !violation.m_Excluded && violation.m_Severity == aSeverity )
+            count++;
+    }
+
+    return count;
+}
+
+
+CHECK_REPORT::VIOLATION CHECK_REPORT::MakeViolation( const RC_ITEM& aItem, SEVERITY aSeverity,
+        double aX, double aY, const std::function<EDA_ITEM*( const KIID& )>& aResolve )
+{
+    VIOLATION violation;
+
+    violation.m_Type = aItem.GetSettingsKey();
+    violation.m_Description = aItem.GetErrorText();
+    violation.m_Message = aItem.GetErrorMessage();
+    violation.m_Severity = aSeverity;
+    violation.m_X = aX;
+    violation.m_Y = aY;
+
+    for( const KIID& id : { aItem.GetMainItemID(), aItem.GetAuxItemID(), aItem.GetAuxItem2ID(),
+                            aItem.GetAuxItem3ID() } )
+    {
+        if( id == niluuid )
+            continue;
+
+        ITEM      item;
+        EDA_ITEM* edaItem = aResolve( id );
+
+        item.m_Uuid = id.AsString();
+
+        if( edaItem )
+            item.m_Description = edaItem->GetSelectMenuText( EDA_UNITS::MILLIMETRES );
+
+        violation.m_Items.push_back( item );
+    }
+
+    return violation;
+}
+
+
+bool CHECK_REPORT::HasErrors() const
+{
+    for( const FILE_RESULT& result : m_results )
+    {
+        if( !result.m_Error.IsEmpty() )
+            return true;
+    }
+
+    return false;
+}
+
+
+bool CHECK_REPORT::HasViolations( SEVERITY aSeverity ) const
+{
+    for( const FILE_RESULT& result : m_results )
+    {
+        for( const VIOLATION& violation : result.m_Violations )
+        {
+            if( violation.m_Excluded )
+                continue;
+
+            // Only errors and warnings are violations, whatever the other severities are
+            if( violation.m_Severity == RPT_SEVERITY_ERROR
+                    || ( violation.m_Severity == RPT_SEVERITY_WARNING
+                         && aSeverity <= RPT_SEVERITY_WARNING ) )
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+std::string CHECK_REPORT::Format( FORMAT aFormat ) const
+{
+    return aFormat == FORMAT::JUNIT ? formatJUnit() : formatJSON();
+}
+
+
+bool CHECK_REPORT::Save( const wxString& aFilePath, FORMAT aFormat ) const
+{
+    std::string         buffer = Format( aFormat );
+    wxFFileOutputStream fileStream( aFilePath, "wb" );
+
+    return fileStream.IsOk() && fileStream.WriteAll( buffer.c_str(), buffer.size() );
+}
+
+
+std::string CHECK_REPORT::formatJSON() const
+{
+    nlohmann::json files = nlohmann::json::array();
+
+    for( const FILE_RESULT& result : m_results )
+    {
+        nlohmann::json violations = nlohmann::json::array();
+
+        for( const VIOLATION& violation : result.m_Violations )
+        {
+            nlohmann::json items = nlohmann::json::array();
+
+            for( const ITEM& item : violation.m_Items )
+            {
+                items.push_back( { { "uuid",        TO_UTF8( item.m_Uuid ) },
+                                   { "description", TO_UTF8( item.m_Description ) } } );
+            }
+
+            violations.push_back( { { "type",        TO_UTF8( violation.m_Type ) },
+                                    { "description", TO_UTF8( violation.m_Description ) },
+                                    { "message",     TO_UTF8( violation.m_Message ) },
+                                    { "severity",
+                                      TO_UTF8( SeverityToString( violation.m_Severity ) ) },
+                                    { "excluded",    violation.m_Excluded },
+                                    { "pos",         { { "x", violation.m_X },
+                                                       { "y", violation.m_Y } } },
+                                    { "items",       items } } );
+        }
+
+        nlohmann::json js = { { "file",       TO_UTF8( result.m_File ) },
+                              { "time",       result.m_Time },
+                              { "errors",     result.Count( RPT_SEVERITY_ERROR ) },
+                              { "warnings",   result.Count( RPT_SEVERITY_WARNING ) },
+                              { "violations", violations } };
+
+        if( !result.m_Error.IsEmpty() )
+            js["error"] = TO_UTF8( result.m_Error );
+
+        files.push_back( js );
+    }
+
+    nlohmann::json js = { { "version", REPORT_FORMAT_VERSION },
+                          { "tool",    m_tool },
+                          { "files",   files } };
+
+    return js.dump( 2 ) + "\n";
+}
+
+
+static std::string escapeXML( const wxString& aText )
+{
+    std::string escaped;
+
+    for( char c : std::string( TO_UTF8( aText ) ) )
+    {
+        switch( c )
+        {
+        case '&':  escaped += "&amp;";  break;
+        case '<':  escaped += "&lt;";   break;
+        case '>':  escaped += "&gt;";   break;
+        case '"':  escaped += "&quot;"; break;
+        case '\'': escaped += "&apos;"; break;
+        default:   escaped += c;        break;
+        }
+    }
+
+    return escaped;
+}
+
+
+std::string CHECK_REPORT::formatJUnit() const
+{
+    int    failures = 0;
+    int    errors = 0;
+    double time = 0.0;
+
+    std::ostringstream cases;
+
+    for( const FILE_RESULT& result : m_results )
+    {
+        int  fileErrors = result.Count( RPT_SEVERITY_ERROR );
+        int  fileWarnings = result.Count( RPT_SEVERITY_WARNING );
+        bool fails = fileErrors > 0
+                     || ( m_failSeverity <= RPT_SEVERITY_WARNING && fileWarnings > 0 );
+
+        std::ostringstream details;
+
+        for( const VIOLATION& violation : result.m_Violations )
+        {
+            if( violation.m_Excluded || violation.m_Severity == RPT_SEVERITY_IGNORE )
+                continue;
+
+            details << escapeXML( wxString::Format( "[%s] %s: %s @(%.4f mm, %.4f mm)\n",
+                                                    violation.m_Type,
+                                                    SeverityToString( violation.m_Severity ),
+                                                    violation.m_Message,
+                                                    violation.m_X,
+                                                    violation.m_Y ) );
+
+            for( const ITEM& item : violation.m_Items )
+                details << "    - " << escapeXML( item.m_Description ) << "\n";
+        }
+
+        cases << "    <testcase classname=\"" << m_tool << "\" name=\""
+              << escapeXML( result.m_File ) << "\" time=\"" << result.m_Time / 1000.0 << "\">\n";
+
+        if( !result.m_Error.IsEmpty() )
+        {
+            errors++;
+            cases << "      <error message=\"" << escapeXML( result.m_Error ) << "\"/>\n";
+        }
+        else if( fails )
+        {
+            failures++;
+            cases << "      <failure type=\"" << m_tool << "\" message=\""
+                  << escapeXML( wxString::Format( "%d errors, %d warnings", fileErrors,
+                                                  fileWarnings ) )
+                  << "\">\n" << details.str() << "      </failure>\n";
+        }
+        else if( fileWarnings > 0 )
+        {
+            cases << "      <system-out>\n" << details.str() << "      </system-out>\n";
+        }
+
+        cases << "    </testcase>\n";
+
+        time += result.m_Time / 1000.0;
+    }
+
+    std::ostringstream xml;
+    std::ostringstream counts;
+
+    counts << "tests=\"" << m_results.size() << "\" failures=\"" << failures << "\" errors=\""
+           << errors << "\" time=\"" << time << "\"";
+
+    xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml << "<testsuites name=\"" << m_tool << "\" " << counts.str() << ">\n";
+    xml << "  <testsuite name=\"" << m_tool << "\" " << counts.str() << ">\n";
+    xml << cases.str();
+    xml << "  </testsuite>\n";
+    xml << "</testsuites>\n";
+
+    return xml.str();
+}
+
+
+void STDERR_PROGRESS_REPORTER::Report( const wxString& aMessage )
+{
+    PROGRESS_REPORTER::Report( aMessage );
+
+    if( aMessage.IsEmpty() )
+        return;
+
+    fprintf( stderr, "%s%s\n", TO_UTF8( m_prefix ), TO_UTF8( aMessage ) );
+    fflush( stderr );
+}
+
+} // namespace KI_TEST
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef QA_UTILS_CHECK_REPORT_H
+#define QA_UTILS_CHECK_REPORT_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <widgets/progress_reporter.h>
+#include <widgets/ui_common.h>
+#include <wx/string.h>
+
+class EDA_ITEM;
+class KIID;
+class RC_ITEM;
+
+namespace KI_TEST
+{
+
+/**
+ * The results of checking a batch of files with the DRC or the ERC.  Each file is a test case,
+ * which fails when violations of the fail severity are found (errors, unless warnings are set
+ * to fail too), and errs when it cannot be checked.
+ *
+ * The report is written as JSON, or as a JUnit XML test report for continuous integration.
+ */
+class CHECK_REPORT
+{
+public:
+    enum class FORMAT
+    {
+        JSON,
+        JUNIT
+    };
+
+    struct ITEM
+    {
+        wxString m_Uuid;
+        wxString m_Description;
+    };
+
+    struct VIOLATION
+    {
+        wxString          m_Type;           ///< the settings key of the violation
+        wxString          m_Description;
+        wxString          m_Message;
+        SEVERITY          m_Severity = RPT_SEVERITY_ERROR;
+        bool              m_Excluded = false;
+        double            m_X = 0.0;        ///< millimetres
+        double            m_Y = 0.0;
+        std::vector<ITEM> m_Items;
+    };
+
+    struct FILE_RESULT
+    {
+        wxString               m_File;
+        wxString               m_Error;     ///< why the file could not be checked, if it couldn't
+        double                 m_Time = 0.0;
+        std::vector<VIOLATION> m_Violations;
+
+        int Count( SEVERITY aSeverity ) const;
+    };
+
+    /**
+     * @param aTool is the name of the check, "drc" or "erc".
+     */
+    CHECK_REPORT( const std::string& aTool ) :
+            m_tool( aTool ),
+            m_failSeverity( RPT_SEVERITY_ERROR )
+    {
+    }
+
+    /**
+     * Set the least severity of the violations which fail a file, RPT_SEVERITY_ERROR or
+     * RPT_SEVERITY_WARNING.
+     */
+    void SetFailSeverity( SEVERITY aSeverity ) { m_failSeverity = aSeverity; }
+
+    SEVERITY GetFailSeverity() const { return m_failSeverity; }
+
+    /**
+     * Describe the violation \a aItem of \a aSeverity at \a aX, \a aY.
+     *
+     * @param aResolve looks up the items of the violation by their UUID.
+     */
+    static VIOLATION MakeViolation( const RC_ITEM& aItem, SEVERITY aSeverity, double aX,
+                                    double aY,
+                                    const std::function<EDA_ITEM*( const KIID& )>& aResolve );
+
+    void AddResult( FILE_RESULT aResult ) { m_results.push_back( std::move( aResult ) ); }
+
+    const std::vector<FILE_RESULT>& GetResults() const { return m_results; }
+
+    /**
+     * @return true if a file could not be checked.
+     */
+    bool HasErrors() const;
+
+    /**
+     * @return true if an error which isn't excluded was found, or a warning when \a aSeverity
+     *         is #RPT_SEVERITY_WARNING or lower.  Other severities are never violations.
+     */
+    bool HasViolations( SEVERITY aSeverity ) const;
+
+    std::string Format( FORMAT aFormat ) const;
+
+    bool Save( const wxString& aFilePath, FORMAT aFormat ) const;
+
+private:
+    std::string formatJSON() const;
+    std::string formatJUnit() const;
+
+    std::string              m_tool;
+    SEVERITY                 m_failSeverity;
+    std::vector<FILE_RESULT> m_results;
+};
+
+
+/**
+ * Print the phases of a long task on stderr, one line each, for batch tools whose stdout
+ * may be a report.
+ */
+class STDERR_PROGRESS_REPORTER : public PROGRESS_REPORTER
+{
+public:
+    STDERR_PROGRESS_REPORTER() :
+            PROGRESS_REPORTER( 1 )
+    {
+    }
+
+    /**
+     * Set the text lines start with, such as the name of the file being checked.
+     */
+    void SetPrefix( const wxString& aPrefix ) { m_prefix = aPrefix; }
+
+    void Report( const wxString& aMessage ) override;
+
+private:
+    bool updateUI() override { return true; }
+
+    wxString m_prefix;
+};
+
+} // namespace KI_TEST
+
+#endif // QA_UTILS_CHECK_REPORT_H